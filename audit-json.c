@@ -45,6 +45,11 @@ static	const char *const stypes[STYPE__MAX] = {
 	"get", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static	const char *const optypes[OPTYPE__MAX] = {
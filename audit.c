@@ -195,6 +195,16 @@ ort_audit(const struct role *r, const struct config *cfg)
 			a->type = AUDIT_INSERT;
 			a->st = st;
 		}
+
+		if (st->ups != NULL &&
+		    rolemap_has(st->ups->rolemap, r)) {
+			a = calloc(1, sizeof(struct audit));
+			if (a == NULL)
+				goto err;
+			TAILQ_INSERT_TAIL(aq, a, entries);
+			a->type = AUDIT_UPSERT;
+			a->st = st;
+		}
 				 
 		TAILQ_FOREACH(up, &st->uq, entries)
 			if (rolemap_has(up->rolemap, r)) {
@@ -0,0 +1,59 @@
+#! /bin/sh
+#
+# Usage: bench-runner.sh rows
+# Run the C, Node.js, and Rust benchmarks over bench/bench.ort with the
+# given number of rows, printing one JSON object per operation.
+# Backends whose tools aren't configured are skipped.
+
+rows=$1
+ntmp=`mktemp`
+rm -f $ntmp
+tmp=$ntmp.db
+f=bench/bench.ort
+
+trap "rm -f $tmp bench/bench bench/bench.ort.c bench/bench.ort.h" 0
+
+if [ -z "$rows" ]
+then
+	echo "usage: $0 rows" 1>&2
+	exit 1
+fi
+
+if pkg-config --exists sqlbox
+then
+	echo "bench: $f... C" 1>&2
+	set -e
+	./ort-c-header $f >bench/bench.ort.h
+	./ort-c-source -S. -h bench.ort.h $f >bench/bench.ort.c
+	$CC -Ibench $CFLAGS -o bench/bench \
+		bench/bench.ort.c bench/bench.c $LDADD
+	rm -f $tmp
+	./ort-sql $f | sqlite3 $tmp
+	./bench/bench $tmp $rows
+	set +e
+else
+	echo "bench: skipping C" 1>&2
+fi
+
+if [ -n "$TS_NODE" ]
+then
+	echo "bench: $f... Node.js" 1>&2
+	$TS_NODE --skip-project bench/bench-runner.ts $rows || exit 1
+else
+	echo "bench: skipping Node.js" 1>&2
+fi
+
+if [ -n "$CARGO" ]
+then
+	echo "bench: $f... Rust" 1>&2
+	set -e
+	./ort-rust $f >rust/src/lib.rs
+	cp bench/bench.rs rust/src/main.rs
+	( cd rust && $CARGO build --release --offline 1>&2 )
+	rm -f $tmp
+	./ort-sql $f | sqlite3 $tmp
+	./rust/target/release/orb $tmp $rows
+	set +e
+else
+	echo "bench: skipping Rust" 1>&2
+fi
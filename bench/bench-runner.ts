@@ -0,0 +1,78 @@
+/// <reference path="../node_modules/@types/node/index.d.ts" />
+
+/*
+ * Run the Node.js benchmark with the number of rows given as the only
+ * argument and print its results, one JSON object per line.
+ */
+
+const ts = require('typescript');
+const fs = require('fs');
+const { spawnSync } = require('child_process');
+const bcrypt = require('bcrypt');
+const Database = require('better-sqlite3');
+const validator = require('validator');
+
+const tmpdb: string = '/tmp/bench.db';
+const ortname: string = 'bench/bench.ort';
+const rows: number = parseInt(process.argv[process.argv.length - 1]);
+const script: string = fs.readFileSync('bench/bench.ts').toString();
+
+function fail(msg: string, err?: any): never
+{
+	console.error('ts-node: ' + ortname + '... fail (' + msg + ')');
+	if (typeof err !== 'undefined')
+		console.error(err);
+	process.exit(1);
+}
+
+if (isNaN(rows) || rows <= 0)
+	fail('bad row count');
+
+const sql = spawnSync('./ort-sql', [ortname]);
+if (sql.status !== 0)
+	fail('ort-sql did not execute', Error(sql.stderr));
+
+spawnSync('rm', ['-f', tmpdb]);
+
+const sqlite = spawnSync('sqlite3', [tmpdb], {
+	'input': sql.stdout.toString()
+});
+if (sqlite.status !== 0)
+	fail('sqlite3 did not execute', Error(sqlite.stderr));
+
+const nodejs = spawnSync('./ort-nodejs', ['-e', ortname]);
+if (nodejs.status !== 0)
+	fail('ort-nodejs did not execute', Error(nodejs.stderr));
+
+const output = ts.transpileModule(nodejs.stdout.toString() + script, {
+	compilerOptions: {
+		alwaysStrict: true,
+		module: 'es2015',
+		noEmitOnError: true,
+		strict: true,
+		target: 'esnext',
+	},
+	reportDiagnostics: true,
+});
+
+if (typeof output.diagnostics !== 'undefined' &&
+    output.diagnostics.length > 0)
+	fail('transpile', ts.formatDiagnostics(output.diagnostics, {
+		getCurrentDirectory: () => '.',
+		getCanonicalFileName: (f: string) => '<stdin>',
+		getNewLine: () => '\n'
+	}));
+
+const func: Function = new Function
+	('validator', 'bcrypt', 'Database', 'dbfile', 'rows',
+	 output.outputText);
+const results: string[]|null =
+	func(validator, bcrypt, Database, tmpdb, rows);
+
+spawnSync('rm', ['-f', tmpdb]);
+
+if (results === null)
+	fail('run');
+
+for (const line of results)
+	console.log(line);
@@ -0,0 +1,221 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/queue.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.ort.h"
+
+/*
+ * Latencies (in nanoseconds) of one operation.
+ */
+struct	lat {
+	const char	*op;
+	uint64_t	*ns;
+	size_t		 nsz;
+	struct timespec	 start;
+	struct timespec	 opstart;
+};
+
+static uint64_t
+diff_ns(const struct timespec *a, const struct timespec *b)
+{
+
+	return (uint64_t)(b->tv_sec - a->tv_sec) * 1000000000ULL +
+		(uint64_t)b->tv_nsec - (uint64_t)a->tv_nsec;
+}
+
+static int
+lat_cmp(const void *a, const void *b)
+{
+	uint64_t	 x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void
+lat_start(struct lat *l, const char *op)
+{
+
+	l->op = op;
+	l->nsz = 0;
+	clock_gettime(CLOCK_MONOTONIC, &l->start);
+}
+
+static void
+lat_begin(struct lat *l)
+{
+
+	clock_gettime(CLOCK_MONOTONIC, &l->opstart);
+}
+
+static void
+lat_end(struct lat *l)
+{
+	struct timespec	 now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	l->ns[l->nsz++] = diff_ns(&l->opstart, &now);
+}
+
+/*
+ * Print the throughput and nearest-rank percentiles of the operation as
+ * a line of JSON.
+ */
+static void
+lat_print(struct lat *l)
+{
+	struct timespec	 now;
+	double		 secs;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	secs = diff_ns(&l->start, &now) / 1e9;
+	qsort(l->ns, l->nsz, sizeof(uint64_t), lat_cmp);
+	printf("{\"lang\": \"c\", \"op\": \"%s\", \"n\": %zu, "
+	    "\"secs\": %.6f, \"ops\": %.1f, "
+	    "\"p50_us\": %.3f, \"p99_us\": %.3f}\n",
+	    l->op, l->nsz, secs, l->nsz / secs,
+	    l->ns[(l->nsz * 50 + 99) / 100 - 1] / 1e3,
+	    l->ns[(l->nsz * 99 + 99) / 100 - 1] / 1e3);
+}
+
+static void
+count_cb(const struct item *p, void *arg)
+{
+
+	(*(size_t *)arg)++;
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct lat	 l;
+	struct item	*p;
+	struct item_q	*q;
+	int64_t		*cids, *ids;
+	size_t		 i, rows, comps, n;
+	char		 name[32];
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s db rows\n", argv[0]);
+		return 1;
+	}
+	if ((rows = strtoul(argv[2], NULL, 10)) == 0)
+		return 1;
+	if ((comps = rows / 100) == 0)
+		comps = 1;
+
+	cids = calloc(comps, sizeof(int64_t));
+	ids = calloc(rows, sizeof(int64_t));
+	l.ns = calloc(rows, sizeof(uint64_t));
+	if (cids == NULL || ids == NULL || l.ns == NULL)
+		return 1;
+
+	if ((ort = db_open(argv[1])) == NULL)
+		return 1;
+
+	for (i = 0; i < comps; i++) {
+		snprintf(name, sizeof(name), "company-%zu", i);
+		if ((cids[i] = db_company_insert(ort, name)) < 0)
+			return 1;
+	}
+
+	lat_start(&l, "insert");
+	for (i = 0; i < rows; i++) {
+		snprintf(name, sizeof(name), "item-%zu", i);
+		lat_begin(&l);
+		ids[i] = db_item_insert(ort, 
+			cids[i % comps], name, i, time(NULL));
+		lat_end(&l);
+		if (ids[i] < 0)
+			return 1;
+	}
+	lat_print(&l);
+
+	lat_start(&l, "get");
+	for (i = 0; i < rows; i++) {
+		snprintf(name, sizeof(name), "item-%zu", i);
+		lat_begin(&l);
+		p = db_item_get_by_name_eq(ort, name);
+		lat_end(&l);
+		if (p == NULL)
+			return 1;
+		db_item_free(p);
+	}
+	lat_print(&l);
+
+	lat_start(&l, "list");
+	for (i = 0; i < comps; i++) {
+		lat_begin(&l);
+		q = db_item_list_by_cid_eq(ort, cids[i]);
+		lat_end(&l);
+		if (q == NULL || TAILQ_EMPTY(q))
+			return 1;
+		db_item_freeq(q);
+	}
+	lat_print(&l);
+
+	lat_start(&l, "iterate");
+	for (i = 0; i < comps; i++) {
+		n = 0;
+		lat_begin(&l);
+		db_item_iterate_by_cid_eq(ort, count_cb, &n, cids[i]);
+		lat_end(&l);
+		if (n == 0)
+			return 1;
+	}
+	lat_print(&l);
+
+	lat_start(&l, "count");
+	for (i = 0; i < comps; i++) {
+		lat_begin(&l);
+		n = db_item_count_by_cid_eq(ort, cids[i]);
+		lat_end(&l);
+		if (n == 0)
+			return 1;
+	}
+	lat_print(&l);
+
+	lat_start(&l, "update");
+	for (i = 0; i < rows; i++) {
+		lat_begin(&l);
+		if (db_item_update_value_set_by_id_eq
+		    (ort, i + 1, ids[i]) != 1)
+			return 1;
+		lat_end(&l);
+	}
+	lat_print(&l);
+
+	lat_start(&l, "delete");
+	for (i = 0; i < rows; i++) {
+		lat_begin(&l);
+		db_item_delete_by_id_eq(ort, ids[i]);
+		lat_end(&l);
+	}
+	lat_print(&l);
+
+	db_close(ort);
+	free(cids);
+	free(ids);
+	free(l.ns);
+	return 0;
+}
@@ -0,0 +1,127 @@
+use orb::ort;
+use std::env;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Instant, SystemTime, UNIX_EPOCH};
+
+// Rows seen by the iterate callback, which can't capture.
+static SEEN: AtomicUsize = AtomicUsize::new(0);
+
+// Latencies (in nanoseconds) of one operation.
+struct Lat {
+    op: &'static str,
+    ns: Vec<u64>,
+    start: Instant,
+    opstart: Instant,
+}
+
+impl Lat {
+    fn new(op: &'static str) -> Lat {
+        let now = Instant::now();
+        Lat { op: op, ns: Vec::new(), start: now, opstart: now }
+    }
+    fn begin(&mut self) {
+        self.opstart = Instant::now();
+    }
+    fn end(&mut self) {
+        self.ns.push(self.opstart.elapsed().as_nanos() as u64);
+    }
+    // Print the throughput and nearest-rank percentiles of the
+    // operation as a line of JSON.
+    fn print(&mut self) {
+        let secs = self.start.elapsed().as_secs_f64();
+        let n = self.ns.len();
+        self.ns.sort();
+        println!("{{\"lang\": \"rust\", \"op\": \"{}\", \"n\": {}, \
+                  \"secs\": {:.6}, \"ops\": {:.1}, \
+                  \"p50_us\": {:.3}, \"p99_us\": {:.3}}}",
+                 self.op, n, secs, n as f64 / secs,
+                 self.ns[(n * 50 + 99) / 100 - 1] as f64 / 1e3,
+                 self.ns[(n * 99 + 99) / 100 - 1] as f64 / 1e3);
+    }
+}
+
+fn count_cb(_res: ort::objs::Item) {
+    SEEN.fetch_add(1, Ordering::Relaxed);
+}
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 3);
+    let rows: usize = args[2].parse().unwrap();
+    let comps: usize = std::cmp::max(1, rows / 100);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let mut cids: Vec<i64> = Vec::new();
+    let mut ids: Vec<i64> = Vec::new();
+
+    for i in 0..comps {
+        cids.push(ctx.db_company_insert(&format!("company-{}", i)).unwrap());
+    }
+
+    let mut l = Lat::new("insert");
+    for i in 0..rows {
+        let name = format!("item-{}", i);
+        let now = SystemTime::now().duration_since(UNIX_EPOCH).unwrap().as_secs() as i64;
+        l.begin();
+        let id = ctx.db_item_insert(cids[i % comps], &name, i as i64, now).unwrap();
+        l.end();
+        assert!(id >= 0);
+        ids.push(id);
+    }
+    l.print();
+
+    let mut l = Lat::new("get");
+    for i in 0..rows {
+        let name = format!("item-{}", i);
+        l.begin();
+        let obj = ctx.db_item_get_by_name_eq(&name).unwrap();
+        l.end();
+        assert!(obj.is_some());
+    }
+    l.print();
+
+    let mut l = Lat::new("list");
+    for i in 0..comps {
+        l.begin();
+        let objs = ctx.db_item_list_by_cid_eq(cids[i]).unwrap();
+        l.end();
+        assert!(objs.len() > 0);
+    }
+    l.print();
+
+    let mut l = Lat::new("iterate");
+    for i in 0..comps {
+        SEEN.store(0, Ordering::Relaxed);
+        l.begin();
+        ctx.db_item_iterate_by_cid_eq(count_cb, cids[i]).unwrap();
+        l.end();
+        assert!(SEEN.load(Ordering::Relaxed) > 0);
+    }
+    l.print();
+
+    let mut l = Lat::new("count");
+    for i in 0..comps {
+        l.begin();
+        let n = ctx.db_item_count_by_cid_eq(cids[i]).unwrap();
+        l.end();
+        assert!(n > 0);
+    }
+    l.print();
+
+    let mut l = Lat::new("update");
+    for i in 0..rows {
+        l.begin();
+        let ok = ctx.db_item_update_value_set_by_id_eq(i as i64 + 1, ids[i]).unwrap();
+        l.end();
+        assert!(ok);
+    }
+    l.print();
+
+    let mut l = Lat::new("delete");
+    for i in 0..rows {
+        l.begin();
+        ctx.db_item_delete_by_id_eq(ids[i]).unwrap();
+        l.end();
+    }
+    l.print();
+}
@@ -0,0 +1,139 @@
+/*
+ * Body of the Node.js benchmark, appended to the embedded output of
+ * ort-nodejs and run by bench-runner.ts with "dbfile" and "rows".
+ * Returns an array of result lines.
+ */
+
+const results: string[] = [];
+let op: string = '';
+let lats: number[] = [];
+let start: bigint = 0n;
+let opstart: bigint = 0n;
+
+function latStart(name: string): void
+{
+	op = name;
+	lats = [];
+	start = process.hrtime.bigint();
+}
+
+function latBegin(): void
+{
+	opstart = process.hrtime.bigint();
+}
+
+function latEnd(): void
+{
+	lats.push(Number(process.hrtime.bigint() - opstart));
+}
+
+/*
+ * Record the throughput and nearest-rank percentiles of the operation
+ * as a line of JSON.
+ */
+function latPrint(): void
+{
+	const secs: number = 
+		Number(process.hrtime.bigint() - start) / 1e9;
+	const n: number = lats.length;
+
+	lats.sort((a: number, b: number) => a - b);
+	results.push(JSON.stringify({
+		lang: 'nodejs',
+		op: op,
+		n: n,
+		secs: secs,
+		ops: n / secs,
+		p50_us: lats[Math.ceil(n * 0.50) - 1] / 1e3,
+		p99_us: lats[Math.ceil(n * 0.99) - 1] / 1e3
+	}));
+}
+
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+const comps: number = Math.max(1, Math.floor(rows / 100));
+const cids: bigint[] = [];
+const ids: bigint[] = [];
+let i: number;
+let n: number;
+
+for (i = 0; i < comps; i++)
+	cids.push(ctx.db_company_insert('company-' + i));
+
+latStart('insert');
+for (i = 0; i < rows; i++) {
+	const name: string = 'item-' + i;
+	const now: bigint = BigInt(Math.floor(Date.now() / 1000));
+	latBegin();
+	const id: bigint = ctx.db_item_insert
+		(cids[i % comps], name, BigInt(i), now);
+	latEnd();
+	if (id < 0)
+		return null;
+	ids.push(id);
+}
+latPrint();
+
+latStart('get');
+for (i = 0; i < rows; i++) {
+	const name: string = 'item-' + i;
+	latBegin();
+	const obj: ortns.item|null = ctx.db_item_get_by_name_eq(name);
+	latEnd();
+	if (obj === null)
+		return null;
+}
+latPrint();
+
+latStart('list');
+for (i = 0; i < comps; i++) {
+	latBegin();
+	const objs: ortns.item[] = ctx.db_item_list_by_cid_eq(cids[i]);
+	latEnd();
+	if (objs.length === 0)
+		return null;
+}
+latPrint();
+
+latStart('iterate');
+for (i = 0; i < comps; i++) {
+	n = 0;
+	latBegin();
+	ctx.db_item_iterate_by_cid_eq(cids[i], 
+		(_res: ortns.item) => { n++; });
+	latEnd();
+	if (n === 0)
+		return null;
+}
+latPrint();
+
+latStart('count');
+for (i = 0; i < comps; i++) {
+	latBegin();
+	const count: bigint = ctx.db_item_count_by_cid_eq(cids[i]);
+	latEnd();
+	if (count === 0n)
+		return null;
+}
+latPrint();
+
+latStart('update');
+for (i = 0; i < rows; i++) {
+	latBegin();
+	const ok: boolean = ctx.db_item_update_value_set_by_id_eq
+		(BigInt(i + 1), ids[i]);
+	latEnd();
+	if (!ok)
+		return null;
+}
+latPrint();
+
+latStart('delete');
+for (i = 0; i < rows; i++) {
+	latBegin();
+	ctx.db_item_delete_by_id_eq(ids[i]);
+	latEnd();
+}
+latPrint();
+
+return results;
@@ -0,0 +1,311 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "config.h"
+
+#if HAVE_SYS_QUEUE
+# include <sys/queue.h>
+#endif
+
+#if HAVE_ERR
+# include <err.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ort.h"
+#include "ort-lang-c.h"
+#include "ort-lang-javascript.h"
+#include "ort-lang-json.h"
+#include "ort-lang-nodejs.h"
+#include "ort-lang-rust.h"
+#include "ort-lang-sql.h"
+#include "ort-lang-xliff.h"
+
+/*
+ * Time each stage of ort(1) and its generators over a configuration,
+ * as one JSON object per stage, each stage being repeated "runs" times.
+ * Output is written to /dev/null so that only generation is measured.
+ */
+
+static	struct ort_lang_c	 c;
+static	struct ort_lang_js	 js;
+static	struct ort_lang_json	 json;
+static	struct ort_lang_nodejs	 nodejs;
+static	struct ort_lang_rust	 rust;
+static	struct ort_lang_sql	 sql;
+static	struct ort_lang_xliff	 xliff;
+
+static int
+stage_write(const struct config *cfg, FILE *f)
+{
+
+	return ort_write_file(f, cfg);
+}
+
+static int
+stage_diff(const struct config *cfg, FILE *f)
+{
+	struct diffq	*q;
+
+	(void)f;
+	if ((q = ort_diff(cfg, cfg)) == NULL)
+		return 0;
+	ort_diffq_free(q);
+	return 1;
+}
+
+static int
+stage_c_header(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_c_header(&c, cfg, f);
+}
+
+static int
+stage_c_source(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_c_source(&c, cfg, f);
+}
+
+static int
+stage_c_manpage(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_c_manpage(&c, cfg, f);
+}
+
+static int
+stage_c_explain(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_c_explain(&c, cfg, f);
+}
+
+static int
+stage_javascript(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_javascript(cfg, &js, f);
+}
+
+static int
+stage_json(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_json(&json, cfg, f);
+}
+
+static int
+stage_nodejs(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_nodejs(&nodejs, cfg, f);
+}
+
+static int
+stage_rust(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_rust(&rust, cfg, f);
+}
+
+static int
+stage_sql(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_sql(&sql, cfg, f);
+}
+
+static int
+stage_sql_advise(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_sql_advise(&sql, cfg, f);
+}
+
+static int
+stage_xliff(const struct config *cfg, FILE *f)
+{
+
+	return ort_lang_xliff_extract(&xliff, cfg, f, NULL);
+}
+
+static	const struct stage {
+	const char	*name;
+	int		(*fp)(const struct config *, FILE *);
+} stages[] = {
+	{ "write", stage_write },
+	{ "diff", stage_diff },
+	{ "c-header", stage_c_header },
+	{ "c-source", stage_c_source },
+	{ "c-manpage", stage_c_manpage },
+	{ "c-explain", stage_c_explain },
+	{ "javascript", stage_javascript },
+	{ "json", stage_json },
+	{ "nodejs", stage_nodejs },
+	{ "rust", stage_rust },
+	{ "sql", stage_sql },
+	{ "sql-advise", stage_sql_advise },
+	{ "xliff", stage_xliff },
+	{ NULL, NULL }
+};
+
+static double
+now(void)
+{
+	struct timespec	 ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+		err(1, "clock_gettime");
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void
+report(const char *name, size_t runs, double min, double sum)
+{
+
+	printf("{\"stage\": \"%s\", \"n\": %zu, \"min_ms\": %.3f, "
+		"\"mean_ms\": %.3f}\n", name, runs, 
+		min * 1e3, sum / runs * 1e3);
+}
+
+/*
+ * Parse the configuration in "f", recording the time spent in both
+ * ort_parse_file() and ort_parse_close().
+ * Exits on failure.
+ */
+static struct config *
+parse(FILE *f, const char *fname, double *parse, double *link)
+{
+	struct config	*cfg;
+	double		 start;
+
+	if ((cfg = ort_config_alloc()) == NULL)
+		err(1, NULL);
+	rewind(f);
+	start = now();
+	if (!ort_parse_file(cfg, f, fname))
+		goto out;
+	*parse = now() - start;
+	start = now();
+	if (!ort_parse_close(cfg))
+		goto out;
+	*link = now() - start;
+	return cfg;
+out:
+	ort_write_msg_file(stderr, &cfg->mq);
+	exit(1);
+}
+
+int
+main(int argc, char *argv[])
+{
+	FILE			*f, *null;
+	struct config		*cfg;
+	const struct stage	*st;
+	size_t			 i, runs = 10, jobs = 1;
+	double			 start, t, p, l,
+				 pmin = 0.0, psum = 0.0,
+				 lmin = 0.0, lsum = 0.0,
+				 min, sum;
+	char			*ep;
+	int			 ch;
+
+	while ((ch = getopt(argc, argv, "n:P:")) != -1)
+		switch (ch) {
+		case 'n':
+			runs = strtoul(optarg, &ep, 10);
+			if (*optarg == '\0' || *ep != '\0' || runs == 0)
+				goto usage;
+			break;
+		case 'P':
+			jobs = strtoul(optarg, &ep, 10);
+			if (*optarg == '\0' || *ep != '\0' || jobs == 0)
+				goto usage;
+			break;
+		default:
+			goto usage;
+		}
+
+	argc -= optind;
+	argv += optind;
+
+	if (argc != 1)
+		goto usage;
+
+	if ((f = fopen(argv[0], "r")) == NULL)
+		err(1, "%s", argv[0]);
+	if ((null = fopen("/dev/null", "w")) == NULL)
+		err(1, "/dev/null");
+
+	c.flags = ORT_LANG_C_CORE | ORT_LANG_C_JSON_KCGI |
+		ORT_LANG_C_JSON_JSMN | ORT_LANG_C_VALID_KCGI |
+		ORT_LANG_C_DB_SQLBOX;
+	c.includes = c.flags;
+	c.header = "bench.h";
+	c.guard = "BENCH_H";
+	c.ext_jsmn = "";
+	js.ext_privMethods = "";
+	nodejs.flags = ORT_LANG_NODEJS_CORE | ORT_LANG_NODEJS_DB;
+	c.jobs = nodejs.jobs = rust.jobs = jobs;
+
+	/* Each parse produces a new configuration, kept for the last. */
+
+	cfg = NULL;
+	for (i = 0; i < runs; i++) {
+		if (cfg != NULL)
+			ort_config_free(cfg);
+		cfg = parse(f, argv[0], &p, &l);
+		if (i == 0 || p < pmin)
+			pmin = p;
+		if (i == 0 || l < lmin)
+			lmin = l;
+		psum += p;
+		lsum += l;
+	}
+
+	report("parse", runs, pmin, psum);
+	report("link", runs, lmin, lsum);
+
+	for (st = stages; st->name != NULL; st++) {
+		min = sum = 0.0;
+		for (i = 0; i < runs; i++) {
+			start = now();
+			if (!(*st->fp)(cfg, null))
+				errx(1, "%s: failed", st->name);
+			if (fflush(null) == EOF)
+				err(1, "/dev/null");
+			t = now() - start;
+			if (i == 0 || t < min)
+				min = t;
+			sum += t;
+		}
+		report(st->name, runs, min, sum);
+	}
+
+	ort_config_free(cfg);
+	fclose(null);
+	fclose(f);
+	return 0;
+usage:
+	fprintf(stderr, "usage: %s [-n runs] [-P jobs] config\n", getprogname());
+	return 1;
+}
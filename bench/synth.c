@@ -0,0 +1,195 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Synthesise a valid ort(5) configuration of the given size, for
+ * benchmarking ort itself.
+ * Structures are chained by references in runs of "depth", and their
+ * queries are spread over their own and (for joins) referenced fields.
+ */
+
+#define	ITEMS	8 /* items per enumeration */
+
+static	const char *const types[] = {
+	"int",
+	"text",
+	"real",
+	"epoch",
+	"email",
+	"date",
+	"enum", /* replaced by an enumeration */
+};
+
+#define	TYPESZ	(sizeof(types) / sizeof(types[0]))
+
+static size_t	structs = 50, fields = 8, depth = 2,
+		queries = 8, roles = 0, enums = 4, labels = 1;
+
+static void
+synth_enum(size_t i)
+{
+	size_t	 j, k;
+
+	printf("enum e%zu {\n", i);
+	for (j = 0; j < ITEMS; j++) {
+		printf("  item i%zu", j);
+		for (k = 0; k < labels; k++)
+			if (k == 0)
+				printf(" jslabel \"e%zu i%zu\"", i, j);
+			else
+				printf(" jslabel.l%zu \"l%zu e%zu i%zu\"", 
+					k, k, i, j);
+		puts(";");
+	}
+	printf("  comment \"Enumeration %zu.\";\n};\n\n", i);
+}
+
+/*
+ * Print the chain of "n" references leading from a structure to its
+ * furthest referenced structure.
+ */
+static void
+synth_chain(size_t n)
+{
+
+	while (n-- > 0)
+		fputs("p.", stdout);
+}
+
+static void
+synth_struct(size_t i)
+{
+	size_t	 j, f, g, up;
+	const char *type;
+
+	/* Number of references above us in our run. */
+
+	up = i % (depth + 1);
+
+	printf("struct s%zu {\n", i);
+	puts("  field id int rowid;");
+	for (j = 0; j < fields; j++) {
+		type = types[j % (enums > 0 ? TYPESZ : TYPESZ - 1)];
+		if (type == types[TYPESZ - 1])
+			printf("  field f%zu enum e%zu", j, (i + j) % enums);
+		else
+			printf("  field f%zu %s", j, type);
+		printf(" comment \"Field %zu of %zu.\";\n", j, i);
+	}
+	if (up > 0) {
+		printf("  field pid:s%zu.id int;\n", i - 1);
+		puts("  field p struct pid;");
+	}
+
+	for (j = 0; j < queries; j++) {
+		f = j % fields;
+		g = (j + 1) % fields;
+		switch (j % 6) {
+		case 0:
+			printf("  search id, f%zu: name q%zu;\n", f, j);
+			break;
+		case 1:
+			printf("  list f%zu: name q%zu;\n", f, j);
+			break;
+		case 2:
+			printf("  iterate f%zu ge: order f%zu desc "
+				"limit 10 name q%zu;\n", f, g, j);
+			break;
+		case 3:
+			printf("  count f%zu: name q%zu;\n", f, j);
+			break;
+		case 4:
+			printf("  list ");
+			synth_chain(up);
+			printf("f%zu: name q%zu;\n", f, j);
+			break;
+		default:
+			printf("  update f%zu: id: name q%zu;\n", f, j);
+			break;
+		}
+	}
+
+	puts("  insert;");
+	puts("  delete id: name d;");
+	if (roles > 0)
+		printf("  roles r%zu { all; };\n", i % roles);
+	printf("  comment \"Structure %zu.\";\n};\n\n", i);
+}
+
+int
+main(int argc, char *argv[])
+{
+	int	 c;
+	size_t	 i, *vp;
+	char	*ep;
+
+	while ((c = getopt(argc, argv, "d:e:f:l:q:r:s:")) != -1) {
+		switch (c) {
+		case 'd':
+			vp = &depth;
+			break;
+		case 'e':
+			vp = &enums;
+			break;
+		case 'f':
+			vp = &fields;
+			break;
+		case 'l':
+			vp = &labels;
+			break;
+		case 'q':
+			vp = &queries;
+			break;
+		case 'r':
+			vp = &roles;
+			break;
+		case 's':
+			vp = &structs;
+			break;
+		default:
+			goto usage;
+		}
+		*vp = strtoul(optarg, &ep, 10);
+		if (*optarg == '\0' || *ep != '\0')
+			goto usage;
+	}
+
+	if (structs == 0 || fields == 0)
+		goto usage;
+
+	for (i = 0; i < enums; i++)
+		synth_enum(i);
+	for (i = 0; i < structs; i++)
+		synth_struct(i);
+
+	if (roles > 0) {
+		puts("roles {");
+		for (i = 0; i < roles; i++)
+			printf("  role r%zu;\n", i);
+		puts("};");
+	}
+
+	return 0;
+usage:
+	fprintf(stderr, "usage: %s [-d depth] [-e enums] "
+		"[-f fields] [-l labels] [-q queries] [-r roles] "
+		"[-s structs]\n", argv[0]);
+	return 1;
+}
@@ -86,6 +86,18 @@ parse_free_ordq(struct ordq *q)
 	}
 }
 
+static void
+parse_free_projq(struct projq *q)
+{
+	struct proj	*proj;
+
+	while ((proj = TAILQ_FIRST(q)) != NULL) {
+		TAILQ_REMOVE(q, proj, entries);
+		free(proj->fname);
+		free(proj);
+	}
+}
+
 static void
 parse_free_distinct(struct dstnct *p)
 {
@@ -105,6 +117,7 @@ parse_free_search(struct search *p)
 	if (p->aggr != NULL)
 		parse_free_aggr(p->aggr);
 	parse_free_ordq(&p->ordq);
+	parse_free_projq(&p->projq);
 	if (p->group != NULL)
 		parse_free_group(p->group);
 
@@ -133,6 +146,22 @@ parse_free_unique(struct unique *p)
 	free(p);
 }
 
+static void
+parse_free_index(struct index *p)
+{
+	struct iref	*r;
+
+	while ((r = TAILQ_FIRST(&p->nq)) != NULL) {
+		TAILQ_REMOVE(&p->nq, r, entries);
+		free(r);
+	}
+	while ((r = TAILQ_FIRST(&p->wq)) != NULL) {
+		TAILQ_REMOVE(&p->wq, r, entries);
+		free(r);
+	}
+	free(p);
+}
+
 static void
 parse_free_update(struct update *p)
 {
@@ -233,6 +262,7 @@ parse_free_strct(struct strct *p)
 	struct alias	*a;
 	struct update	*u;
 	struct unique	*n;
+	struct index	*ix;
 	struct rolemap	*rm;
 
 	while ((f = TAILQ_FIRST(&p->fq)) != NULL) {
@@ -265,6 +295,15 @@ parse_free_strct(struct strct *p)
 		TAILQ_REMOVE(&p->nq, n, entries);
 		parse_free_unique(n);
 	}
+	while ((ix = TAILQ_FIRST(&p->iq)) != NULL) {
+		TAILQ_REMOVE(&p->iq, ix, entries);
+		parse_free_index(ix);
+	}
+
+	if (p->ups != NULL) {
+		parse_free_unique(p->ups->target);
+		free(p->ups);
+	}
 
 	free(p->doc);
 	free(p->name);
@@ -320,6 +359,9 @@ parse_free_resolve(struct resolve *p)
 			free(p->struct_order.names[i]);
 		free(p->struct_order.names);
 		break;
+	case RESOLVE_PROJ:
+		free(p->struct_proj.name);
+		break;
 	case RESOLVE_SENT:
 		for (i = 0; i < p->struct_sent.namesz; i++)
 			free(p->struct_sent.names[i]);
@@ -328,6 +370,9 @@ parse_free_resolve(struct resolve *p)
 	case RESOLVE_UNIQUE:
 		free(p->struct_unique.name);
 		break;
+	case RESOLVE_INDEX:
+		free(p->struct_index.name);
+		break;
 	case RESOLVE_UP_CONSTRAINT:
 		free(p->struct_up_const.name);
 		break;
@@ -406,6 +451,7 @@ ort_config_free(struct config *cfg)
 		free(cfg->fnames[i]);
 	free(cfg->fnames);
 
+	symtab_free(&cfg->priv->st);
 	free(cfg->priv);
 	free(cfg);
 }
@@ -24,6 +24,7 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
 #if HAVE_ERR
 # include <err.h>
 #endif
@@ -40,6 +41,11 @@
 #include "ort-lang-c.h"
 #include "lang-c.h"
 
+/*
+ * List of files written by the last split (-o) run.
+ */
+#define	MANIFEST ".ort-c-source"
+
 /*
  * Read a file into memory.
  * If the file contains NUL characters, these will prematurely end the
@@ -81,6 +87,291 @@ readfile(const char *dir, const char *fname)
 	return buf;
 }
 
+/*
+ * Write "sz" bytes of "buf" into "fname" within "dir", unless the file
+ * already has exactly that content, in which case it's left alone so
+ * that its modification time doesn't trigger rebuilds.
+ * The new content is written to a temporary file then renamed.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+writeifchanged(const char *dir, const char *fname,
+	const char *buf, size_t sz)
+{
+	int		 fd, rc = 0;
+	size_t		 pos;
+	ssize_t		 ssz;
+	struct stat	 st;
+	char		*file = NULL, *tmp = NULL, *old = NULL;
+
+	if (asprintf(&file, "%s/%s", dir, fname) == -1 ||
+	    asprintf(&tmp, "%s/.%s.tmp", dir, fname) == -1) {
+		warn(NULL);
+		goto out;
+	}
+
+	if ((fd = open(file, O_RDONLY, 0)) != -1) {
+		if (fstat(fd, &st) != -1 && (uint64_t)st.st_size == sz &&
+		    (old = malloc(sz + 1)) != NULL &&
+		    read(fd, old, sz + 1) == (ssize_t)sz &&
+		    memcmp(old, buf, sz) == 0)
+			rc = 1;
+		close(fd);
+		if (rc)
+			goto out;
+	} else if (errno != ENOENT) {
+		warn("%s", file);
+		goto out;
+	}
+
+	if ((fd = open(tmp, O_WRONLY|O_CREAT|O_TRUNC, 0666)) == -1) {
+		warn("%s", tmp);
+		goto out;
+	}
+	for (pos = 0; pos < sz; pos += (size_t)ssz)
+		if ((ssz = write(fd, buf + pos, sz - pos)) == -1) {
+			warn("%s", tmp);
+			close(fd);
+			unlink(tmp);
+			goto out;
+		}
+	if (close(fd) == -1) {
+		warn("%s", tmp);
+		unlink(tmp);
+		goto out;
+	}
+	if (rename(tmp, file) == -1) {
+		warn("%s", file);
+		unlink(tmp);
+		goto out;
+	}
+	rc = 1;
+out:
+	free(old);
+	free(tmp);
+	free(file);
+	return rc;
+}
+
+static int
+namecmp(const void *a, const void *b)
+{
+
+	return strcasecmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+ * See whether "a" and "b" within "dir" are the same file, as "db_foo.c"
+ * and "db_Foo.c" are on case-insensitive file systems.
+ */
+static int
+samefile(const char *dir, const char *a, const char *b)
+{
+	struct stat	 sta, stb;
+	char		*fa, *fb;
+	int		 rc = 0;
+
+	if (asprintf(&fa, "%s/%s", dir, a) == -1)
+		return 0;
+	if (asprintf(&fb, "%s/%s", dir, b) == -1) {
+		free(fa);
+		return 0;
+	}
+	if (stat(fa, &sta) != -1 && stat(fb, &stb) != -1)
+		rc = sta.st_dev == stb.st_dev && sta.st_ino == stb.st_ino;
+	free(fa);
+	free(fb);
+	return rc;
+}
+
+/*
+ * Remove files listed in the manifest MANIFEST of "dir", from the last
+ * run, that are not among the "namesz" sorted "names" now produced.
+ * These are the files of structures since removed or renamed.
+ * Names are sorted case-insensitively, as structure names are unique
+ * regardless of case.
+ * A missing manifest (the first run) is not an error.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+unlinkstale(const char *dir, char **names, size_t namesz)
+{
+	int		 fd, rc = 0;
+	ssize_t		 ssz;
+	struct stat	 st;
+	char		*file = NULL, *buf = NULL, *cp, *ep, **np;
+
+	if (asprintf(&file, "%s/%s", dir, MANIFEST) == -1) {
+		warn(NULL);
+		return 0;
+	}
+	if ((fd = open(file, O_RDONLY, 0)) == -1) {
+		if ((rc = errno == ENOENT) == 0)
+			warn("%s", file);
+		free(file);
+		return rc;
+	}
+	if (fstat(fd, &st) == -1) {
+		warn("%s", file);
+		goto out;
+	} else if ((uint64_t)st.st_size >= SIZE_MAX) {
+		warnx("%s: file too large", file);
+		goto out;
+	}
+	if ((buf = malloc((size_t)st.st_size + 1)) == NULL) {
+		warn(NULL);
+		goto out;
+	}
+	if ((ssz = read(fd, buf, (size_t)st.st_size)) == -1) {
+		warn("%s", file);
+		goto out;
+	}
+	buf[ssz] = '\0';
+	free(file);
+	file = NULL;
+
+	/* 
+	 * Only ever remove plain names within the directory, whatever
+	 * the manifest says.
+	 */
+
+	for (cp = buf; *cp != '\0'; cp = ep) {
+		if ((ep = strchr(cp, '\n')) != NULL)
+			*ep++ = '\0';
+		else
+			ep = cp + strlen(cp);
+		if (*cp == '\0' || *cp == '.' || strchr(cp, '/') != NULL)
+			continue;
+		np = bsearch(&cp, names, namesz, sizeof(char *), namecmp);
+		if (np != NULL && 
+		    (strcmp(*np, cp) == 0 || samefile(dir, *np, cp)))
+			continue;
+		if (asprintf(&file, "%s/%s", dir, cp) == -1) {
+			warn(NULL);
+			goto out;
+		}
+		if (unlink(file) == -1 && errno != ENOENT) {
+			warn("%s", file);
+			goto out;
+		}
+		free(file);
+		file = NULL;
+	}
+	rc = 1;
+out:
+	close(fd);
+	free(buf);
+	free(file);
+	return rc;
+}
+
+/*
+ * Split output into "dir": db.c with everything not specific to a
+ * structure, then db_xxx.c with the functions of each structure xxx.
+ * The names of these files are kept in the manifest MANIFEST so that
+ * the next run can remove those it no longer produces.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+writesplit(const struct ort_lang_c *args,
+	const struct config *cfg, const char *dir)
+{
+	const struct strct	*p;
+	FILE			*f;
+	char			*buf = NULL, **names;
+	size_t			 sz, i, namesz = 1;
+	int			 rc;
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		namesz++;
+	if ((names = calloc(namesz, sizeof(char *))) == NULL) {
+		warn(NULL);
+		return 0;
+	}
+	i = 0;
+	if ((names[i++] = strdup("db.c")) == NULL) {
+		warn(NULL);
+		goto err;
+	}
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (asprintf(&names[i++], "db_%s.c", p->name) == -1) {
+			names[--i] = NULL;
+			warn(NULL);
+			goto err;
+		}
+
+	if ((f = open_memstream(&buf, &sz)) == NULL) {
+		warn(NULL);
+		return 0;
+	}
+	rc = ort_lang_c_source_common(args, cfg, f);
+	if (fclose(f) == EOF || !rc) {
+		warn(NULL);
+		free(buf);
+		goto err;
+	}
+	rc = writeifchanged(dir, names[0], buf, sz);
+	free(buf);
+	if (!rc)
+		goto err;
+
+	i = 1;
+	TAILQ_FOREACH(p, &cfg->sq, entries) {
+		buf = NULL;
+		if ((f = open_memstream(&buf, &sz)) == NULL) {
+			warn(NULL);
+			goto err;
+		}
+		rc = ort_lang_c_source_strct(args, cfg, p, f);
+		if (fclose(f) == EOF || !rc) {
+			warn(NULL);
+			free(buf);
+			goto err;
+		}
+		rc = writeifchanged(dir, names[i++], buf, sz);
+		free(buf);
+		if (!rc)
+			goto err;
+	}
+
+	/* 
+	 * Remove what's no longer produced, then record what is.
+	 * The manifest is written last so that an interrupted run
+	 * still knows about the files of the last complete one.
+	 */
+
+	qsort(names, namesz, sizeof(char *), namecmp);
+	if (!unlinkstale(dir, names, namesz))
+		goto err;
+
+	buf = NULL;
+	if ((f = open_memstream(&buf, &sz)) == NULL) {
+		warn(NULL);
+		goto err;
+	}
+	for (i = 0; i < namesz; i++)
+		fprintf(f, "%s\n", names[i]);
+	if (fclose(f) == EOF) {
+		warn(NULL);
+		free(buf);
+		goto err;
+	}
+	rc = writeifchanged(dir, MANIFEST, buf, sz);
+	free(buf);
+	if (!rc)
+		goto err;
+
+	for (i = 0; i < namesz; i++)
+		free(names[i]);
+	free(names);
+	return 1;
+err:
+	for (i = 0; i < namesz; i++)
+		free(names[i]);
+	free(names);
+	return 0;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -91,9 +382,10 @@ main(int argc, char *argv[])
 	FILE			**confs = NULL;
 	size_t			  i;
 	char			 *ext_jsmn;
+	const char		 *er, *outdir = NULL;
 
 #if HAVE_PLEDGE
-	if (pledge("stdio rpath", NULL) == -1)
+	if (pledge("stdio rpath wpath cpath", NULL) == -1)
 		err(1, "pledge");
 #endif
 
@@ -101,7 +393,7 @@ main(int argc, char *argv[])
 	args.header = "db.h";
 	args.flags = ORT_LANG_C_DB_SQLBOX;
 
-	while ((c = getopt(argc, argv, "h:I:jJN:S:v")) != -1)
+	while ((c = getopt(argc, argv, "h:I:jJN:o:P:S:v")) != -1)
 		switch (c) {
 		case 'h':
 			args.header = optarg;
@@ -126,6 +418,14 @@ main(int argc, char *argv[])
 			if (strchr(optarg, 'd') != NULL)
 				args.flags &= ~ORT_LANG_C_DB_SQLBOX;
 			break;
+		case 'o':
+			outdir = optarg;
+			break;
+		case 'P':
+			args.jobs = strtonum(optarg, 1, 256, &er);
+			if (er != NULL)
+				errx(EXIT_FAILURE, "-P: %s: %s", optarg, er);
+			break;
 		case 'S':
 			sharedir = optarg;
 			break;
@@ -139,6 +439,11 @@ main(int argc, char *argv[])
 	argc -= optind;
 	argv += optind;
 
+#if HAVE_PLEDGE
+	if (outdir == NULL && pledge("stdio rpath", NULL) == -1)
+		err(EXIT_FAILURE, "pledge");
+#endif
+
 	/* Read in all of our files now so we can repledge. */
 
 	if (argc > 0 &&
@@ -154,7 +459,7 @@ main(int argc, char *argv[])
 	args.ext_jsmn = ext_jsmn = readfile(sharedir, "jsmn.c");
 
 #if HAVE_PLEDGE
-	if (pledge("stdio", NULL) == -1)
+	if (outdir == NULL && pledge("stdio", NULL) == -1)
 		err(EXIT_FAILURE, "pledge");
 #endif
 	if ((cfg = ort_config_alloc()) == NULL)
@@ -167,9 +472,12 @@ main(int argc, char *argv[])
 	if (argc == 0 && !ort_parse_file(cfg, stdin, "<stdin>"))
 		goto out;
 
-	if ((rc = ort_parse_close(cfg)))
-		if (!(rc = ort_lang_c_source(&args, cfg, stdout)))
+	if ((rc = ort_parse_close(cfg))) {
+		if (outdir != NULL)
+			rc = writesplit(&args, cfg, outdir);
+		else if (!(rc = ort_lang_c_source(&args, cfg, stdout)))
 			warn(NULL);
+	}
 out:
 	ort_write_msg_file(stderr, &cfg->mq);
 	ort_config_free(cfg);
@@ -187,6 +495,9 @@ usage:
 		"[-h header[,header...] "
 		"[-I jJv] "
 		"[-N d] "
+		"[-o dir] "
+		"[-P jobs] "
+		"[-S sharedir] "
 		"[config...]\n",
 		getprogname());
 	return EXIT_FAILURE;
@@ -0,0 +1,844 @@
+/*
+ * WARNING: automatically generated by ort 0.14.1.
+ * DO NOT EDIT!
+ */
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE
+#endif
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE
+#endif
+#include <sys/queue.h>
+
+#include <assert.h>
+/*
+ * Required for b64_ntop().
+ */
+#include <ctype.h>
+#include <netinet/in.h>
+#include <resolv.h>
+#include <stdio.h>
+#include <stdint.h> /* int64_t */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h> /* _XOPEN_SOURCE and gmtime_r()*/
+#include <unistd.h>
+
+#include <sqlbox.h>
+
+#include "db.h"
+
+/*
+ * All SQL statements we'll later define in "stmts".
+ */
+enum	stmt {
+	STMT_company_BY_UNIQUE_id,
+	STMT_company_BY_SEARCH_0,
+	STMT_company_INSERT,
+	STMT_company_DELETE_0,
+	STMT_user_BY_UNIQUE_email,
+	STMT_user_BY_UNIQUE_uid,
+	STMT_user_BY_SEARCH_0,
+	STMT_user_BY_SEARCH_1,
+	STMT_user_BY_SEARCH_2,
+	STMT_user_INSERT,
+	STMT_user_UPDATE_0,
+	STMT_user_UPDATE_1,
+	STMT_user_DELETE_0,
+	STMT_session_BY_UNIQUE_id,
+	STMT_session_BY_SEARCH_0,
+	STMT_session_INSERT,
+	STMT_session_DELETE_0,
+	STMT__MAX
+};
+
+/*
+ * Definition of our opaque "ort", which contains role information.
+ */
+struct	ort {
+	/* Hidden database connection */
+	struct sqlbox *db;
+};
+
+/*
+ * Table columns.
+ * The macro accepts a table name because we use AS statements a lot.
+ * This is because tables can appear multiple times in a single query and 
+ * need aliasing.
+ */
+#define DB_SCHEMA_company(_x) \
+	#_x ".name" "," \
+	#_x ".id" "," \
+	#_x ".somenum"
+#define DB_SCHEMA_user(_x) \
+	#_x ".cid" "," \
+	#_x ".sex" "," \
+	#_x ".hash" "," \
+	#_x ".email" "," \
+	#_x ".image" "," \
+	#_x ".name" "," \
+	#_x ".uid"
+#define DB_SCHEMA_session(_x) \
+	#_x ".userid" "," \
+	#_x ".token" "," \
+	#_x ".mtime" "," \
+	#_x ".id"
+
+/*
+ * Our full set of SQL statements.
+ * We define these beforehand because that's how sqlbox(3) handles 
+ * statement generation.
+ * Notice the "AS" part: this allows for multiple inner joins without 
+ * ambiguity.
+ */
+static	const char *const stmts[STMT__MAX] = {
+	/* STMT_company_BY_UNIQUE_id */
+	"SELECT " DB_SCHEMA_company(company) " FROM company WHERE company.id = ?",
+	/* STMT_company_BY_SEARCH_0 */
+	"SELECT " DB_SCHEMA_company(company) " FROM company "
+		"WHERE company.somenum ISNULL",
+	/* STMT_company_INSERT */
+	"INSERT INTO company (name,somenum) VALUES (?,?)",
+	/* STMT_company_DELETE_0 */
+	"DELETE FROM company",
+	/* STMT_user_BY_UNIQUE_email */
+	"SELECT " DB_SCHEMA_user(user) "," DB_SCHEMA_company(_a) " FROM user "
+		"INNER JOIN company AS _a ON _a.id=user.cid "
+		"WHERE user.email = ?",
+	/* STMT_user_BY_UNIQUE_uid */
+	"SELECT " DB_SCHEMA_user(user) "," DB_SCHEMA_company(_a) " FROM user "
+		"INNER JOIN company AS _a ON _a.id=user.cid "
+		"WHERE user.uid = ?",
+	/* STMT_user_BY_SEARCH_0 */
+	"SELECT " DB_SCHEMA_user(user) "," DB_SCHEMA_company(_a) " FROM user "
+		"INNER JOIN company AS _a ON _a.id=user.cid "
+		"WHERE user.name = ? LIMIT 5",
+	/* STMT_user_BY_SEARCH_1 */
+	"SELECT " DB_SCHEMA_user(user) "," DB_SCHEMA_company(_a) " FROM user "
+		"INNER JOIN company AS _a ON _a.id=user.cid "
+		"WHERE user.email = ?",
+	/* STMT_user_BY_SEARCH_2 */
+	"SELECT " DB_SCHEMA_user(user) "," DB_SCHEMA_company(_a) " FROM user "
+		"INNER JOIN company AS _a ON _a.id=user.cid "
+		"WHERE user.uid = ? ORDER BY _a.name ASC",
+	/* STMT_user_INSERT */
+	"INSERT INTO user (cid,sex,hash,email,image,name) VALUES (?,?,?,?,"
+		" ?,?)",
+	/* STMT_user_UPDATE_0 */
+	"UPDATE user SET hash = ? WHERE uid = ?",
+	/* STMT_user_UPDATE_1 */
+	"UPDATE user SET email = ? WHERE uid = ?",
+	/* STMT_user_DELETE_0 */
+	"DELETE FROM user",
+	/* STMT_session_BY_UNIQUE_id */
+	"SELECT " DB_SCHEMA_session(session) "," DB_SCHEMA_user(_b) "," 
+		DB_SCHEMA_company(_c) " FROM session "
+		"INNER JOIN user AS _b ON _b.uid=session.userid "
+		"INNER JOIN company AS _c ON _c.id=_b.cid "
+		"WHERE session.id = ?",
+	/* STMT_session_BY_SEARCH_0 */
+	"SELECT " DB_SCHEMA_session(session) "," DB_SCHEMA_user(_b) "," 
+		DB_SCHEMA_company(_c) " FROM session "
+		"INNER JOIN user AS _b ON _b.uid=session.userid "
+		"INNER JOIN company AS _c ON _c.id=_b.cid "
+		"WHERE _c.name = ? AND session.mtime = ?",
+	/* STMT_session_INSERT */
+	"INSERT INTO session (userid,token,mtime) VALUES (?,?,?)",
+	/* STMT_session_DELETE_0 */
+	"DELETE FROM session WHERE id = ?",
+};
+
+/*
+ * Finally, all of the functions we'll use.
+ * All of the non-static functions are documented in the associated 
+ * header file.
+ */
+
+void
+db_trans_open(struct ort *ctx, size_t id, int mode)
+{
+	struct sqlbox *db = ctx->db;
+	int c;
+
+	if (mode < 0)
+		c = sqlbox_trans_exclusive(db, 0, id);
+	else if (mode > 0)
+		c = sqlbox_trans_immediate(db, 0, id);
+	else
+		c = sqlbox_trans_deferred(db, 0, id);
+	if (!c)
+		exit(EXIT_FAILURE);
+}
+
+void
+db_trans_rollback(struct ort *ctx, size_t id)
+{
+	struct sqlbox *db = ctx->db;
+
+	if (!sqlbox_trans_rollback(db, 0, id))
+		exit(EXIT_FAILURE);
+}
+
+void
+db_trans_commit(struct ort *ctx, size_t id)
+{
+	struct sqlbox *db = ctx->db;
+
+	if (!sqlbox_trans_commit(db, 0, id))
+		exit(EXIT_FAILURE);
+}
+
+void
+db_logging_data(struct ort *ort, const void *arg, size_t sz)
+{
+
+	if (!sqlbox_msg_set_dat(ort->db, arg, sz))
+		exit(EXIT_FAILURE);
+}
+
+struct ort *
+db_open(const char *file)
+{
+
+	return db_open_logging(file, NULL, NULL, NULL);
+}
+
+struct ort *
+db_open_logging(const char *file,
+	void (*log)(const char *, void *),
+	void (*log_short)(const char *, ...), void *log_arg)
+{
+	size_t i;
+	struct ort *ctx = NULL;
+	struct sqlbox_cfg cfg;
+	struct sqlbox *db = NULL;
+	struct sqlbox_pstmt pstmts[STMT__MAX];
+	struct sqlbox_src srcs[1] = {
+		{ .fname = (char *)file,
+		  .mode = SQLBOX_SRC_RW }
+	};
+
+	memset(&cfg, 0, sizeof(struct sqlbox_cfg));
+	cfg.msg.func = log;
+	cfg.msg.func_short = log_short;
+	cfg.msg.dat = log_arg;
+	cfg.srcs.srcs = srcs;
+	cfg.srcs.srcsz = 1;
+	cfg.stmts.stmts = pstmts;
+	cfg.stmts.stmtsz = STMT__MAX;
+
+	for (i = 0; i < STMT__MAX; i++)
+		pstmts[i].stmt = (char *)stmts[i];
+
+	ctx = malloc(sizeof(struct ort));
+	if (ctx == NULL)
+		goto err;
+
+	if ((db = sqlbox_alloc(&cfg)) == NULL)
+		goto err;
+	ctx->db = db;
+
+	/*
+	 * Now actually open the database.
+	 * If this succeeds, then we're good to go.
+	 */
+
+	if (sqlbox_open_async(db, 0))
+		return ctx;
+err:
+	sqlbox_free(db);
+	free(ctx);
+	return NULL;
+}
+
+void
+db_close(struct ort *p)
+{
+	if (p == NULL)
+		return;
+	sqlbox_free(p->db);
+	free(p);
+}
+
+/*
+ * Fill in a company from an open statement "stmt".
+ * This starts grabbing results from "pos", which may be NULL to start 
+ * from zero.
+ * This follows DB_SCHEMA_company's order for columns.
+ */
+static void
+db_company_fill(struct ort *ctx, struct company *p, const struct sqlbox_parmset *set, size_t *pos)
+{
+	size_t i = 0;
+	int64_t tmpint;
+
+	if (pos == NULL)
+		pos = &i;
+	memset(p, 0, sizeof(*p));
+	if (sqlbox_parm_string_alloc
+	    (&set->ps[(*pos)++], &p->name, NULL) == -1)
+		exit(EXIT_FAILURE);
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_company_id(p, tmpint);
+	p->has_somenum = set->ps[*pos].type != SQLBOX_PARM_NULL;
+	if (p->has_somenum) {
+		if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+			exit(EXIT_FAILURE);
+		ORT_SET_company_somenum(p, tmpint);
+	} else
+		(*pos)++;
+}
+
+static void
+db_company_fill_r(struct ort *ctx, struct company *p,
+	const struct sqlbox_parmset *res, size_t *pos)
+{
+	size_t i = 0;
+
+	if (pos == NULL)
+		pos = &i;
+	db_company_fill(ctx, p, res, pos);
+}
+
+/*
+ * Free resources from "p" and all nested objects.
+ * Does not free the "p" pointer itself.
+ * Has no effect if "p" is NULL.
+ */
+static void
+db_company_unfill(struct company *p)
+{
+	if (p == NULL)
+		return;
+	free(p->name);
+}
+
+static void
+db_company_unfill_r(struct company *p)
+{
+	if (p == NULL)
+		return;
+	db_company_unfill(p);
+}
+
+void
+db_company_free(struct company *p)
+{
+	db_company_unfill_r(p);
+	free(p);
+}
+
+void
+db_company_freeq(struct company_q *q)
+{
+	struct company *p;
+
+	if (q == NULL)
+		return;
+	while ((p = TAILQ_FIRST(q)) != NULL) {
+		TAILQ_REMOVE(q, p, _entries);
+		db_company_free(p);
+	}
+	free(q);
+}
+
+int64_t
+db_company_insert(struct ort *ctx, const char *v1, company_somenum *v2)
+{
+	enum sqlbox_code rc;
+	int64_t id = -1;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[2];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].sparm = v1;
+	parms[0].type = SQLBOX_PARM_STRING;
+	if (v2 == NULL) {
+		parms[1].type = SQLBOX_PARM_NULL;
+	} else {
+		parms[1].iparm = ORT_GETV_company_somenum(*v2);
+		parms[1].type = SQLBOX_PARM_INT;
+	}
+
+	rc = sqlbox_exec(db, 0, STMT_company_INSERT, 
+	     2, parms, SQLBOX_STMT_CONSTRAINT);
+	if (rc == SQLBOX_CODE_ERROR)
+		exit(EXIT_FAILURE);
+	else if (rc != SQLBOX_CODE_OK)
+		return (-1);
+	if (!sqlbox_lastid(db, 0, &id))
+		exit(EXIT_FAILURE);
+	return id;
+}
+
+struct company_q *
+db_company_list_by_somenum_isnull(struct ort *ctx)
+{
+	struct company *p;
+	struct company_q *q;
+	const struct sqlbox_parmset *res;
+	struct sqlbox *db = ctx->db;
+
+	q = malloc(sizeof(struct company_q));
+	if (q == NULL) {
+		perror(NULL);
+		exit(EXIT_FAILURE);
+	}
+	TAILQ_INIT(q);
+
+	if (!sqlbox_prepare_bind_async
+	    (db, 0, STMT_company_BY_SEARCH_0,
+	     0, NULL, SQLBOX_STMT_MULTI))
+		exit(EXIT_FAILURE);
+	while ((res = sqlbox_step(db, 0)) != NULL && res->psz) {
+		p = malloc(sizeof(struct company));
+		if (p == NULL) {
+			perror(NULL);
+			exit(EXIT_FAILURE);
+		}
+		db_company_fill_r(ctx, p, res, NULL);
+		TAILQ_INSERT_TAIL(q, p, _entries);
+	}
+	if (res == NULL)
+		exit(EXIT_FAILURE);
+	if (!sqlbox_finalise(db, 0))
+		exit(EXIT_FAILURE);
+	return q;
+}
+
+void
+db_company_delete(struct ort *ctx)
+{
+	enum sqlbox_code c;
+	struct sqlbox *db = ctx->db;
+
+
+	c = sqlbox_exec
+		(db, 0, STMT_company_DELETE_0, 0, NULL, 0);
+	if (c != SQLBOX_CODE_OK)
+		exit(EXIT_FAILURE);
+}
+
+/*
+ * Fill in a user from an open statement "stmt".
+ * This starts grabbing results from "pos", which may be NULL to start 
+ * from zero.
+ * This follows DB_SCHEMA_user's order for columns.
+ */
+static void
+db_user_fill(struct ort *ctx, struct user *p, const struct sqlbox_parmset *set, size_t *pos)
+{
+	size_t i = 0;
+	int64_t tmpint;
+
+	if (pos == NULL)
+		pos = &i;
+	memset(p, 0, sizeof(*p));
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_user_cid(p, tmpint);
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	p->sex = (enum sex)tmpint;
+	if (sqlbox_parm_string_alloc
+	    (&set->ps[(*pos)++], &p->hash, NULL) == -1)
+		exit(EXIT_FAILURE);
+	if (sqlbox_parm_string_alloc
+	    (&set->ps[(*pos)++], &p->email, NULL) == -1)
+		exit(EXIT_FAILURE);
+	p->has_image = set->ps[*pos].type != SQLBOX_PARM_NULL;
+	if (p->has_image) {
+		if (sqlbox_parm_blob_alloc(&set->ps[(*pos)++],
+		    &p->image, &p->image_sz) == -1)
+			exit(EXIT_FAILURE);
+	} else
+		(*pos)++;
+	if (sqlbox_parm_string_alloc
+	    (&set->ps[(*pos)++], &p->name, NULL) == -1)
+		exit(EXIT_FAILURE);
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_user_uid(p, tmpint);
+}
+
+static void
+db_user_fill_r(struct ort *ctx, struct user *p,
+	const struct sqlbox_parmset *res, size_t *pos)
+{
+	size_t i = 0;
+
+	if (pos == NULL)
+		pos = &i;
+	db_user_fill(ctx, p, res, pos);
+	db_company_fill_r(ctx, &p->company, res, pos);
+}
+
+/*
+ * Free resources from "p" and all nested objects.
+ * Does not free the "p" pointer itself.
+ * Has no effect if "p" is NULL.
+ */
+static void
+db_user_unfill(struct user *p)
+{
+	if (p == NULL)
+		return;
+	free(p->hash);
+	free(p->email);
+	free(p->image);
+	free(p->name);
+}
+
+static void
+db_user_unfill_r(struct user *p)
+{
+	if (p == NULL)
+		return;
+	db_user_unfill(p);
+	db_company_unfill_r(&p->company);
+}
+
+void
+db_user_free(struct user *p)
+{
+	db_user_unfill_r(p);
+	free(p);
+}
+
+int64_t
+db_user_insert(struct ort *ctx, company_id v1, enum sex v2, const char *v3,
+     const char *v4,
+     size_t v5_sz, const void **v5,
+     const char *v6)
+{
+	enum sqlbox_code rc;
+	int64_t id = -1;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[6];
+	char hash1[64];
+
+	crypt_newhash(v3, "blowfish,a", hash1, sizeof(hash1));
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].iparm = ORT_GETV_user_cid(v1);
+	parms[0].type = SQLBOX_PARM_INT;
+	parms[1].iparm = v2;
+	parms[1].type = SQLBOX_PARM_INT;
+	parms[2].sparm = hash1;
+	parms[2].type = SQLBOX_PARM_STRING;
+	parms[3].sparm = v4;
+	parms[3].type = SQLBOX_PARM_STRING;
+	if (v5 == NULL) {
+		parms[4].type = SQLBOX_PARM_NULL;
+	} else {
+		parms[4].bparm = *v5;
+		parms[4].type = SQLBOX_PARM_BLOB;
+		parms[4].sz = v5_sz;
+	}
+	parms[5].sparm = v6;
+	parms[5].type = SQLBOX_PARM_STRING;
+
+	rc = sqlbox_exec(db, 0, STMT_user_INSERT, 
+	     6, parms, SQLBOX_STMT_CONSTRAINT);
+	if (rc == SQLBOX_CODE_ERROR)
+		exit(EXIT_FAILURE);
+	else if (rc != SQLBOX_CODE_OK)
+		return (-1);
+	if (!sqlbox_lastid(db, 0, &id))
+		exit(EXIT_FAILURE);
+	return id;
+}
+
+void
+db_user_iterate_by_name_eq(struct ort *ctx, user_cb cb, void *arg, const char *v1)
+{
+	struct user p;
+	const struct sqlbox_parmset *res;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[1];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].sparm = v1;
+	parms[0].type = SQLBOX_PARM_STRING;
+
+	if (!sqlbox_prepare_bind_async
+	    (db, 0, STMT_user_BY_SEARCH_0,
+	     1, parms, SQLBOX_STMT_MULTI))
+		exit(EXIT_FAILURE);
+	while ((res = sqlbox_step(db, 0)) != NULL && res->psz) {
+		db_user_fill_r(ctx, &p, res, NULL);
+		(*cb)(&p, arg);
+		db_user_unfill_r(&p);
+	}
+	if (res == NULL)
+		exit(EXIT_FAILURE);
+	if (!sqlbox_finalise(db, 0))
+		exit(EXIT_FAILURE);
+}
+
+struct user *
+db_user_get_creds(struct ort *ctx, const char *v1, const char *v2)
+{
+	struct user *p = NULL;
+	const struct sqlbox_parmset *res;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[1];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].sparm = v1;
+	parms[0].type = SQLBOX_PARM_STRING;
+
+	if (!sqlbox_prepare_bind_async
+	    (db, 0, STMT_user_BY_SEARCH_1, 1, parms, 0))
+		exit(EXIT_FAILURE);
+	if ((res = sqlbox_step(db, 0)) != NULL && res->psz) {
+		p = malloc(sizeof(struct user));
+		if (p == NULL) {
+			perror(NULL);
+			exit(EXIT_FAILURE);
+		}
+		db_user_fill_r(ctx, p, res, NULL);
+		if (v2 == NULL || crypt_checkpass(v2, p->hash) == -1) {
+			db_user_free(p);
+			p = NULL;
+		}
+	}
+	if (res == NULL)
+		exit(EXIT_FAILURE);
+	if (!sqlbox_finalise(db, 0))
+		exit(EXIT_FAILURE);
+	return p;
+}
+
+struct user *
+db_user_get_by_uid_eq(struct ort *ctx, user_uid v1)
+{
+	struct user *p = NULL;
+	const struct sqlbox_parmset *res;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[1];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].iparm = ORT_GETV_user_uid(v1);
+	parms[0].type = SQLBOX_PARM_INT;
+
+	if (!sqlbox_prepare_bind_async
+	    (db, 0, STMT_user_BY_SEARCH_2, 1, parms, 0))
+		exit(EXIT_FAILURE);
+	if ((res = sqlbox_step(db, 0)) != NULL && res->psz) {
+		p = malloc(sizeof(struct user));
+		if (p == NULL) {
+			perror(NULL);
+			exit(EXIT_FAILURE);
+		}
+		db_user_fill_r(ctx, p, res, NULL);
+	}
+	if (res == NULL)
+		exit(EXIT_FAILURE);
+	if (!sqlbox_finalise(db, 0))
+		exit(EXIT_FAILURE);
+	return p;
+}
+
+int
+db_user_update_hash_set_by_uid_eq(struct ort *ctx, const char *v1, user_uid v2)
+{
+	enum sqlbox_code c;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[2];
+	char hash1[64];
+
+	crypt_newhash(v1, "blowfish,a", hash1, sizeof(hash1));
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].sparm = hash1;
+	parms[0].type = SQLBOX_PARM_STRING;
+	parms[1].iparm = ORT_GETV_user_uid(v2);
+	parms[1].type = SQLBOX_PARM_INT;
+
+	c = sqlbox_exec
+		(db, 0, STMT_user_UPDATE_0,
+		 2, parms, SQLBOX_STMT_CONSTRAINT);
+	if (c == SQLBOX_CODE_ERROR)
+		exit(EXIT_FAILURE);
+	return (c == SQLBOX_CODE_OK) ? 1 : 0;
+}
+
+int
+db_user_update_email_set_by_uid_eq(struct ort *ctx, const char *v1, user_uid v2)
+{
+	enum sqlbox_code c;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[2];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].sparm = v1;
+	parms[0].type = SQLBOX_PARM_STRING;
+	parms[1].iparm = ORT_GETV_user_uid(v2);
+	parms[1].type = SQLBOX_PARM_INT;
+
+	c = sqlbox_exec
+		(db, 0, STMT_user_UPDATE_1,
+		 2, parms, SQLBOX_STMT_CONSTRAINT);
+	if (c == SQLBOX_CODE_ERROR)
+		exit(EXIT_FAILURE);
+	return (c == SQLBOX_CODE_OK) ? 1 : 0;
+}
+
+void
+db_user_delete(struct ort *ctx)
+{
+	enum sqlbox_code c;
+	struct sqlbox *db = ctx->db;
+
+
+	c = sqlbox_exec
+		(db, 0, STMT_user_DELETE_0, 0, NULL, 0);
+	if (c != SQLBOX_CODE_OK)
+		exit(EXIT_FAILURE);
+}
+
+/*
+ * Fill in a session from an open statement "stmt".
+ * This starts grabbing results from "pos", which may be NULL to start 
+ * from zero.
+ * This follows DB_SCHEMA_session's order for columns.
+ */
+static void
+db_session_fill(struct ort *ctx, struct session *p, const struct sqlbox_parmset *set, size_t *pos)
+{
+	size_t i = 0;
+	int64_t tmpint;
+
+	if (pos == NULL)
+		pos = &i;
+	memset(p, 0, sizeof(*p));
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_session_userid(p, tmpint);
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_session_token(p, tmpint);
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_session_mtime(p, (time_t)tmpint);
+	if (sqlbox_parm_int(&set->ps[(*pos)++], &tmpint) == -1)
+		exit(EXIT_FAILURE);
+	ORT_SET_session_id(p, tmpint);
+}
+
+static void
+db_session_fill_r(struct ort *ctx, struct session *p,
+	const struct sqlbox_parmset *res, size_t *pos)
+{
+	size_t i = 0;
+
+	if (pos == NULL)
+		pos = &i;
+	db_session_fill(ctx, p, res, pos);
+	db_user_fill_r(ctx, &p->user, res, pos);
+}
+
+/*
+ * Free resources from "p" and all nested objects.
+ * Does not free the "p" pointer itself.
+ * Has no effect if "p" is NULL.
+ */
+static void
+db_session_unfill(struct session *p)
+{
+	if (p == NULL)
+		return;
+}
+
+static void
+db_session_unfill_r(struct session *p)
+{
+	if (p == NULL)
+		return;
+	db_session_unfill(p);
+	db_user_unfill_r(&p->user);
+}
+
+void
+db_session_free(struct session *p)
+{
+	db_session_unfill_r(p);
+	free(p);
+}
+
+int64_t
+db_session_insert(struct ort *ctx, user_uid v1, session_token v2, session_mtime v3)
+{
+	enum sqlbox_code rc;
+	int64_t id = -1;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[3];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].iparm = ORT_GETV_session_userid(v1);
+	parms[0].type = SQLBOX_PARM_INT;
+	parms[1].iparm = ORT_GETV_session_token(v2);
+	parms[1].type = SQLBOX_PARM_INT;
+	parms[2].iparm = (time_t)ORT_GETV_session_mtime(v3);
+	parms[2].type = SQLBOX_PARM_INT;
+
+	rc = sqlbox_exec(db, 0, STMT_session_INSERT, 
+	     3, parms, SQLBOX_STMT_CONSTRAINT);
+	if (rc == SQLBOX_CODE_ERROR)
+		exit(EXIT_FAILURE);
+	else if (rc != SQLBOX_CODE_OK)
+		return (-1);
+	if (!sqlbox_lastid(db, 0, &id))
+		exit(EXIT_FAILURE);
+	return id;
+}
+
+void
+db_session_iterate_foo(struct ort *ctx, session_cb cb, void *arg, const char *v1,
+     session_mtime v2)
+{
+	struct session p;
+	const struct sqlbox_parmset *res;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[2];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].sparm = v1;
+	parms[0].type = SQLBOX_PARM_STRING;
+	parms[1].iparm = (time_t)ORT_GETV_session_mtime(v2);
+	parms[1].type = SQLBOX_PARM_INT;
+
+	if (!sqlbox_prepare_bind_async
+	    (db, 0, STMT_session_BY_SEARCH_0,
+	     2, parms, SQLBOX_STMT_MULTI))
+		exit(EXIT_FAILURE);
+	while ((res = sqlbox_step(db, 0)) != NULL && res->psz) {
+		db_session_fill_r(ctx, &p, res, NULL);
+		(*cb)(&p, arg);
+		db_session_unfill_r(&p);
+	}
+	if (res == NULL)
+		exit(EXIT_FAILURE);
+	if (!sqlbox_finalise(db, 0))
+		exit(EXIT_FAILURE);
+}
+
+void
+db_session_delete_by_id_eq(struct ort *ctx, session_id v1)
+{
+	enum sqlbox_code c;
+	struct sqlbox *db = ctx->db;
+	struct sqlbox_parm parms[1];
+
+	memset(parms, 0, sizeof(parms));
+	parms[0].iparm = ORT_GETV_session_id(v1);
+	parms[0].type = SQLBOX_PARM_INT;
+
+	c = sqlbox_exec
+		(db, 0, STMT_session_DELETE_0, 1, parms, 0);
+	if (c != SQLBOX_CODE_OK)
+		exit(EXIT_FAILURE);
+}
+
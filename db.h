@@ -0,0 +1,402 @@
+#ifndef DB_H
+#define DB_H
+
+/*
+ * WARNING: automatically generated by ort_lang_c_header 0.14.1.
+ * DO NOT EDIT!
+ */
+
+#ifndef KWBP_VERSION
+# define KWBP_VERSION "0.14.1"
+#endif
+#ifndef KWBP_VSTAMP
+# define KWBP_VSTAMP 11502
+#endif
+
+/*
+ * Birthsex of individual
+ */
+enum	sex {
+	/* Male */
+	SEX_male = 0,
+	/* Female */
+	SEX_female = 1,
+	/* Other */
+	SEX_other = 2
+};
+
+typedef int64_t company_id;
+typedef int64_t company_somenum;
+typedef int64_t user_uid;
+typedef int64_t session_token;
+typedef time_t session_mtime;
+typedef int64_t session_id;
+
+/*
+ * Controlling organisation.
+ */
+struct	company {
+	/* Name of the organisation. */
+	char	*name;
+	company_id	 id;
+	/* Simply a check for null values. */
+	company_somenum	 somenum;
+	/* Non-zero if "somenum" field is null/unset. */
+	int has_somenum;
+	TAILQ_ENTRY(company) _entries;
+};
+
+/*
+ * Queue of company for listings.
+ */
+TAILQ_HEAD(company_q, company);
+
+/*
+ * A regular user.
+ */
+struct	user {
+	/*
+	 * This struct will be filled in from an inner join
+	 *     on the "cid" variable.
+	 */
+	struct company company;
+	/* A foreign key reference. */
+	company_id	 cid;
+	/* User's birth sex. */
+	enum sex sex;
+	/*
+	 * Password hash.
+	 *     This is passed to inserts and updates as a password,
+	 *     then hashed within the implementation and extracted
+	 *     (in listings and searches) as the hash value.
+	 */
+	char	*hash;
+	/* Unique e-mail address. */
+	char	*email;
+	/* A PNG image or something. */
+	void	*image;
+	size_t	 image_sz;
+	/* User's full name. */
+	char	*name;
+	user_uid	 uid;
+	/* Non-zero if "image" field is null/unset. */
+	int has_image;
+};
+
+/*
+ * Callback of user for iteration.
+ * The arg parameter is the opaque pointer passed into the iterate 
+ * function.
+ */
+typedef void (*user_cb)(const struct user *v, void *arg);
+
+/*
+ * Authenticated session.
+ */
+struct	session {
+	struct user user;
+	/* Associated user. */
+	user_uid	 userid;
+	/* Random cookie. */
+	session_token	 token;
+	session_mtime	 mtime;
+	session_id	 id;
+};
+
+/*
+ * Callback of session for iteration.
+ * The arg parameter is the opaque pointer passed into the iterate 
+ * function.
+ */
+typedef void (*session_cb)(const struct session *v, void *arg);
+
+#define ORT_company_id(_src) (_src)
+static inline int64_t ORT_GET_company_id(const struct company *dst) { return dst->id; }
+#define ORT_GETV_company_id(_dst) (_dst)
+static inline void ORT_SET_company_id(struct company *dst, int64_t src) { dst->id = src; }
+#define ORT_SETV_company_id(_dst, _src) *(_dst) = (_src)
+
+#define ORT_company_somenum(_src) (_src)
+static inline int64_t ORT_GET_company_somenum(const struct company *dst) { return dst->somenum; }
+#define ORT_GETV_company_somenum(_dst) (_dst)
+static inline void ORT_SET_company_somenum(struct company *dst, int64_t src) { dst->somenum = src; }
+#define ORT_SETV_company_somenum(_dst, _src) *(_dst) = (_src)
+
+static inline int64_t ORT_GET_user_cid(const struct user *dst) { return dst->cid; }
+#define ORT_GETV_user_cid(_dst) (_dst)
+static inline void ORT_SET_user_cid(struct user *dst, int64_t src) { dst->cid = src; }
+#define ORT_SETV_user_cid(_dst, _src) *(_dst) = (_src)
+
+#define ORT_user_uid(_src) (_src)
+static inline int64_t ORT_GET_user_uid(const struct user *dst) { return dst->uid; }
+#define ORT_GETV_user_uid(_dst) (_dst)
+static inline void ORT_SET_user_uid(struct user *dst, int64_t src) { dst->uid = src; }
+#define ORT_SETV_user_uid(_dst, _src) *(_dst) = (_src)
+
+static inline int64_t ORT_GET_session_userid(const struct session *dst) { return dst->userid; }
+#define ORT_GETV_session_userid(_dst) (_dst)
+static inline void ORT_SET_session_userid(struct session *dst, int64_t src) { dst->userid = src; }
+#define ORT_SETV_session_userid(_dst, _src) *(_dst) = (_src)
+
+#define ORT_session_token(_src) (_src)
+static inline int64_t ORT_GET_session_token(const struct session *dst) { return dst->token; }
+#define ORT_GETV_session_token(_dst) (_dst)
+static inline void ORT_SET_session_token(struct session *dst, int64_t src) { dst->token = src; }
+#define ORT_SETV_session_token(_dst, _src) *(_dst) = (_src)
+
+#define ORT_session_mtime(_src) (_src)
+static inline time_t ORT_GET_session_mtime(const struct session *dst) { return dst->mtime; }
+#define ORT_GETV_session_mtime(_dst) (_dst)
+static inline void ORT_SET_session_mtime(struct session *dst, time_t src) { dst->mtime = src; }
+#define ORT_SETV_session_mtime(_dst, _src) *(_dst) = (_src)
+
+#define ORT_session_id(_src) (_src)
+static inline int64_t ORT_GET_session_id(const struct session *dst) { return dst->id; }
+#define ORT_GETV_session_id(_dst) (_dst)
+static inline void ORT_SET_session_id(struct session *dst, int64_t src) { dst->id = src; }
+#define ORT_SETV_session_id(_dst, _src) *(_dst) = (_src)
+
+__BEGIN_DECLS
+
+/*
+ * Forward declaration of opaque pointer.
+ */
+struct ort;
+
+/*
+ * Set the argument given to the logging function specified to 
+ * db_open_logging().
+ * Has no effect if no logging function has been set.
+ * The buffer is copied into a child process, so serialised objects may 
+ * not have any pointers in the current address space or they will fail 
+ * (at best).
+ * Set length to zero to unset the logging function callback argument.
+ */
+void db_logging_data(struct ort *ort, const void *arg, size_t sz);
+
+/*
+ * Allocate and open the database in "file".
+ * Returns an opaque pointer or NULL on memory exhaustion.
+ * The returned pointer must be closed with db_close().
+ * See db_open_logging() for the equivalent function that accepts logging 
+ * callbacks.
+ * This function starts a child with fork(), the child of which opens the 
+ * database, so a constraint environment (e.g., with pledge) must take 
+ * this into account.
+ * Subsequent this function, all database operations take place over IPC.
+ */
+struct ort *db_open(const char *file);
+
+/*
+ * Like db_open() but accepts a function for logging.
+ * If both are provided, the "long" form overrides the "short" form.
+ * The logging function is run both in a child and parent process, so it 
+ * must not have side effects.
+ * The optional pointer is passed to the long form logging function and 
+ * is inherited by the child process as-is, without being copied by 
+ * value.
+ * See db_logging_data() to set the pointer after initialisation.
+ */
+struct ort *db_open_logging(const char *file,
+	void (*log)(const char *, void *),
+	void (*log_short)(const char *, ...), void *log_arg);
+
+/*
+ * Open a transaction with identifier "id".
+ * If "mode" is 0, the transaction is opened in "deferred" mode, meaning 
+ * that the database is read-locked (no writes allowed) on the first read 
+ * operation, and write-locked on the first write (only the current 
+ * process can write).
+ * If "mode" is >0, the transaction immediately starts a write-lock.
+ * If "mode" is <0, the transaction starts in a write-pending, where no 
+ * other locks can be held at the same time.
+ * The DB_TRANS_OPEN_IMMEDIATE, DB_TRANS_OPEN_DEFERRED, and 
+ * DB_TRANS_OPEN_EXCLUSIVE macros accomplish the same but with the "mode" 
+ * being explicit in the name and not needing to be specified.
+ */
+void db_trans_open(struct ort *ctx, size_t id, int mode);
+
+#define DB_TRANS_OPEN_IMMEDIATE(_ctx, _id) \
+	db_trans_open((_ctx), (_id), 1)
+#define DB_TRANS_OPEN_DEFERRED(_ctx, _id)\
+	db_trans_open((_ctx), (_id), 0)
+#define DB_TRANS_OPEN_EXCLUSIVE(_ctx, _id)\
+	db_trans_open((_ctx), (_id), -1)
+
+/*
+ * Roll-back an open transaction.
+ */
+void db_trans_rollback(struct ort *ctx, size_t id);
+
+/*
+ * Commit an open transaction.
+ */
+void db_trans_commit(struct ort *ctx, size_t id);
+
+/*
+ * Close the context opened by db_open().
+ * Has no effect if "p" is NULL.
+ */
+void db_close(struct ort *p);
+
+
+/*
+ * Clear resources and free "p".
+ * Has no effect if "p" is NULL.
+ */
+void db_company_free(struct company *p);
+
+/*
+ * Unfill and free all queue members.
+ * Has no effect if "q" is NULL.
+ */
+void db_company_freeq(struct company_q *q);
+
+/*
+ * Insert a new row into the database.
+ * Only native (and non-rowid) fields may be set.
+ * 	v1: name
+ * 	v2: somenum
+ * Returns the new row's identifier on success or <0 otherwise.
+ */
+int64_t db_company_insert(struct ort *ctx, const char *v1, company_somenum *v2);
+
+/*
+ * Search for a set of company.
+ * Queries on the following fields in struct company:
+ * 	somenum (not an argument: checked is null)
+ * Always returns a queue pointer.
+ * Free this with db_company_freeq().
+ */
+struct company_q *db_company_list_by_somenum_isnull(struct ort *ctx);
+
+/*
+ * Delete fields in struct company.
+ *  * Constraint fields:
+ * Returns zero on constraint violation, non-zero on success.
+ */
+void db_company_delete(struct ort *ctx);
+
+/*
+ * Clear resources and free "p".
+ * Has no effect if "p" is NULL.
+ */
+void db_user_free(struct user *p);
+
+/*
+ * Insert a new row into the database.
+ * Only native (and non-rowid) fields may be set.
+ * 	v1: cid
+ * 	v2: sex
+ * 	v3: hash (pre-hashed password)
+ * 	v4: email
+ * 	v5: image
+ * 	v6: name
+ * Returns the new row's identifier on success or <0 otherwise.
+ */
+int64_t db_user_insert(struct ort *ctx, company_id v1, enum sex v2, const char *v3,
+     const char *v4,
+     size_t v5_sz, const void **v5,
+     const char *v6);
+
+/*
+ * Create a function that searches for users by a given
+ *     name; and, when found, invokes a callback function
+ *     provided the user structure.
+ * This callback function is called during an implicit transaction: thus, 
+ * it should not invoke any database modifications or risk deadlock.
+ * Queries on the following fields in struct user:
+ * 	v1: name (equals)
+ * Invokes the given callback with retrieved data.
+ */
+void db_user_iterate_by_name_eq(struct ort *ctx, user_cb cb, void *arg, const char *v1);
+
+/*
+ * Search for a unique user with their e-mail and
+ *     password.
+ *     This is a quick way to verify that a user has entered
+ *     the correct password for logging in.
+ * Queries on the following fields in struct user:
+ * 	v1: email (equals)
+ * 	v2: hash (pre-hashed password, equals)
+ * Returns a pointer or NULL on fail.
+ * Free the pointer with db_user_free().
+ */
+struct user *db_user_get_creds(struct ort *ctx, const char *v1, const char *v2);
+
+/*
+ * Lookup by unique identifier.
+ * Queries on the following fields in struct user:
+ * 	v1: uid (equals)
+ * Returns a pointer or NULL on fail.
+ * Free the pointer with db_user_free().
+ */
+struct user *db_user_get_by_uid_eq(struct ort *ctx, user_uid v1);
+
+/*
+ * Update fields in struct user.
+ * Updated fields:
+ * 	v1: hash (password)
+ * Constraint fields:
+ * 	v2: uid (equals)
+ * Returns zero on constraint violation, non-zero on success.
+ */
+int db_user_update_hash_set_by_uid_eq(struct ort *ctx, const char *v1, user_uid v2);
+
+/*
+ * Update fields in struct user.
+ * Updated fields:
+ * 	v1: email
+ * Constraint fields:
+ * 	v2: uid (equals)
+ * Returns zero on constraint violation, non-zero on success.
+ */
+int db_user_update_email_set_by_uid_eq(struct ort *ctx, const char *v1, user_uid v2);
+
+/*
+ * Delete fields in struct user.
+ *  * Constraint fields:
+ * Returns zero on constraint violation, non-zero on success.
+ */
+void db_user_delete(struct ort *ctx);
+
+/*
+ * Clear resources and free "p".
+ * Has no effect if "p" is NULL.
+ */
+void db_session_free(struct session *p);
+
+/*
+ * Insert a new row into the database.
+ * Only native (and non-rowid) fields may be set.
+ * 	v1: userid
+ * 	v2: token
+ * 	v3: mtime
+ * Returns the new row's identifier on success or <0 otherwise.
+ */
+int64_t db_session_insert(struct ort *ctx, user_uid v1, session_token v2,
+     session_mtime v3);
+
+/*
+ * Search for company's logged-in users.
+ * This callback function is called during an implicit transaction: thus, 
+ * it should not invoke any database modifications or risk deadlock.
+ * Queries on the following fields in struct session:
+ * 	v1: user.company.name (equals)
+ * 	v2: mtime (equals)
+ * Invokes the given callback with retrieved data.
+ */
+void db_session_iterate_foo(struct ort *ctx, session_cb cb, void *arg, const char *v1,
+     session_mtime v2);
+
+/*
+ * Delete fields in struct session.
+ *  * Constraint fields:
+ * 	v1: id (equals)
+ * Returns zero on constraint violation, non-zero on success.
+ */
+void db_session_delete_by_id_eq(struct ort *ctx, session_id v1);
+
+__END_DECLS
+
+#endif
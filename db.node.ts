@@ -0,0 +1,906 @@
+/**
+ * WARNING: automatically generated by ort 0.14.1.
+ * DO NOT EDIT!
+ * @packageDocumentation
+ */
+
+import bcrypt from 'bcrypt';
+import Database from 'better-sqlite3';
+
+/**
+ * Namespace for data interfaces and representative classes.  The 
+ * interfaces are for the data itself, while the classes manage roles and 
+ * metadata.
+ */
+export namespace ortns
+{
+	/**
+	 * Birthsex of individual
+	 */
+	export enum sex
+	{
+		/**
+		 * Male
+		 */
+		male = '0',
+		/**
+		 * Female
+		 */
+		female = '1',
+		/**
+		 * Other
+		 */
+		other = '2'
+	}
+
+	/**
+	 * Controlling organisation.
+	 */
+	export interface companyData
+	{
+		/**
+		 * Name of the organisation.
+		 */
+		name: string;
+		id: bigint;
+		/**
+		 * Simply a check for null values.
+		 */
+		somenum: bigint|null;
+	}
+
+	function db_export_company(role: string, obj: companyData): any
+	{
+		const res: any = {}
+
+		res['name'] = obj['name'];
+		res['id'] = obj['id'].toString();
+		res['somenum'] = (obj['somenum'] === null) ?
+			null : obj['somenum'].toString();
+
+		return res;
+	}
+
+	/**
+	 * Class instance of {@link ortns.companyData}.
+	 */
+	export class company
+	{
+		readonly #role: string;
+		readonly obj: ortns.companyData;
+
+		/**
+		 * A {@link ortns.companyData} as extracted from the database in 
+		 * a particular role.
+		 * @param role The role in which this was extracted from the 
+		 * database. When exported, this role will be checked for 
+		 * permission to export.
+		 * @param obj The raw data.
+		 */
+		constructor(role: string, obj: ortns.companyData)
+		{
+			this.#role = role;
+			this.obj = obj;
+		}
+
+		/**
+		 * Export the contained {@link ortns.companyData} respecting 
+		 * fields not exported, roles, etc.  It's safe to call 
+		 * `JSON.stringify()` on the returned object to write responses.
+		 */
+		export(): any
+		{
+			return db_export_company(this.#role, this.obj);
+		}
+	}
+
+	/**
+	 * A regular user.
+	 */
+	export interface userData
+	{
+		/**
+		 * This struct will be filled in from an inner join
+		 *     on the "cid" variable.
+		 */
+		company: ortns.companyData;
+		/**
+		 * A foreign key reference.
+		 */
+		cid: bigint;
+		/**
+		 * User's birth sex.
+		 */
+		sex: ortns.sex;
+		/**
+		 * Password hash.
+		 *     This is passed to inserts and updates as a password,
+		 *     then hashed within the implementation and extracted
+		 *     (in listings and searches) as the hash value.
+		 */
+		hash: string;
+		/**
+		 * Unique e-mail address.
+		 */
+		email: string;
+		/**
+		 * A PNG image or something.
+		 */
+		image: Buffer|null;
+		/**
+		 * User's full name.
+		 */
+		name: string;
+		uid: bigint;
+	}
+
+	function db_export_user(role: string, obj: userData): any
+	{
+		const res: any = {}
+
+		res['company'] = db_export_company(role, obj['company'])
+		res['cid'] = obj['cid'].toString();
+		res['sex'] = obj['sex'];
+		/**
+		 * Don't output hash: password.
+		 */
+		res['email'] = obj['email'];
+		res['image'] = (obj['image'] === null) ?
+			null : obj['image'].toString('base64');
+		res['name'] = obj['name'];
+		res['uid'] = obj['uid'].toString();
+
+		return res;
+	}
+
+	/**
+	 * Class instance of {@link ortns.userData}.
+	 */
+	export class user
+	{
+		readonly #role: string;
+		readonly obj: ortns.userData;
+
+		/**
+		 * A {@link ortns.userData} as extracted from the database in a 
+		 * particular role.
+		 * @param role The role in which this was extracted from the 
+		 * database. When exported, this role will be checked for 
+		 * permission to export.
+		 * @param obj The raw data.
+		 */
+		constructor(role: string, obj: ortns.userData)
+		{
+			this.#role = role;
+			this.obj = obj;
+		}
+
+		/**
+		 * Export the contained {@link ortns.userData} respecting fields 
+		 * not exported, roles, etc.  It's safe to call 
+		 * `JSON.stringify()` on the returned object to write responses.
+		 */
+		export(): any
+		{
+			return db_export_user(this.#role, this.obj);
+		}
+	}
+
+	/**
+	 * Authenticated session.
+	 */
+	export interface sessionData
+	{
+		user: ortns.userData;
+		/**
+		 * Associated user.
+		 */
+		userid: bigint;
+		/**
+		 * Random cookie.
+		 */
+		token: bigint;
+		mtime: bigint;
+		id: bigint;
+	}
+
+	function db_export_session(role: string, obj: sessionData): any
+	{
+		const res: any = {}
+
+		res['user'] = db_export_user(role, obj['user'])
+		res['userid'] = obj['userid'].toString();
+		res['token'] = obj['token'].toString();
+		res['mtime'] = obj['mtime'].toString();
+		res['id'] = obj['id'].toString();
+
+		return res;
+	}
+
+	/**
+	 * Class instance of {@link ortns.sessionData}.
+	 */
+	export class session
+	{
+		readonly #role: string;
+		readonly obj: ortns.sessionData;
+
+		/**
+		 * A {@link ortns.sessionData} as extracted from the database in 
+		 * a particular role.
+		 * @param role The role in which this was extracted from the 
+		 * database. When exported, this role will be checked for 
+		 * permission to export.
+		 * @param obj The raw data.
+		 */
+		constructor(role: string, obj: ortns.sessionData)
+		{
+			this.#role = role;
+			this.obj = obj;
+		}
+
+		/**
+		 * Export the contained {@link ortns.sessionData} respecting 
+		 * fields not exported, roles, etc.  It's safe to call 
+		 * `JSON.stringify()` on the returned object to write responses.
+		 */
+		export(): any
+		{
+			return db_export_session(this.#role, this.obj);
+		}
+	}
+}
+
+namespace ortstmt
+{
+	export enum ortstmt
+	{
+		STMT_company_BY_UNIQUE_id,
+		STMT_company_BY_SEARCH_0,
+		STMT_company_INSERT,
+		STMT_company_DELETE_0,
+		STMT_user_BY_UNIQUE_email,
+		STMT_user_BY_UNIQUE_uid,
+		STMT_user_BY_SEARCH_0,
+		STMT_user_BY_SEARCH_1,
+		STMT_user_BY_SEARCH_2,
+		STMT_user_INSERT,
+		STMT_user_UPDATE_0,
+		STMT_user_UPDATE_1,
+		STMT_user_DELETE_0,
+		STMT_session_BY_UNIQUE_id,
+		STMT_session_BY_SEARCH_0,
+		STMT_session_INSERT,
+		STMT_session_DELETE_0,
+	}
+
+	export function stmtBuilder(idx: ortstmt): string
+	{
+		return ortstmts[idx];
+	}
+
+	const ortstmts: readonly string[] =
+	[
+		/* STMT_company_BY_UNIQUE_id */
+		'SELECT ' + ort_schema_company('company') + ' FROM company WHERE company.id = ?',
+		/* STMT_company_BY_SEARCH_0 */
+		'SELECT ' + ort_schema_company('company') + ' FROM company '
+			+ 'WHERE company.somenum ISNULL',
+		/* STMT_company_INSERT */
+		'INSERT INTO company (name,somenum) VALUES (?,?)',
+		/* STMT_company_DELETE_0 */
+		'DELETE FROM company',
+		/* STMT_user_BY_UNIQUE_email */
+		'SELECT ' + ort_schema_user('user') + ',' + ort_schema_company('_a') + ' FROM user '
+			+ 'INNER JOIN company AS _a ON _a.id=user.cid '
+			+ 'WHERE user.email = ?',
+		/* STMT_user_BY_UNIQUE_uid */
+		'SELECT ' + ort_schema_user('user') + ',' + ort_schema_company('_a') + ' FROM user '
+			+ 'INNER JOIN company AS _a ON _a.id=user.cid '
+			+ 'WHERE user.uid = ?',
+		/* STMT_user_BY_SEARCH_0 */
+		'SELECT ' + ort_schema_user('user') + ',' + ort_schema_company('_a') + ' FROM user '
+			+ 'INNER JOIN company AS _a ON _a.id=user.cid '
+			+ 'WHERE user.name = ? LIMIT 5',
+		/* STMT_user_BY_SEARCH_1 */
+		'SELECT ' + ort_schema_user('user') + ',' + ort_schema_company('_a') + ' FROM user '
+			+ 'INNER JOIN company AS _a ON _a.id=user.cid '
+			+ 'WHERE user.email = ?',
+		/* STMT_user_BY_SEARCH_2 */
+		'SELECT ' + ort_schema_user('user') + ',' + ort_schema_company('_a') + ' FROM user '
+			+ 'INNER JOIN company AS _a ON _a.id=user.cid '
+			+ 'WHERE user.uid = ? ORDER BY _a.name ASC',
+		/* STMT_user_INSERT */
+		'INSERT INTO user (cid,sex,hash,email,image,name) VALUES '
+			+ '(?,?,?,?,?,?)',
+		/* STMT_user_UPDATE_0 */
+		'UPDATE user SET hash = ? WHERE uid = ?',
+		/* STMT_user_UPDATE_1 */
+		'UPDATE user SET email = ? WHERE uid = ?',
+		/* STMT_user_DELETE_0 */
+		'DELETE FROM user',
+		/* STMT_session_BY_UNIQUE_id */
+		'SELECT ' + ort_schema_session('session') + ',' + ort_schema_user('_b') + ',' 
+			+ ort_schema_company('_c') + ' FROM session '
+			+ 'INNER JOIN user AS _b ON _b.uid=session.userid '
+			+ 'INNER JOIN company AS _c ON _c.id=_b.cid '
+			+ 'WHERE session.id = ?',
+		/* STMT_session_BY_SEARCH_0 */
+		'SELECT ' + ort_schema_session('session') + ',' + ort_schema_user('_b') + ',' 
+			+ ort_schema_company('_c') + ' FROM session '
+			+ 'INNER JOIN user AS _b ON _b.uid=session.userid '
+			+ 'INNER JOIN company AS _c ON _c.id=_b.cid '
+			+ 'WHERE _c.name = ? AND session.mtime = ?',
+		/* STMT_session_INSERT */
+		'INSERT INTO session (userid,token,mtime) VALUES (?,?,?)',
+		/* STMT_session_DELETE_0 */
+		'DELETE FROM session WHERE id = ?',
+	];
+
+	function ort_schema_company(v: string): string
+	{
+		return v + '.name' + ',' +
+		       v + '.id' + ',' +
+		       v + '.somenum';
+	}
+
+	function ort_schema_user(v: string): string
+	{
+		return v + '.cid' + ',' +
+		       v + '.sex' + ',' +
+		       v + '.hash' + ',' +
+		       v + '.email' + ',' +
+		       v + '.image' + ',' +
+		       v + '.name' + ',' +
+		       v + '.uid';
+	}
+
+	function ort_schema_session(v: string): string
+	{
+		return v + '.userid' + ',' +
+		       v + '.token' + ',' +
+		       v + '.mtime' + ',' +
+		       v + '.id';
+	}
+}
+
+/**
+ * Manages each sequence of database interaction.
+ */
+export class ortctx
+{
+	#role: string = 'default';
+	readonly #o: ortdb;
+
+	constructor(o: ortdb)
+	{
+		this.#o = o;
+	}
+
+	/**
+	 * Open a transaction with a unique identifier.  This is the 
+	 * preferred way of creating database transactions.  The transaction 
+	 * immediately enters unshared lock mode (single writer, readers 
+	 * allowed).
+	 * @param id The unique identifier.
+	 * @throws Throws on database error.
+	 */
+	db_trans_open_immediate(id: number): void
+	{
+		this.#o.db.exec('BEGIN TRANSACTION IMMEDIATE');
+	}
+
+	/**
+	 * Open a transaction with a unique identifier.  The transaction 
+	 * locks the database on first access with shared locks (no writes 
+	 * allowed, reads allowed) on queries and unshared locks (single 
+	 * writer, reads allowed) on modification.
+	 * @param id The unique identifier.
+	 * @throws Throws on database error.
+	 */
+	db_trans_open_deferred(id: number): void
+	{
+		this.#o.db.exec('BEGIN TRANSACTION DEFERRED');
+	}
+
+	/**
+	 * Open a transaction with a unique identifier.  The transaction 
+	 * locks exclusively, preventing all other access.
+	 * @param id The unique identifier.
+	 * @throws Throws on database error.
+	 */
+	db_trans_open_exclusive(id: number): void
+	{
+		this.#o.db.exec('BEGIN TRANSACTION EXCLUSIVE');
+	}
+
+	/**
+	 * Roll-back a transaction opened by {@link db_trans_open_immediate} 
+	 * or similar.
+	 * @param id The transaction identifier.
+	 * @throws Throws on database error.
+	 */
+	db_trans_rollback(id: number): void
+	{
+		this.#o.db.exec('ROLLBACK TRANSACTION');
+	}
+
+	/**
+	 * Commit a transaction opened by {@link db_trans_open_immediate} or 
+	 * similar.
+	 * @param id The transaction identifier.
+	 * @throws Throws on database error.
+	 */
+	db_trans_commit(id: number): void
+	{
+		this.#o.db.exec('COMMIT TRANSACTION');
+	}
+
+	private db_company_fill(data: {row: any[], pos: number}):
+		ortns.companyData
+	{
+		const obj: ortns.companyData = {
+			'name': <string>data.row[data.pos + 0],
+			'id': <bigint>data.row[data.pos + 1],
+			'somenum': <bigint|null>data.row[data.pos + 2],
+		};
+		data.pos += 3;
+		return obj;
+	}
+
+	/**
+	 * Insert a row.  Accepts all native fields as parameters excluding 
+	 * rowid, which is automatically set by the database.  If any fields 
+	 * are specified as null, they may be passed as null values.
+	 * @param v1 name
+	 * @param v2 somenum
+	 * @return Row identifier on success or -1 on constraint violation.
+	 * @throws Throws on database error.
+	 */
+	db_company_insert(v1: string, v2: bigint|null): bigint
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_company_INSERT));
+
+		parms.push(v1);
+		parms.push(v2);
+
+		try {
+			info = stmt.run(parms);
+		} catch (er) {
+			if (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||
+			    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')
+				return BigInt(-1);
+			throw er;
+		}
+
+		return BigInt(info.lastInsertRowid.toString());
+	}
+
+	/**
+	 * Search for a set of {@link ortns.company}.
+	 * The following fields are constrained by unary operations: 
+	 * somenum (checked is null)
+	 * @return Result of null if no results found.
+	 * @throws Throws on database error.
+	 */
+	db_company_list_by_somenum_isnull(): ortns.company[]
+	{
+		const parms: any[] = [];
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_company_BY_SEARCH_0));
+		stmt.raw(true);
+
+		const rows: any[] = stmt.all(parms);
+		const objs: ortns.company[] = [];
+		let i: number;
+
+		for (i = 0; i < rows.length; i++) {
+			const obj: ortns.companyData =
+				this.db_company_fill({row: <any[]>rows[i], pos: 0});
+			objs.push(new ortns.company(this.#role, obj));
+		}
+		return objs;
+	}
+
+	/**
+	 * @throws Throws on database error.
+	 */
+	db_company_delete(): void
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_company_DELETE_0));
+
+
+		stmt.run(parms);
+	}
+
+	private db_user_fill(data: {row: any[], pos: number}):
+		ortns.userData
+	{
+		const obj: ortns.userData = {
+			/* A dummy value for now. */
+			'company': <ortns.companyData>{},
+			'cid': <bigint>data.row[data.pos + 0],
+			'sex': <ortns.sex>data.row[data.pos + 1].toString(),
+			'hash': <string>data.row[data.pos + 2],
+			'email': <string>data.row[data.pos + 3],
+			'image': <Buffer|null>data.row[data.pos + 4],
+			'name': <string>data.row[data.pos + 5],
+			'uid': <bigint>data.row[data.pos + 6],
+		};
+		data.pos += 7;
+		obj.company = this.db_company_fill(data);
+		return obj;
+	}
+
+	/**
+	 * Insert a row.  Accepts all native fields as parameters excluding 
+	 * rowid, which is automatically set by the database.  If any fields 
+	 * are specified as null, they may be passed as null values.
+	 * @param v1 cid
+	 * @param v2 sex
+	 * @param v3 hash
+	 * @param v4 email
+	 * @param v5 image
+	 * @param v6 name
+	 * @return Row identifier on success or -1 on constraint violation.
+	 * @throws Throws on database error.
+	 */
+	db_user_insert(v1: bigint, v2: ortns.sex, v3: string, v4: string,
+		v5: Buffer|null, v6: string): bigint
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_INSERT));
+
+		parms.push(v1);
+		parms.push(v2);
+		parms.push(bcrypt.hashSync(v3, this.#o.args.bcrypt_cost));
+		parms.push(v4);
+		parms.push(v5);
+		parms.push(v6);
+
+		try {
+			info = stmt.run(parms);
+		} catch (er) {
+			if (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||
+			    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')
+				return BigInt(-1);
+			throw er;
+		}
+
+		return BigInt(info.lastInsertRowid.toString());
+	}
+
+	/**
+	 * Create a function that searches for users by a given
+	 *     name; and, when found, invokes a callback function
+	 *     provided the user structure.
+	 * The callback is called during an implicit transaction: thus, it 
+	 * should not invoke any database modifications or risk deadlock.
+	 * @param v1 name
+	 * @param cb Callback with retrieved data.
+	 * @throws Throws on database error.
+	 */
+	db_user_iterate_by_name_eq(v1: string,
+		cb: (res: ortns.user) => void): void
+	{
+		const parms: any[] = [];
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_BY_SEARCH_0));
+		stmt.raw(true);
+
+		parms.push(v1);
+
+		for (const cols of stmt.iterate(parms)) {
+			const obj: ortns.userData =
+				this.db_user_fill({row: <any>cols, pos: 0});
+			cb(new ortns.user(this.#role, obj));
+		}
+	}
+
+	/**
+	 * Search for a unique user with their e-mail and
+	 *     password.
+	 *     This is a quick way to verify that a user has entered
+	 *     the correct password for logging in.
+	 * @param v1 email
+	 * @param v2 hash (hashed password)
+	 * @return Result or null if no results found.
+	 * @throws Throws on database error.
+	 */
+	db_user_get_creds(v1: string, v2: string): ortns.user|null
+	{
+		const parms: any[] = [];
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_BY_SEARCH_1));
+		stmt.raw(true);
+
+		parms.push(v1);
+
+		const cols: any = stmt.get(parms);
+
+		if (typeof cols === 'undefined')
+			return null;
+		const obj: ortns.userData = 
+			this.db_user_fill({row: <any[]>cols, pos: 0});
+		if (!bcrypt.compareSync(v2, obj.hash))
+			return null;
+		return new ortns.user(this.#role, obj);
+	}
+
+	/**
+	 * Lookup by unique identifier.
+	 * @param v1 uid
+	 * @return Result or null if no results found.
+	 * @throws Throws on database error.
+	 */
+	db_user_get_by_uid_eq(v1: bigint): ortns.user|null
+	{
+		const parms: any[] = [];
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_BY_SEARCH_2));
+		stmt.raw(true);
+
+		parms.push(v1);
+
+		const cols: any = stmt.get(parms);
+
+		if (typeof cols === 'undefined')
+			return null;
+		const obj: ortns.userData = 
+			this.db_user_fill({row: <any[]>cols, pos: 0});
+		return new ortns.user(this.#role, obj);
+	}
+
+	/**
+	 * @throws Throws on database error.
+	 */
+	db_user_delete(): void
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_DELETE_0));
+
+
+		stmt.run(parms);
+	}
+
+	/**
+	 * @param v1 update hash (hashed)
+	 * @param v2 constraint uid (eq)
+	 * @return False on constraint violation, true on success.
+	 * @throws Throws on database error.
+	 */
+	db_user_update_hash_set_by_uid_eq(v1: string, v2: bigint): boolean
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_UPDATE_0));
+
+		parms.push(bcrypt.hashSync(v1, this.#o.args.bcrypt_cost));
+		parms.push(v2);
+
+		try {
+			info = stmt.run(parms);
+		} catch (er) {
+			if (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||
+			    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')
+				return false;
+			throw er;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @param v1 update email
+	 * @param v2 constraint uid (eq)
+	 * @return False on constraint violation, true on success.
+	 * @throws Throws on database error.
+	 */
+	db_user_update_email_set_by_uid_eq(v1: string, v2: bigint):
+		boolean
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_user_UPDATE_1));
+
+		parms.push(v1);
+		parms.push(v2);
+
+		try {
+			info = stmt.run(parms);
+		} catch (er) {
+			if (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||
+			    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')
+				return false;
+			throw er;
+		}
+
+		return true;
+	}
+
+	private db_session_fill(data: {row: any[], pos: number}):
+		ortns.sessionData
+	{
+		const obj: ortns.sessionData = {
+			/* A dummy value for now. */
+			'user': <ortns.userData>{},
+			'userid': <bigint>data.row[data.pos + 0],
+			'token': <bigint>data.row[data.pos + 1],
+			'mtime': <bigint>data.row[data.pos + 2],
+			'id': <bigint>data.row[data.pos + 3],
+		};
+		data.pos += 4;
+		obj.user = this.db_user_fill(data);
+		return obj;
+	}
+
+	/**
+	 * Insert a row.  Accepts all native fields as parameters excluding 
+	 * rowid, which is automatically set by the database.  If any fields 
+	 * are specified as null, they may be passed as null values.
+	 * @param v1 userid
+	 * @param v2 token
+	 * @param v3 mtime
+	 * @return Row identifier on success or -1 on constraint violation.
+	 * @throws Throws on database error.
+	 */
+	db_session_insert(v1: bigint, v2: bigint, v3: bigint): bigint
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_session_INSERT));
+
+		parms.push(v1);
+		parms.push(v2);
+		parms.push(v3);
+
+		try {
+			info = stmt.run(parms);
+		} catch (er) {
+			if (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||
+			    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')
+				return BigInt(-1);
+			throw er;
+		}
+
+		return BigInt(info.lastInsertRowid.toString());
+	}
+
+	/**
+	 * Search for company's logged-in users.
+	 * The callback is called during an implicit transaction: thus, it 
+	 * should not invoke any database modifications or risk deadlock.
+	 * @param v1 user.company.name
+	 * @param v2 mtime
+	 * @param cb Callback with retrieved data.
+	 * @throws Throws on database error.
+	 */
+	db_session_iterate_foo(v1: string, v2: bigint,
+		cb: (res: ortns.session) => void): void
+	{
+		const parms: any[] = [];
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_session_BY_SEARCH_0));
+		stmt.raw(true);
+
+		parms.push(v1);
+		parms.push(v2);
+
+		for (const cols of stmt.iterate(parms)) {
+			const obj: ortns.sessionData =
+				this.db_session_fill({row: <any>cols, pos: 0});
+			cb(new ortns.session(this.#role, obj));
+		}
+	}
+
+	/**
+	 * @param v1 constraint id (eq)
+	 * @throws Throws on database error.
+	 */
+	db_session_delete_by_id_eq(v1: bigint): void
+	{
+		const parms: any[] = [];
+		let info: Database.RunResult;
+		const stmt: Database.Statement =
+			this.#o.db.prepare(ortstmt.stmtBuilder
+			(ortstmt.ortstmt.STMT_session_DELETE_0));
+
+		parms.push(v1);
+
+		stmt.run(parms);
+	}
+}
+
+/**
+ * Interface configuration.
+ */
+export interface ortargs
+{
+	/**
+	 * The number of rounds when bcrypting passwords.
+	 */
+	bcrypt_cost: number;
+}
+
+/**
+ * Application-wide database instance. There should only be one of these 
+ * per server.
+ */
+export class ortdb
+{
+	readonly args: ortargs;
+	readonly db: Database.Database;
+
+	/**
+	 * The version of ort-nodejs used to create the module.
+	 */
+	readonly version: string = '0.14.1';
+
+	/**
+	 * The numeric version of ort-nodejs used to create the module.
+	 */
+	readonly vstamp: number = 11502;
+
+	/**
+	 * Do not call this: use {@link ort} instead.
+	 */
+	constructor(dbname: string, args?: ortargs)
+	{
+		this.db = new Database(dbname);
+		this.db.defaultSafeIntegers(true);
+		if (typeof args !== 'undefined') {
+			this.args = Object.assign({}, args);
+		} else {
+			this.args = { bcrypt_cost: 10 };
+		}
+	}
+
+	/**
+	 * Connect to the database.  This should be invoked for each request.  
+	 * In applications not having a request, this corresponds to a single 
+	 * operator sequence.  If roles are enabled, the connection will 
+	 * begin in the "default" role.
+	 */
+	connect(): ortctx
+	{
+		return new ortctx(this);
+	}
+}
+
+/**
+ * Create an application-wide database instance. This should only be 
+ * called once per server.
+ * @param dbname An existing sqlite3 database.
+ * @param args Optional configuration parameters. If not given, the 
+ * number of bcrypt rounds defaults to 10.
+ * @throws Throws on database error.
+ */
+export function ort(dbname: string, args?: optargs): ortdb
+{
+	return new ortdb(dbname, args);
+}
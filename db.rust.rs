@@ -0,0 +1,575 @@
+/*
+ * WARNING: automatically generated by ort 0.14.1.
+ * DO NOT EDIT!
+ */
+#[macro_use]
+extern crate num_derive;
+
+pub mod ort {
+    use libsqlite3_sys;
+    use rusqlite::{Connection,Result,params,Row};
+    use bcrypt::{hash,verify};
+    use num_traits::{FromPrimitive,ToPrimitive};
+
+    pub const VERSION: &str = "0.14.1";
+    pub const VSTAMP: i64 = 11502;
+
+    pub mod data {
+        use base64;
+        fn json_escape(src: &str) -> String {
+            let mut escaped = String::with_capacity(src.len() + 2);
+            escaped.push('"');
+            for c in src.chars() {
+                match c {
+                    '\x08' => escaped += "\\b",
+                    '\x0c' => escaped += "\\f",
+                    '\n'   => escaped += "\\n",
+                    '\r'   => escaped += "\\r",
+                    '\t'   => escaped += "\\t",
+                    '"'    => escaped += "\\\"",
+                    '\\'   => escaped += "\\",
+                    c      => escaped.push(c),
+                }
+            }
+            escaped.push('"');
+            escaped
+        }
+        #[derive(FromPrimitive,ToPrimitive,PartialEq,Debug)]
+        pub enum Sex {
+            Male = 0,
+            Female = 1,
+            Other = 2,
+        }
+        pub struct Company {
+            pub name: String,
+            pub id: i64,
+            pub somenum: Option<i64>,
+        }
+        impl Company {
+            pub(super) fn to_json(&self) -> String {
+                let mut ret = String::new();
+                ret += "\"name\":";
+                ret += &json_escape(&self.name);
+                ret += ",\"id\":";
+                ret += &format!("\"{}\"", self.id);
+                ret += ",\"somenum\":";
+                if let Some(x) = self.somenum {
+                    ret += &format!("\"{}\"", x);
+                } else {
+                    ret += "null";
+                }
+                ret
+            }
+        }
+        pub struct User {
+            pub company: Company,
+            pub cid: i64,
+            pub sex: Sex,
+            pub hash: String,
+            pub email: String,
+            pub image: Option<Vec<u8>>,
+            pub name: String,
+            pub uid: i64,
+        }
+        impl User {
+            pub(super) fn to_json(&self) -> String {
+                let mut ret = String::new();
+                ret += "\"company\":";
+                ret += "{";
+                ret += &self.company.to_json();
+                ret += "}";
+                ret += ",\"cid\":";
+                ret += &format!("\"{}\"", self.cid);
+                ret += ",\"sex\":";
+                ret += &format!("\"{}\"", num_traits::ToPrimitive::to_i64(&self.sex).unwrap());
+                ret += ",\"email\":";
+                ret += &json_escape(&self.email);
+                ret += ",\"image\":";
+                if let Some(ref x) = &self.image {
+                    ret += "\"";
+                    ret += &base64::encode(x);
+                    ret += "\"";
+                } else {
+                    ret += "null";
+                }
+                ret += ",\"name\":";
+                ret += &json_escape(&self.name);
+                ret += ",\"uid\":";
+                ret += &format!("\"{}\"", self.uid);
+                ret
+            }
+        }
+        pub struct Session {
+            pub user: User,
+            pub userid: i64,
+            pub token: i64,
+            pub mtime: i64,
+            pub id: i64,
+        }
+        impl Session {
+            pub(super) fn to_json(&self) -> String {
+                let mut ret = String::new();
+                ret += "\"user\":";
+                ret += "{";
+                ret += &self.user.to_json();
+                ret += "}";
+                ret += ",\"userid\":";
+                ret += &format!("\"{}\"", self.userid);
+                ret += ",\"token\":";
+                ret += &format!("\"{}\"", self.token);
+                ret += ",\"mtime\":";
+                ret += &format!("\"{}\"", self.mtime);
+                ret += ",\"id\":";
+                ret += &format!("\"{}\"", self.id);
+                ret
+            }
+        }
+    }
+
+    pub mod objs {
+        pub struct Company {
+            pub data: super::data::Company,
+        }
+        impl Company {
+            pub fn export(&self) -> String {
+                let mut ret = String::new();
+                ret += "{";
+                ret += &self.data.to_json();
+                ret += "}";
+                ret
+            }
+        }
+        pub struct User {
+            pub data: super::data::User,
+        }
+        impl User {
+            pub fn export(&self) -> String {
+                let mut ret = String::new();
+                ret += "{";
+                ret += &self.data.to_json();
+                ret += "}";
+                ret
+            }
+        }
+        pub struct Session {
+            pub data: super::data::Session,
+        }
+        impl Session {
+            pub fn export(&self) -> String {
+                let mut ret = String::new();
+                ret += "{";
+                ret += &self.data.to_json();
+                ret += "}";
+                ret
+            }
+        }
+    }
+
+    pub(self) mod stmt {
+        #[allow(dead_code)]
+        pub enum Ortstmt {
+            CompanyByUniqueId,
+            CompanyBySearch0,
+            CompanyInsert,
+            CompanyDelete0,
+            UserByUniqueEmail,
+            UserByUniqueUid,
+            UserBySearch0,
+            UserBySearch1,
+            UserBySearch2,
+            UserInsert,
+            UserUpdate0,
+            UserUpdate1,
+            UserDelete0,
+            SessionByUniqueId,
+            SessionBySearch0,
+            SessionInsert,
+            SessionDelete0,
+        }
+
+        fn stmt_company(v: &str) -> String {
+            let mut s = String::new();
+            s += &format!("{}.name, ", v);
+            s += &format!("{}.id, ", v);
+            s += &format!("{}.somenum", v);
+            s
+        }
+
+        fn stmt_user(v: &str) -> String {
+            let mut s = String::new();
+            s += &format!("{}.cid, ", v);
+            s += &format!("{}.sex, ", v);
+            s += &format!("{}.hash, ", v);
+            s += &format!("{}.email, ", v);
+            s += &format!("{}.image, ", v);
+            s += &format!("{}.name, ", v);
+            s += &format!("{}.uid", v);
+            s
+        }
+
+        fn stmt_session(v: &str) -> String {
+            let mut s = String::new();
+            s += &format!("{}.userid, ", v);
+            s += &format!("{}.token, ", v);
+            s += &format!("{}.mtime, ", v);
+            s += &format!("{}.id", v);
+            s
+        }
+
+        pub fn stmt_fmt(v: Ortstmt) -> String {
+            let s;
+            match v {
+                Ortstmt::CompanyByUniqueId => {
+                    s = String::new() + "SELECT " + &stmt_company("company") + " FROM company WHERE company.id = ?"; },
+                Ortstmt::CompanyBySearch0 => {
+                    s = String::new() + "SELECT " + &stmt_company("company") + " FROM company "
+                        + "WHERE company.somenum ISNULL"; },
+                Ortstmt::CompanyInsert => {
+                    s = String::new() + "INSERT INTO company "
+                        + "(name,somenum) VALUES (?,"
+                        + " ?)"; },
+                Ortstmt::CompanyDelete0 => {
+                    s = String::new() + "DELETE FROM company"; },
+                Ortstmt::UserByUniqueEmail => {
+                    s = String::new() + "SELECT " + &stmt_user("user") + "," 
+                        + &stmt_company("_a") + " FROM user "
+                        + "INNER JOIN company AS _a ON _a.id=user.cid "
+                        + "WHERE user.email = ?"; },
+                Ortstmt::UserByUniqueUid => {
+                    s = String::new() + "SELECT " + &stmt_user("user") + "," 
+                        + &stmt_company("_a") + " FROM user "
+                        + "INNER JOIN company AS _a ON _a.id=user.cid "
+                        + "WHERE user.uid = ?"; },
+                Ortstmt::UserBySearch0 => {
+                    s = String::new() + "SELECT " + &stmt_user("user") + "," 
+                        + &stmt_company("_a") + " FROM user "
+                        + "INNER JOIN company AS _a ON _a.id=user.cid "
+                        + "WHERE user.name = ? LIMIT 5"; },
+                Ortstmt::UserBySearch1 => {
+                    s = String::new() + "SELECT " + &stmt_user("user") + "," 
+                        + &stmt_company("_a") + " FROM user "
+                        + "INNER JOIN company AS _a ON _a.id=user.cid "
+                        + "WHERE user.email = ?"; },
+                Ortstmt::UserBySearch2 => {
+                    s = String::new() + "SELECT " + &stmt_user("user") + "," 
+                        + &stmt_company("_a") + " FROM user "
+                        + "INNER JOIN company AS _a ON _a.id=user.cid "
+                        + "WHERE user.uid = ? ORDER BY _a.name ASC"; },
+                Ortstmt::UserInsert => {
+                    s = String::new() + "INSERT INTO user "
+                        + "(cid,sex,hash,email,image,"
+                        + " name) VALUES (?,?,?,?,?,"
+                        + " ?)"; },
+                Ortstmt::UserUpdate0 => {
+                    s = String::new() + "UPDATE user SET hash = ? WHERE uid = ?"; },
+                Ortstmt::UserUpdate1 => {
+                    s = String::new() + "UPDATE user SET email = ? WHERE uid = ?"; },
+                Ortstmt::UserDelete0 => {
+                    s = String::new() + "DELETE FROM user"; },
+                Ortstmt::SessionByUniqueId => {
+                    s = String::new() + "SELECT " + &stmt_session("session") + "," 
+                        + &stmt_user("_b") + "," 
+                        + &stmt_company("_c") + " FROM session "
+                        + "INNER JOIN user AS _b ON _b.uid=session.userid "
+                        + "INNER JOIN company AS _c ON _c.id=_b.cid "
+                        + "WHERE session.id = ?"; },
+                Ortstmt::SessionBySearch0 => {
+                    s = String::new() + "SELECT " + &stmt_session("session") + "," 
+                        + &stmt_user("_b") + "," 
+                        + &stmt_company("_c") + " FROM session "
+                        + "INNER JOIN user AS _b ON _b.uid=session.userid "
+                        + "INNER JOIN company AS _c ON _c.id=_b.cid "
+                        + "WHERE _c.name = ? AND session.mtime = ?"; },
+                Ortstmt::SessionInsert => {
+                    s = String::new() + "INSERT INTO session "
+                        + "(userid,token,mtime) VALUES "
+                        + "(?,?,?)"; },
+                Ortstmt::SessionDelete0 => {
+                    s = String::new() + "DELETE FROM session WHERE id = ?"; },
+            }
+            s
+        }
+    }
+
+    pub struct Ortctx {
+        args: Ortargs,
+        conn: Connection,
+    }
+
+    impl Ortctx {
+        fn db_company_fill(&self, row: &Row, i: &mut usize) -> Result<data::Company> {
+            let ncol: usize = *i;
+            *i += 3;
+            Ok(data::Company {
+                name: row.get(ncol + 0)?,
+                id: row.get(ncol + 1)?,
+                somenum: row.get(ncol + 2)?,
+            })
+        }
+        pub fn db_company_insert(&self, v1: &String, v2: Option<i64>) -> Result<i64> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::CompanyInsert);
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.insert(params![
+                v1,
+                v2,
+            ]) {
+                Ok(i) => Ok(i),
+                Err(e) => match e {
+                    rusqlite::Error::SqliteFailure(err, ref _desc) => match err.code {
+                        libsqlite3_sys::ErrorCode::ConstraintViolation => Ok(-1),
+                        _ => Err(e),
+                    },
+                    _ => Err(e),
+                },
+            }
+        }
+        pub fn db_company_list_by_somenum_isnull(&self) -> Result<Vec<objs::Company>> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::CompanyBySearch0);
+            let mut stmt = self.conn.prepare(&sql)?;
+            let mut rows = stmt.query(params![
+            ])?;
+            let mut vec = Vec::new();
+            while let Some(row) = rows.next()? {
+                let mut i = 0;
+                let obj = self.db_company_fill(&row, &mut i)?;
+                vec.push(objs::Company {
+                    data: obj,
+                });
+            }
+            Ok(vec)
+        }
+        pub fn db_company_delete(&self, ) -> Result<()> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::CompanyDelete0);
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.execute(params![
+            ]) {
+                Ok(_) => Ok(()),
+                Err(e) => Err(e),
+            }
+        }
+        fn db_user_fill(&self, row: &Row, i: &mut usize) -> Result<data::User> {
+            let ncol: usize = *i;
+            *i += 7;
+            let obj0 = self.db_company_fill(row, i)?;
+            let obj1 = row.get(ncol + 1)?;
+            Ok(data::User {
+                company: obj0,
+                cid: row.get(ncol + 0)?,
+                sex: FromPrimitive::from_i64(obj1).ok_or(rusqlite::Error::IntegralValueOutOfRange(ncol + 1, obj1))?,
+                hash: row.get(ncol + 2)?,
+                email: row.get(ncol + 3)?,
+                image: row.get(ncol + 4)?,
+                name: row.get(ncol + 5)?,
+                uid: row.get(ncol + 6)?,
+            })
+        }
+        pub fn db_user_insert(&self, v1: i64, v2: data::Sex, v3: &String, v4: &String, v5: Option<&Vec<u8>>, v6: &String) -> Result<i64> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserInsert);
+            let hash1 = hash(v3, self.args.bcrypt_cost).unwrap();
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.insert(params![
+                v1,
+                ToPrimitive::to_i64(&v2).unwrap(),
+                hash1,
+                v4,
+                v5,
+                v6,
+            ]) {
+                Ok(i) => Ok(i),
+                Err(e) => match e {
+                    rusqlite::Error::SqliteFailure(err, ref _desc) => match err.code {
+                        libsqlite3_sys::ErrorCode::ConstraintViolation => Ok(-1),
+                        _ => Err(e),
+                    },
+                    _ => Err(e),
+                },
+            }
+        }
+        pub fn db_user_iterate_by_name_eq(&self, cb: fn(res: objs::User), v1: &String) -> Result<()> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserBySearch0);
+            let mut stmt = self.conn.prepare(&sql)?;
+            let mut rows = stmt.query(params![
+                v1,
+            ])?;
+            while let Some(row) = rows.next()? {
+                let mut i = 0;
+                let obj = self.db_user_fill(&row, &mut i)?;
+                cb(objs::User {
+                    data: obj,
+                });
+            }
+            Ok(())
+        }
+        pub fn db_user_get_creds(&self, v1: &String, v2: &String) -> Result<Option<objs::User>> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserBySearch1);
+            let mut stmt = self.conn.prepare(&sql)?;
+            let mut rows = stmt.query(params![
+                v1,
+            ])?;
+            if let Some(row) = rows.next()? {
+                let mut i = 0;
+                let obj = self.db_user_fill(&row, &mut i)?;
+                if !verify(v2, &obj.hash).unwrap() {
+                    return Ok(None);
+                }
+                return Ok(Some(objs::User {
+                    data: obj,
+                }));
+            }
+            Ok(None)
+        }
+        pub fn db_user_get_by_uid_eq(&self, v1: i64) -> Result<Option<objs::User>> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserBySearch2);
+            let mut stmt = self.conn.prepare(&sql)?;
+            let mut rows = stmt.query(params![
+                v1,
+            ])?;
+            if let Some(row) = rows.next()? {
+                let mut i = 0;
+                let obj = self.db_user_fill(&row, &mut i)?;
+                return Ok(Some(objs::User {
+                    data: obj,
+                }));
+            }
+            Ok(None)
+        }
+        pub fn db_user_delete(&self, ) -> Result<()> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserDelete0);
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.execute(params![
+            ]) {
+                Ok(_) => Ok(()),
+                Err(e) => Err(e),
+            }
+        }
+        pub fn db_user_update_hash_set_by_uid_eq(&self, v1: &String, v2: i64) -> Result<bool> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserUpdate0);
+            let hash1 = hash(v1, self.args.bcrypt_cost).unwrap();
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.execute(params![
+                hash1,
+                v2,
+            ]) {
+                Ok(_) => Ok(true),
+                Err(e) => match e {
+                    rusqlite::Error::SqliteFailure(err, ref _desc) => match err.code {
+                        libsqlite3_sys::ErrorCode::ConstraintViolation => Ok(false),
+                        _ => Err(e),
+                    },
+                    _ => Err(e),
+                },
+            }
+        }
+        pub fn db_user_update_email_set_by_uid_eq(&self, v1: &String, v2: i64) -> Result<bool> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::UserUpdate1);
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.execute(params![
+                v1,
+                v2,
+            ]) {
+                Ok(_) => Ok(true),
+                Err(e) => match e {
+                    rusqlite::Error::SqliteFailure(err, ref _desc) => match err.code {
+                        libsqlite3_sys::ErrorCode::ConstraintViolation => Ok(false),
+                        _ => Err(e),
+                    },
+                    _ => Err(e),
+                },
+            }
+        }
+        fn db_session_fill(&self, row: &Row, i: &mut usize) -> Result<data::Session> {
+            let ncol: usize = *i;
+            *i += 4;
+            let obj0 = self.db_user_fill(row, i)?;
+            Ok(data::Session {
+                user: obj0,
+                userid: row.get(ncol + 0)?,
+                token: row.get(ncol + 1)?,
+                mtime: row.get(ncol + 2)?,
+                id: row.get(ncol + 3)?,
+            })
+        }
+        pub fn db_session_insert(&self, v1: i64, v2: i64, v3: i64) -> Result<i64> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::SessionInsert);
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.insert(params![
+                v1,
+                v2,
+                v3,
+            ]) {
+                Ok(i) => Ok(i),
+                Err(e) => match e {
+                    rusqlite::Error::SqliteFailure(err, ref _desc) => match err.code {
+                        libsqlite3_sys::ErrorCode::ConstraintViolation => Ok(-1),
+                        _ => Err(e),
+                    },
+                    _ => Err(e),
+                },
+            }
+        }
+        pub fn db_session_iterate_foo(&self, cb: fn(res: objs::Session), v1: &String, v2: i64) -> Result<()> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::SessionBySearch0);
+            let mut stmt = self.conn.prepare(&sql)?;
+            let mut rows = stmt.query(params![
+                v1,
+                v2,
+            ])?;
+            while let Some(row) = rows.next()? {
+                let mut i = 0;
+                let obj = self.db_session_fill(&row, &mut i)?;
+                cb(objs::Session {
+                    data: obj,
+                });
+            }
+            Ok(())
+        }
+        pub fn db_session_delete_by_id_eq(&self, v1: i64) -> Result<()> {
+            let sql = stmt::stmt_fmt(stmt::Ortstmt::SessionDelete0);
+            let mut stmt = self.conn.prepare(&sql)?;
+            match stmt.execute(params![
+                v1,
+            ]) {
+                Ok(_) => Ok(()),
+                Err(e) => Err(e),
+            }
+        }
+        pub(self) fn new(dbname: &str, args: &Ortargs) -> Result<Ortctx> {
+            let conn = Connection::open(dbname)?;
+            conn.execute("PRAGMA foreign_keys=ON", [])?;
+            Ok(Ortctx {
+                args: *args,
+                conn,
+            })
+        }
+    }
+
+    #[derive(Copy, Clone)]
+    pub struct Ortargs {
+        pub bcrypt_cost: u32,
+    }
+
+    pub struct Ortdb {
+        dbname: String,
+        args: Ortargs,
+    }
+
+    impl Ortdb {
+        pub fn new(dbname: &str) -> Ortdb {
+            Ortdb {
+                dbname: dbname.to_string(),
+                args: Ortargs {
+                    bcrypt_cost: bcrypt::DEFAULT_COST,
+                }
+            }
+        }
+        pub fn new_with_args(dbname: &str, args: Ortargs) -> Ortdb {
+            Ortdb {
+                dbname: dbname.to_string(),
+                args,
+            }
+        }
+        pub fn connect(&self) -> Result<Ortctx> {
+            Ortctx::new(&self.dbname, &self.args)
+        }
+    }
+}
@@ -0,0 +1,46 @@
+PRAGMA foreign_keys=ON;
+
+-- Controlling organisation.
+CREATE TABLE company (
+	-- Name of the organisation.
+	name TEXT NOT NULL,
+	id INTEGER PRIMARY KEY,
+	-- Simply a check for null values.
+	somenum INTEGER
+);
+
+-- A regular user.
+CREATE TABLE user (
+	-- A foreign key reference.
+	cid INTEGER NOT NULL,
+	-- User's birth sex.
+	sex INTEGER NOT NULL,
+	-- Password hash.
+	--     This is passed to inserts and updates as a password,
+	--     then hashed within the implementation and extracted
+	--     (in listings and searches) as the hash value.
+	hash TEXT NOT NULL,
+	-- Unique e-mail address.
+	email TEXT NOT NULL,
+	-- A PNG image or something.
+	image BLOB,
+	-- User's full name.
+	name TEXT NOT NULL,
+	uid INTEGER PRIMARY KEY,
+	FOREIGN KEY(cid) REFERENCES company(id) ON DELETE CASCADE
+);
+
+CREATE UNIQUE INDEX unique_user__email ON user(email);
+
+-- Authenticated session.
+CREATE TABLE session (
+	-- Associated user.
+	userid INTEGER NOT NULL,
+	-- Random cookie.
+	token INTEGER NOT NULL,
+	-- (Stored as a UNIX epoch value.)
+	mtime INTEGER NOT NULL,
+	id INTEGER PRIMARY KEY,
+	FOREIGN KEY(userid) REFERENCES user(uid)
+);
+
@@ -29,6 +29,16 @@
 #include <unistd.h>
 
 #include "ort.h"
+#include "extern.h"
+
+/*
+ * Name indexes of both configurations, built by ort_diff() itself so
+ * that it works on any configuration, linked or not.
+ */
+struct	diffsyms {
+	struct symtab	 from;
+	struct symtab	 into;
+};
 
 static struct diff *
 diff_alloc(struct diffq *q, enum difftype type)
@@ -487,7 +497,7 @@ ort_diff_eitem(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_bitf(struct diffq *q,
+ort_diff_bitf(struct diffq *q, const struct diffsyms *ds,
 	const struct bitf *efrom, const struct bitf *einto)
 {
 	const struct bitidx	*ifrom, *iinto;
@@ -501,9 +511,7 @@ ort_diff_bitf(struct diffq *q,
 	 */
 
 	TAILQ_FOREACH(iinto, &einto->bq, entries) {
-		TAILQ_FOREACH(ifrom, &efrom->bq, entries)
-			if (strcasecmp(iinto->name, ifrom->name) == 0)
-				break;
+		ifrom = symtab_find(&ds->from, SYM_BITIDX, efrom, iinto->name);
 		if ((rc = ort_diff_bitidx(q, ifrom, iinto)) < 0)
 			return 0;
 		else if (rc > 0)
@@ -513,9 +521,7 @@ ort_diff_bitf(struct diffq *q,
 	/* Look at old indices no longer in the new. */
 
 	TAILQ_FOREACH(ifrom, &efrom->bq, entries) {
-		TAILQ_FOREACH(iinto, &einto->bq, entries)
-			if (strcasecmp(iinto->name, ifrom->name) == 0)
-				break;
+		iinto = symtab_find(&ds->into, SYM_BITIDX, einto, ifrom->name);
 		if (iinto == NULL) {
 			if ((d = diff_alloc(q, DIFF_DEL_BITIDX)) == NULL)
 				return 0;
@@ -590,6 +596,43 @@ ort_has_unique(struct diffq *q,
 	return 0;
 }
 
+/*
+ * See if "os" contains the index "ip": the same columns by name in the
+ * same order, and the same (normalised) "where" constraints.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+ort_has_index(const struct index *ip, const struct strct *os)
+{
+	const struct index	*oip;
+	const struct iref	*ir, *oir;
+
+	TAILQ_FOREACH(oip, &os->iq, entries) {
+		ir = TAILQ_FIRST(&ip->nq);
+		oir = TAILQ_FIRST(&oip->nq);
+		while (ir != NULL && oir != NULL &&
+		       strcasecmp(ir->field->name, 
+			oir->field->name) == 0) {
+			ir = TAILQ_NEXT(ir, entries);
+			oir = TAILQ_NEXT(oir, entries);
+		}
+		if (ir != NULL || oir != NULL)
+			continue;
+		ir = TAILQ_FIRST(&ip->wq);
+		oir = TAILQ_FIRST(&oip->wq);
+		while (ir != NULL && oir != NULL && ir->op == oir->op &&
+		       strcasecmp(ir->field->name, 
+			oir->field->name) == 0) {
+			ir = TAILQ_NEXT(ir, entries);
+			oir = TAILQ_NEXT(oir, entries);
+		}
+		if (ir == NULL && oir == NULL)
+			return 1;
+	}
+
+	return 0;
+}
+
 /*
  * Order-preserving check for updateq.  Emits DIFF_MOD_UPDATE_PARAMS if
  * "q" is not NULL.
@@ -699,7 +742,9 @@ ort_diff_update(struct diffq *q,
  * Return >0 on failure, 0 if dissimilar, >0 if similar.
  */
 static int
-ort_diff_strct_updateq(struct diffq *q,
+ort_diff_strct_updateq(struct diffq *q, const struct diffsyms *ds,
+	enum symt type,
+	const struct strct *from, const struct strct *into,
 	const struct updateq *fromq, const struct updateq *intoq)
 {
 	const struct update	*fdel, *idel;
@@ -714,10 +759,7 @@ ort_diff_strct_updateq(struct diffq *q,
 	TAILQ_FOREACH(fdel, fromq, entries) {
 		if (fdel->name == NULL)
 			continue;
-		TAILQ_FOREACH(idel, intoq, entries)
-			if (idel->name != NULL &&
-			    strcasecmp(fdel->name, idel->name) == 0)
-				break;
+		idel = symtab_find(&ds->into, type, into, fdel->name);
 		if (idel == NULL) {
 			d = diff_alloc(q, DIFF_DEL_UPDATE);
 			if (d == NULL)
@@ -742,10 +784,7 @@ ort_diff_strct_updateq(struct diffq *q,
 	TAILQ_FOREACH(idel, intoq, entries) {
 		if (idel->name == NULL)
 			continue;
-		TAILQ_FOREACH(fdel, fromq, entries)
-			if (fdel->name != NULL &&
-			    strcasecmp(fdel->name, idel->name) == 0)
-				break;
+		fdel = symtab_find(&ds->from, type, from, idel->name);
 		if (fdel == NULL) {
 			d = diff_alloc(q, DIFF_ADD_UPDATE);
 			if (d == NULL)
@@ -844,6 +883,32 @@ ort_check_ordq(const struct ordq *from, const struct ordq *into)
 	return ointo == NULL && ointo == ofrom;
 }
 
+/*
+ * Check selected columns.
+ * These aren't order-preserving, as columns are always returned in the
+ * structure's order.
+ * Return zero if not the same, non-zero if the same.
+ */
+static int
+ort_check_projq(const struct projq *from, const struct projq *into)
+{
+	const struct proj	*pfrom, *pinto;
+	size_t			 nfrom = 0, ninto = 0;
+
+	TAILQ_FOREACH(pinto, into, entries)
+		ninto++;
+	TAILQ_FOREACH(pfrom, from, entries) {
+		TAILQ_FOREACH(pinto, into, entries)
+			if (strcasecmp(pfrom->fname, pinto->fname) == 0)
+				break;
+		if (pinto == NULL)
+			return 0;
+		nfrom++;
+	}
+
+	return nfrom == ninto;
+}
+
 /*
  * Emit DIFF_MOD_SEARCH_xxxx if "q" is not NULL.
  * Return <0 on failure, 0 if dissimilar, >0 if similar.
@@ -879,6 +944,17 @@ ort_diff_search(struct diffq *q,
 		rc = 0;
 	}
 
+	if (!ort_check_projq(&from->projq, &into->projq)) {
+		if (q != NULL) {
+			d = diff_alloc(q, DIFF_MOD_SEARCH_SELECT);
+			if (d == NULL)
+				return -1;
+			d->search_pair.from = from;
+			d->search_pair.into = into;
+		}
+		rc = 0;
+	}
+
 	if ((from->aggr != NULL && into->aggr == NULL) ||
 	    (from->aggr == NULL && into->aggr != NULL) ||
 	    (from->aggr != NULL && into->aggr != NULL &&
@@ -975,7 +1051,7 @@ ort_diff_search(struct diffq *q,
  * Returns <0 on failure, 0 on dissimilar, >0 on similar.
  */
 static int
-ort_diff_searchq(struct diffq *q,
+ort_diff_searchq(struct diffq *q, const struct diffsyms *ds,
 	const struct strct *from, const struct strct *into)
 {
 	const struct search	*sfrom, *sinto;
@@ -985,11 +1061,8 @@ ort_diff_searchq(struct diffq *q,
 	TAILQ_FOREACH(sfrom, &from->sq, entries) {
 		if (sfrom->name == NULL)
 			continue;
-		TAILQ_FOREACH(sinto, &into->sq, entries)
-			if (sinto->name != NULL &&
-			    sinto->type == sfrom->type &&
-			    strcasecmp(sinto->name, sfrom->name) == 0)
-				break;
+		sinto = symtab_find(&ds->into,
+			SYM_SEARCH + sfrom->type, into, sfrom->name);
 		if (sinto == NULL) {
 			d = diff_alloc(q, DIFF_DEL_SEARCH);
 			if (d == NULL)
@@ -1014,11 +1087,8 @@ ort_diff_searchq(struct diffq *q,
 	TAILQ_FOREACH(sinto, &into->sq, entries) {
 		if (sinto->name == NULL)
 			continue;
-		TAILQ_FOREACH(sfrom, &from->sq, entries)
-			if (sfrom->name != NULL &&
-			    sinto->type == sfrom->type &&
-			    strcasecmp(sinto->name, sfrom->name) == 0)
-				break;
+		sfrom = symtab_find(&ds->from,
+			SYM_SEARCH + sinto->type, from, sinto->name);
 		if (sfrom == NULL) {
 			d = diff_alloc(q, DIFF_ADD_SEARCH);
 			if (d == NULL)
@@ -1126,6 +1196,15 @@ ort_diff_strct_insert(struct diffq *q,
 		rc = 0;
 	}
 
+	if (fins->flags != iins->flags) {
+		d = diff_alloc(q, DIFF_MOD_INSERT_FLAGS);
+		if (d == NULL)
+			return -1;
+		d->strct_pair.into = into;
+		d->strct_pair.from = from;
+		rc = 0;
+	}
+
 	if (!ort_check_insert_order(from, into)) {
 		d = diff_alloc(q, DIFF_MOD_INSERT_PARAMS);
 		if (d == NULL)
@@ -1143,13 +1222,98 @@ ort_diff_strct_insert(struct diffq *q,
 	return rc;
 }
 
+/*
+ * See if the unique fields of "from" and "into" are the same by name,
+ * regardless of order.
+ * Return zero if dissimilar, non-zero if similar.
+ */
+static int
+ort_check_unique_fields(const struct unique *from,
+	const struct unique *into)
+{
+	const struct nref	*nfrom, *ninto;
+	size_t			 fromsz = 0, intosz = 0;
+
+	TAILQ_FOREACH(nfrom, &from->nq, entries)
+		fromsz++;
+	TAILQ_FOREACH(ninto, &into->nq, entries)
+		intosz++;
+	if (fromsz != intosz)
+		return 0;
+
+	TAILQ_FOREACH(nfrom, &from->nq, entries) {
+		TAILQ_FOREACH(ninto, &into->nq, entries)
+			if (strcasecmp(nfrom->field->name,
+			    ninto->field->name) == 0)
+				break;
+		if (ninto == NULL)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Return >0 on failure, 0 if modified, >0 if same.
+ */
+static int
+ort_diff_strct_upsert(struct diffq *q,
+	const struct strct *from, const struct strct *into)
+{
+	const struct upsert	*fups = from->ups, *iups = into->ups;
+	struct diff		*d;
+	int			 rc = 1;
+
+	if (fups == NULL && iups == NULL)
+		return 1;
+
+	if (fups == NULL && iups != NULL) {
+		if ((d = diff_alloc(q, DIFF_ADD_UPSERT)) == NULL)
+			return -1;
+		d->strct = into;
+		return 0;
+	} else if (fups != NULL && iups == NULL) {
+		if ((d = diff_alloc(q, DIFF_DEL_UPSERT)) == NULL)
+			return -1;
+		d->strct = from;
+		return 0;
+	} 
+
+	assert(fups != NULL && iups != NULL);
+
+	if (!ort_check_rolemap_roles(fups->rolemap, iups->rolemap)) {
+		d = diff_alloc(q, DIFF_MOD_UPSERT_ROLEMAP);
+		if (d == NULL)
+			return -1;
+		d->strct_pair.into = into;
+		d->strct_pair.from = from;
+		rc = 0;
+	}
+
+	if (!ort_check_unique_fields(fups->target, iups->target)) {
+		d = diff_alloc(q, DIFF_MOD_UPSERT_TARGET);
+		if (d == NULL)
+			return -1;
+		d->strct_pair.into = into;
+		d->strct_pair.from = from;
+		rc = 0;
+	}
+
+	d = diff_alloc(q, rc ? DIFF_SAME_UPSERT : DIFF_MOD_UPSERT);
+	if (d == NULL)
+		return -1;
+	d->strct_pair.into = into;
+	d->strct_pair.from = from;
+	return rc;
+}
+
 /*
  * Emit DIFF_ADD_FIELD and DIFF_DEL_FIELD, using ort_diff_field() for
  * same or different fields.
  * Return <0 on failure, 0 on dissimilar, >0 on similar.
  */
 static int
-ort_diff_fields(struct diffq *q,
+ort_diff_fields(struct diffq *q, const struct diffsyms *ds,
 	const struct strct *from, const struct strct *into)
 {
 	const struct field	*ifrom, *iinto;
@@ -1157,9 +1321,7 @@ ort_diff_fields(struct diffq *q,
 	int			 rc = 1, c;
 
 	TAILQ_FOREACH(iinto, &into->fq, entries) {
-		TAILQ_FOREACH(ifrom, &from->fq, entries)
-			if (strcasecmp(iinto->name, ifrom->name) == 0)
-				break;
+		ifrom = symtab_find(&ds->from, SYM_FIELD, from, iinto->name);
 		if (ifrom == NULL) {
 			d = diff_alloc(q, DIFF_ADD_FIELD);
 			if (d == NULL)
@@ -1175,9 +1337,7 @@ ort_diff_fields(struct diffq *q,
 	}
 
 	TAILQ_FOREACH(ifrom, &from->fq, entries) {
-		TAILQ_FOREACH(iinto, &into->fq, entries)
-			if (strcasecmp(iinto->name, ifrom->name) == 0)
-				break;
+		iinto = symtab_find(&ds->into, SYM_FIELD, into, ifrom->name);
 		if (iinto == NULL) {
 			d = diff_alloc(q, DIFF_DEL_FIELD);
 			if (d == NULL)
@@ -1195,31 +1355,32 @@ ort_diff_fields(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_strct(struct diffq *q,
+ort_diff_strct(struct diffq *q, const struct diffsyms *ds,
 	const struct strct *efrom, const struct strct *einto)
 {
 	const struct unique	*u;
+	const struct index	*ip;
 	struct diff		*d;
 	int			 rc;
 	enum difftype		 type = DIFF_SAME_STRCT;
 
 	/* All query types. */
 
-	if ((rc = ort_diff_searchq(q, efrom, einto)) < 0)
+	if ((rc = ort_diff_searchq(q, ds, efrom, einto)) < 0)
 		return 0;
 	else if (rc == 0)
 		type = DIFF_MOD_STRCT;
 
 	/* Deletes and updates. */
 
-	if ((rc = ort_diff_strct_updateq
-	    (q, &efrom->uq, &einto->uq)) < 0)
+	if ((rc = ort_diff_strct_updateq(q, ds, SYM_UPDATE,
+	    efrom, einto, &efrom->uq, &einto->uq)) < 0)
 		return 0;
 	else if (rc == 0)
 		type = DIFF_MOD_STRCT;
 
-	if ((rc = ort_diff_strct_updateq
-	    (q, &efrom->dq, &einto->dq)) < 0)
+	if ((rc = ort_diff_strct_updateq(q, ds, SYM_DELETE,
+	    efrom, einto, &efrom->dq, &einto->dq)) < 0)
 		return 0;
 	else if (rc == 0)
 		type = DIFF_MOD_STRCT;
@@ -1231,9 +1392,14 @@ ort_diff_strct(struct diffq *q,
 	else if (rc == 0)
 		type = DIFF_MOD_STRCT;
 
+	if ((rc = ort_diff_strct_upsert(q, efrom, einto)) < 0)
+		return 0;
+	else if (rc == 0)
+		type = DIFF_MOD_STRCT;
+
 	/* Field add/del/mod. */
 
-	if ((rc = ort_diff_fields(q, efrom, einto)) < 0)
+	if ((rc = ort_diff_fields(q, ds, efrom, einto)) < 0)
 		return 0;
 	else if (rc == 0)
 		type = DIFF_MOD_STRCT;
@@ -1258,6 +1424,26 @@ ort_diff_strct(struct diffq *q,
 		type = DIFF_MOD_STRCT;
 	}
 
+	/* Index add/del. */
+
+	TAILQ_FOREACH(ip, &einto->iq, entries) {
+		if (ort_has_index(ip, efrom))
+			continue;
+		if ((d = diff_alloc(q, DIFF_ADD_INDEX)) == NULL)
+			return 0;
+		d->index = ip;
+		type = DIFF_MOD_STRCT;
+	}
+
+	TAILQ_FOREACH(ip, &efrom->iq, entries) {
+		if (ort_has_index(ip, einto))
+			continue;
+		if ((d = diff_alloc(q, DIFF_DEL_INDEX)) == NULL)
+			return 0;
+		d->index = ip;
+		type = DIFF_MOD_STRCT;
+	}
+
 	/* Comment. */
 
 	if (!ort_check_comment(efrom->doc, einto->doc)) {
@@ -1280,7 +1466,7 @@ ort_diff_strct(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_enm(struct diffq *q,
+ort_diff_enm(struct diffq *q, const struct diffsyms *ds,
 	const struct enm *efrom, const struct enm *einto)
 {
 	const struct eitem	*ifrom, *iinto;
@@ -1294,9 +1480,7 @@ ort_diff_enm(struct diffq *q,
 	 */
 
 	TAILQ_FOREACH(iinto, &einto->eq, entries) {
-		TAILQ_FOREACH(ifrom, &efrom->eq, entries)
-			if (strcasecmp(iinto->name, ifrom->name) == 0)
-				break;
+		ifrom = symtab_find(&ds->from, SYM_EITEM, efrom, iinto->name);
 		if ((rc = ort_diff_eitem(q, ifrom, iinto)) < 0)
 			return 0;
 		else if (rc > 0)
@@ -1306,9 +1490,7 @@ ort_diff_enm(struct diffq *q,
 	/* Look at old enumerations no longer in the new. */
 
 	TAILQ_FOREACH(ifrom, &efrom->eq, entries) {
-		TAILQ_FOREACH(iinto, &einto->eq, entries)
-			if (strcasecmp(iinto->name, ifrom->name) == 0)
-				break;
+		iinto = symtab_find(&ds->into, SYM_EITEM, einto, ifrom->name);
 		if (iinto == NULL) {
 			if ((d = diff_alloc(q, DIFF_DEL_EITEM)) == NULL)
 				return 0;
@@ -1347,29 +1529,25 @@ ort_diff_enm(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_bitfs(struct diffq *q, 
+ort_diff_bitfs(struct diffq *q, const struct diffsyms *ds,
 	const struct config *from, const struct config *into)
 {
 	const struct bitf	*efrom, *einto;
 	struct diff		*d;
 
 	TAILQ_FOREACH(einto, &into->bq, entries) {
-		TAILQ_FOREACH(efrom, &from->bq, entries)
-			if (strcasecmp(efrom->name, einto->name) == 0)
-				break;
+		efrom = symtab_find(&ds->from, SYM_BITF, NULL, einto->name);
 
 		if (efrom == NULL) {
 			if ((d = diff_alloc(q, DIFF_ADD_BITF)) == NULL)
 				return 0;
 			d->bitf = einto;
-		} else if (!ort_diff_bitf(q, efrom, einto))
+		} else if (!ort_diff_bitf(q, ds, efrom, einto))
 			return 0;
 	}
 
 	TAILQ_FOREACH(efrom, &from->bq, entries) {
-		TAILQ_FOREACH(einto, &into->bq, entries)
-			if (strcasecmp(efrom->name, einto->name) == 0)
-				break;
+		einto = symtab_find(&ds->into, SYM_BITF, NULL, efrom->name);
 		if (einto == NULL) {
 			if ((d = diff_alloc(q, DIFF_DEL_BITF)) == NULL)
 				return 0;
@@ -1386,29 +1564,25 @@ ort_diff_bitfs(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_strcts(struct diffq *q, 
+ort_diff_strcts(struct diffq *q, const struct diffsyms *ds,
 	const struct config *from, const struct config *into)
 {
 	const struct strct	*efrom, *einto;
 	struct diff		*d;
 
 	TAILQ_FOREACH(einto, &into->sq, entries) {
-		TAILQ_FOREACH(efrom, &from->sq, entries)
-			if (strcasecmp(efrom->name, einto->name) == 0)
-				break;
+		efrom = symtab_find(&ds->from, SYM_STRCT, NULL, einto->name);
 		if (efrom == NULL) {
 			d = diff_alloc(q, DIFF_ADD_STRCT);
 			if (d == NULL)
 				return 0;
 			d->strct = einto;
-		} else if (!ort_diff_strct(q, efrom, einto))
+		} else if (!ort_diff_strct(q, ds, efrom, einto))
 			return 0; 
 	}
 
 	TAILQ_FOREACH(efrom, &from->sq, entries) {
-		TAILQ_FOREACH(einto, &into->sq, entries)
-			if (strcasecmp(efrom->name, einto->name) == 0)
-				break;
+		einto = symtab_find(&ds->into, SYM_STRCT, NULL, efrom->name);
 		if (einto == NULL) {
 			d = diff_alloc(q, DIFF_DEL_STRCT);
 			if (d == NULL)
@@ -1425,7 +1599,7 @@ ort_diff_strcts(struct diffq *q,
  * Return <0 on failure, on if dissimilar, >0 if similar.
  */
 static int
-ort_diff_role(struct diffq *q,
+ort_diff_role(struct diffq *q, const struct diffsyms *ds,
 	const struct role *rfrom, const struct role *rinto)
 {
 	const struct role	*cfrom, *cinto;
@@ -1478,11 +1652,8 @@ ort_diff_role(struct diffq *q,
 		rc = 0;
 	} else
 		TAILQ_FOREACH(cfrom, &rfrom->subrq, entries) {
-			TAILQ_FOREACH(cinto, &rinto->subrq, entries)
-				if (strcasecmp
-				    (cfrom->name, cinto->name) == 0)
-					break;
-			if (cinto != NULL)
+			cinto = symtab_find(&ds->into, SYM_ROLE, NULL, cfrom->name);
+			if (cinto != NULL && cinto->parent == rinto)
 				continue;
 			d = diff_alloc(q, DIFF_MOD_ROLE_CHILDREN);
 			if (d == NULL)
@@ -1502,7 +1673,7 @@ ort_diff_role(struct diffq *q,
  * Return <0 on failure, 0 on dissimilar, >0 on similar.
  */
 static int
-ort_diff_roleq(struct diffq *q,
+ort_diff_roleq(struct diffq *q, const struct diffsyms *ds,
 	const struct config *from, const struct config *into)
 {
 	const struct role	*rinto, *rfrom;
@@ -1510,9 +1681,7 @@ ort_diff_roleq(struct diffq *q,
 	int			 rc = 1, c;
 
 	TAILQ_FOREACH(rfrom, &from->arq, allentries) {
-		TAILQ_FOREACH(rinto, &into->arq, allentries)
-			if (strcasecmp(rfrom->name, rinto->name) == 0)
-				break;
+		rinto = symtab_find(&ds->into, SYM_ROLE, NULL, rfrom->name);
 		if (rinto == NULL) {
 			d = diff_alloc(q, DIFF_DEL_ROLE);
 			if (d == NULL)
@@ -1523,7 +1692,7 @@ ort_diff_roleq(struct diffq *q,
 		} else if (rfrom->parent == NULL)
 			continue;
 
-		if ((c = ort_diff_role(q, rfrom, rinto)) < 0)
+		if ((c = ort_diff_role(q, ds, rfrom, rinto)) < 0)
 			return -1;
 		if (c == 0) {
 			rc = 0;
@@ -1538,9 +1707,7 @@ ort_diff_roleq(struct diffq *q,
 	}
 
 	TAILQ_FOREACH(rinto, &into->arq, allentries) {
-		TAILQ_FOREACH(rfrom, &from->arq, allentries)
-			if (strcasecmp(rfrom->name, rinto->name) == 0)
-				break;
+		rfrom = symtab_find(&ds->from, SYM_ROLE, NULL, rinto->name);
 		if (rfrom == NULL) {
 			d = diff_alloc(q, DIFF_ADD_ROLE);
 			if (d == NULL)
@@ -1559,7 +1726,7 @@ ort_diff_roleq(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_roles(struct diffq *q, 
+ort_diff_roles(struct diffq *q, const struct diffsyms *ds,
 	const struct config *from, const struct config *into)
 {
 	struct diff		*d;
@@ -1583,7 +1750,7 @@ ort_diff_roles(struct diffq *q,
 		return 1;
 	}
 
-	if ((rc = ort_diff_roleq(q, from, into)) < 0)
+	if ((rc = ort_diff_roleq(q, ds, from, into)) < 0)
 		return 0;
 	d = diff_alloc(q, rc ? DIFF_SAME_ROLES : DIFF_MOD_ROLES);
 	if (d == NULL)
@@ -1597,29 +1764,25 @@ ort_diff_roles(struct diffq *q,
  * Return zero on failure, non-zero on success.
  */
 static int
-ort_diff_enms(struct diffq *q, 
+ort_diff_enms(struct diffq *q, const struct diffsyms *ds,
 	const struct config *from, const struct config *into)
 {
 	const struct enm	*efrom, *einto;
 	struct diff		*d;
 
 	TAILQ_FOREACH(einto, &into->eq, entries) {
-		TAILQ_FOREACH(efrom, &from->eq, entries)
-			if (strcasecmp(efrom->name, einto->name) == 0)
-				break;
+		efrom = symtab_find(&ds->from, SYM_ENM, NULL, einto->name);
 
 		if (efrom == NULL) {
 			if ((d = diff_alloc(q, DIFF_ADD_ENM)) == NULL)
 				return 0;
 			d->enm = einto;
-		} else if (!ort_diff_enm(q, efrom, einto))
+		} else if (!ort_diff_enm(q, ds, efrom, einto))
 			return 0;
 	}
 
 	TAILQ_FOREACH(efrom, &from->eq, entries) {
-		TAILQ_FOREACH(einto, &into->eq, entries)
-			if (strcasecmp(efrom->name, einto->name) == 0)
-				break;
+		einto = symtab_find(&ds->into, SYM_ENM, NULL, efrom->name);
 		if (einto == NULL) {
 			if ((d = diff_alloc(q, DIFF_DEL_ENM)) == NULL)
 				return 0;
@@ -1630,27 +1793,46 @@ ort_diff_enms(struct diffq *q,
 	return 1;
 }
 
+/*
+ * Index the names of both configurations first: each object is then
+ * matched by name with a lookup in the other configuration's index
+ * instead of a scan.  Only unnamed queries and updates, which are
+ * matched by content, are still compared pairwise.
+ * The indexes are our own, not the linker's, as either configuration
+ * may not have been linked.
+ */
 struct diffq *
 ort_diff(const struct config *from, const struct config *into)
 {
 	struct diffq	*q;
+	struct diffsyms	 ds;
+
+	memset(&ds, 0, sizeof(struct diffsyms));
 
 	if ((q = calloc(1, sizeof(struct diffq))) == NULL)
 		return NULL;
 
 	TAILQ_INIT(q);
 
-	if (!ort_diff_enms(q, from, into))
+	if (!symtab_build(&ds.from, from) ||
+	    !symtab_build(&ds.into, into))
+		goto err;
+
+	if (!ort_diff_enms(q, &ds, from, into))
 		goto err;
-	if (!ort_diff_bitfs(q, from, into))
+	if (!ort_diff_bitfs(q, &ds, from, into))
 		goto err;
-	if (!ort_diff_strcts(q, from, into))
+	if (!ort_diff_strcts(q, &ds, from, into))
 		goto err;
-	if (!ort_diff_roles(q, from, into))
+	if (!ort_diff_roles(q, &ds, from, into))
 		goto err;
 
+	symtab_free(&ds.from);
+	symtab_free(&ds.into);
 	return q;
 err:
+	symtab_free(&ds.from);
+	symtab_free(&ds.into);
 	ort_diffq_free(q);
 	return NULL;
 }
@@ -28,7 +28,9 @@ enum	resolvet {
 	RESOLVE_AGGR,
 	RESOLVE_DISTINCT,
 	RESOLVE_GROUPROW,
+	RESOLVE_INDEX,
 	RESOLVE_ORDER,
+	RESOLVE_PROJ,
 	RESOLVE_ROLE,
 	RESOLVE_ROLEMAP,
 	RESOLVE_SENT,
@@ -91,6 +93,10 @@ struct	resolve {
 				char		**names;
 				size_t		  namesz;
 		} struct_order; /* ...order ->bar<- */
+		struct struct_proj {
+				struct proj	*result;
+				char		*name;
+		} struct_proj; /* ...select ->bar<- */
 		struct struct_role {
 				struct rref	*result;
 				char		*name;
@@ -109,6 +115,10 @@ struct	resolve {
 				struct nref	*result;
 				char		*name;
 		} struct_unique; /* unique ->bar<-... */
+		struct struct_index {
+				struct iref	*result;
+				char		*name;
+		} struct_index; /* index ->bar<-... */
 		struct field_def_eitem {
 				struct field	*result;
 				char		*name;
@@ -117,12 +127,60 @@ struct	resolve {
 	TAILQ_ENTRY(resolve)	entries;
 };
 
+/*
+ * Kinds of named objects in the symbol table.
+ * Each is looked up by name within a scope, which is NULL for
+ * top-level objects.
+ * Queries are keyed by SYM_SEARCH plus their enum stype.
+ */
+enum	symt {
+	SYM_ALIAS, /* alias (originating structure) */
+	SYM_BITF, /* bitfield (no scope) */
+	SYM_BITIDX, /* bitfield item (bitfield) */
+	SYM_DELETE, /* named delete (structure) */
+	SYM_EITEM, /* enumeration item (enumeration) */
+	SYM_ENM, /* enumeration (no scope) */
+	SYM_FIELD, /* field (structure) */
+	SYM_ROLE, /* any role (no scope) */
+	SYM_STRCT, /* structure (no scope) */
+	SYM_UPDATE, /* named update (structure) */
+	SYM_SEARCH /* named query (structure) */
+};
+
+struct	sym {
+	unsigned int	 type; /* enum symt (plus stype) */
+	const void	*scope; /* containing object or NULL */
+	const char	*name; /* name (case insensitive) */
+	size_t		 hash; /* hash of all of the above */
+	void		*obj; /* the object itself */
+};
+
+/*
+ * Case-insensitive hash of named objects, open-addressed.
+ * The linker's is filled from the parsed configuration when linking,
+ * then with aliases as they're created.
+ */
+struct	symtab {
+	struct sym	*syms; /* slots (NULL name if empty) */
+	size_t		 symsz; /* occupied slots */
+	size_t		 symmax; /* slots (power of two) */
+};
+
 /*
  * Private information used only within the parsing and linking phase,
  * and not exported to the final configuration.
  */
 struct	config_private {
 	struct resolveq		 rq; /* resolution requests */
+	struct symtab		 st; /* named objects */
+	int			 loaded; /* from a snapshot */
 };
 
+void	*symtab_find(const struct symtab *, unsigned int,
+		const void *, const char *);
+int	 symtab_add(struct symtab *, unsigned int,
+		const void *, const char *, void *);
+int	 symtab_build(struct symtab *, const struct config *);
+void	 symtab_free(struct symtab *);
+
 #endif /* !EXTERN_H */
@@ -0,0 +1,476 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "config.h"
+
+#if HAVE_SYS_QUEUE
+# include <sys/queue.h>
+#endif
+#include <sys/stat.h>
+
+#include <assert.h>
+#if HAVE_ERR
+# include <err.h>
+#endif
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ort-paths.h"
+#include "ort.h"
+#include "ort-lang-c.h"
+#include "ort-lang-javascript.h"
+#include "ort-lang-nodejs.h"
+#include "ort-lang-rust.h"
+#include "ort-lang-sql.h"
+
+enum	gent {
+	GEN_C_HEADER,
+	GEN_C_SOURCE,
+	GEN_JAVASCRIPT,
+	GEN_NODEJS,
+	GEN_RUST,
+	GEN_SQL,
+	GEN__MAX
+};
+
+static	const char *const gents[GEN__MAX] = {
+	"c-header", /* GEN_C_HEADER */
+	"c-source", /* GEN_C_SOURCE */
+	"javascript", /* GEN_JAVASCRIPT */
+	"nodejs", /* GEN_NODEJS */
+	"rust", /* GEN_RUST */
+	"sql", /* GEN_SQL */
+};
+
+/*
+ * Arguments shared by all targets, each as its standalone tool would
+ * have them by default.
+ */
+struct	genargs {
+	struct ort_lang_c	 cheader;
+	struct ort_lang_c	 csource;
+	struct ort_lang_js	 js;
+	struct ort_lang_nodejs	 nodejs;
+	struct ort_lang_rust	 rust;
+	const struct config	*cfg;
+};
+
+/*
+ * An output file ("-o target=file").
+ */
+struct	target {
+	enum gent	 type;
+	const char	*fname;
+	char		*tmp; /* written until renamed to fname */
+	FILE		*f;
+	int		 rc; /* generator result */
+};
+
+/*
+ * Targets shared between workers.
+ * Each worker takes the next unclaimed target until none remain.
+ */
+struct	targetpool {
+	pthread_mutex_t		 mtx; /* protects "next" */
+	struct target		*targets;
+	size_t			 targetsz;
+	size_t			 next; /* next unclaimed target */
+	const struct genargs	*args;
+};
+
+/*
+ * Read a file into memory.
+ * If the file contains NUL characters, these will prematurely end the
+ * file when printed, as it's interpreted as a string.
+ * Return the file contents (never fails).
+ */
+static char *
+readfile(const char *dir, const char *fname)
+{
+	int		 fd;
+	ssize_t		 ssz;
+	size_t		 sz;
+	struct stat	 st;
+	char		*buf, *file;
+
+	if (asprintf(&file, "%s/%s", dir, fname) == -1)
+		err(1, NULL);
+
+	if ((fd = open(file, O_RDONLY, 0)) == -1)
+		err(1, "%s", file);
+	if (fstat(fd, &st) == -1)
+		err(1, "%s", file);
+
+	/* FIXME: overflow check. */
+
+	assert(st.st_size > 0 &&
+		(uint64_t)st.st_size < SIZE_MAX);
+
+	sz = (size_t)st.st_size;
+	if ((buf = malloc(sz + 1)) == NULL)
+		err(1, NULL);
+
+	if ((ssz = read(fd, buf, sz)) < 0)
+		err(1, "%s", file);
+	else if ((size_t)ssz != sz)
+		errx(1, "%s: bad file length", file);
+
+	buf[sz] = '\0';
+	close(fd);
+	free(file);
+	return buf;
+}
+
+/*
+ * Run the generator of target "t" into its file.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+gen_target(const struct genargs *args, const struct target *t)
+{
+
+	switch (t->type) {
+	case GEN_C_HEADER:
+		return ort_lang_c_header(&args->cheader, args->cfg, t->f);
+	case GEN_C_SOURCE:
+		return ort_lang_c_source(&args->csource, args->cfg, t->f);
+	case GEN_JAVASCRIPT:
+		return ort_lang_javascript(args->cfg, &args->js, t->f);
+	case GEN_NODEJS:
+		return ort_lang_nodejs(&args->nodejs, args->cfg, t->f);
+	case GEN_RUST:
+		return ort_lang_rust(&args->rust, args->cfg, t->f);
+	case GEN_SQL:
+		return ort_lang_sql(NULL, args->cfg, t->f);
+	default:
+		abort();
+	}
+}
+
+static void *
+gen_worker(void *arg)
+{
+	struct targetpool	*pool = arg;
+	struct target		*t;
+	size_t			 i;
+
+	for (;;) {
+		if (pthread_mutex_lock(&pool->mtx) != 0)
+			return NULL;
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->mtx);
+		if (i >= pool->targetsz)
+			break;
+		t = &pool->targets[i];
+		t->rc = gen_target(pool->args, t);
+	}
+
+	return NULL;
+}
+
+/*
+ * Run all targets, each into its own file, by up to "jobs" threads
+ * (including the caller's).
+ * The configuration is only read, so generators may share it.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+gen_targets(const struct genargs *args, struct target *targets,
+	size_t targetsz, size_t jobs)
+{
+	struct targetpool	 pool;
+	pthread_t		*thrs = NULL;
+	size_t			 i, thrsz = 0;
+	int			 rc = 1;
+
+	memset(&pool, 0, sizeof(struct targetpool));
+	pool.targets = targets;
+	pool.targetsz = targetsz;
+	pool.args = args;
+
+	if (jobs > targetsz)
+		jobs = targetsz;
+
+	if (jobs <= 1) {
+		for (i = 0; i < targetsz; i++)
+			targets[i].rc = gen_target(args, &targets[i]);
+	} else {
+		if (pthread_mutex_init(&pool.mtx, NULL) != 0) {
+			warn(NULL);
+			return 0;
+		}
+
+		/*
+		 * Failing to start a thread isn't an error: the
+		 * caller's thread always works, so we just run with
+		 * fewer.
+		 */
+
+		if ((thrs = calloc(jobs - 1, sizeof(pthread_t))) != NULL)
+			for ( ; thrsz < jobs - 1; thrsz++)
+				if (pthread_create(&thrs[thrsz], NULL,
+				    gen_worker, &pool) != 0)
+					break;
+
+		gen_worker(&pool);
+
+		for (i = 0; i < thrsz; i++)
+			pthread_join(thrs[i], NULL);
+		free(thrs);
+		pthread_mutex_destroy(&pool.mtx);
+	}
+
+	for (i = 0; i < targetsz; i++)
+		if (!targets[i].rc) {
+			warn("%s", targets[i].fname);
+			rc = 0;
+		}
+
+	return rc;
+}
+
+/*
+ * Open the temporary file of target "t", within the same directory as
+ * its file so that it can be renamed over it, with the permissions
+ * that creating the file would have given.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+target_open(struct target *t)
+{
+	int	 fd;
+	mode_t	 mask;
+
+	if (asprintf(&t->tmp, "%s.XXXXXXXXXX", t->fname) == -1) {
+		warn(NULL);
+		t->tmp = NULL;
+		return 0;
+	}
+	if ((fd = mkstemp(t->tmp)) == -1) {
+		warn("%s", t->tmp);
+		free(t->tmp);
+		t->tmp = NULL;
+		return 0;
+	}
+
+	mask = umask(0);
+	umask(mask);
+	if (fchmod(fd, 0666 & ~mask) == -1 ||
+	    (t->f = fdopen(fd, "w")) == NULL) {
+		warn("%s", t->tmp);
+		close(fd);
+		unlink(t->tmp);
+		free(t->tmp);
+		t->tmp = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Close the temporary file of target "t" and, if "rc" is non-zero,
+ * rename it over the target's file: otherwise, remove it.
+ * Returns zero on failure (or if "rc" is zero), non-zero on success.
+ */
+static int
+target_close(struct target *t, int rc)
+{
+
+	if (t->f != NULL && fclose(t->f) == EOF && rc) {
+		warn("%s", t->tmp);
+		rc = 0;
+	}
+	t->f = NULL;
+	if (t->tmp == NULL)
+		return 0;
+	if (rc && rename(t->tmp, t->fname) == -1) {
+		warn("%s", t->fname);
+		rc = 0;
+	}
+	if (!rc && unlink(t->tmp) == -1)
+		warn("%s", t->tmp);
+	free(t->tmp);
+	t->tmp = NULL;
+	return rc;
+}
+
+int
+main(int argc, char *argv[])
+{
+	const char		 *sharedir = SHAREDIR, *er;
+	struct genargs		  args;
+	struct config		 *cfg = NULL;
+	struct target		 *targets = NULL, *t;
+	int			  c, rc = 0;
+	FILE			**confs = NULL;
+	size_t			  i, targetsz = 0, jobs = 1;
+	char			 *ext_jsmn = NULL, *ext_privMethods = NULL,
+				 *cp;
+	void			 *pp;
+
+#if HAVE_PLEDGE
+	if (pledge("stdio rpath wpath cpath", NULL) == -1)
+		err(EXIT_FAILURE, "pledge");
+#endif
+
+	memset(&args, 0, sizeof(struct genargs));
+	args.cheader.flags = ORT_LANG_C_CORE | ORT_LANG_C_DB_SQLBOX;
+	args.cheader.guard = "DB_H";
+	args.csource.flags = ORT_LANG_C_DB_SQLBOX;
+	args.csource.header = "db.h";
+	args.nodejs.flags = ORT_LANG_NODEJS_DB | ORT_LANG_NODEJS_CORE;
+
+	while ((c = getopt(argc, argv, "jJo:P:S:v")) != -1)
+		switch (c) {
+		case 'j':
+			args.cheader.flags |= ORT_LANG_C_JSON_KCGI;
+			args.csource.flags |= ORT_LANG_C_JSON_KCGI;
+			break;
+		case 'J':
+			args.cheader.flags |= ORT_LANG_C_JSON_JSMN;
+			args.csource.flags |= ORT_LANG_C_JSON_JSMN;
+			break;
+		case 'o':
+			if ((cp = strchr(optarg, '=')) == NULL ||
+			    cp[1] == '\0')
+				errx(EXIT_FAILURE, "-o: %s: expected "
+					"target=file", optarg);
+			for (i = 0; i < GEN__MAX; i++)
+				if (strlen(gents[i]) == (size_t)
+				    (cp - optarg) && strncmp(gents[i],
+				    optarg, (size_t)(cp - optarg)) == 0)
+					break;
+			if (i == GEN__MAX)
+				errx(EXIT_FAILURE, "-o: %.*s: unknown "
+					"target", (int)(cp - optarg), optarg);
+			pp = reallocarray(targets,
+				targetsz + 1, sizeof(struct target));
+			if (pp == NULL)
+				err(EXIT_FAILURE, NULL);
+			targets = pp;
+			t = &targets[targetsz++];
+			memset(t, 0, sizeof(struct target));
+			t->type = i;
+			t->fname = cp + 1;
+			break;
+		case 'P':
+			jobs = strtonum(optarg, 1, 256, &er);
+			if (er != NULL)
+				errx(EXIT_FAILURE, "-P: %s: %s", optarg, er);
+			break;
+		case 'S':
+			sharedir = optarg;
+			break;
+		case 'v':
+			args.cheader.flags |= ORT_LANG_C_VALID_KCGI;
+			args.csource.flags |= ORT_LANG_C_VALID_KCGI;
+			break;
+		default:
+			goto usage;
+		}
+
+	argc -= optind;
+	argv += optind;
+
+	if (targetsz == 0)
+		goto usage;
+
+	/* Read in all of our files now so we can repledge. */
+
+	if (argc > 0 &&
+	    (confs = calloc((size_t)argc, sizeof(FILE *))) == NULL)
+		err(EXIT_FAILURE, NULL);
+
+	for (i = 0; i < (size_t)argc; i++)
+		if ((confs[i] = fopen(argv[i], "r")) == NULL)
+			err(EXIT_FAILURE, "%s", argv[i]);
+
+	/* Files we might embed in output. */
+
+	for (i = 0; i < targetsz; i++)
+		if (targets[i].type == GEN_C_SOURCE && ext_jsmn == NULL)
+			args.csource.ext_jsmn = ext_jsmn =
+				readfile(sharedir, "jsmn.c");
+		else if (targets[i].type == GEN_JAVASCRIPT &&
+		    ext_privMethods == NULL)
+			args.js.ext_privMethods = ext_privMethods =
+				readfile(sharedir, "ortPrivate.ts");
+
+	if ((cfg = ort_config_alloc()) == NULL)
+		err(EXIT_FAILURE, NULL);
+
+	/* 
+	 * Output goes to temporary files, renamed over the targets only
+	 * once all are generated, so failure leaves prior output as-is.
+	 */
+
+	for (i = 0; i < targetsz; i++)
+		if (!target_open(&targets[i])) {
+			while (i-- > 0)
+				target_close(&targets[i], 0);
+			exit(EXIT_FAILURE);
+		}
+
+#if HAVE_PLEDGE
+	if (pledge("stdio cpath", NULL) == -1)
+		err(EXIT_FAILURE, "pledge");
+#endif
+
+	for (i = 0; i < (size_t)argc; i++)
+		if (!ort_parse_file(cfg, confs[i], argv[i]))
+			goto out;
+
+	if (argc == 0 && !ort_parse_file(cfg, stdin, "<stdin>"))
+		goto out;
+
+	if ((rc = ort_parse_close(cfg))) {
+		args.cfg = cfg;
+		rc = gen_targets(&args, targets, targetsz, jobs);
+	}
+out:
+	ort_write_msg_file(stderr, &cfg->mq);
+	ort_config_free(cfg);
+
+	for (i = 0; i < (size_t)argc; i++)
+		fclose(confs[i]);
+	for (i = 0; i < targetsz; i++)
+		if (!target_close(&targets[i], rc))
+			rc = 0;
+
+	free(confs);
+	free(targets);
+	free(ext_jsmn);
+	free(ext_privMethods);
+	return rc ? EXIT_SUCCESS : EXIT_FAILURE;
+usage:
+	fprintf(stderr,
+		"usage: %s "
+		"[-jJv] "
+		"[-P jobs] "
+		"[-S sharedir] "
+		"-o target=file ... "
+		"[config...]\n",
+		getprogname());
+	free(targets);
+	return EXIT_FAILURE;
+}
@@ -427,6 +427,19 @@ gen_struct(FILE *f, const struct ort_lang_c *args,
 			return 0;
 	}
 
+	if (s->flags & STRCT_HAS_PROJ) {
+		if (!gen_commentv(f, 1, COMMENT_C,
+		    "Columns filled from the database, one bit per "
+		    "column, tested with DB_ISFILLED() and the "
+		    "DB_FILLED_%s_xxx indices.\n"
+		    "Queries with a select clause set only the "
+		    "columns they read.", s->name))
+			return 0;
+		if (fprintf(f, "\tuint64_t _filled[%zu];\n",
+		    gen_filled_words(s)) < 0)
+			return 0;
+	}
+
 	if ((s->flags & STRCT_HAS_QUEUE) &&
 	    fprintf(f, "\tTAILQ_ENTRY(%s) _entries;\n", s->name) < 0)
 		return 0;
@@ -442,6 +455,20 @@ gen_struct(FILE *f, const struct ort_lang_c *args,
 	if (fputs("};\n", f) == EOF)
 		return 0;
 
+	if (s->flags & STRCT_HAS_PROJ) {
+		if (fputc('\n', f) == EOF)
+			return 0;
+		if (!gen_commentv(f, 0, COMMENT_C,
+		    "Bit indices of the \"_filled\" member of %s, "
+		    "one per column.", s->name))
+			return 0;
+		TAILQ_FOREACH(fd, &s->fq, entries)
+			if (fd->type != FTYPE_STRUCT &&
+			    fprintf(f, "#define DB_FILLED_%s_%s %zu\n",
+			    s->name, fd->name, gen_filled_col(fd)) < 0)
+				return 0;
+	}
+
 	if (s->flags & STRCT_HAS_QUEUE) {
 		if (fputc('\n', f) == EOF)
 			return 0;
@@ -467,15 +494,30 @@ gen_struct(FILE *f, const struct ort_lang_c *args,
 			return 0;
 	}
 
+	if (s->flags & STRCT_HAS_UNTIL) {
+		if (fputc('\n', f) == EOF)
+			return 0;
+		if (!gen_commentv(f, 0, COMMENT_C,
+		    "Like %s_cb, but returning non-zero to stop "
+		    "the iteration.", s->name))
+			return 0;
+		if (fprintf(f, "typedef int (*%s_until_cb)(const struct "
+		    "%s *v, void *arg);\n", s->name, s->name) < 0)
+			return 0;
+	}
+
 	return 1;
 }
 
 /*
  * Generate update/delete functions for a structure.
+ * If "ret" is non-zero, this is the update variant returning the
+ * modified row.
  * Returns zero on failure, non-zero on success.
  */
 static int
-gen_update(FILE *f, const struct config *cfg, const struct update *up)
+gen_update(FILE *f, const struct config *cfg, 
+	const struct update *up, int ret)
 {
 	const struct uref	*ref;
 	enum cmtt		 ct = COMMENT_C_FRAG_OPEN;
@@ -537,6 +579,14 @@ gen_update(FILE *f, const struct config *cfg, const struct update *up)
 				return 0;
 		}
 
+	if (ret) {
+		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
+		    "Returns the modified row or NULL on constraint "
+		    "violation or if no row was modified."))
+			return 0;
+		return gen_func_db_update_returning(f, up, 1);
+	}
+
 	if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
 	    "Returns zero on constraint violation, "
 	    "non-zero on success."))
@@ -552,6 +602,7 @@ static int
 gen_search(FILE *f, const struct config *cfg, const struct search *s)
 {
 	const struct sent	*sent;
+	const struct proj	*proj;
 	const struct strct	*rc;
 	size_t			 pos = 1;
 
@@ -560,6 +611,20 @@ gen_search(FILE *f, const struct config *cfg, const struct search *s)
 
 	rc = s->dst != NULL ? s->dst->strct : s->parent;
 
+	/* Grouped counts return an array of their own structure. */
+
+	if (SEARCH_ISHISTO(s)) {
+		if (!gen_commentv(f, 0, COMMENT_C,
+		    "Count of results in %s having the given "
+		    "\"%s\" value.", s->parent->name, 
+		    s->group->fname))
+			return 0;
+		if (!gen_struct_db_histo(f, s))
+			return 0;
+		if (fputc('\n', f) == EOF)
+			return 0;
+	}
+
 	if (s->doc != NULL) {
 		if (!gen_comment(f, 0, COMMENT_C_FRAG_OPEN, s->doc))
 			return 0;
@@ -571,10 +636,29 @@ gen_search(FILE *f, const struct config *cfg, const struct search *s)
 		if (!gen_commentv(f, 0, COMMENT_C_FRAG_OPEN,
 		    "Search for a set of %s.", rc->name))
 			return 0;
+	} else if (SEARCH_ISHISTO(s)) {
+		if (!gen_commentv(f, 0, COMMENT_C_FRAG_OPEN,
+		    "Count results of a search in %s for each "
+		    "value of \"%s\".", rc->name, s->group->fname))
+			return 0;
 	} else if (s->type == STYPE_COUNT) {
 		if (!gen_commentv(f, 0, COMMENT_C_FRAG_OPEN,
 		    "Count results of a search in %s.", rc->name))
 			return 0;
+	} else if (s->type == STYPE_EXISTS) {
+		if (!gen_commentv(f, 0, COMMENT_C_FRAG_OPEN,
+		    "Check whether a search in %s has any results, "
+		    "stopping at the first.", rc->name))
+			return 0;
+	} else if (STYPE_ISAGGR(s->type)) {
+		if (!gen_commentv(f, 0, COMMENT_C_FRAG_OPEN,
+		    "Compute the %s of \"%s\" over results of "
+		    "a search in %s.", 
+		    s->type == STYPE_SUM ? "sum" :
+		    s->type == STYPE_AVG ? "average" :
+		    s->type == STYPE_MIN ? "minimum" : "maximum",
+		    TAILQ_FIRST(&s->projq)->fname, rc->name))
+			return 0;
 	} else {
 		if (!gen_commentv(f, 0, COMMENT_C_FRAG_OPEN,
 		    "Iterate over results in %s.", rc->name))
@@ -614,6 +698,20 @@ gen_search(FILE *f, const struct config *cfg, const struct search *s)
 	     "Use this sparingly!"))
 		return 0;
 
+	if (gen_search_projected(s)) {
+		if (!gen_comment(f, 0, COMMENT_C_FRAG,
+		    "Only the following columns (with the row "
+		    "identifier and foreign keys) are read, as "
+		    "marked in the \"_filled\" member: the others "
+		    "are zeroed, set as null, or the first item of "
+		    "enumerations:"))
+			return 0;
+		TAILQ_FOREACH(proj, &s->projq, entries)
+			if (!gen_commentv(f, 0, COMMENT_C_FRAG,
+			    "\t%s", proj->fname))
+				return 0;
+	}
+
 	if (!gen_commentv(f, 0, COMMENT_C_FRAG,
 	    "Queries on the following fields in struct %s:",
 	    s->parent->name))
@@ -652,10 +750,28 @@ gen_search(FILE *f, const struct config *cfg, const struct search *s)
 		    "Free this with db_%s_freeq().",
 		    rc->name))
 			return 0;
+	} else if (SEARCH_ISHISTO(s)) {
+		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
+		    "Returns an array of counts ordered by value, "
+		    "its length stored in \"sz\", or NULL if there "
+		    "are no results.\n"
+		    "Free the array with free()."))
+			return 0;
 	} else if (s->type == STYPE_COUNT) {
 		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
 		    "Returns the count of results."))
 			return 0;
+	} else if (s->type == STYPE_EXISTS) {
+		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
+		    "Returns non-zero if there are any results, "
+		    "zero otherwise."))
+			return 0;
+	} else if (STYPE_ISAGGR(s->type)) {
+		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
+		    "Returns zero if no rows matched (or all "
+		    "values were null), else non-zero with the "
+		    "result stored in \"val\"."))
+			return 0;
 	} else {
 		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
 		    "Invokes the given callback with "
@@ -663,7 +779,38 @@ gen_search(FILE *f, const struct config *cfg, const struct search *s)
 			return 0;
 	}
 
-	return gen_func_db_search(f, s, 1);
+	if (!gen_func_db_search(f, s, 1))
+		return 0;
+
+	if (s->flags & SEARCH_HAS_UNTIL) {
+		if (fputc('\n', f) == EOF)
+			return 0;
+		if (!gen_comment(f, 0, COMMENT_C,
+		    "Like the above, but stops the iteration (and "
+		    "the query) when the callback returns non-zero.\n"
+		    "Returns the number of results passed to the "
+		    "callback, including the last."))
+			return 0;
+		return gen_func_db_search_until(f, s, 1);
+	}
+
+	if (!(s->flags & SEARCH_HAS_MANY))
+		return 1;
+
+	if (fputc('\n', f) == EOF)
+		return 0;
+	if (!gen_commentv(f, 0, COMMENT_C,
+	    "Like the above, but looks up each of the \"n\" "
+	    "values of %s in \"v1\", batching them into as few "
+	    "queries as possible.\n"
+	    "Returns an array of \"n\" results in the order of "
+	    "\"v1\", each NULL if not found, or NULL if \"n\" is "
+	    "zero.\n"
+	    "Free each result with db_%s_free() and the array "
+	    "with free().", TAILQ_FIRST(&s->sntq)->fname, 
+	    s->parent->name))
+		return 0;
+	return gen_func_db_search_many(f, s, 1);
 }
 
 /*
@@ -732,14 +879,88 @@ gen_database(FILE *f, const struct config *cfg, const struct strct *p)
 			return 0;
 	}
 
+	if (p->ins != NULL && (p->ins->flags & INSERT_RETURNING)) {
+		if (!gen_commentv(f, 0, COMMENT_C,
+		    "Like db_%s_insert(), but returns the new row as "
+		    "written by the database (with its identifier and "
+		    "any defaults) instead of the identifier.\n"
+		    "Returns the new row or NULL on constraint "
+		    "violation.", p->name))
+			return 0;
+		if (!gen_func_db_insert_returning(f, p, 1))
+			return 0;
+	}
+
+	if (p->ups != NULL) {
+		if (!gen_comment(f, 0, COMMENT_C_FRAG_OPEN,
+		    "Insert a new row into the database or, if it "
+		    "conflicts with an existing row on the upsert "
+		    "fields, update the other native (and non-rowid) "
+		    "fields of that row.\n"
+		    "Arguments are as for the insert:"))
+			return 0;
+		pos = 1;
+		TAILQ_FOREACH(fd, &p->fq, entries) {
+			if (fd->type == FTYPE_STRUCT ||
+			    (fd->flags & FIELD_ROWID))
+				continue;
+			if (fd->type == FTYPE_PASSWORD) {
+				if (!gen_commentv(f, 0, COMMENT_C_FRAG,
+				    "\tv%zu: %s (pre-hashed password)",
+				    pos++, fd->name))
+					return 0;
+			} else {
+				if (!gen_commentv(f, 0, COMMENT_C_FRAG,
+				    "\tv%zu: %s", pos++, fd->name))
+					return 0;
+			}
+		}
+		if (!gen_comment(f, 0, COMMENT_C_FRAG_CLOSE,
+		    "Returns the inserted or updated row's identifier "
+		    "on success or <0 otherwise."))
+			return 0;
+		if (!gen_func_db_upsert(f, p, 1))
+			return 0;
+	}
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (!(fd->flags & FIELD_LAZY))
+			continue;
+		if (!gen_commentv(f, 0, COMMENT_C,
+		    "Read the lazy column \"%s\" of \"p\", which must "
+		    "have its row identifier set, replacing any value "
+		    "already in \"p\".\n"
+		    "Returns zero if the row was not found, non-zero "
+		    "on success.", fd->name))
+			return 0;
+		if (!gen_func_db_load(f, fd, 1))
+			return 0;
+		if (fputs("\n", f) == EOF)
+			return 0;
+		if (fd->type != FTYPE_BLOB)
+			continue;
+		if (!gen_commentv(f, 0, COMMENT_C,
+		    "Get the size in bytes of the lazy column \"%s\" "
+		    "in row \"id\" into \"sz\" without reading it.\n"
+		    "Returns <0 if the row was not found, zero if the "
+		    "column is null, >0 on success.", fd->name))
+			return 0;
+		if (!gen_func_db_blob(f, fd, 1))
+			return 0;
+		if (fputs("\n", f) == EOF)
+			return 0;
+	}
+
 	TAILQ_FOREACH(s, &p->sq, entries)
 		if (!gen_search(f, cfg, s))
 			return 0;
 	TAILQ_FOREACH(u, &p->uq, entries)
-		if (!gen_update(f, cfg, u))
+		if (!gen_update(f, cfg, u, 0) ||
+		    ((u->flags & UPDATE_RETURNING) &&
+		     !gen_update(f, cfg, u, 1)))
 			return 0;
 	TAILQ_FOREACH(u, &p->dq, entries)
-		if (!gen_update(f, cfg, u))
+		if (!gen_update(f, cfg, u, 0))
 			return 0;
 
 	return 1;
@@ -1192,6 +1413,21 @@ ort_lang_c_header(const struct ort_lang_c *args,
 	}
 
 	if (args->flags & ORT_LANG_C_CORE) {
+		TAILQ_FOREACH(p, &cfg->sq, entries)
+			if (p->flags & STRCT_HAS_PROJ)
+				break;
+		if (p != NULL) {
+			if (!gen_comment(f, 0, COMMENT_C,
+			    "Non-zero if the column with the "
+			    "DB_FILLED_xxx_yyy index \"_col\" of the "
+			    "structure pointed to by \"_p\" was "
+			    "filled from the database."))
+				return 0;
+			if (fputs("#define DB_ISFILLED(_p, _col) \\\n"
+			    "\t(((_p)->_filled[(_col) / 64] >> "
+			    "((_col) % 64)) & 1)\n\n", f) == EOF)
+				return 0;
+		}
 		TAILQ_FOREACH(e, &cfg->eq, entries)
 			if (!gen_enum(f, e))
 				return 0;
@@ -385,13 +385,16 @@ gen_strcts(FILE *f, const struct config *cfg)
 }
 
 /*
+ * If "until" is non-zero, this is the early-terminating variant of an
+ * iterate search.
  * Return FALSE on failure, TRUE on success.
  */
 static int
-gen_query(FILE *f, const struct search *sr, int syn)
+gen_query(FILE *f, const struct search *sr, int until, int syn)
 {
 	const char		*retname;
 	const struct sent	*sent;
+	const char		*aggrt;
 	int		 	 c;
 
 	if (syn && fputs(".Ft \"", f) == EOF)
@@ -401,23 +404,32 @@ gen_query(FILE *f, const struct search *sr, int syn)
 
 	retname = sr->dst != NULL ? 
 		sr->dst->strct->name : sr->parent->name;
-	if (sr->type == STYPE_COUNT)
+	if (SEARCH_ISHISTO(sr)) {
+		if (fputs("struct ", f) == EOF)
+			return 0;
+		if ((c = gen_histo_name(f, sr)) >= 0)
+			c = fprintf(f, " *");
+	} else if (sr->type == STYPE_COUNT)
 		c = fprintf(f, "uint64_t");
+	else if (sr->type == STYPE_EXISTS)
+		c = fprintf(f, "int");
 	else if (sr->type == STYPE_SEARCH)
 		c = fprintf(f, "struct %s *", retname);
 	else if (sr->type == STYPE_LIST)
 		c = fprintf(f, "struct %s_q *", retname);
+	else if (STYPE_ISAGGR(sr->type))
+		c = fprintf(f, "int");
 	else
-		c = fprintf(f, "void");
+		c = fprintf(f, until ? "size_t" : "void");
 	if (c < 0)
 		return 0;
 
 	if (syn && fprintf(f, "\"\n"
-	    ".Fo db_%s_%s",
-	    sr->parent->name, get_stype_str(sr->type)) < 0)
+	    ".Fo db_%s_%s%s", sr->parent->name, 
+	    get_stype_str(sr->type), until ? "_until" : "") < 0)
 		return 0;
-	if (!syn && fprintf(f, "\" Fn db_%s_%s",
-	    sr->parent->name, get_stype_str(sr->type)) < 0)
+	if (!syn && fprintf(f, "\" Fn db_%s_%s%s", sr->parent->name,
+	    get_stype_str(sr->type), until ? "_until" : "") < 0)
 		return 0;
 
 	if (sr->name == NULL && !TAILQ_EMPTY(&sr->sntq)) {
@@ -444,12 +456,29 @@ gen_query(FILE *f, const struct search *sr, int syn)
 
 	if (sr->type == STYPE_ITERATE) {
 		if (syn && fprintf(f,
-		    ".Fa \"%s_cb cb\"\n"
-		    ".Fa \"void *arg\"\n", retname) < 0)
+		    ".Fa \"%s_%scb cb\"\n"
+		    ".Fa \"void *arg\"\n", retname, 
+		    until ? "until_" : "") < 0)
+			return 0;
+		if (!syn && fprintf(f, 
+		    "-\tcb\t%s_%scb\n"
+		    "-\targ\tvoid *\n", retname, 
+		    until ? "until_" : "") < 0)
+			return 0;
+	} else if (SEARCH_ISHISTO(sr)) {
+		if (syn && fputs(".Fa \"size_t *sz\"\n", f) == EOF)
+			return 0;
+		if (!syn && fputs("-\tsz\tsize_t *\n", f) == EOF)
+			return 0;
+	} else if (STYPE_ISAGGR(sr->type)) {
+		aggrt = sr->type == STYPE_AVG ||
+			TAILQ_FIRST(&sr->projq)->field->type ==
+			FTYPE_REAL ? "double" : "int64_t";
+		if (syn && fprintf(f,
+		    ".Fa \"%s *val\"\n", aggrt) < 0)
 			return 0;
 		if (!syn && fprintf(f, 
-		    "-\tcb\t%s_cb\n"
-		    "-\targ\tvoid *\n", retname) < 0)
+		    "-\tval\t%s *\n", aggrt) < 0)
 			return 0;
 	}
 
@@ -494,6 +523,12 @@ gen_query(FILE *f, const struct search *sr, int syn)
 			return 0;
 		if (sr->doc != NULL && !gen_doc_block(f, sr->doc, 0, 1))
 			return 0;
+		if (until && fputs(
+		    ".Pp\n"
+		    "Stops the iteration when the callback returns\n"
+		    "non-zero, returning the number of results passed to\n"
+		    "the callback.\n", f) == EOF)
+			return 0;
 		if (sr->rolemap) {
 			if (fputs(
 			    ".Pp\n"
@@ -508,6 +543,86 @@ gen_query(FILE *f, const struct search *sr, int syn)
 	return 1;
 }
 
+/*
+ * The multi-key lookup of a search with SEARCH_HAS_MANY.
+ * Return FALSE on failure, TRUE on success.
+ */
+static int
+gen_query_many(FILE *f, const struct search *sr, int syn)
+{
+	const struct field	*fd;
+	const struct sent	*sent;
+
+	sent = TAILQ_FIRST(&sr->sntq);
+	fd = sent->field;
+
+	if (fprintf(f, "%s\"struct %s **\"%sdb_%s_get_many",
+	    syn ? ".Ft " : ".It Ft ", sr->parent->name,
+	    syn ? "\n.Fo " : " Fn ", sr->parent->name) < 0)
+		return 0;
+	if (sr->name == NULL) {
+		if (fprintf(f, "_by_%s_%s", sent->uname,
+		    get_optype_str(sent->op)) < 0)
+			return 0;
+	} else if (fprintf(f, "_%s", sr->name) < 0)
+		return 0;
+
+	if (syn) {
+		if (fputs("\n"
+		    ".Fa \"struct ort *ort\"\n"
+		    ".Fa \"", f) == EOF)
+			return 0;
+	} else if (fputs("\n"
+	    ".TS\n"
+	    "l l l.\n"
+	    "-\tort\tstruct ort *\n"
+	    "-\tv1\t", f) == EOF)
+		return 0;
+
+	if (fd->type == FTYPE_TEXT || fd->type == FTYPE_EMAIL) {
+		if (fputs("const char *const *", f) == EOF)
+			return 0;
+	} else {
+		if (fputs("const ", f) == EOF)
+			return 0;
+		if (!gen_field_type(f, fd))
+			return 0;
+		if (fputs(" *", f) == EOF)
+			return 0;
+	}
+
+	if (syn)
+		return fputs(" v1\"\n"
+			".Fa \"size_t n\"\n"
+			".Fc\n", f) != EOF;
+
+	if (fprintf(f, "\n"
+	    "-\tn\tsize_t\n"
+	    ".TE\n"
+	    ".Pp\n"
+	    "Look up each of the\n"
+	    ".Fa n\n"
+	    "values of\n"
+	    ".Va %s\n"
+	    "in\n"
+	    ".Fa v1 ,\n"
+	    "returning an array of results in the same order, each\n"
+	    ".Dv NULL\n"
+	    "if not found.\n", fd->name) < 0)
+		return 0;
+	if (sr->rolemap) {
+		if (fputs(
+		    ".Pp\n"
+		    "Only allowed to the following:", f) == EOF)
+			return 0;
+		if (!gen_rolemap(f, sr->rolemap))
+			return 0;
+		if (fputs(" .\n", f) == EOF)
+			return 0;
+	}
+	return 1;
+}
+
 /*
  * Return FALSE on failure, TRUE on success.
  */
@@ -668,9 +783,16 @@ gen_queries(FILE *f, const struct config *cfg, int syn)
 		return 0;
 
 	TAILQ_FOREACH(s, &cfg->sq, entries)
-		TAILQ_FOREACH(sr, &s->sq, entries)
-			if (!gen_query(f, sr, syn))
+		TAILQ_FOREACH(sr, &s->sq, entries) {
+			if (!gen_query(f, sr, 0, syn))
 				return 0;
+			if ((sr->flags & SEARCH_HAS_UNTIL) &&
+			    !gen_query(f, sr, 1, syn))
+				return 0;
+			if ((sr->flags & SEARCH_HAS_MANY) &&
+			    !gen_query_many(f, sr, syn))
+				return 0;
+		}
 	
 	if (!syn && fputs(".El\n.Pp\n", f) == EOF)
 		return 0;
@@ -254,6 +254,28 @@ gen_role(FILE *f, const struct role *r)
 	return 1;
 }
 
+/*
+ * Set the "_filled" words of "obj" (e.g., "p." or "p->") to the columns
+ * of "p" read by search "s", or by the default schema if NULL.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_filled_set(FILE *f, size_t tabs, const char *obj,
+	const struct strct *p, const struct search *s)
+{
+	size_t	 i, j;
+
+	for (i = 0; i < gen_filled_words(p); i++) {
+		for (j = 0; j < tabs; j++)
+			if (fputc('\t', f) == EOF)
+				return 0;
+		if (fprintf(f, "%s_filled[%zu] = UINT64_C(0x%" PRIx64
+		    ");\n", obj, i, gen_filled(p, s, i)) < 0)
+			return 0;
+	}
+	return 1;
+}
+
 /*
  * Fill an individual field from the database in gen_fill().
  * Return zero on failure, non-zero on success.
@@ -477,11 +499,13 @@ gen_bind_hash(FILE *f, size_t pos, size_t hpos, size_t tabs)
 
 /*
  * Generate a search function for an STYPE_ITERATE.
+ * If "until" is non-zero, generate the variant whose callback returns
+ * non-zero to stop the iteration, returning the number of callbacks.
  * Return zero on failure, non-zero on success.
  */
 static int
 gen_iterator(FILE *f, const struct config *cfg,
-	const struct search *s, size_t num)
+	const struct search *s, size_t num, int until)
 {
 	const struct sent	*sent;
 	const struct strct 	*retstr;
@@ -499,7 +523,9 @@ gen_iterator(FILE *f, const struct config *cfg,
 
 	/* Emit top of the function w/optional static parameters. */
 
-	if (!gen_func_db_search(f, s, 0))
+	if (until && !gen_func_db_search_until(f, s, 0))
+		return 0;
+	if (!until && !gen_func_db_search(f, s, 0))
 		return 0;
 	if (fprintf(f, "\n"
   	    "{\n"
@@ -508,6 +534,9 @@ gen_iterator(FILE *f, const struct config *cfg,
 	    "\tstruct sqlbox *db = ctx->db;\n",
 	    retstr->name) < 0)
 		return 0;
+	if (until && fputs("\tsize_t n = 0;\n"
+	    "\tint stop;\n", f) == EOF)
+		return 0;
 	if (parms > 0 && fprintf(f,
 	    "\tstruct sqlbox_parm parms[%zu];\n", parms) < 0)
 		return 0;
@@ -545,6 +574,12 @@ gen_iterator(FILE *f, const struct config *cfg,
 	    parms > 0 ? "parms" : "NULL", retstr->name) < 0)
 		return 0;
 
+	/* Conditional marking of columns read by a select clause. */
+
+	if (gen_search_projected(s) &&
+	    !gen_filled_set(f, 2, "p.", s->parent, s))
+		return 0;
+
 	/* Conditional post-query null lookup. */
 
 	if ((retstr->flags & STRCT_HAS_NULLREFS) && fprintf(f,
@@ -576,13 +611,30 @@ gen_iterator(FILE *f, const struct config *cfg,
 		pos++;
 	}
 
-	return fprintf(f, "\t\t(*cb)(&p, arg);\n"
+	if (!until)
+		return fprintf(f, "\t\t(*cb)(&p, arg);\n"
+			"\t\tdb_%s_unfill_r(&p);\n"
+		       "\t}\n"
+		       "\tif (res == NULL)\n"
+		       "\t\texit(EXIT_FAILURE);\n"
+		       "\tif (!sqlbox_finalise(db, 0))\n"
+		       "\t\texit(EXIT_FAILURE);\n"
+		       "}\n"
+		       "\n", retstr->name) > 0;
+
+	/* Finalising mid-way discards the remaining rows. */
+
+	return fprintf(f, "\t\tn++;\n"
+		"\t\tstop = (*cb)(&p, arg);\n"
 		"\t\tdb_%s_unfill_r(&p);\n"
+		"\t\tif (stop)\n"
+		"\t\t\tbreak;\n"
 	       "\t}\n"
 	       "\tif (res == NULL)\n"
 	       "\t\texit(EXIT_FAILURE);\n"
 	       "\tif (!sqlbox_finalise(db, 0))\n"
 	       "\t\texit(EXIT_FAILURE);\n"
+	       "\treturn n;\n"
 	       "}\n"
 	       "\n", retstr->name) > 0;
 }
@@ -677,6 +729,12 @@ gen_list(FILE *f, const struct config *cfg,
 	    retstr->name, retstr->name) < 0)
 		return 0;
 
+	/* Conditional marking of columns read by a select clause. */
+
+	if (gen_search_projected(s) &&
+	    !gen_filled_set(f, 2, "p->", s->parent, s))
+		return 0;
+
 	/* Conditional post-query to fill null refs. */
 
 	if (retstr->flags & STRCT_HAS_NULLREFS && fprintf(f,
@@ -827,6 +885,28 @@ gen_roles(FILE *f, const struct config *cfg, const struct strct *p)
 			free(buf);
 		}
 
+	/* Lazy loads are as permissive as the unique lookups. */
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (!(fd->flags & FIELD_LAZY))
+			continue;
+		if (asprintf(&buf, "STMT_%s_LOAD_%s",
+		    p->name, fd->name) < 0)
+			return -1;
+		if (!gen_role_stmt_all(f, cfg, buf))
+			return -1;
+		shown++;
+		free(buf);
+		if (fd->type != FTYPE_BLOB)
+			continue;
+		if (asprintf(&buf, "STMT_%s_BLOB_SIZE_%s",
+		    p->name, fd->name) < 0)
+			return -1;
+		if (!gen_role_stmt_all(f, cfg, buf))
+			return -1;
+		free(buf);
+	}
+
 	/* Start with all query types. */
 
 	pos = 0;
@@ -847,6 +927,26 @@ gen_roles(FILE *f, const struct config *cfg, const struct strct *p)
 		free(buf);
 	}
 
+	/* Multi-key lookups share their search's roles. */
+
+	pos = 0;
+	TAILQ_FOREACH(s, &p->sq, entries) {
+		pos++;
+		if (s->rolemap == NULL || !(s->flags & SEARCH_HAS_MANY))
+			continue;
+		if (asprintf(&buf, "STMT_%s_BY_SEARCH_%zu_MANY",
+		    p->name, pos - 1) < 0)
+			return -1;
+		TAILQ_FOREACH(rs, &s->rolemap->rq, entries)
+			if (strcmp(rs->role->name, "all") == 0) {
+				if (!gen_role_stmt_all(f, cfg, buf))
+					return -1;
+			} else if (!gen_role_stmt(f, rs->role, buf))
+				return -1;
+		shown++;
+		free(buf);
+	}
+
 	/* Next: insertions. */
 
 	if (p->ins != NULL && p->ins->rolemap != NULL) {
@@ -862,6 +962,37 @@ gen_roles(FILE *f, const struct config *cfg, const struct strct *p)
 		free(buf);
 	}
 
+	/* Returning insertions share the insertion's roles. */
+
+	if (p->ins != NULL && p->ins->rolemap != NULL &&
+	    (p->ins->flags & INSERT_RETURNING)) {
+		if (asprintf(&buf, "STMT_%s_INSERT_RETURNING", 
+		    p->name) < 0)
+			return -1;
+		TAILQ_FOREACH(rs, &p->ins->rolemap->rq, entries)
+			if (strcmp(rs->role->name, "all") == 0) {
+				if (!gen_role_stmt_all(f, cfg, buf))
+					return -1;
+			} else if (!gen_role_stmt(f, rs->role, buf))
+				return -1;
+		free(buf);
+	}
+
+	/* Next: upserts. */
+
+	if (p->ups != NULL && p->ups->rolemap != NULL) {
+		if (asprintf(&buf, "STMT_%s_UPSERT", p->name) < 0)
+			return -1;
+		TAILQ_FOREACH(rs, &p->ups->rolemap->rq, entries)
+			if (strcmp(rs->role->name, "all") == 0) {
+				if (!gen_role_stmt_all(f, cfg, buf))
+					return -1;
+			} else if (!gen_role_stmt(f, rs->role, buf))
+				return -1;
+		shown++;
+		free(buf);
+	}
+
 	/* Next: updates. */
 
 	pos = 0;
@@ -880,6 +1011,18 @@ gen_roles(FILE *f, const struct config *cfg, const struct strct *p)
 				return -1;
 		shown++;
 		free(buf);
+		if (!(u->flags & UPDATE_RETURNING))
+			continue;
+		if (asprintf(&buf, "STMT_%s_UPDATE_%zu_RETURNING",
+		    p->name, pos - 1) < 0)
+			return -1;
+		TAILQ_FOREACH(rs, &u->rolemap->rq, entries)
+			if (strcmp(rs->role->name, "all") == 0) {
+				if (!gen_role_stmt_all(f, cfg, buf))
+					return -1;
+			} else if (!gen_role_stmt(f, rs->role, buf))
+				return -1;
+		free(buf);
 	}
 
 	/* Finally: deletions. */
@@ -1236,7 +1379,10 @@ gen_close(FILE *f, const struct config *cfg)
 }
 
 /*
- * Generate a query function for an STYPE_COUNT.
+ * Generate a query function for an STYPE_COUNT, STYPE_EXISTS, or any
+ * of the aggregates (STYPE_ISAGGR), all of which return a single column
+ * in a single row.
+ * Aggregates over no rows return NULL, which we report as failure.
  * Return zero on failure, non-zero on success.
  */
 static int
@@ -1245,7 +1391,12 @@ gen_count(FILE *f, const struct config *cfg,
 {
 	const struct sent	*sent;
 	size_t			 pos, parms = 0, idx;
-	int			 c;
+	int			 c, real = 0;
+
+	if (STYPE_ISAGGR(s->type))
+		real = s->type == STYPE_AVG || 
+			TAILQ_FIRST(&s->projq)->field->type == 
+			FTYPE_REAL;
 
 	/* Count all possible parameters to bind. */
 
@@ -1258,9 +1409,14 @@ gen_count(FILE *f, const struct config *cfg,
 		return 0;
 	if (fputs("\n"
 	    "{\n"
-	    "\tconst struct sqlbox_parmset *res;\n"
-	    "\tint64_t val;\n"
-	    "\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
+	    "\tconst struct sqlbox_parmset *res;\n", f) == EOF)
+		return 0;
+	if ((s->type == STYPE_COUNT || s->type == STYPE_EXISTS) && 
+	    fputs("\tint64_t val;\n", f) == EOF)
+		return 0;
+	if (STYPE_ISAGGR(s->type) && fputs("\tint rc = 0;\n", f) == EOF)
+		return 0;
+	if (fputs("\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
 		return 0;
 	if (parms > 0 && fprintf(f,
 	    "\tstruct sqlbox_parm parms[%zu];\n", parms) < 0)
@@ -1287,20 +1443,160 @@ gen_count(FILE *f, const struct config *cfg,
 
 	/* A single returned entry. */
 
-	return fprintf(f, "\n"
-		"\tif (!sqlbox_prepare_bind_async\n"
-		"\t    (db, 0, STMT_%s_BY_SEARCH_%zu, %zu, %s, 0))\n"
-		"\t	exit(EXIT_FAILURE);\n"
-		"\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
-		"\t\texit(EXIT_FAILURE);\n"
-		"\telse if (res->psz != 1)\n"
+	if (fprintf(f, "\n"
+	    "\tif (!sqlbox_prepare_bind_async\n"
+	    "\t    (db, 0, STMT_%s_BY_SEARCH_%zu, %zu, %s, 0))\n"
+	    "\t	exit(EXIT_FAILURE);\n"
+	    "\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\telse if (res->psz != 1)\n"
+	    "\t\texit(EXIT_FAILURE);\n", 
+	    s->parent->name, num, parms,
+	    parms > 0 ? "parms" : "NULL") < 0)
+		return 0;
+
+	if (s->type == STYPE_COUNT)
+		return fputs
+			("\tif (sqlbox_parm_int(&res->ps[0], &val) == -1)\n"
+			 "\t\texit(EXIT_FAILURE);\n"
+			 "\tsqlbox_finalise(db, 0);\n"
+			 "\treturn (uint64_t)val;\n"
+			 "}\n\n", f) != EOF;
+	if (s->type == STYPE_EXISTS)
+		return fputs
+			("\tif (sqlbox_parm_int(&res->ps[0], &val) == -1)\n"
+			 "\t\texit(EXIT_FAILURE);\n"
+			 "\tsqlbox_finalise(db, 0);\n"
+			 "\treturn val != 0;\n"
+			 "}\n\n", f) != EOF;
+
+	return fprintf(f, 
+		"\tif (res->ps[0].type != SQLBOX_PARM_NULL) {\n"
+		"\t\tif (%s(&res->ps[0], val) == -1)\n"
+		"\t\t\texit(EXIT_FAILURE);\n"
+		"\t\trc = 1;\n"
+		"\t}\n"
+		"\tsqlbox_finalise(db, 0);\n"
+		"\treturn rc;\n"
+		"}\n\n", real ? 
+		"sqlbox_parm_float" : "sqlbox_parm_int") > 0;
+}
+
+/*
+ * Generate a query function for a grouped count (SEARCH_ISHISTO),
+ * which returns an array of grouped values and their counts.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_histo(FILE *f, const struct config *cfg,
+	const struct search *s, size_t num)
+{
+	const struct sent	*sent;
+	const struct field	*fd = s->group->field;
+	size_t			 pos, parms = 0, idx;
+	int			 c;
+
+	TAILQ_FOREACH(sent, &s->sntq, entries)
+		if (OPTYPE_ISBINARY(sent->op))
+			parms += count_bind
+				(sent->field->type, sent->op);
+
+	if (!gen_func_db_search(f, s, 0))
+		return 0;
+	if (fputs("\n"
+	    "{\n"
+	    "\tconst struct sqlbox_parmset *res;\n"
+	    "\tstruct ", f) == EOF)
+		return 0;
+	if (gen_histo_name(f, s) < 0)
+		return 0;
+	if (fputs(" *p = NULL, *pp;\n"
+	    "\tint64_t tmpint;\n", f) == EOF)
+		return 0;
+	if (fd->type == FTYPE_REAL &&
+	    fputs("\tdouble tmpreal;\n", f) == EOF)
+		return 0;
+	if (fputs("\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
+		return 0;
+	if (parms > 0 && fprintf(f,
+	    "\tstruct sqlbox_parm parms[%zu];\n", parms) < 0)
+		return 0;
+	if (fputc('\n', f) == EOF)
+		return 0;
+
+	if (parms > 0 && fputs
+	    ("\tmemset(parms, 0, sizeof(parms));\n", f) == EOF)
+		return 0;
+
+	pos = idx = 1;
+	TAILQ_FOREACH(sent, &s->sntq, entries)
+		if (OPTYPE_ISBINARY(sent->op)) {
+			c = gen_bind_val(f, sent->field,
+				idx, pos, sent->op);
+			if (c < 0)
+				return 0;
+			idx += (size_t)c;
+			pos++;
+		}
+
+	if (fprintf(f, "\n"
+	    "\t*sz = 0;\n"
+	    "\tif (!sqlbox_prepare_bind_async\n"
+	    "\t    (db, 0, STMT_%s_BY_SEARCH_%zu,\n"
+	    "\t     %zu, %s, SQLBOX_STMT_MULTI))\n"
+	    "\t	exit(EXIT_FAILURE);\n"
+	    "\twhile ((res = sqlbox_step(db, 0)) != NULL "
+	    "&& res->psz) {\n"
+	    "\t\tif (res->psz != 2)\n"
+	    "\t\t\texit(EXIT_FAILURE);\n"
+	    "\t\tpp = realloc(p, (*sz + 1) * sizeof(*p));\n"
+	    "\t\tif (pp == NULL) {\n"
+	    "\t\t\tperror(NULL);\n"
+	    "\t\t\texit(EXIT_FAILURE);\n"
+	    "\t\t}\n"
+	    "\t\tp = pp;\n",
+	    s->parent->name, num, parms,
+	    parms > 0 ? "parms" : "NULL") < 0)
+		return 0;
+
+	if (fd->type == FTYPE_REAL) {
+		if (fputs("\t\tif (sqlbox_parm_float"
+		    "(&res->ps[0], &tmpreal) == -1)\n"
+		    "\t\t\texit(EXIT_FAILURE);\n"
+		    "\t\tp[*sz].value = tmpreal;\n", f) == EOF)
+			return 0;
+	} else {
+		if (fputs("\t\tif (sqlbox_parm_int"
+		    "(&res->ps[0], &tmpint) == -1)\n"
+		    "\t\t\texit(EXIT_FAILURE);\n", f) == EOF)
+			return 0;
+		if (fd->type == FTYPE_ENUM) {
+			if (fprintf(f, "\t\tp[*sz].value = "
+			    "(enum %s)tmpint;\n", fd->enm->name) < 0)
+				return 0;
+		} else if (fd->type == FTYPE_DATE ||
+		    fd->type == FTYPE_EPOCH) {
+			if (fputs("\t\tp[*sz].value = "
+			    "(time_t)tmpint;\n", f) == EOF)
+				return 0;
+		} else {
+			if (fputs("\t\tp[*sz].value = "
+			    "tmpint;\n", f) == EOF)
+				return 0;
+		}
+	}
+
+	return fputs("\t\tif (sqlbox_parm_int"
+		"(&res->ps[1], &tmpint) == -1)\n"
+		"\t\t\texit(EXIT_FAILURE);\n"
+		"\t\tp[(*sz)++].count = (uint64_t)tmpint;\n"
+		"\t}\n"
+		"\tif (res == NULL)\n"
 		"\t\texit(EXIT_FAILURE);\n"
-		"\tif (sqlbox_parm_int(&res->ps[0], &val) == -1)\n"
+		"\tif (!sqlbox_finalise(db, 0))\n"
 		"\t\texit(EXIT_FAILURE);\n"
-		"\tsqlbox_finalise(db, 0);\n"
-		"\treturn (uint64_t)val;\n"
-		"}\n\n", s->parent->name, num, parms,
-		parms > 0 ? "parms" : "NULL") > 0;
+		"\treturn p;\n"
+		"}\n\n", f) != EOF;
 }
 
 /*
@@ -1373,6 +1669,12 @@ gen_search(FILE *f, const struct config *cfg,
 	    retstr->name, retstr->name) < 0)
 		return 0;
 
+	/* Conditional marking of columns read by a select clause. */
+
+	if (gen_search_projected(s) &&
+	    !gen_filled_set(f, 2, "p->", s->parent, s))
+		return 0;
+
 	/* Conditional post-query reference lookup. */
 
 	if (retstr->flags & STRCT_HAS_NULLREFS && fprintf(f,
@@ -1413,6 +1715,160 @@ gen_search(FILE *f, const struct config *cfg,
 		"}\n\n", f) != EOF;
 }
 
+/*
+ * Generate the multi-key lookup for a search with SEARCH_HAS_MANY.
+ * Keys are bound in chunks of GEN_MANY_CHUNK, short chunks repeating
+ * the last key, and each returned row is matched back to the indices
+ * of the keys that requested it.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_search_many(FILE *f, const struct search *s, size_t num)
+{
+	const struct field	*fd;
+	const struct strct	*p = s->parent;
+
+	fd = TAILQ_FIRST(&s->sntq)->field;
+
+	if (!gen_func_db_search_many(f, s, 0))
+		return 0;
+	if (fprintf(f, "\n"
+	    "{\n"
+	    "\tstruct %s **ps, *p, *pp;\n"
+	    "\tconst struct sqlbox_parmset *res;\n"
+	    "\tstruct sqlbox *db = ctx->db;\n"
+	    "\tstruct sqlbox_parm parms[%d];\n"
+	    "\tsize_t i, j, sz;\n"
+	    "\tint found;\n"
+	    "\n"
+	    "\tif (n == 0)\n"
+	    "\t\treturn NULL;\n"
+	    "\tif ((ps = calloc(n, sizeof(struct %s *))) == NULL) {\n"
+	    "\t\tperror(NULL);\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\t}\n"
+	    "\n"
+	    "\tmemset(parms, 0, sizeof(parms));\n"
+	    "\tfor (i = 0; i < n; i += sz) {\n"
+	    "\t\tsz = n - i > %d ? %d : n - i;\n"
+	    "\t\tfor (j = 0; j < %d; j++) {\n",
+	    p->name, GEN_MANY_CHUNK, p->name, GEN_MANY_CHUNK, 
+	    GEN_MANY_CHUNK, GEN_MANY_CHUNK) < 0)
+		return 0;
+
+	/* Bind the key or, past the chunk, the chunk's last key. */
+
+	switch (fd->type) {
+	case FTYPE_DATE:
+	case FTYPE_EPOCH:
+		if (fprintf(f, "\t\t\tparms[j].iparm = (time_t)"
+		    "ORT_GETV_%s_%s\n"
+		    "\t\t\t\t(v1[i + (j < sz ? j : sz - 1)]);\n",
+		    p->name, fd->name) < 0)
+			return 0;
+		break;
+	case FTYPE_BIT:
+	case FTYPE_BITFIELD:
+	case FTYPE_INT:
+		if (fprintf(f, "\t\t\tparms[j].iparm = "
+		    "ORT_GETV_%s_%s\n"
+		    "\t\t\t\t(v1[i + (j < sz ? j : sz - 1)]);\n",
+		    p->name, fd->name) < 0)
+			return 0;
+		break;
+	default:
+		if (fprintf(f, "\t\t\tparms[j].%s = "
+		    "v1[i + (j < sz ? j : sz - 1)];\n",
+		    bindvars[fd->type]) < 0)
+			return 0;
+		break;
+	}
+
+	if (fprintf(f, 
+	    "\t\t\tparms[j].type = %s;\n"
+	    "\t\t}\n"
+	    "\t\tif (!sqlbox_prepare_bind_async(db, 0,\n"
+	    "\t\t    STMT_%s_BY_SEARCH_%zu_MANY, %d, parms,\n"
+	    "\t\t    SQLBOX_STMT_MULTI))\n"
+	    "\t\t\texit(EXIT_FAILURE);\n"
+	    "\t\twhile ((res = sqlbox_step(db, 0)) != NULL "
+	    "&& res->psz) {\n",
+	    bindtypes[fd->type], p->name, num, GEN_MANY_CHUNK) < 0)
+		return 0;
+	if (fprintf(f, 
+	    "\t\t\tp = malloc(sizeof(struct %s));\n"
+	    "\t\t\tif (p == NULL) {\n"
+	    "\t\t\t\tperror(NULL);\n"
+	    "\t\t\t\texit(EXIT_FAILURE);\n"
+	    "\t\t\t}\n"
+	    "\t\t\tdb_%s_fill_r(ctx, p, res, NULL);\n",
+	    p->name, p->name) < 0)
+		return 0;
+	if ((p->flags & STRCT_HAS_NULLREFS) && fprintf(f,
+	    "\t\t\tdb_%s_reffind(ctx, p);\n", p->name) < 0)
+		return 0;
+
+	/* 
+	 * Hand the row to each index with its key: the first gets the
+	 * row itself, duplicates get their own copy.
+	 * The copy is from the filled row, as the reffind may have run
+	 * other statements since reading the result.
+	 */
+
+	if (fputs("\t\t\tfound = 0;\n"
+	    "\t\t\tfor (j = i; j < i + sz; j++) {\n", f) == EOF)
+		return 0;
+
+	switch (fd->type) {
+	case FTYPE_BIT:
+	case FTYPE_BITFIELD:
+	case FTYPE_DATE:
+	case FTYPE_EPOCH:
+	case FTYPE_INT:
+		if (fprintf(f, "\t\t\t\tif (ORT_GET_%s_%s(p) !=\n"
+		    "\t\t\t\t    ORT_GETV_%s_%s(v1[j]))\n",
+		    p->name, fd->name, p->name, fd->name) < 0)
+			return 0;
+		break;
+	case FTYPE_ENUM:
+		if (fprintf(f, "\t\t\t\tif (p->%s != v1[j])\n",
+		    fd->name) < 0)
+			return 0;
+		break;
+	default:
+		if (fprintf(f, "\t\t\t\tif "
+		    "(strcmp(p->%s, v1[j]))\n", fd->name) < 0)
+			return 0;
+		break;
+	}
+
+	if (fputs("\t\t\t\t\tcontinue;\n"
+	    "\t\t\t\tif (found++ == 0) {\n"
+	    "\t\t\t\t\tps[j] = p;\n"
+	    "\t\t\t\t\tcontinue;\n"
+	    "\t\t\t\t}\n", f) == EOF)
+		return 0;
+	return fprintf(f, 
+		"\t\t\t\tpp = malloc(sizeof(struct %s));\n"
+		"\t\t\t\tif (pp == NULL) {\n"
+		"\t\t\t\t\tperror(NULL);\n"
+		"\t\t\t\t\texit(EXIT_FAILURE);\n"
+		"\t\t\t\t}\n"
+		"\t\t\t\tdb_%s_copy_r(pp, p);\n"
+		"\t\t\t\tps[j] = pp;\n"
+		"\t\t\t}\n"
+		"\t\t\tif (found == 0)\n"
+		"\t\t\t\tdb_%s_free(p);\n"
+		"\t\t}\n"
+		"\t\tif (res == NULL)\n"
+		"\t\t\texit(EXIT_FAILURE);\n"
+		"\t\tif (!sqlbox_finalise(db, 0))\n"
+		"\t\t\texit(EXIT_FAILURE);\n"
+		"\t}\n"
+		"\treturn ps;\n"
+		"}\n\n", p->name, p->name, p->name) > 0;
+}
+
 /*
  * Generate the "freeq" function.
  * This must have STRCT_HAS_QUEUE defined in its flags, otherwise the
@@ -1444,17 +1900,23 @@ gen_freeq(FILE *f, const struct strct *p)
 }
 
 /*
- * Generate the "insert" function.
- * If we don't have an insert, does nothing and return success.
+ * Generate the "insert" function or, if "ups" is non-zero, the "upsert"
+ * function, which binds the same parameters.
+ * If "ret" is non-zero, generate the insert variant returning the new
+ * row instead.
+ * If we don't have the operation, does nothing and return success.
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_insert(FILE *f, const struct config *cfg, const struct strct *p)
+gen_insert(FILE *f, const struct config *cfg,
+	const struct strct *p, int ups, int ret)
 {
 	const struct field	*fd;
 	size_t			 hpos, idx, parms = 0, tabs, pos;
 
-	if (p->ins == NULL)
+	if (ups ? p->ups == NULL : p->ins == NULL)
+		return 1;
+	if (ret && !(p->ins->flags & INSERT_RETURNING))
 		return 1;
 
 	/* Count non-struct non-rowid parameters to bind. */
@@ -1464,13 +1926,22 @@ gen_insert(FILE *f, const struct config *cfg, const struct strct *p)
 		    !(fd->flags & FIELD_ROWID))
 			parms++;
 
-	if (!gen_func_db_insert(f, p, 0))
+	if (ups ? !gen_func_db_upsert(f, p, 0) :
+	    ret ? !gen_func_db_insert_returning(f, p, 0) :
+	    !gen_func_db_insert(f, p, 0))
 		return 0;
-	if (fputs("\n"
-	    "{\n"
-	    "\tenum sqlbox_code rc;\n"
-	    "\tint64_t id = -1;\n"
-	    "\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
+	if (fputs("\n{\n", f) == EOF)
+		return 0;
+	if ((ups || ret) && fputs
+	    ("\tconst struct sqlbox_parmset *res;\n", f) == EOF)
+		return 0;
+	if (!ups && !ret && fputs("\tenum sqlbox_code rc;\n", f) == EOF)
+		return 0;
+	if (ret && fprintf(f, "\tstruct %s *p = NULL;\n", p->name) < 0)
+		return 0;
+	if (!ret && fputs("\tint64_t id = -1;\n", f) == EOF)
+		return 0;
+	if (fputs("\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
 		return 0;
 
 	if (parms > 0 && fprintf(f,
@@ -1552,6 +2023,59 @@ gen_insert(FILE *f, const struct config *cfg, const struct strct *p)
 	if (parms > 0 && fputc('\n', f) == EOF)
 		return 0;
 
+	/*
+	 * The upsert returns the row identifier of the inserted or
+	 * updated row, as sqlbox_lastid() isn't set by the update.
+	 * Constraint failures (other than the conflict target) leave
+	 * an empty result.
+	 */
+
+	if (ups)
+		return fprintf(f,
+			"\tif (!sqlbox_prepare_bind_async\n"
+			"\t    (db, 0, STMT_%s_UPSERT, %zu, %s,\n"
+			"\t     SQLBOX_STMT_CONSTRAINT))\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\tif (res->code == SQLBOX_CODE_OK && "
+			"res->psz == 1 &&\n"
+			"\t    sqlbox_parm_int(&res->ps[0], &id) == -1)\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\tif (!sqlbox_finalise(db, 0))\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\treturn id;\n"
+			"}\n\n", p->name, parms,
+			parms > 0 ? "parms" : "NULL") > 0;
+
+	/*
+	 * The returning variant fills the row from the statement's
+	 * result, which is empty on constraint failure.
+	 */
+
+	if (ret)
+		return fprintf(f,
+			"\tif (!sqlbox_prepare_bind_async\n"
+			"\t    (db, 0, STMT_%s_INSERT_RETURNING, %zu, %s,\n"
+			"\t     SQLBOX_STMT_CONSTRAINT))\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\tif (res->code == SQLBOX_CODE_OK && res->psz) {\n"
+			"\t\tp = malloc(sizeof(struct %s));\n"
+			"\t\tif (p == NULL) {\n"
+			"\t\t\tperror(NULL);\n"
+			"\t\t\texit(EXIT_FAILURE);\n"
+			"\t\t}\n"
+			"\t\tdb_%s_fill(ctx, p, res, NULL);\n"
+			"\t}\n"
+			"\tif (!sqlbox_finalise(db, 0))\n"
+			"\t\texit(EXIT_FAILURE);\n"
+			"\treturn p;\n"
+			"}\n\n", p->name, parms,
+			parms > 0 ? "parms" : "NULL",
+			p->name, p->name) > 0;
+
 	return fprintf(f,
 		"\trc = sqlbox_exec(db, 0, STMT_%s_INSERT, \n"
 		"\t     %zu, %s, SQLBOX_STMT_CONSTRAINT);\n"
@@ -1582,12 +2106,140 @@ gen_free(FILE *f, const struct strct *p)
 		"}\n\n", p->name) > 0;
 }
 
+/*
+ * Generate the on-demand reader of lazy field "fd", which has a
+ * structure with a rowid.
+ * The prior value is freed only when the row is found.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_load(FILE *f, const struct field *fd)
+{
+	const struct strct	*p = fd->parent;
+	size_t			 indent = 2;
+
+	assert(p->rowid != NULL);
+	assert(fd->type == FTYPE_BLOB || fd->type == FTYPE_TEXT);
+
+	if (!gen_func_db_load(f, fd, 0))
+		return 0;
+	if (fprintf(f, "\n"
+	    "{\n"
+	    "\tconst struct sqlbox_parmset *res;\n"
+	    "\tstruct sqlbox_parm parm;\n"
+	    "\tstruct sqlbox *db = ctx->db;\n"
+	    "\tint found = 0;\n"
+	    "\n"
+	    "\tmemset(&parm, 0, sizeof(struct sqlbox_parm));\n"
+	    "\tparm.type = SQLBOX_PARM_INT;\n"
+	    "\tparm.iparm = ORT_GET_%s_%s(p);\n"
+	    "\tif (!sqlbox_prepare_bind_async\n"
+	    "\t    (db, 0, STMT_%s_LOAD_%s, 1, &parm, 0))\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\tif (res->psz == 1) {\n"
+	    "\t\tfree(p->%s);\n"
+	    "\t\tp->%s = NULL;\n",
+	    p->name, p->rowid->name, p->name, fd->name,
+	    fd->name, fd->name) < 0)
+		return 0;
+
+	if (fd->type == FTYPE_BLOB &&
+	    fprintf(f, "\t\tp->%s_sz = 0;\n", fd->name) < 0)
+		return 0;
+
+	if (fd->flags & FIELD_NULL) {
+		if (!print_src(f, 2,
+		    "p->has_%s = res->ps[0].type != "
+		    "SQLBOX_PARM_NULL;\n"
+		    "if (p->has_%s) {", fd->name, fd->name))
+			return 0;
+		indent = 3;
+	}
+
+	if (fd->type == FTYPE_BLOB) {
+		if (!print_src(f, indent,
+		    "if (%s(&res->ps[0],\n"
+		    "    &p->%s, &p->%s_sz) == -1)\n"
+		    "\texit(EXIT_FAILURE);", coltypes[fd->type],
+		    fd->name, fd->name))
+			return 0;
+	} else {
+		if (!print_src(f, indent,
+		    "if (%s\n"
+		    "    (&res->ps[0], &p->%s, NULL) == -1)\n"
+		    "\texit(EXIT_FAILURE);",
+		    coltypes[fd->type], fd->name))
+			return 0;
+	}
+
+	if ((fd->flags & FIELD_NULL) && fputs("\t\t}\n", f) == EOF)
+		return 0;
+
+	if ((p->flags & STRCT_HAS_PROJ) && fprintf(f,
+	    "\t\tp->_filled[DB_FILLED_%s_%s / 64] |=\n"
+	    "\t\t    UINT64_C(1) << (DB_FILLED_%s_%s %% 64);\n",
+	    p->name, fd->name, p->name, fd->name) < 0)
+		return 0;
+
+	return fputs("\t\tfound = 1;\n"
+		"\t}\n"
+		"\tif (!sqlbox_finalise(db, 0))\n"
+		"\t\texit(EXIT_FAILURE);\n"
+		"\treturn found;\n"
+		"}\n\n", f) != EOF;
+}
+
+/*
+ * Generate the size reader of lazy blob field "fd", which has a
+ * structure with a rowid.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_blob(FILE *f, const struct field *fd)
+{
+	const struct strct	*p = fd->parent;
+
+	assert(p->rowid != NULL);
+	assert(fd->type == FTYPE_BLOB);
+
+	if (!gen_func_db_blob(f, fd, 0))
+		return 0;
+	return fprintf(f, "\n"
+	    "{\n"
+	    "\tconst struct sqlbox_parmset *res;\n"
+	    "\tstruct sqlbox_parm parm;\n"
+	    "\tstruct sqlbox *db = ctx->db;\n"
+	    "\tint found = -1;\n"
+	    "\n"
+	    "\tmemset(&parm, 0, sizeof(struct sqlbox_parm));\n"
+	    "\tparm.type = SQLBOX_PARM_INT;\n"
+	    "\tparm.iparm = id;\n"
+	    "\tif (!sqlbox_prepare_bind_async\n"
+	    "\t    (db, 0, STMT_%s_BLOB_SIZE_%s, 1, &parm, 0))\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\tif (res->psz == 1 &&\n"
+	    "\t    res->ps[0].type == SQLBOX_PARM_INT) {\n"
+	    "\t\t*sz = (size_t)res->ps[0].iparm;\n"
+	    "\t\tfound = 1;\n"
+	    "\t} else if (res->psz == 1)\n"
+	    "\t\tfound = 0;\n"
+	    "\tif (!sqlbox_finalise(db, 0))\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\treturn found;\n"
+	    "}\n\n", p->name, fd->name) > 0;
+}
+
 /*
  * Generate the "unfill" function.
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_unfill(FILE *f, const struct config *cfg, const struct strct *p)
+gen_unfill(FILE *f, const struct config *cfg,
+	const struct strct *p, int split)
 {
 	const struct field	*fd;
 
@@ -1598,11 +2250,12 @@ gen_unfill(FILE *f, const struct config *cfg, const struct strct *p)
 		return 0;
 
 	if (fprintf(f,
-  	    "static void\n"
+  	    "%svoid\n"
 	    "db_%s_unfill(struct %s *p)\n"
 	    "{\n"
 	    "\tif (p == NULL)\n"
-	    "\t\treturn;\n", p->name, p->name) < 0)
+	    "\t\treturn;\n", split ? "" : "static ",
+	    p->name, p->name) < 0)
 		return 0;
 
 	TAILQ_FOREACH(fd, &p->fq, entries)
@@ -1631,16 +2284,16 @@ gen_unfill(FILE *f, const struct config *cfg, const struct strct *p)
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_unfill_r(FILE *f, const struct strct *p)
+gen_unfill_r(FILE *f, const struct strct *p, int split)
 {
 	const struct field	*fd;
 
-	if (fprintf(f, "static void\n"
+	if (fprintf(f, "%svoid\n"
 	    "db_%s_unfill_r(struct %s *p)\n"
 	    "{\n"
 	    "\tif (p == NULL)\n"
 	    "\t\treturn;\n"
-	    "\tdb_%s_unfill(p);\n",
+	    "\tdb_%s_unfill(p);\n", split ? "" : "static ",
 	    p->name, p->name, p->name) < 0)
 		return 0;
 
@@ -1675,7 +2328,8 @@ gen_unfill_r(FILE *f, const struct strct *p)
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_reffind(FILE *f, const struct config *cfg, const struct strct *p)
+gen_reffind(FILE *f, const struct config *cfg,
+	const struct strct *p, int split)
 {
 	const struct field	*fd;
 
@@ -1692,11 +2346,11 @@ gen_reffind(FILE *f, const struct config *cfg, const struct strct *p)
 		    (fd->ref->source->flags & FIELD_NULL))
 			break;
 
-	if (fprintf(f, "static void\n"
+	if (fprintf(f, "%svoid\n"
 	    "db_%s_reffind(struct ort *ctx, struct %s *p)\n"
 	    "{\n"
 	    "\tstruct sqlbox *db = ctx->db;\n",
-	    p->name, p->name) < 0)
+	    split ? "" : "static ", p->name, p->name) < 0)
 		return 0;
 
 	if (fd != NULL && fputs
@@ -1750,11 +2404,12 @@ gen_reffind(FILE *f, const struct config *cfg, const struct strct *p)
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_fill_r(FILE *f, const struct config *cfg, const struct strct *p)
+gen_fill_r(FILE *f, const struct config *cfg,
+	const struct strct *p, int split)
 {
 	const struct field	*fd;
 
-	if (fprintf(f, "static void\n"
+	if (fprintf(f, "%svoid\n"
 	    "db_%s_fill_r(struct ort *ctx, struct %s *p,\n"
 	    "\tconst struct sqlbox_parmset *res, size_t *pos)\n"
 	    "{\n"
@@ -1762,7 +2417,7 @@ gen_fill_r(FILE *f, const struct config *cfg, const struct strct *p)
 	    "\n"
 	    "\tif (pos == NULL)\n"
 	    "\t\tpos = &i;\n"
-	    "\tdb_%s_fill(ctx, p, res, pos);\n",
+	    "\tdb_%s_fill(ctx, p, res, pos);\n", split ? "" : "static ",
 	    p->name, p->name, p->name) < 0)
 		return 0;
 
@@ -1778,12 +2433,127 @@ gen_fill_r(FILE *f, const struct config *cfg, const struct strct *p)
 	return fputs("}\n\n", f) != EOF;
 }
 
+/*
+ * See whether "p" is "q" or nested within it.
+ * Return zero if not, non-zero if so.
+ */
+static int
+strct_nests(const struct strct *q, const struct strct *p)
+{
+	const struct field	*fd;
+
+	if (q == p)
+		return 1;
+	TAILQ_FOREACH(fd, &q->fq, entries)
+		if (fd->type == FTYPE_STRUCT &&
+		    strct_nests(fd->ref->target->parent, p))
+			return 1;
+	return 0;
+}
+
+/*
+ * See whether "p" needs a copy_r function, which is when it's returned
+ * by (or nested in the results of) a multi-key lookup.
+ * Return zero if not, non-zero if so.
+ */
+static int
+need_copy_r(const struct config *cfg, const struct strct *p)
+{
+	const struct strct	*q;
+	const struct search	*s;
+
+	TAILQ_FOREACH(q, &cfg->sq, entries)
+		TAILQ_FOREACH(s, &q->sq, entries)
+			if ((s->flags & SEARCH_HAS_MANY) &&
+			    strct_nests(q, p))
+				return 1;
+	return 0;
+}
+
+/*
+ * Generate the recursive "copy" function, which deep-copies a filled
+ * structure into uninitialised storage.
+ * This is only generated if need_copy_r() says so.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_copy_r(FILE *f, const struct config *cfg,
+	const struct strct *p, int split)
+{
+	const struct field	*fd;
+
+	if (!need_copy_r(cfg, p))
+		return 1;
+
+	if (fprintf(f, "%svoid\n"
+	    "db_%s_copy_r(struct %s *dst, const struct %s *src)\n"
+	    "{\n"
+	    "\t*dst = *src;\n", split ? "" : "static ",
+	    p->name, p->name, p->name) < 0)
+		return 0;
+
+	TAILQ_FOREACH(fd, &p->fq, entries)
+		switch (fd->type) {
+		case FTYPE_BLOB:
+			if (fprintf(f, "\tif (src->%s != NULL) {\n"
+			    "\t\tdst->%s = malloc(src->%s_sz > 0 ?\n"
+			    "\t\t\tsrc->%s_sz : 1);\n"
+			    "\t\tif (dst->%s == NULL) {\n"
+			    "\t\t\tperror(NULL);\n"
+			    "\t\t\texit(EXIT_FAILURE);\n"
+			    "\t\t}\n"
+			    "\t\tmemcpy(dst->%s, src->%s, src->%s_sz);\n"
+			    "\t}\n", fd->name, fd->name, fd->name, 
+			    fd->name, fd->name, fd->name, fd->name, 
+			    fd->name) < 0)
+				return 0;
+			break;
+		case FTYPE_PASSWORD:
+		case FTYPE_TEXT:
+		case FTYPE_EMAIL:
+			if (fprintf(f, "\tif (src->%s != NULL &&\n"
+			    "\t    (dst->%s = strdup(src->%s)) == NULL) {\n"
+			    "\t\tperror(NULL);\n"
+			    "\t\texit(EXIT_FAILURE);\n"
+			    "\t}\n", fd->name, fd->name, fd->name) < 0)
+				return 0;
+			break;
+		case FTYPE_STRUCT:
+			if ((fd->ref->source->flags & FIELD_NULL) &&
+			    fprintf(f, "\tif (src->has_%s)\n\t",
+			    fd->name) < 0)
+				return 0;
+			if (fprintf(f, "\tdb_%s_copy_r"
+			    "(&dst->%s, &src->%s);\n",
+			    fd->ref->target->parent->name,
+			    fd->name, fd->name) < 0)
+				return 0;
+			break;
+		default:
+			break;
+		}
+
+	if (!TAILQ_EMPTY(&cfg->rq) && fputs
+	    ("\tif (src->priv_store != NULL) {\n"
+	     "\t\tdst->priv_store = malloc(sizeof(struct ort_store));\n"
+	     "\t\tif (dst->priv_store == NULL) {\n"
+	     "\t\t\tperror(NULL);\n"
+	     "\t\t\texit(EXIT_FAILURE);\n"
+	     "\t\t}\n"
+	     "\t\t*dst->priv_store = *src->priv_store;\n"
+	     "\t}\n", f) == EOF)
+		return 0;
+
+	return fputs("}\n\n", f) != EOF;
+}
+
 /*
  * Generate the "fill" function.
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_fill(FILE *f, const struct config *cfg, const struct strct *p)
+gen_fill(FILE *f, const struct config *cfg,
+	const struct strct *p, int split)
 {
 	const struct field	*fd;
 	int	 		 needint = 0;
@@ -1815,12 +2585,12 @@ gen_fill(FILE *f, const struct config *cfg, const struct strct *p)
 	    "This follows DB_SCHEMA_%s's order for columns.",
 	    p->name, p->name))
 		return 0;
-	if (fprintf(f, "static void\n"
+	if (fprintf(f, "%svoid\n"
 	    "db_%s_fill(struct ort *ctx, struct %s *p, "
 	    "const struct sqlbox_parmset *set, size_t *pos)\n"
 	    "{\n"
 	    "\tsize_t i = 0;\n",
-	    p->name, p->name) < 0)
+	    split ? "" : "static ", p->name, p->name) < 0)
 		return 0;
 	if (needint && fputs("\tint64_t tmpint;\n", f) == EOF)
 		return 0;
@@ -1829,6 +2599,9 @@ gen_fill(FILE *f, const struct config *cfg, const struct strct *p)
 	     "\t\tpos = &i;\n"
 	     "\tmemset(p, 0, sizeof(*p));\n", f) == EOF)
 		return 0;
+	if ((p->flags & STRCT_HAS_PROJ) &&
+	    !gen_filled_set(f, 1, "p->", p, NULL))
+		return 0;
 	TAILQ_FOREACH(fd, &p->fq, entries)
 		if (!gen_fill_field(f, fd))
 			return 0;
@@ -1848,11 +2621,13 @@ gen_fill(FILE *f, const struct config *cfg, const struct strct *p)
 
 /*
  * Generate an update or delete function.
+ * If "ret" is non-zero, this is the update variant returning the
+ * modified row.
  * Return zero on failure, non-zero on success.
  */
 static int
 gen_update(FILE *f, const struct config *cfg,
-	const struct update *up, size_t num)
+	const struct update *up, size_t num, int ret)
 {
 	const struct uref	*ref;
 	size_t	 		 pos, idx, hpos, parms = 0, tabs;
@@ -1872,12 +2647,19 @@ gen_update(FILE *f, const struct config *cfg,
 
 	/* Emit function prologue. */
 
-	if (!gen_func_db_update(f, up, 0))
+	if (ret ? !gen_func_db_update_returning(f, up, 0) :
+	    !gen_func_db_update(f, up, 0))
 		return 0;
-	if (fputs("\n"
-	    "{\n"
-	    "\tenum sqlbox_code c;\n"
-	    "\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
+	if (fputs("\n{\n", f) == EOF)
+		return 0;
+	if (ret && fprintf(f,
+	    "\tstruct %s *p = NULL;\n"
+	    "\tconst struct sqlbox_parmset *res;\n",
+	    up->parent->name) < 0)
+		return 0;
+	if (!ret && fputs("\tenum sqlbox_code c;\n", f) == EOF)
+		return 0;
+	if (fputs("\tstruct sqlbox *db = ctx->db;\n", f) == EOF)
 		return 0;
 	if (parms > 0 && fprintf
 	    (f, "\tstruct sqlbox_parm parms[%zu];\n", parms) < 0)
@@ -1974,7 +2756,31 @@ gen_update(FILE *f, const struct config *cfg,
 	if (fputc('\n', f) == EOF)
 		return 0;
 
-	if (up->type == UP_MODIFY) {
+	if (ret) {
+		if (fprintf(f, "\tif (!sqlbox_prepare_bind_async\n"
+		    "\t    (db, 0, STMT_%s_UPDATE_%zu_RETURNING, %zu, %s,\n"
+		    "\t     SQLBOX_STMT_CONSTRAINT))\n"
+		    "\t\texit(EXIT_FAILURE);\n"
+		    "\tif ((res = sqlbox_step(db, 0)) == NULL)\n"
+		    "\t\texit(EXIT_FAILURE);\n"
+		    "\tif (res->code == SQLBOX_CODE_OK && res->psz) {\n"
+		    "\t\tp = malloc(sizeof(struct %s));\n"
+		    "\t\tif (p == NULL) {\n"
+		    "\t\t\tperror(NULL);\n"
+		    "\t\t\texit(EXIT_FAILURE);\n"
+		    "\t\t}\n"
+		    "\t\tdb_%s_fill(ctx, p, res, NULL);\n"
+		    "\t}\n"
+		    "\tif (!sqlbox_finalise(db, 0))\n"
+		    "\t\texit(EXIT_FAILURE);\n"
+		    "\treturn p;\n"
+		    "}\n"
+		    "\n",
+		    up->parent->name, num, parms,
+		    parms > 0 ? "parms" : "NULL",
+		    up->parent->name, up->parent->name) < 0)
+			return 0;
+	} else if (up->type == UP_MODIFY) {
 		if (fprintf(f, "\tc = sqlbox_exec\n"
 		    "\t\t(db, 0, STMT_%s_UPDATE_%zu,\n"
 		    "\t\t %zu, %s, SQLBOX_STMT_CONSTRAINT);\n"
@@ -2680,6 +3486,9 @@ gen_json_out(FILE *f, const struct strct *p)
 /*
  * Generate all of the functions we've defined in our header for the
  * given structure "s".
+ * If "fq" is NULL, the structure is in its own translation unit: its
+ * internal functions are all emitted and not static, as other
+ * structures' units may call them.
  * Return zero on failure, non-zero on success.
  */
 static int
@@ -2690,29 +3499,47 @@ gen_functions(FILE *f, const struct config *cfg, const struct strct *p,
 	const struct search 	*s;
 	const struct update 	*u;
 	const struct filldep	*fd;
+	const struct field	*fld;
 	size_t	 		 pos;
+	int			 split;
 
-	fd = get_filldep(fq, p);
+	fd = fq != NULL ? get_filldep(fq, p) : NULL;
+	split = fq == NULL;
 
 	if (dbin) {
-		if (fd != NULL && !gen_fill(f, cfg, p))
+		if ((split || fd != NULL) && !gen_fill(f, cfg, p, split))
+			return 0;
+		if ((split || (fd != NULL &&
+		     (fd->need & FILLDEP_FILL_R))) &&
+		    !gen_fill_r(f, cfg, p, split))
 			return 0;
-		if (fd != NULL &&
-		   (fd->need & FILLDEP_FILL_R) &&
-		   !gen_fill_r(f, cfg, p))
+		if (!gen_unfill(f, cfg, p, split))
 			return 0;
-		if (!gen_unfill(f, cfg, p))
+		if (!gen_unfill_r(f, p, split))
 			return 0;
-		if (!gen_unfill_r(f, p))
+		if (!gen_copy_r(f, cfg, p, split))
 			return 0;
-		if (!gen_reffind(f, cfg, p))
+		if (!gen_reffind(f, cfg, p, split))
 			return 0;
 		if (!gen_free(f, p))
 			return 0;
 		if (!gen_freeq(f, p))
 			return 0;
-		if (!gen_insert(f, cfg, p))
+		if (!gen_insert(f, cfg, p, 0, 0))
+			return 0;
+		if (!gen_insert(f, cfg, p, 0, 1))
 			return 0;
+		if (!gen_insert(f, cfg, p, 1, 0))
+			return 0;
+		TAILQ_FOREACH(fld, &p->fq, entries) {
+			if (!(fld->flags & FIELD_LAZY))
+				continue;
+			if (!gen_load(f, fld))
+				return 0;
+			if (fld->type == FTYPE_BLOB &&
+			    !gen_blob(f, fld))
+				return 0;
+		}
 	}
 
 	if (json && !gen_json_out(f, p))
@@ -2726,24 +3553,43 @@ gen_functions(FILE *f, const struct config *cfg, const struct strct *p,
 		pos = 0;
 		TAILQ_FOREACH(s, &p->sq, entries)
 			if (s->type == STYPE_SEARCH) {
-				if (!gen_search(f, cfg, s, pos++))
+				if (!gen_search(f, cfg, s, pos))
+					return 0;
+				if ((s->flags & SEARCH_HAS_MANY) &&
+				    !gen_search_many(f, s, pos))
 					return 0;
+				pos++;
 			} else if (s->type == STYPE_LIST) {
 				if (!gen_list(f, cfg, s, pos++))
 					return 0;
-			} else if (s->type == STYPE_COUNT) {
+			} else if (SEARCH_ISHISTO(s)) {
+				if (!gen_histo(f, cfg, s, pos++))
+					return 0;
+			} else if (s->type == STYPE_COUNT ||
+			    s->type == STYPE_EXISTS ||
+			    STYPE_ISAGGR(s->type)) {
 				if (!gen_count(f, cfg, s, pos++))
 					return 0;
-			} else
-				if (!gen_iterator(f, cfg, s, pos++))
+			} else {
+				if (!gen_iterator(f, cfg, s, pos, 0))
+					return 0;
+				if ((s->flags & SEARCH_HAS_UNTIL) &&
+				    !gen_iterator(f, cfg, s, pos, 1))
 					return 0;
+				pos++;
+			}
 		pos = 0;
-		TAILQ_FOREACH(u, &p->uq, entries)
-			if (!gen_update(f, cfg, u, pos++))
+		TAILQ_FOREACH(u, &p->uq, entries) {
+			if (!gen_update(f, cfg, u, pos, 0))
+				return 0;
+			if ((u->flags & UPDATE_RETURNING) &&
+			    !gen_update(f, cfg, u, pos, 1))
 				return 0;
+			pos++;
+		}
 		pos = 0;
 		TAILQ_FOREACH(u, &p->dq, entries)
-			if (!gen_update(f, cfg, u, pos++))
+			if (!gen_update(f, cfg, u, pos++, 0))
 				return 0;
 	}
 
@@ -2795,6 +3641,7 @@ gen_valid(FILE *f, const struct strct *p)
  * This macro accepts a single parameter that's given to all of the
  * members so that a later SELECT can use INNER JOIN xxx AS yyy and have
  * multiple joins on the same table.
+ * Lazy columns are replaced by constants in the same position.
  * Return zero on failure, non-zero on success.
  */
 static int
@@ -2811,7 +3658,11 @@ gen_schema(FILE *f, const struct strct *p)
 			continue;
 		if (fprintf(f, "%s\n", s) < 0)
 			return 0;
-		if (fprintf(f, "\t#_x \".%s\"", fd->name) < 0)
+		if ((fd->flags & FIELD_LAZY) && fprintf(f, "\t\"%s\"",
+		    gen_sql_placeholder(fd, LANG_C)) < 0)
+			return 0;
+		if (!(fd->flags & FIELD_LAZY) &&
+		    fprintf(f, "\t#_x \".%s\"", fd->name) < 0)
 			return 0;
 		s = " \",\" \\";
 	}
@@ -2819,19 +3670,363 @@ gen_schema(FILE *f, const struct strct *p)
 	return fputc('\n', f) != EOF;
 }
 
+/*
+ * Emit the driver of ort_lang_c_explain(): it loads the schema into an
+ * in-memory database and runs EXPLAIN QUERY PLAN on each statement.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_explain_driver(FILE *f)
+{
+
+	if (fputs(
+	    "/*\n"
+	    " * Read all of \"fname\" into a NUL-terminated buffer.\n"
+	    " * Exits on failure.\n"
+	    " */\n"
+	    "static char *\n"
+	    "readall(const char *fname)\n"
+	    "{\n"
+	    "\tFILE\t*f;\n"
+	    "\tchar\t*buf = NULL;\n"
+	    "\tsize_t\t sz = 0, nr;\n"
+	    "\n"
+	    "\tif ((f = fopen(fname, \"r\")) == NULL) {\n"
+	    "\t\tperror(fname);\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\t}\n"
+	    "\tdo {\n"
+	    "\t\tif ((buf = realloc(buf, sz + BUFSIZ + 1)) == NULL) {\n"
+	    "\t\t\tperror(NULL);\n"
+	    "\t\t\texit(EXIT_FAILURE);\n"
+	    "\t\t}\n"
+	    "\t\tnr = fread(buf + sz, 1, BUFSIZ, f);\n"
+	    "\t\tsz += nr;\n"
+	    "\t} while (nr > 0);\n"
+	    "\tif (ferror(f)) {\n"
+	    "\t\tperror(fname);\n"
+	    "\t\texit(EXIT_FAILURE);\n"
+	    "\t}\n"
+	    "\tfclose(f);\n"
+	    "\tbuf[sz] = '\\0';\n"
+	    "\treturn buf;\n"
+	    "}\n\n", f) == EOF)
+		return 0;
+
+	if (fputs(
+	    "/*\n"
+	    " * Mark the statements named in the allow-list \"fname\", one per line,\n"
+	    " * as permitted to scan.\n"
+	    " * Blank lines and those beginning with \"#\" are ignored.\n"
+	    " */\n"
+	    "static void\n"
+	    "readallow(const char *fname, int *allowed)\n"
+	    "{\n"
+	    "\tchar\t*buf, *cp, *ln;\n"
+	    "\tsize_t\t i;\n"
+	    "\n"
+	    "\tbuf = readall(fname);\n"
+	    "\tfor (cp = buf; (ln = strsep(&cp, \"\\n\")) != NULL; ) {\n"
+	    "\t\tln[strcspn(ln, \" \\t\\r#\")] = '\\0';\n"
+	    "\t\tif (ln[0] == '\\0')\n"
+	    "\t\t\tcontinue;\n"
+	    "\t\tfor (i = 0; i < STMT__MAX; i++)\n"
+	    "\t\t\tif (strcmp(ln, stmtnames[i]) == 0)\n"
+	    "\t\t\t\tbreak;\n"
+	    "\t\tif (i == STMT__MAX)\n"
+	    "\t\t\tfprintf(stderr, \"%s: unknown \"\n"
+	    "\t\t\t\t\"statement: %s\\n\", fname, ln);\n"
+	    "\t\telse\n"
+	    "\t\t\tallowed[i] = 1;\n"
+	    "\t}\n"
+	    "\tfree(buf);\n"
+	    "}\n\n", f) == EOF)
+		return 0;
+
+	if (fputs(
+	    "int\n"
+	    "main(int argc, char *argv[])\n"
+	    "{\n"
+	    "\tsqlite3\t\t*db;\n"
+	    "\tsqlite3_stmt\t*stmt;\n"
+	    "\tconst char\t*detail, *verdict, *progname = argv[0];\n"
+	    "\tchar\t\t*schema, *sql;\n"
+	    "\tint\t\t c, scan, search, allowed[STMT__MAX];\n"
+	    "\tsize_t\t\t i, fails = 0;\n"
+	    "\n"
+	    "\tmemset(allowed, 0, sizeof(allowed));\n"
+	    "\n"
+	    "\twhile ((c = getopt(argc, argv, \"a:\")) != -1)\n"
+	    "\t\tswitch (c) {\n"
+	    "\t\tcase 'a':\n"
+	    "\t\t\treadallow(optarg, allowed);\n"
+	    "\t\t\tbreak;\n"
+	    "\t\tdefault:\n"
+	    "\t\t\tgoto usage;\n"
+	    "\t\t}\n"
+	    "\n"
+	    "\targc -= optind;\n"
+	    "\targv += optind;\n"
+	    "\tif (argc != 1)\n"
+	    "\t\tgoto usage;\n"
+	    "\n"
+	    "\tschema = readall(argv[0]);\n"
+	    "\tif (sqlite3_open(\":memory:\", &db) != SQLITE_OK) {\n"
+	    "\t\tfprintf(stderr, \"sqlite3_open: %s\\n\", \n"
+	    "\t\t\tsqlite3_errmsg(db));\n"
+	    "\t\treturn EXIT_FAILURE;\n"
+	    "\t}\n"
+	    "\tif (sqlite3_exec(db, schema, NULL, NULL, NULL) != SQLITE_OK) {\n"
+	    "\t\tfprintf(stderr, \"%s: %s\\n\", \n"
+	    "\t\t\targv[0], sqlite3_errmsg(db));\n"
+	    "\t\treturn EXIT_FAILURE;\n"
+	    "\t}\n"
+	    "\tfree(schema);\n"
+	    "\n"
+	    "\tfor (i = 0; i < STMT__MAX; i++) {\n"
+	    "\t\tsql = malloc(strlen(stmts[i]) + 20);\n"
+	    "\t\tif (sql == NULL) {\n"
+	    "\t\t\tperror(NULL);\n"
+	    "\t\t\treturn EXIT_FAILURE;\n"
+	    "\t\t}\n"
+	    "\t\tstrcpy(sql, \"EXPLAIN QUERY PLAN \");\n"
+	    "\t\tstrcat(sql, stmts[i]);\n"
+	    "\t\tif (sqlite3_prepare_v2(db, sql, \n"
+	    "\t\t    -1, &stmt, NULL) != SQLITE_OK) {\n"
+	    "\t\t\tfprintf(stderr, \"%s: %s\\n\", \n"
+	    "\t\t\t\tstmtnames[i], sqlite3_errmsg(db));\n"
+	    "\t\t\treturn EXIT_FAILURE;\n"
+	    "\t\t}\n"
+	    "\t\tfree(sql);\n"
+	    "\n"
+	    "\t\tscan = search = 0;\n"
+	    "\t\twhile (sqlite3_step(stmt) == SQLITE_ROW) {\n"
+	    "\t\t\tdetail = (const char *)\n"
+	    "\t\t\t\tsqlite3_column_text(stmt, 3);\n"
+	    "\t\t\tif (detail == NULL)\n"
+	    "\t\t\t\tcontinue;\n"
+	    "\t\t\tif (strncmp(detail, \"SCAN \", 5) == 0 &&\n"
+	    "\t\t\t    strcmp(detail, \"SCAN CONSTANT ROW\") != 0)\n"
+	    "\t\t\t\tscan = 1;\n"
+	    "\t\t\telse if (strncmp(detail, \"SEARCH \", 7) == 0)\n"
+	    "\t\t\t\tsearch = 1;\n"
+	    "\t\t}\n"
+	    "\t\tsqlite3_reset(stmt);\n"
+	    "\n"
+	    "\t\tverdict = scan ? \"SCAN\" : search ? \"SEARCH\" : \"NONE\";\n"
+	    "\t\tif (scan && allowed[i])\n"
+	    "\t\t\tprintf(\"%s: %s (allowed)\\n\", stmtnames[i], verdict);\n"
+	    "\t\telse\n"
+	    "\t\t\tprintf(\"%s: %s\\n\", stmtnames[i], verdict);\n"
+	    "\n"
+	    "\t\twhile (sqlite3_step(stmt) == SQLITE_ROW)\n"
+	    "\t\t\tif ((detail = (const char *)\n"
+	    "\t\t\t    sqlite3_column_text(stmt, 3)) != NULL)\n"
+	    "\t\t\t\tprintf(\"\\t%s\\n\", detail);\n"
+	    "\t\tsqlite3_finalize(stmt);\n"
+	    "\n"
+	    "\t\tif (scan && !allowed[i])\n"
+	    "\t\t\tfails++;\n"
+	    "\t}\n"
+	    "\n"
+	    "\tsqlite3_close(db);\n"
+	    "\n"
+	    "\tif (fails > 0) {\n"
+	    "\t\tfprintf(stderr, \"%zu statement(s) scan \"\n"
+	    "\t\t\t\"without being allowed\\n\", fails);\n"
+	    "\t\treturn EXIT_FAILURE;\n"
+	    "\t}\n"
+	    "\treturn EXIT_SUCCESS;\n"
+	    "usage:\n"
+	    "\tfprintf(stderr, \"usage: %s [-a allowlist] schema.sql\\n\", \n"
+	    "\t\tprogname);\n"
+	    "\treturn EXIT_FAILURE;\n"
+	    "}\n\n", f) == EOF)
+		return 0;
+
+	return 1;
+}
+
 int
-ort_lang_c_source(const struct ort_lang_c *args,
+ort_lang_c_explain(const struct ort_lang_c *args,
 	const struct config *cfg, FILE *f)
+{
+	const struct strct	*p;
+
+	if (!gen_commentv(f, 0, COMMENT_C,
+	    "WARNING: automatically generated by ort %s.\n"
+	    "DO NOT EDIT!", ORT_VERSION))
+		return 0;
+
+	if (fputs(
+	    "#ifndef _GNU_SOURCE\n"
+	    "# define _GNU_SOURCE\n"
+	    "#endif\n"
+	    "#ifndef _DEFAULT_SOURCE\n"
+	    "# define _DEFAULT_SOURCE\n"
+	    "#endif\n"
+	    "#include <stdio.h>\n"
+	    "#include <stdlib.h>\n"
+	    "#include <string.h>\n"
+	    "#include <unistd.h>\n\n"
+	    "#include <sqlite3.h>\n\n", f) == EOF)
+		return 0;
+
+	/* The same statements as generated by ort_lang_c_source(). */
+
+	if (fputs("enum\tstmt {\n", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (!gen_sql_enums(f, 1, p, LANG_C))
+			return 0;
+	if (fputs("\tSTMT__MAX\n};\n\n", f) == EOF)
+		return 0;
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (!gen_schema(f, p))
+			return 0;
+	if (fputc('\n', f) == EOF)
+		return 0;
+
+	if (fputs("static\tconst char "
+	    "*const stmts[STMT__MAX] = {\n", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (!gen_sql_stmts(f, 1, p, LANG_C))
+			return 0;
+	if (fputs("};\n\n", f) == EOF)
+		return 0;
+
+	if (fputs("static\tconst char "
+	    "*const stmtnames[STMT__MAX] = {\n", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (!gen_sql_enum_names(f, 1, p))
+			return 0;
+	if (fputs("};\n\n", f) == EOF)
+		return 0;
+
+	return gen_explain_driver(f);
+}
+
+/*
+ * Which part of the output is being generated.
+ */
+enum	srcpart {
+	SRC_ALL, /* single file */
+	SRC_COMMON, /* split: all but structure functions */
+	SRC_STRCT /* split: one structure's functions */
+};
+
+/*
+ * Arguments to gen_functions() shared by all structures.
+ */
+struct	genfuncs {
+	const struct config	*cfg;
+	const struct filldepq	*fq;
+	int			 json;
+	int			 jsonparse;
+	int			 valids;
+	int			 dbin;
+};
+
+/*
+ * Adapt gen_functions() to gen_each_strct().
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_functions_strct(FILE *f, const struct strct *p, void *arg)
+{
+	const struct genfuncs	*gf = arg;
+
+	return gen_functions(f, gf->cfg, p, gf->json,
+		gf->jsonparse, gf->valids, gf->dbin, gf->fq);
+}
+
+/*
+ * Declare the internal functions of all structures, which are defined
+ * in the structures' own translation units when splitting output.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_internal_protos(FILE *f, const struct config *cfg)
+{
+	const struct strct	*p;
+
+	if (!gen_comment(f, 0, COMMENT_C,
+	    "Internal functions shared between each structure's "
+	    "source file."))
+		return 0;
+
+	TAILQ_FOREACH(p, &cfg->sq, entries) {
+		if (fprintf(f,
+		    "void db_%s_fill(struct ort *, struct %s *, "
+		     "const struct sqlbox_parmset *, size_t *);\n"
+		    "void db_%s_fill_r(struct ort *, struct %s *, "
+		     "const struct sqlbox_parmset *, size_t *);\n"
+		    "void db_%s_unfill(struct %s *);\n"
+		    "void db_%s_unfill_r(struct %s *);\n",
+		    p->name, p->name, p->name, p->name,
+		    p->name, p->name, p->name, p->name) < 0)
+			return 0;
+		if ((p->flags & STRCT_HAS_NULLREFS) && fprintf(f,
+		    "void db_%s_reffind(struct ort *, struct %s *);\n",
+		    p->name, p->name) < 0)
+			return 0;
+		if (need_copy_r(cfg, p) && fprintf(f,
+		    "void db_%s_copy_r(struct %s *, "
+		     "const struct %s *);\n",
+		    p->name, p->name, p->name) < 0)
+			return 0;
+	}
+
+	return fputc('\n', f) != EOF;
+}
+
+/*
+ * Emit the JSMN implementation "jsmn".
+ * When splitting output, its public functions go into the shared file
+ * and only the static number parsers following them, which are used by
+ * the structures' JSON parsers, into each structure's file.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_jsmn(FILE *f, const char *jsmn, enum srcpart part)
+{
+	const char	*cp;
+	size_t		 sz;
+
+	if (part == SRC_ALL)
+		return fprintf(f, "%s\n", jsmn) >= 0;
+
+	cp = strstr(jsmn, "static int\njsmn_parse_real");
+	if (cp == NULL)
+		cp = strchr(jsmn, '\0');
+
+	if (part == SRC_STRCT)
+		return fprintf(f, "%s\n", cp) >= 0;
+
+	sz = (size_t)(cp - jsmn);
+	if (fwrite(jsmn, 1, sz, f) != sz)
+		return 0;
+	return fputc('\n', f) != EOF;
+}
+
+/*
+ * Emit everything preceding the functions: headers, the statements,
+ * the "ort" context, and the validation array.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_prelude(const struct ort_lang_c *args,
+	const struct config *cfg, FILE *f, enum srcpart part)
 {
 	const struct strct 	*p;
-	const struct search	*s;
 	const char		*start, *cp;
 	size_t			 sz;
 	int			 need_kcgi = 0,
 				 need_kcgijson = 0,
 				 need_sqlbox = 0;
-	struct filldepq		 fq;
-	struct filldep		*fd;
 
 	if (!gen_commentv(f, 0, COMMENT_C,
 	    "WARNING: automatically generated by ort %s.\n"
@@ -2948,7 +4143,7 @@ ort_lang_c_source(const struct ort_lang_c *args,
 	}
 
 	if ((args->flags & ORT_LANG_C_JSON_JSMN) &&
-	    fprintf(f, "%s\n", args->ext_jsmn) < 0)
+	    !gen_jsmn(f, args->ext_jsmn, part))
 		return 0;
 
 	if (args->flags & ORT_LANG_C_DB_SQLBOX) {
@@ -3016,23 +4211,33 @@ ort_lang_c_source(const struct ort_lang_c *args,
 		if (fputc('\n', f) == EOF)
 			return 0;
 
-		if (!gen_comment(f, 0, COMMENT_C,
-		    "Our full set of SQL statements.\n"
-		    "We define these beforehand because "
-		    "that's how sqlbox(3) handles statement "
-		    "generation.\n"
-		    "Notice the \"AS\" part: this allows "
-		    "for multiple inner joins without "
-		    "ambiguity."))
-			return 0;
-		if (fputs("static\tconst char "
-		    "*const stmts[STMT__MAX] = {\n", f) == EOF)
-			return 0;
-		TAILQ_FOREACH(p, &cfg->sq, entries)
-			if (!gen_sql_stmts(f, 1, p, LANG_C))
+		/* 
+		 * Statements are only used when opening, so a structure
+		 * on its own instead needs the others' internals.
+		 */
+
+		if (part == SRC_STRCT) {
+			if (!gen_internal_protos(f, cfg))
 				return 0;
-		if (fputs("};\n\n", f) == EOF)
-			return 0;
+		} else {
+			if (!gen_comment(f, 0, COMMENT_C,
+			    "Our full set of SQL statements.\n"
+			    "We define these beforehand because "
+			    "that's how sqlbox(3) handles statement "
+			    "generation.\n"
+			    "Notice the \"AS\" part: this allows "
+			    "for multiple inner joins without "
+			    "ambiguity."))
+				return 0;
+			if (fputs("static\tconst char "
+			    "*const stmts[STMT__MAX] = {\n", f) == EOF)
+				return 0;
+			TAILQ_FOREACH(p, &cfg->sq, entries)
+				if (!gen_sql_stmts(f, 1, p, LANG_C))
+					return 0;
+			if (fputs("};\n\n", f) == EOF)
+				return 0;
+		}
 	}
 
 	/*
@@ -3041,7 +4246,7 @@ ort_lang_c_source(const struct ort_lang_c *args,
 	 * All of the functions have been defined in the header file.
 	 */
 
-	if (args->flags & ORT_LANG_C_VALID_KCGI) {
+	if ((args->flags & ORT_LANG_C_VALID_KCGI) && part != SRC_STRCT) {
 		if (fputs("const struct kvalid "
 		    "valid_keys[VALID__MAX] = {\n", f) == EOF)
 			return 0;
@@ -3059,20 +4264,48 @@ ort_lang_c_source(const struct ort_lang_c *args,
 	    "All of the non-static functions are documented "
 	    "in the associated header file."))
 		return 0;
-	if (fputc('\n', f) == EOF)
+	return fputc('\n', f) != EOF;
+}
+
+/*
+ * Emit the functions not specific to any structure.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_common(const struct ort_lang_c *args,
+	const struct config *cfg, FILE *f)
+{
+
+	if (!(args->flags & ORT_LANG_C_DB_SQLBOX))
+		return 1;
+	if (!gen_transactions(f, cfg))
+		return 0;
+	if (!gen_open(f, cfg))
+		return 0;
+	if (!gen_close(f, cfg))
+		return 0;
+	if (!TAILQ_EMPTY(&cfg->rq) &&
+	    !gen_func_role_transitions(f, cfg))
 		return 0;
+	return 1;
+}
 
-	if (args->flags & ORT_LANG_C_DB_SQLBOX) {
-		if (!gen_transactions(f, cfg))
-			return 0;
-		if (!gen_open(f, cfg))
-			return 0;
-		if (!gen_close(f, cfg))
-			return 0;
-		if (!TAILQ_EMPTY(&cfg->rq) &&
-		    !gen_func_role_transitions(f, cfg))
-			return 0;
-	}
+int
+ort_lang_c_source(const struct ort_lang_c *args,
+	const struct config *cfg, FILE *f)
+{
+	const struct strct 	*p;
+	const struct search	*s;
+	const struct update	*u;
+	struct filldepq		 fq;
+	struct filldep		*fd;
+	struct genfuncs		 gf;
+	int			 rc;
+
+	if (!gen_prelude(args, cfg, f, SRC_ALL))
+		return 0;
+	if (!gen_common(args, cfg, f))
+		return 0;
 
 	/*
 	 * Before we generate our functions, we need to decide which
@@ -3089,18 +4322,58 @@ ort_lang_c_source(const struct ort_lang_c *args,
 			if (!gen_filldep(&fq, p, FILLDEP_FILL_R))
 				return 0;
 
-	TAILQ_FOREACH(p, &cfg->sq, entries)
-		gen_functions(f, cfg, p,
-			args->flags & ORT_LANG_C_JSON_KCGI,
-			args->flags & ORT_LANG_C_JSON_JSMN,
-			args->flags & ORT_LANG_C_VALID_KCGI,
-			args->flags & ORT_LANG_C_DB_SQLBOX, &fq);
+	/* Returning operations only fill the (reference-less) row. */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries) {
+		if (p->ins != NULL &&
+		    (p->ins->flags & INSERT_RETURNING) &&
+		    !gen_filldep(&fq, p, 0))
+			return 0;
+		TAILQ_FOREACH(u, &p->uq, entries)
+			if ((u->flags & UPDATE_RETURNING) &&
+			    !gen_filldep(&fq, p, 0))
+				return 0;
+	}
+
+	/* Each structure's functions are independent of the others. */
+
+	gf.cfg = cfg;
+	gf.fq = &fq;
+	gf.json = args->flags & ORT_LANG_C_JSON_KCGI;
+	gf.jsonparse = args->flags & ORT_LANG_C_JSON_JSMN;
+	gf.valids = args->flags & ORT_LANG_C_VALID_KCGI;
+	gf.dbin = args->flags & ORT_LANG_C_DB_SQLBOX;
+
+	rc = gen_each_strct(f, cfg, args->jobs, gen_functions_strct, &gf);
 
 	while ((fd = TAILQ_FIRST(&fq)) != NULL) {
 		TAILQ_REMOVE(&fq, fd, entries);
 		free(fd);
 	}
 
-	return 1;
+	return rc;
 }
 
+int
+ort_lang_c_source_common(const struct ort_lang_c *args,
+	const struct config *cfg, FILE *f)
+{
+
+	if (!gen_prelude(args, cfg, f, SRC_COMMON))
+		return 0;
+	return gen_common(args, cfg, f);
+}
+
+int
+ort_lang_c_source_strct(const struct ort_lang_c *args,
+	const struct config *cfg, const struct strct *p, FILE *f)
+{
+
+	if (!gen_prelude(args, cfg, f, SRC_STRCT))
+		return 0;
+	return gen_functions(f, cfg, p,
+		args->flags & ORT_LANG_C_JSON_KCGI,
+		args->flags & ORT_LANG_C_JSON_JSMN,
+		args->flags & ORT_LANG_C_VALID_KCGI,
+		args->flags & ORT_LANG_C_DB_SQLBOX, NULL);
+}
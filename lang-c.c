@@ -35,6 +35,11 @@ static	const char *const stypes[STYPE__MAX] = {
 	"get", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static	const char *const utypes[UP__MAX] = {
@@ -323,13 +328,12 @@ print_var(FILE *f, size_t pos, size_t col,
 }
 
 /*
- * Generate the db_xxxx_update function header.
- * If "decl" is non-zero, this is the declaration; otherwise, the
- * definition header.
+ * Generate the db_xxxx_update function header, or if "ret" is
+ * non-zero, the variant returning the modified row.
  * Return zero on failure, non-zero on success.
  */
-int
-gen_func_db_update(FILE *f, const struct update *u, int decl)
+static int
+gen_func_db_update_op(FILE *f, const struct update *u, int ret, int decl)
 {
 	const struct uref	*ur;
 	size_t			 pos = 1, col = 0, sz;
@@ -340,7 +344,12 @@ gen_func_db_update(FILE *f, const struct update *u, int decl)
 
 	/* Start with return value. */
 
-	if (!decl) {
+	if (ret) {
+		if ((rc = fprintf(f, "struct %s *%s", 
+		    u->parent->name, decl ? "" : "\n")) < 0)
+			return 0;
+		col = decl ? (size_t)rc : 0;
+	} else if (!decl) {
 		if (fprintf(f, "%s\n", type) < 0)
 			return 0;
 	} else {
@@ -400,6 +409,12 @@ gen_func_db_update(FILE *f, const struct update *u, int decl)
 		sz += (size_t)rc;
 	}
 
+	if (ret) {
+		if (fputs("_returning", f) == EOF)
+			return 0;
+		sz += 10;
+	}
+
 	if ((col += sz) >= 72) {
 		if (fputs("\n    ", f) == EOF)
 			return 0;
@@ -430,20 +445,185 @@ gen_func_db_update(FILE *f, const struct update *u, int decl)
 	return fprintf(f, ")%s", decl ? ";\n" : "") > 0;
 }
 
+/*
+ * Generate the db_xxxx_update function header.
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_update(FILE *f, const struct update *u, int decl)
+{
+
+	return gen_func_db_update_op(f, u, 0, decl);
+}
+
+/*
+ * Generate the db_xxxx_update_yyyy_returning function header, which has
+ * the same arguments as the update but returns the modified row.
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_update_returning(FILE *f, const struct update *u, int decl)
+{
+
+	return gen_func_db_update_op(f, u, 1, decl);
+}
+
 /*
  * Generate the db_xxxx_{count,get,list,iterate} function header.
  * If "decl" is non-zero, this is the declaration; otherwise, the
  * definition header.
  * Return zero on failure, non-zero on success.
  */
+/*
+ * Print the part of a query function's name following the query type,
+ * i.e., the "_by_xxx_op" terms or the "_name".
+ * Return the number of bytes printed or <0 on failure.
+ */
+static int
+gen_search_suffix(FILE *f, const struct search *s)
+{
+	const struct sent	*sent;
+	int			 rc, sz = 0;
+
+	if (s->name == NULL && !TAILQ_EMPTY(&s->sntq)) {
+		if (fputs("_by", f) == EOF)
+			return -1;
+		sz += 3;
+		TAILQ_FOREACH(sent, &s->sntq, entries) {
+			rc = fprintf(f, "_%s_%s", 
+				sent->uname, optypes[sent->op]);
+			if (rc < 0)
+				return -1;
+			sz += rc;
+		}
+	} else if (s->name != NULL) {
+		if ((rc = fprintf(f, "_%s", s->name)) < 0)
+			return -1;
+		sz += rc;
+	}
+
+	return sz;
+}
+
+/*
+ * Generate the name of the structure returned by a grouped count,
+ * which is the query function's name without the "db_".
+ * Return the number of bytes printed or <0 on failure.
+ */
 int
-gen_func_db_search(FILE *f, const struct search *s, int decl)
+gen_histo_name(FILE *f, const struct search *s)
+{
+	int	 rc, sz;
+
+	assert(SEARCH_ISHISTO(s));
+	if ((rc = fprintf(f, "%s_%s", 
+	    s->parent->name, stypes[s->type])) < 0)
+		return -1;
+	if ((sz = gen_search_suffix(f, s)) < 0)
+		return -1;
+	return rc + sz;
+}
+
+/*
+ * Generate the structure returned by a grouped count.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_struct_db_histo(FILE *f, const struct search *s)
+{
+	const struct field	*fd = s->group->field;
+
+	if (fputs("struct ", f) == EOF)
+		return 0;
+	if (gen_histo_name(f, s) < 0)
+		return 0;
+	if (fputs(" {\n\t", f) == EOF)
+		return 0;
+	if (fd->type == FTYPE_ENUM) {
+		if (fprintf(f, "enum %s ", fd->enm->name) < 0)
+			return 0;
+	} else {
+		assert(ftypes[fd->type] != NULL);
+		if (fputs(ftypes[fd->type], f) == EOF)
+			return 0;
+	}
+	return fputs("value;\n"
+		"\tuint64_t count;\n"
+		"};\n", f) != EOF;
+}
+
+/*
+ * Generate the function header of the multi-key lookup of a search
+ * with SEARCH_HAS_MANY.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_search_many(FILE *f, const struct search *s, int decl)
+{
+	const struct field	*fd, *rfd;
+	int			 rc, col;
+
+	assert(s->flags & SEARCH_HAS_MANY);
+	fd = TAILQ_FIRST(&s->sntq)->field;
+
+	if ((col = fprintf(f, "struct %s **", s->parent->name)) < 0)
+		return 0;
+	if (!decl) {
+		if (fputc('\n', f) == EOF)
+			return 0;
+		col = 0;
+	}
+	if ((rc = fprintf(f, "db_%s_get_many", s->parent->name)) < 0)
+		return 0;
+	col += rc;
+	if ((rc = gen_search_suffix(f, s)) < 0)
+		return 0;
+	if ((col += rc) >= 40 && fputs("\n    ", f) == EOF)
+		return 0;
+	if (fputs("(struct ort *ctx, ", f) == EOF)
+		return 0;
+
+	switch (fd->type) {
+	case FTYPE_ENUM:
+		rc = fprintf(f, "const enum %s *", fd->enm->name);
+		break;
+	case FTYPE_EMAIL:
+	case FTYPE_TEXT:
+		rc = fprintf(f, "const char *const *");
+		break;
+	default:
+		rfd = fd->ref != NULL ? fd->ref->target : fd;
+		rc = fprintf(f, "const %s_%s *",
+			rfd->parent->name, rfd->name);
+		break;
+	}
+	if (rc < 0)
+		return 0;
+
+	return fprintf(f, "v1, size_t n)%s", decl ? ";\n" : "") > 0;
+}
+
+/*
+ * Generate the function header of a query.
+ * If "until" is non-zero, this is the variant of an STYPE_ITERATE
+ * whose callback may stop the iteration.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_func_db_search_op(FILE *f, const struct search *s, int until,
+	int decl)
 {
 	const struct sent	*sent;
 	const struct strct	*retstr;
 	size_t			 pos = 1, col = 0, sz = 0;
 	int			 rc;
 
+	assert(!until || s->type == STYPE_ITERATE);
+
 	/* 
 	 * If we have a "distinct" clause, we use that to generate
 	 * responses, not the structure itself.
@@ -453,12 +633,22 @@ gen_func_db_search(FILE *f, const struct search *s, int decl)
 
 	/* Start with return value. */
 
-	if (s->type == STYPE_SEARCH)
+	if (SEARCH_ISHISTO(s)) {
+		if (fputs("struct ", f) == EOF)
+			return 0;
+		if ((rc = gen_histo_name(f, s)) < 0)
+			return 0;
+		if (fputs(" *", f) == EOF)
+			return 0;
+		rc += 9;
+	} else if (s->type == STYPE_SEARCH)
 		rc = fprintf(f, "struct %s *", retstr->name);
 	else if (s->type == STYPE_LIST)
 		rc = fprintf(f, "struct %s_q *", retstr->name);
 	else if (s->type == STYPE_ITERATE)
-		rc = fprintf(f, "void");
+		rc = fprintf(f, until ? "size_t" : "void");
+	else if (STYPE_ISAGGR(s->type) || s->type == STYPE_EXISTS)
+		rc = fprintf(f, "int");
 	else
 		rc = fprintf(f, "uint64_t");
 
@@ -470,7 +660,8 @@ gen_func_db_search(FILE *f, const struct search *s, int decl)
 		if (fputc('\n', f) == EOF)
 			return 0;
 		col = 0;
-	} else if (s->type != STYPE_SEARCH && s->type != STYPE_LIST) {
+	} else if (s->type != STYPE_SEARCH && s->type != STYPE_LIST &&
+	    !SEARCH_ISHISTO(s)) {
 		if (fputc(' ', f) == EOF)
 			return 0;
 		col++;
@@ -478,26 +669,14 @@ gen_func_db_search(FILE *f, const struct search *s, int decl)
 
 	/* Now function name. */
 
-	rc = fprintf(f, "db_%s_%s", s->parent->name, stypes[s->type]);
+	rc = fprintf(f, "db_%s_%s%s", s->parent->name, 
+		stypes[s->type], until ? "_until" : "");
 	if (rc < 0)
 		return 0;
 	sz += (size_t)rc;
-	if (s->name == NULL && !TAILQ_EMPTY(&s->sntq)) {
-		if (fputs("_by", f) == EOF)
-			return 0;
-		sz += 3;
-		TAILQ_FOREACH(sent, &s->sntq, entries) {
-			rc = fprintf(f, "_%s_%s", 
-				sent->uname, optypes[sent->op]);
-			if (rc < 0)
-				return 0;
-			sz += (size_t)rc;
-		}
-	} else if (s->name != NULL) {
-		if ((rc = fprintf(f, "_%s", s->name)) < 0)
-			return 0;
-		sz += (size_t)rc;
-	}
+	if ((rc = gen_search_suffix(f, s)) < 0)
+		return 0;
+	sz += (size_t)rc;
 
 	if ((col += sz) >= 72) {
 		if (fputs("\n    ", f) == EOF)
@@ -512,8 +691,20 @@ gen_func_db_search(FILE *f, const struct search *s, int decl)
 	col += 16;
 
 	if (s->type == STYPE_ITERATE) {
-		if ((rc = fprintf(f, 
-		    ", %s_cb cb, void *arg", retstr->name)) < 0)
+		if ((rc = fprintf(f, ", %s_%scb cb, void *arg", 
+		    retstr->name, until ? "until_" : "")) < 0)
+			return 0;
+		col += (size_t)rc;
+	} else if (SEARCH_ISHISTO(s)) {
+		if ((rc = fprintf(f, ", size_t *sz")) < 0)
+			return 0;
+		col += (size_t)rc;
+	} else if (STYPE_ISAGGR(s->type)) {
+		assert(!TAILQ_EMPTY(&s->projq));
+		if ((rc = fprintf(f, ", %s *val", 
+		    s->type == STYPE_AVG || 
+		    TAILQ_FIRST(&s->projq)->field->type == 
+		    FTYPE_REAL ? "double" : "int64_t")) < 0)
 			return 0;
 		col += (size_t)rc;
 	}
@@ -529,14 +720,30 @@ gen_func_db_search(FILE *f, const struct search *s, int decl)
 	return fprintf(f, ")%s", decl ? ";\n" : "") > 0;
 }
 
+int
+gen_func_db_search(FILE *f, const struct search *s, int decl)
+{
+
+	return gen_func_db_search_op(f, s, 0, decl);
+}
+
+int
+gen_func_db_search_until(FILE *f, const struct search *s, int decl)
+{
+
+	return gen_func_db_search_op(f, s, 1, decl);
+}
+
 /*
- * Generate the db_xxxx_insert function header.
- * If "decl" is non-zero, this is the declaration; otherwise, the
- * definition header.
+ * Generate the db_xxxx_{insert,upsert} function header, "op" being the
+ * operation name.
+ * If "ret" is non-zero, the function returns the written row instead
+ * of its identifier.
  * Return zero on failure, non-zero on success.
  */
-int
-gen_func_db_insert(FILE *f, const struct strct *p, int decl)
+static int
+gen_func_db_insert_op(FILE *f, const struct strct *p,
+	const char *op, int ret, int decl)
 {
 	const struct field *fd;
 	size_t	 	    pos = 1, col = 0;
@@ -544,7 +751,12 @@ gen_func_db_insert(FILE *f, const struct strct *p, int decl)
 
 	/* Start with return value. */
 
-	if (!decl) {
+	if (ret) {
+		if ((rc = fprintf(f, "struct %s *%s", 
+		    p->name, decl ? "" : "\n")) < 0)
+			return 0;
+		col = decl ? (size_t)rc : 0;
+	} else if (!decl) {
 		if (fputs("int64_t\n", f) == EOF)
 			return 0;
 	} else {
@@ -555,7 +767,7 @@ gen_func_db_insert(FILE *f, const struct strct *p, int decl)
 
 	/* Now function name. */
 
-	if ((rc = fprintf(f, "db_%s_insert", p->name)) < 0)
+	if ((rc = fprintf(f, "db_%s_%s", p->name, op)) < 0)
 		return 0;
 	col += (size_t)rc;
 
@@ -585,6 +797,80 @@ gen_func_db_insert(FILE *f, const struct strct *p, int decl)
 	return fprintf(f, ")%s", decl ? ";\n" : "") > 0;
 }
 
+/*
+ * Generate the db_xxxx_insert function header.
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_insert(FILE *f, const struct strct *p, int decl)
+{
+
+	return gen_func_db_insert_op(f, p, "insert", 0, decl);
+}
+
+/*
+ * Generate the db_xxxx_insert_returning function header, which has the
+ * same arguments as the insert but returns the new row.
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_insert_returning(FILE *f, const struct strct *p, int decl)
+{
+
+	return gen_func_db_insert_op(f, p, "insert_returning", 1, decl);
+}
+
+/*
+ * Generate the db_xxxx_upsert function header, which has the same
+ * arguments as the insert.
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_upsert(FILE *f, const struct strct *p, int decl)
+{
+
+	return gen_func_db_insert_op(f, p, "upsert", 0, decl);
+}
+
+/*
+ * Generate the db_xxxx_load_yyyy function header for lazy field "fd".
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_load(FILE *f, const struct field *fd, int decl)
+{
+
+	return fprintf(f, "int%sdb_%s_load_%s"
+	       "(struct ort *ctx, struct %s *p)%s",
+	       decl ? " " : "\n", fd->parent->name, fd->name,
+	       fd->parent->name, decl ? ";\n" : "") > 0;
+}
+
+/*
+ * Generate the db_xxxx_blob_size_yyyy function header for lazy blob
+ * field "fd".
+ * If "decl" is non-zero, this is the declaration; otherwise, the
+ * definition header.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_func_db_blob(FILE *f, const struct field *fd, int decl)
+{
+
+	return fprintf(f, "int%sdb_%s_blob_size_%s"
+	       "(struct ort *ctx, int64_t id, size_t *sz)%s",
+	       decl ? " " : "\n", fd->parent->name, fd->name,
+	       decl ? ";\n" : "") > 0;
+}
+
 /*
  * Generate the db_xxxx_freeq function header.
  * If "decl" is non-zero, this is the declaration; otherwise, the
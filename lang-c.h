@@ -31,21 +31,28 @@ struct	filldep {
 
 TAILQ_HEAD(filldepq, filldep);
 
+int	gen_func_db_blob(FILE *, const struct field *, int);
 int	gen_func_db_close(FILE *, int);
 int	gen_func_db_free(FILE *, const struct strct *, int);
 int	gen_func_db_freeq(FILE *, const struct strct *, int);
 int	gen_func_db_insert(FILE *, const struct strct *, int);
+int	gen_func_db_insert_returning(FILE *, const struct strct *, int);
+int	gen_func_db_upsert(FILE *, const struct strct *, int);
+int	gen_func_db_load(FILE *, const struct field *, int);
 int	gen_func_db_open(FILE *, int);
 int	gen_func_db_open_logging(FILE *, int);
 int	gen_func_db_role(FILE *, int);
 int	gen_func_db_role_current(FILE *, int);
 int	gen_func_db_role_stored(FILE *, int);
 int	gen_func_db_search(FILE *, const struct search *, int);
+int	gen_func_db_search_many(FILE *, const struct search *, int);
+int	gen_func_db_search_until(FILE *, const struct search *, int);
 int	gen_func_db_set_logging(FILE *, int);
 int	gen_func_db_trans_commit(FILE *, int);
 int	gen_func_db_trans_open(FILE *, int);
 int	gen_func_db_trans_rollback(FILE *, int);
 int	gen_func_db_update(FILE *, const struct update *, int);
+int	gen_func_db_update_returning(FILE *, const struct update *, int);
 int	gen_func_json_array(FILE *, const struct strct *, int);
 int	gen_func_json_clear(FILE *, const struct strct *, int);
 int	gen_func_json_data(FILE *, const struct strct *, int);
@@ -55,6 +62,8 @@ int	gen_func_json_obj(FILE *, const struct strct *, int);
 int	gen_func_json_parse(FILE *, const struct strct *, int);
 int	gen_func_json_parse_array(FILE *, const struct strct *, int);
 int	gen_func_valid(FILE *, const struct field *, int);
+int	gen_histo_name(FILE *, const struct search *);
+int	gen_struct_db_histo(FILE *, const struct search *);
 
 int	gen_filldep(struct filldepq *, const struct strct *, unsigned int);
 const struct filldep *
@@ -101,17 +101,28 @@ static const char *const stypes[STYPE__MAX] = {
 	"search", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static const char *const rolemapts[ROLEMAP__MAX] = {
 	"all", /* ROLEMAP_ALL */
+	"avg", /* ROLEMAP_AVG */
 	"count", /* ROLEMAP_COUNT */
 	"delete", /* ROLEMAP_DELETE */
+	"exists", /* ROLEMAP_EXISTS */
 	"insert", /* ROLEMAP_INSERT */
 	"iterate", /* ROLEMAP_ITERATE */
 	"list", /* ROLEMAP_LIST */
+	"max", /* ROLEMAP_MAX */
+	"min", /* ROLEMAP_MIN */
 	"search", /* ROLEMAP_SEARCH */
+	"sum", /* ROLEMAP_SUM */
 	"update", /* ROLEMAP_UPDATE */
+	"upsert", /* ROLEMAP_UPSERT */
 	"noexport", /* ROLEMAP_NOEXPORT */
 };
 
@@ -196,6 +207,7 @@ gen_rolemap_full(FILE *f, const struct rolemap *map)
 			return 0;
 		break;
 	case ROLEMAP_INSERT:
+	case ROLEMAP_UPSERT:
 	case ROLEMAP_ALL:
 		if (fputs("null", f) == EOF)
 			return 0;
@@ -537,6 +549,7 @@ gen_field(FILE *f, const struct field *fd)
 	fl = (fd->flags & FIELD_ROWID) |
 		(fd->flags & FIELD_UNIQUE) | 
 		(fd->flags & FIELD_NOEXPORT) | 
+		(fd->flags & FIELD_LAZY) | 
 		(fd->flags & FIELD_NULL);
 	if (fputs(" \"flags\": [", f) == EOF)
 		return 0;
@@ -558,6 +571,12 @@ gen_field(FILE *f, const struct field *fd)
 		if ((fl &= ~FIELD_NOEXPORT) && fputs(", ", f) == EOF)
 			return 0;
 	}
+	if (fl & FIELD_LAZY) { 
+		if (fputs("\"lazy\"", f) == EOF)
+			return 0;
+		if ((fl &= ~FIELD_LAZY) && fputs(", ", f) == EOF)
+			return 0;
+	}
 	if ((fl & FIELD_NULL) && fputs("\"null\"", f) == EOF)
 		return 0;
 	if (fputs("],", f) == EOF)
@@ -673,7 +692,41 @@ gen_insert(FILE *f, const struct insert *insert)
 		return 0;
 	if (!gen_rolemap(f, 0, insert->rolemap))
 		return 0;
-	return fputs(" },", f) != EOF;
+	if (fputs(", \"flags\": [", f) == EOF)
+		return 0;
+	if ((insert->flags & INSERT_RETURNING) &&
+	    fputs(" \"returning\"", f) == EOF)
+		return 0;
+	return fputs(" ] },", f) != EOF;
+}
+
+/*
+ * Emit { upsertObj }|null w/comma.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_upsert(FILE *f, const struct upsert *ups)
+{
+	const struct nref	*ref;
+
+	if (ups == NULL)
+		return fputs(" null,", f) != EOF;
+	if (fputs(" {", f) == EOF)
+		return 0;
+	if (!gen_pos(f, &ups->pos))
+		return 0;
+	if (!gen_rolemap(f, 1, ups->rolemap))
+		return 0;
+	if (fputs(" \"nq\": [", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(ref, &ups->target->nq, entries) {
+		if (fprintf(f, " \"%s\"", ref->field->name) < 0)
+			return 0;
+		if (TAILQ_NEXT(ref, entries) != NULL &&
+		    fputc(',', f) == EOF)
+			return 0;
+	}
+	return fputs(" ] },", f) != EOF;
 }
 
 static int
@@ -807,6 +860,7 @@ gen_search(FILE *f, int *first, const struct search *s)
 {
 	const struct sent	*sent;
 	const struct ord	*ord;
+	const struct proj	*proj;
 
 	if (*first == 0) {
 		if (fputc(',', f) == EOF)
@@ -855,6 +909,15 @@ gen_search(FILE *f, int *first, const struct search *s)
 		    fputc(',', f) == EOF)
 			return 0;
 	}
+	if (fputs(" ], \"projq\": [", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(proj, &s->projq, entries) {
+		if (fprintf(f, " \"%s\"", proj->fname) < 0)
+			return 0;
+		if (TAILQ_NEXT(proj, entries) != NULL && 
+		    fputc(',', f) == EOF)
+			return 0;
+	}
 	if (fputs(" ], \"aggr\": ", f) == EOF)
 		return 0;
 	if (!gen_aggr(f, s->aggr))
@@ -948,6 +1011,10 @@ gen_update(FILE *f, int *first, const struct update *u)
 	if (u->flags & UPDATE_ALL)
 		if (fputs(" \"all\"", f) == EOF)
 			return 0;
+	if (u->flags & UPDATE_RETURNING)
+		if (fprintf(f, "%s \"returning\"", 
+		    (u->flags & UPDATE_ALL) ? "," : "") < 0)
+			return 0;
 	if (fputs(" ], ", f) == EOF)
 		return 0;
 	if (!gen_rolemap(f, 0, u->rolemap))
@@ -976,6 +1043,41 @@ gen_unique(FILE *f, const struct unique *u)
 	return fputs(" ] }", f) != EOF;
 }
 
+/*
+ * Emit { indexObj } w/o comma.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_index(FILE *f, const struct index *ip)
+{
+	const struct iref	*ref;
+
+	if (fputs(" {", f) == EOF)
+		return 0;
+	if (!gen_pos(f, &ip->pos))
+		return 0;
+	if (fputs(" \"nq\": [", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(ref, &ip->nq, entries) {
+		if (fprintf(f, " \"%s\"", ref->field->name) < 0)
+			return 0;
+		if (TAILQ_NEXT(ref, entries) != NULL &&
+		    fputc(',', f) == EOF)
+			return 0;
+	}
+	if (fputs(" ], \"wq\": [", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(ref, &ip->wq, entries) {
+		if (fprintf(f, " { \"field\": \"%s\", \"op\": \"%s\" }",
+		    ref->field->name, optypes[ref->op]) < 0)
+			return 0;
+		if (TAILQ_NEXT(ref, entries) != NULL &&
+		    fputc(',', f) == EOF)
+			return 0;
+	}
+	return fputs(" ] }", f) != EOF;
+}
+
 /*
  * Emit "name": { strctObj } w/o comma.
  * Return zero on failure, non-zero on success.
@@ -987,6 +1089,7 @@ gen_strct(FILE *f, const struct strct *s)
 	const struct search	*sr;
 	const struct update	*up;
 	const struct unique	*un;
+	const struct index	*ip;
 	const struct rolemap	*rm;
 	int			 first;
 
@@ -1009,6 +1112,10 @@ gen_strct(FILE *f, const struct strct *s)
 		return 0;
 	if (!gen_insert(f, s->ins))
 		return 0;
+	if (fputs(" \"upsert\":", f) == EOF)
+		return 0;
+	if (!gen_upsert(f, s->ups))
+		return 0;
 	if (fputs(" \"rq\": [ ", f) == EOF)
 		return 0;
 	TAILQ_FOREACH(rm, &s->rq, entries) {
@@ -1027,6 +1134,15 @@ gen_strct(FILE *f, const struct strct *s)
 		    fputc(',', f) == EOF)
 			return 0;
 	}
+	if (fputs(" ], \"iq\": [ ", f) == EOF)
+		return 0;
+	TAILQ_FOREACH(ip, &s->iq, entries) {
+		if (!gen_index(f, ip))
+			return 0;
+		if (TAILQ_NEXT(ip, entries) != NULL &&
+		    fputc(',', f) == EOF)
+			return 0;
+	}
 	if (fputs(" ], \"uq\": { \"named\": {", f) == EOF)
 		return 0;
 	first = 1;
@@ -38,6 +38,11 @@ static	const char *const stypes[STYPE__MAX] = {
 	"get", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static	const char *const utypes[UP__MAX] = {
@@ -264,6 +269,24 @@ gen_reffind(FILE *f, const struct strct *p)
 	return fputs("\t}\n", f) != EOF;
 }
 
+/*
+ * Print the mask of columns of "p" filled by search "s", or by the
+ * default schema if NULL, as a hexadecimal string for BigInt().
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_filled_hex(FILE *f, const struct strct *p, const struct search *s)
+{
+	size_t	 i = gen_filled_words(p) - 1;
+
+	if (fprintf(f, "'0x%" PRIx64, gen_filled(p, s, i)) < 0)
+		return 0;
+	while (i-- > 0)
+		if (fprintf(f, "%016" PRIx64, gen_filled(p, s, i)) < 0)
+			return 0;
+	return fputc('\'', f) != EOF;
+}
+
 /*
  * Generate db_xxx_fill method.
  * Return zero on failure, non-zero on success.
@@ -366,6 +389,15 @@ gen_fill(FILE *f, const struct strct *p)
 			col++;
 	}
 
+	if (p->flags & STRCT_HAS_PROJ) {
+		if (fputs("\t\t\t'_filled': BigInt(", f) == EOF)
+			return 0;
+		if (!gen_filled_hex(f, p, NULL))
+			return 0;
+		if (fputs("),\n", f) == EOF)
+			return 0;
+	}
+
 	if (fprintf(f, "\t\t};\n"
 	    "\t\tdata.pos += %zu;\n", col) < 0)
 		return 0;
@@ -382,11 +414,13 @@ gen_fill(FILE *f, const struct strct *p)
 }
 
 /*
- * Generate db_xxxx_insert method.  Return FALSE on failure, TRUE on
- * success.
+ * Generate db_xxxx_insert method or, if "ups" is non-zero, the
+ * db_xxxx_upsert method with the same parameters.  If "ret" is
+ * non-zero, generate the db_xxxx_insert_returning method.  Return FALSE
+ * on failure, TRUE on success.
  */
 static int
-gen_insert(FILE *f, const struct strct *p)
+gen_insert(FILE *f, const struct strct *p, int ups, int ret)
 {
 	const struct field	*fd;
 	size_t	 	 	 pos = 1, col;
@@ -394,12 +428,22 @@ gen_insert(FILE *f, const struct strct *p)
 
 	if (fputc('\n', f) == EOF)
 		return 0;
-	if (!gen_comment(f, 1, COMMENT_JS_FRAG_OPEN,
+	if (ret && !gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
+	    "Like db_%s_insert, but returns the new row as written "
+	    "by the database (with its identifier and any defaults).",
+	    p->name))
+		return 0;
+	if (!ups && !ret && !gen_comment(f, 1, COMMENT_JS_FRAG_OPEN,
 	    "Insert a row.  Accepts all native fields as parameters "
 	    "excluding rowid, which is automatically set by the "
 	    "database.  If any fields are specified as null, they "
 	    "may be passed as null values."))
 		return 0;
+	if (ups && !gen_comment(f, 1, COMMENT_JS_FRAG_OPEN,
+	    "Insert a row or, if it conflicts with an existing row "
+	    "on the upsert fields, update the other native fields of "
+	    "that row.  Accepts the same parameters as the insert."))
+		return 0;
 
 	TAILQ_FOREACH(fd, &p->fq, entries) {
 		if (fd->type == FTYPE_STRUCT ||
@@ -410,6 +454,12 @@ gen_insert(FILE *f, const struct strct *p)
 			return 0;
 	}
 	if (!gen_comment(f, 1, COMMENT_JS_FRAG_CLOSE,
+	    ret ? "@return The new row or null on constraint "
+	    "violation.\n"
+	    "@throws Throws on database error." :
+	    ups ? "@return Inserted or updated row identifier on "
+	    "success or -1 on constraint violation.\n"
+	    "@throws Throws on database error." :
 	    "@return Row identifier on success or -1 on "
 	    "constraint violation.\n"
 	    "@throws Throws on database error."))
@@ -417,7 +467,8 @@ gen_insert(FILE *f, const struct strct *p)
 
 	if (fputc('\t', f) == EOF)
 		return 0;
-	if ((rc = fprintf(f, "db_%s_insert", p->name)) < 0)
+	if ((rc = fprintf(f, "db_%s_%s", p->name, 
+	    ups ? "upsert" : ret ? "insert_returning" : "insert")) < 0)
 		return 0;
 	col = 8 + (size_t)rc;
 
@@ -443,7 +494,16 @@ gen_insert(FILE *f, const struct strct *p)
 	if (fputs("):", f) == EOF)
 		return 0;
 
-	if (col + 7 >= 72) {
+	if (ret) {
+		if (col + 14 + strlen(p->name) >= 72) {
+			if (fprintf(f, "\n\t\tortns.%s|null", 
+			    p->name) < 0)
+				return 0;
+		} else {
+			if (fprintf(f, " ortns.%s|null", p->name) < 0)
+				return 0;
+		}
+	} else if (col + 7 >= 72) {
 		if (fputs("\n\t\tbigint", f) == EOF)
 			return 0;
 	} else {
@@ -454,14 +514,20 @@ gen_insert(FILE *f, const struct strct *p)
 	if (fprintf(f, "\n"
 	    "\t{\n"
 	    "\t\tconst parms: any[] = [];\n"
-	    "\t\tlet info: Database.RunResult;\n"
+	    "\t\t%s\n"
 	    "\t\tconst stmt: Database.Statement =\n"
 	    "\t\t\tthis.#o.db.prepare(ortstmt.stmtBuilder\n"
-	    "\t\t\t(ortstmt.ortstmt.STMT_%s_INSERT));\n"
-	    "\n", p->name) < 0)
+	    "\t\t\t(ortstmt.ortstmt.STMT_%s_%s));\n"
+	    "%s"
+	    "\n", ups || ret ? "let cols: any;" : 
+	    "let info: Database.RunResult;",
+	    p->name, ups ? "UPSERT" : 
+	    ret ? "INSERT_RETURNING" : "INSERT",
+	    ups || ret ? "\t\tstmt.raw(true);\n" : "") < 0)
 		return 0;
 
-	if ((rc = gen_rolemap(f, p->ins->rolemap)) < 0)
+	if ((rc = gen_rolemap(f, ups ?
+	    p->ups->rolemap : p->ins->rolemap)) < 0)
 		return 0;
 	else if (rc > 0 && fputc('\n', f) == EOF)
 		return 0;
@@ -526,9 +592,27 @@ gen_insert(FILE *f, const struct strct *p)
 		pos++;
 	}
 
-	return fputs("\n"
+	if (ret)
+		return fprintf(f, "\n"
+		     "\t\ttry {\n"
+		     "\t\t\tcols = stmt.get(parms);\n"
+		     "\t\t} catch (er) {\n"
+		     "\t\t\tif (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||\n"
+		     "\t\t\t    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')\n"
+		     "\t\t\t\treturn null;\n"
+		     "\t\t\tthrow er;\n"
+		     "\t\t}\n"
+		     "\n"
+		     "\t\tif (typeof cols === 'undefined')\n"
+		     "\t\t\treturn null;\n"
+		     "\t\tconst obj: ortns.%sData = \n"
+		     "\t\t\tthis.db_%s_fill({row: <any[]>cols, pos: 0});\n"
+		     "\t\treturn new ortns.%s(this.#role, obj);\n"
+		     "\t}\n", p->name, p->name, p->name) > 0;
+
+	return fprintf(f, "\n"
 	     "\t\ttry {\n"
-	     "\t\t\tinfo = stmt.run(parms);\n"
+	     "\t\t\t%s\n"
 	     "\t\t} catch (er) {\n"
 	     "\t\t\tif (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||\n"
 	     "\t\t\t    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')\n"
@@ -536,17 +620,20 @@ gen_insert(FILE *f, const struct strct *p)
 	     "\t\t\tthrow er;\n"
 	     "\t\t}\n"
 	     "\n"
-	     "\t\treturn BigInt(info.lastInsertRowid.toString());\n"
-	     "\t}\n", f) != EOF;
+	     "\t\treturn BigInt(%s);\n"
+	     "\t}\n", 
+	     ups ? "cols = stmt.get(parms);" : "info = stmt.run(parms);",
+	     ups ? "cols[0]" : "info.lastInsertRowid.toString()") > 0;
 }
 
 /*
- * Generate db_xxx_delete or db_xxx_update method.
+ * Generate db_xxx_delete or db_xxx_update method or, if "ret" is
+ * non-zero, the update method returning the modified row.
  * Return zero on failure, non-zero on success.
  */
 static int
 gen_update(FILE *f, const struct config *cfg,
-	const struct update *up, size_t num)
+	const struct update *up, size_t num, int ret)
 {
 	const struct uref	*ref;
 	enum cmtt		 ct = COMMENT_JS_FRAG_OPEN;
@@ -613,7 +700,12 @@ gen_update(FILE *f, const struct config *cfg,
 			ct = COMMENT_JS_FRAG;
 		}
 
-	if (up->type == UP_MODIFY)
+	if (ret) {
+		if (!gen_comment(f, 1, ct,
+		    "@return The modified row or null on constraint "
+		    "violation or if no row was modified."))
+			return 0;
+	} else if (up->type == UP_MODIFY)
 		if (!gen_comment(f, 1, ct,
 		    "@return False on constraint violation, "
 		    "true on success."))
@@ -677,6 +769,12 @@ gen_update(FILE *f, const struct config *cfg,
 		col += (size_t)rc;
 	}
 
+	if (ret) {
+		if (fputs("_returning", f) == EOF)
+			return 0;
+		col += 10;
+	}
+
 	if (col >= 72) {
 		if (fputs("\n\t(", f) == EOF)
 			return 0;
@@ -711,7 +809,10 @@ gen_update(FILE *f, const struct config *cfg,
 			return 0;
 	}
 
-	if (fputs(up->type == UP_MODIFY ? 
+	if (ret) {
+		if (fprintf(f, "ortns.%s|null", up->parent->name) < 0)
+			return 0;
+	} else if (fputs(up->type == UP_MODIFY ? 
 	    "boolean" : "void", f) == EOF)
 		return 0;
 
@@ -720,14 +821,17 @@ gen_update(FILE *f, const struct config *cfg,
 	if (fprintf(f, "\n"
 	    "\t{\n"
 	    "\t\tconst parms: any[] = [];\n"
-	    "\t\tlet info: Database.RunResult;\n"
+	    "\t\t%s\n"
 	    "\t\tconst stmt: Database.Statement =\n"
 	    "\t\t\tthis.#o.db.prepare(ortstmt.stmtBuilder\n"
-	    "\t\t\t(ortstmt.ortstmt.STMT_%s_%s_%zu));\n"
+	    "\t\t\t(ortstmt.ortstmt.STMT_%s_%s_%zu%s));\n"
+	    "%s"
 	    "\n", 
+	    ret ? "let cols: any;" : "let info: Database.RunResult;",
 	    up->parent->name,
 	    up->type == UP_MODIFY ? "UPDATE" : "DELETE",
-	    num) < 0)
+	    num, ret ? "_RETURNING" : "",
+	    ret ? "\t\tstmt.raw(true);\n" : "") < 0)
 		return 0;
 
 	if ((rc = gen_rolemap(f, up->rolemap)) < 0)
@@ -820,7 +924,26 @@ gen_update(FILE *f, const struct config *cfg,
 		}
 	}
 
-	if (up->type == UP_MODIFY) {
+	if (ret) {
+		if (fprintf(f, "\n"
+		    "\t\ttry {\n"
+		    "\t\t\tcols = stmt.get(parms);\n"
+		    "\t\t} catch (er) {\n"
+		    "\t\t\tif (er.code === 'SQLITE_CONSTRAINT_UNIQUE' ||\n"
+		    "\t\t\t    er.code === 'SQLITE_CONSTRAINT_FOREIGNKEY')\n"
+		    "\t\t\t\treturn null;\n"
+		    "\t\t\tthrow er;\n"
+		    "\t\t}\n"
+		    "\n"
+		    "\t\tif (typeof cols === 'undefined')\n"
+		    "\t\t\treturn null;\n"
+		    "\t\tconst obj: ortns.%sData = \n"
+		    "\t\t\tthis.db_%s_fill({row: <any[]>cols, pos: 0});\n"
+		    "\t\treturn new ortns.%s(this.#role, obj);\n",
+		    up->parent->name, up->parent->name,
+		    up->parent->name) < 0)
+			return 0;
+	} else if (up->type == UP_MODIFY) {
 		if (fputs("\n"
 		    "\t\ttry {\n"
 		    "\t\t\tinfo = stmt.run(parms);\n"
@@ -865,6 +988,25 @@ gen_checkpass(FILE *f, size_t pos, const char *name,
 	return 1;
 }
 
+/*
+ * Mark the columns of "rs" read by search "s" in "obj" after it has
+ * been filled, indented by "tabs".
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_query_filled(FILE *f, size_t tabs, const struct strct *rs,
+	const struct search *s)
+{
+	size_t	 i;
+
+	for (i = 0; i < tabs; i++)
+		if (fputc('\t', f) == EOF)
+			return 0;
+	return fputs("obj._filled = BigInt(", f) != EOF &&
+	    gen_filled_hex(f, rs, s) &&
+	    fputs(");\n", f) != EOF;
+}
+
 /*
  * Generate the check for a query's passwords, with failure in the check
  * returning null or continuing based upon whether "ret" is TRUE.
@@ -904,17 +1046,20 @@ gen_query_checkpass(FILE *f, const struct search *s, int ret)
 }
 
 /*
- * Generate db_xxx_{get,count,list,iterate} methods.  Return FALSE on
- * failure, TRUE on success.
+ * Generate db_xxx_{get,count,list,iterate,sum,avg,min,max} methods.
+ * If "until" is non-zero, generates the early-terminating variant of
+ * an iterate method.
+ * Return FALSE on failure, TRUE on success.
  */
 static int
 gen_query(FILE *f, const struct config *cfg,
-	const struct search *s, size_t num)
+	const struct search *s, size_t num, int until)
 {
 	const struct sent	*sent;
+	const struct proj	*proj;
 	const struct strct	*rs;
 	size_t			 pos, col, sz;
-	int		 	 hasunary = 0, rc;
+	int		 	 hasunary = 0, real = 0, rc;
 
 	/*
 	 * The "real struct" we'll return is either ourselves or the one
@@ -923,6 +1068,13 @@ gen_query(FILE *f, const struct config *cfg,
 
 	rs = s->dst != NULL ? s->dst->strct : s->parent;
 
+	/* Aggregates are real-valued if averaged or over reals. */
+
+	if (STYPE_ISAGGR(s->type))
+		real = s->type == STYPE_AVG ||
+			TAILQ_FIRST(&s->projq)->field->type ==
+			FTYPE_REAL;
+
 	/* Do we document non-parameterised constraints? */
 
 	TAILQ_FOREACH(sent, &s->sntq, entries)
@@ -949,11 +1101,30 @@ gen_query(FILE *f, const struct config *cfg,
 		    "Search for a set of {@link ortns.%s}.", 
 		    rs->name))
 			return 0;
+	} else if (SEARCH_ISHISTO(s)) {
+		if (!gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
+		    "Search result count of {@link ortns.%s} for "
+		    "each value of %s.", rs->name, s->group->fname))
+			return 0;
 	} else if (s->type == STYPE_COUNT) {
 		if (!gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
 		    "Search result count of {@link ortns.%s}.", 
 		    rs->name))
 			return 0;
+	} else if (s->type == STYPE_EXISTS) {
+		if (!gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
+		    "Whether there are any search results of "
+		    "{@link ortns.%s}, stopping at the first.", 
+		    rs->name))
+			return 0;
+	} else if (STYPE_ISAGGR(s->type)) {
+		if (!gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
+		    "Search result %s of {@link ortns.%sData.%s}.", 
+		    s->type == STYPE_SUM ? "sum" :
+		    s->type == STYPE_AVG ? "average" :
+		    s->type == STYPE_MIN ? "minimum" : "maximum",
+		    rs->name, TAILQ_FIRST(&s->projq)->fname))
+			return 0;
 	} else
 		if (!gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
 		    "Iterate results in {@link ortns.%s}.", 
@@ -982,12 +1153,30 @@ gen_query(FILE *f, const struct config *cfg,
 		    "transaction: thus, it should not invoke any "
 		    "database modifications or risk deadlock."))
 			return 0;
+	if (until)
+		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
+		    "The iteration (and query) stops as soon as the "
+		    "callback returns true."))
+			return 0;
 	if (rs->flags & STRCT_HAS_NULLREFS)
 		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
 		    "This search involves nested null structure "
 		    "linking, which involves multiple database "
 		    "calls per invocation. Use sparingly!"))
 			return 0;
+	if (gen_search_projected(s)) {
+		if (!gen_commentv(f, 1, COMMENT_JS_FRAG,
+		    "Only the following columns (with the row "
+		    "identifier and foreign keys) are read, as "
+		    "marked in {@link ortns.%sData._filled}: the "
+		    "others are zeroed, set as null, or the first "
+		    "item of enumerations:", s->parent->name))
+			return 0;
+		TAILQ_FOREACH(proj, &s->projq, entries)
+			if (!gen_commentv(f, 1, COMMENT_JS_FRAG,
+			    "%s", proj->fname))
+				return 0;
+	}
 
 	if (hasunary) { 
 		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
@@ -1020,8 +1209,9 @@ gen_query(FILE *f, const struct config *cfg,
 	}
 
 	if (s->type == STYPE_ITERATE)
-		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
-		    "@param cb Callback with retrieved data."))
+		if (!gen_commentv(f, 1, COMMENT_JS_FRAG,
+		    "@param cb Callback with retrieved data%s.",
+		    until ? ", returning true to stop" : ""))
 			return 0;
 
 	if (s->type == STYPE_SEARCH) {
@@ -1032,10 +1222,29 @@ gen_query(FILE *f, const struct config *cfg,
 		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
 		    "@return Result of null if no results found."))
 			return 0;
-	} else if (s->type == STYPE_COUNT)
+	} else if (SEARCH_ISHISTO(s)) {
+		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
+		    "@return Values and their counts, ordered by "
+		    "value."))
+			return 0;
+	} else if (s->type == STYPE_COUNT) {
 		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
 		    "@return Count of results."))
 			return 0;
+	} else if (s->type == STYPE_EXISTS) {
+		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
+		    "@return Whether there are any results."))
+			return 0;
+	} else if (until) {
+		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
+		    "@return Number of results passed to the "
+		    "callback, including the last."))
+			return 0;
+	} else if (STYPE_ISAGGR(s->type))
+		if (!gen_comment(f, 1, COMMENT_JS_FRAG,
+		    "@return Aggregate value or null if no "
+		    "(non-null) values were found."))
+			return 0;
 
 	if (!gen_comment(f, 1, COMMENT_JS_FRAG_CLOSE,
 	    "@throws Throws on database error."))
@@ -1044,8 +1253,8 @@ gen_query(FILE *f, const struct config *cfg,
 	if (fputc('\t', f) == EOF)
 		return 0;
 
-	if ((rc = fprintf(f, "db_%s_%s", 
-	    s->parent->name, stypes[s->type])) < 0)
+	if ((rc = fprintf(f, "db_%s_%s%s", s->parent->name, 
+	    stypes[s->type], until ? "_until" : "")) < 0)
 		return 0;
 	col = 8 + (size_t)rc;
 
@@ -1085,7 +1294,7 @@ gen_query(FILE *f, const struct config *cfg,
 		}
 
 	if (s->type == STYPE_ITERATE) {
-		sz = strlen(rs->name) + 25;
+		sz = strlen(rs->name) + (until ? 28 : 25);
 		if (pos > 1 && fputc(',', f) == EOF)
 			return 0;
 		if (col + sz >= 72) {
@@ -1097,8 +1306,8 @@ gen_query(FILE *f, const struct config *cfg,
 				return 0;
 			col += 2;
 		}
-		if ((rc = fprintf(f, "cb: "
-		    "(res: ortns.%s) => void", rs->name)) < 0)
+		if ((rc = fprintf(f, "cb: (res: ortns.%s) => %s", 
+		    rs->name, until ? "boolean" : "void")) < 0)
 			return 0;
 		col += (size_t)rc;
 	}
@@ -1111,7 +1320,13 @@ gen_query(FILE *f, const struct config *cfg,
 	else if (s->type == STYPE_LIST)
 		sz = strlen(rs->name) + 8;
 	else if (s->type == STYPE_ITERATE)
-		sz = 4;
+		sz = until ? 6 : 4;
+	else if (STYPE_ISAGGR(s->type))
+		sz = 11;
+	else if (SEARCH_ISHISTO(s))
+		sz = 36;
+	else if (s->type == STYPE_EXISTS)
+		sz = 7;
 	else
 		sz = 6;
 
@@ -1125,7 +1340,26 @@ gen_query(FILE *f, const struct config *cfg,
 		if (fprintf(f, "ortns.%s[]\n", rs->name) < 0)
 			return 0;
 	} else if (s->type == STYPE_ITERATE) {
-		if (fputs("void\n", f) == EOF)
+		if (fputs(until ? "number\n" : "void\n", f) == EOF)
+			return 0;
+	} else if (s->type == STYPE_EXISTS) {
+		if (fputs("boolean\n", f) == EOF)
+			return 0;
+	} else if (STYPE_ISAGGR(s->type)) {
+		if (fprintf(f, "%s|null\n", 
+		    real ? "number" : "bigint") < 0)
+			return 0;
+	} else if (SEARCH_ISHISTO(s)) {
+		if (fputs("{ value: ", f) == EOF)
+			return 0;
+		if (s->group->field->type == FTYPE_ENUM) {
+			if (fprintf(f, "ortns.%s", 
+			    s->group->field->enm->name) < 0)
+				return 0;
+		} else if (fputs(ftypes[s->group->field->type], 
+		    f) == EOF)
+			return 0;
+		if (fputs(", count: bigint }[]\n", f) == EOF)
 			return 0;
 	} else {
 		if (fputs("bigint\n", f) == EOF)
@@ -1206,6 +1440,9 @@ gen_query(FILE *f, const struct config *cfg,
 		    "({row: <any[]>cols, pos: 0});\n",
 		    rs->name, rs->name) < 0)
 			return 0;
+		if (gen_search_projected(s) &&
+		    !gen_query_filled(f, 2, rs, s))
+			return 0;
 		if (rs->flags & STRCT_HAS_NULLREFS)
 		       if (fprintf(f, "\t\tthis.db_%s_reffind"
 			   "(this.#o, obj);\n", rs->name) < 0)
@@ -1216,6 +1453,9 @@ gen_query(FILE *f, const struct config *cfg,
 			return 0;
 		break;
 	case STYPE_ITERATE:
+		if (until && fputs
+		    ("\t\tlet n: number = 0;\n\n", f) == EOF)
+			return 0;
 		if (fprintf(f, 
 		    "\t\tfor (const cols of stmt.iterate(parms)) {\n"
 		    "\t\t\tconst obj: ortns.%sData =\n"
@@ -1223,14 +1463,27 @@ gen_query(FILE *f, const struct config *cfg,
 		    "({row: <any>cols, pos: 0});\n",
 		    rs->name, rs->name) < 0)
 			return 0;
+		if (gen_search_projected(s) &&
+		    !gen_query_filled(f, 3, rs, s))
+			return 0;
 		if (rs->flags & STRCT_HAS_NULLREFS)
 			if (fprintf(f, "\t\t\tthis.db_%s_reffind"
 			    "(this.#o, obj);\n", rs->name) < 0)
 				return 0;
 		gen_query_checkpass(f, s, 0);
+		if (!until) {
+			if (fprintf(f, "\t\t\tcb(new "
+			    "ortns.%s(this.#role, obj));\n"
+			    "\t\t}\n", rs->name) < 0)
+				return 0;
+			break;
+		}
 		if (fprintf(f, 
-		    "\t\t\tcb(new ortns.%s(this.#role, obj));\n"
-		    "\t\t}\n", rs->name) < 0)
+		    "\t\t\tn++;\n"
+		    "\t\t\tif (cb(new ortns.%s(this.#role, obj)))\n"
+		    "\t\t\t\tbreak;\n"
+		    "\t\t}\n"
+		    "\t\treturn n;\n", rs->name) < 0)
 			return 0;
 		break;
 	case STYPE_LIST:
@@ -1245,6 +1498,9 @@ gen_query(FILE *f, const struct config *cfg,
 		    "({row: <any[]>rows[i], pos: 0});\n",
 		    rs->name, rs->name, rs->name) < 0)
 			return 0;
+		if (gen_search_projected(s) &&
+		    !gen_query_filled(f, 3, rs, s))
+			return 0;
 		if (rs->flags & STRCT_HAS_NULLREFS)
 			if (fprintf(f, "\t\t\tthis.db_%s_reffind"
 			    "(this.#o, obj);\n", rs->name) < 0)
@@ -1257,6 +1513,24 @@ gen_query(FILE *f, const struct config *cfg,
 			return 0;
 		break;
 	case STYPE_COUNT:
+		if (SEARCH_ISHISTO(s)) {
+			if (fputs("\t\treturn stmt.all(parms).map"
+			    "((cols: any) => ({\n"
+			    "\t\t\tvalue: ", f) == EOF)
+				return 0;
+			if (s->group->field->type == FTYPE_ENUM) {
+				if (fprintf(f, "<ortns.%s>"
+				    "cols[0].toString(),\n",
+				    s->group->field->enm->name) < 0)
+					return 0;
+			} else if (fprintf(f, "<%s>cols[0],\n",
+			    ftypes[s->group->field->type]) < 0)
+				return 0;
+			if (fputs("\t\t\tcount: BigInt(cols[1])\n"
+			    "\t\t}));\n", f) == EOF)
+				return 0;
+			break;
+		}
 		if (fprintf(f, 
 		    "\t\tconst cols: any = stmt.get(parms);\n"
 		    "\n"
@@ -1265,6 +1539,29 @@ gen_query(FILE *f, const struct config *cfg,
 		    "\t\treturn BigInt(cols[0]);\n") < 0)
 			return 0;
 		break;
+	case STYPE_EXISTS:
+		if (fputs(
+		    "\t\tconst cols: any = stmt.get(parms);\n"
+		    "\n"
+		    "\t\tif (typeof cols === 'undefined')\n"
+		    "\t\t\tthrow \'exists returned no result!?\';\n"
+		    "\t\treturn Boolean(cols[0]);\n", f) == EOF)
+			return 0;
+		break;
+	case STYPE_SUM:
+	case STYPE_AVG:
+	case STYPE_MIN:
+	case STYPE_MAX:
+		if (fprintf(f, 
+		    "\t\tconst cols: any = stmt.get(parms);\n"
+		    "\n"
+		    "\t\tif (typeof cols === 'undefined' ||\n"
+		    "\t\t    cols[0] === null)\n"
+		    "\t\t\treturn null;\n"
+		    "\t\treturn %s(cols[0]);\n",
+		    real ? "Number" : "BigInt") < 0)
+			return 0;
+		break;
 	default:
 		break;
 	}
@@ -1272,6 +1569,188 @@ gen_query(FILE *f, const struct config *cfg,
 	return fputs("\t}\n", f) != EOF;
 }
 
+/*
+ * Generate db_xxx_get_many method for a search with SEARCH_HAS_MANY,
+ * binding keys in chunks of GEN_MANY_CHUNK (short chunks repeating
+ * their last key) and matching rows back to their keys.
+ * Return FALSE on failure, TRUE on success.
+ */
+static int
+gen_query_many(FILE *f, const struct search *s, size_t num)
+{
+	const struct sent	*sent;
+	const struct field	*fd;
+	const struct strct	*p = s->parent;
+	int			 bits;
+
+	sent = TAILQ_FIRST(&s->sntq);
+	fd = sent->field;
+	bits = fd->type == FTYPE_BIT || fd->type == FTYPE_BITFIELD;
+
+	if (fputc('\n', f) == EOF)
+		return 0;
+	if (!gen_commentv(f, 1, COMMENT_JS_FRAG_OPEN,
+	    "Like the above, but looks up each of the values of %s "
+	    "in v1, batching them into as few queries as possible.",
+	    sent->fname))
+		return 0;
+	if (!gen_commentv(f, 1, COMMENT_JS_FRAG,
+	    "@param v1 %s values", sent->fname))
+		return 0;
+	if (!gen_comment(f, 1, COMMENT_JS_FRAG,
+	    "@return Results in the order of v1, each null if not "
+	    "found."))
+		return 0;
+	if (!gen_comment(f, 1, COMMENT_JS_FRAG_CLOSE,
+	    "@throws Throws on database error."))
+		return 0;
+
+	if (fprintf(f, "\tdb_%s_get_many", p->name) < 0)
+		return 0;
+	if (s->name == NULL) {
+		if (fprintf(f, "_by_%s_%s", 
+		    sent->uname, optypes[sent->op]) < 0)
+			return 0;
+	} else if (fprintf(f, "_%s", s->name) < 0)
+		return 0;
+
+	if (fd->type == FTYPE_ENUM) {
+		if (fprintf(f, "(v1: ortns.%s[]):\n", 
+		    fd->enm->name) < 0)
+			return 0;
+	} else if (fprintf(f, "(v1: %s[]):\n", ftypes[fd->type]) < 0)
+		return 0;
+
+	if (fprintf(f, "\t\t(ortns.%s|null)[]\n"
+	    "\t{\n"
+	    "\t\tconst stmt: Database.Statement =\n"
+	    "\t\t\tthis.#o.db.prepare(ortstmt.stmtBuilder\n"
+	    "\t\t\t(ortstmt.ortstmt.STMT_%s_BY_SEARCH_%zu_MANY));\n"
+	    "\t\tconst objs: (ortns.%s|null)[] = v1.map(() => null);\n"
+	    "\t\tlet i: number, j: number;\n"
+	    "\t\tstmt.raw(true);\n"
+	    "\n", p->name, p->name, num, p->name) < 0)
+		return 0;
+	if (gen_rolemap(f, s->rolemap) > 0 && fputc('\n', f) == EOF)
+		return 0;
+
+	if (fprintf(f, 
+	    "\t\tfor (i = 0; i < v1.length; i += %d) {\n"
+	    "\t\t\tconst keys: any[] = v1.slice(i, i + %d);\n"
+	    "\t\t\tconst parms: any[] = [];\n"
+	    "\t\t\tfor (j = 0; j < %d; j++)\n"
+	    "\t\t\t\tparms.push(%skeys[Math.min"
+	    "(j, keys.length - 1)]%s);\n"
+	    "\t\t\tfor (const cols of stmt.iterate(parms)) {\n"
+	    "\t\t\t\tconst obj: ortns.%sData =\n"
+	    "\t\t\t\t\tthis.db_%s_fill"
+	    "({row: <any[]>cols, pos: 0});\n",
+	    GEN_MANY_CHUNK, GEN_MANY_CHUNK, GEN_MANY_CHUNK,
+	    bits ? "BigInt.asIntN(64, " : "", bits ? ")" : "",
+	    p->name, p->name) < 0)
+		return 0;
+	if ((p->flags & STRCT_HAS_NULLREFS) &&
+	    fprintf(f, "\t\t\t\tthis.db_%s_reffind"
+	    "(this.#o, obj);\n", p->name) < 0)
+		return 0;
+
+	return fprintf(f, "\t\t\t\tfor (j = 0; j < keys.length; j++)\n"
+		"\t\t\t\t\tif (obj.%s === %skeys[j]%s)\n"
+		"\t\t\t\t\t\tobjs[i + j] = new "
+		"ortns.%s(this.#role, obj);\n"
+		"\t\t\t}\n"
+		"\t\t}\n"
+		"\t\treturn objs;\n"
+		"\t}\n", fd->name,
+		bits ? "BigInt.asIntN(64, " : "", bits ? ")" : "",
+		p->name) > 0;
+}
+
+/*
+ * Generate db_xxx_load_yyy method for lazy field "fd".
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_load(FILE *f, const struct field *fd)
+{
+	const struct strct	*p = fd->parent;
+
+	assert(p->rowid != NULL);
+
+	if (!gen_commentv(f, 1, COMMENT_JS,
+	    "Read the lazy {@link ortns.%sData.%s} column into "
+	    "\"obj\", which must have its row identifier set.\n"
+	    "@param obj Object to fill in.\n"
+	    "@return Whether the row was found.\n"
+	    "@throws Throws on database error.",
+	    p->name, fd->name))
+		return 0;
+
+	if (fprintf(f,
+	    "\tdb_%s_load_%s(obj: ortns.%s): boolean\n"
+	    "\t{\n"
+	    "\t\tconst stmt: Database.Statement =\n"
+	    "\t\t\tthis.#o.db.prepare(ortstmt.stmtBuilder\n"
+	    "\t\t\t(ortstmt.ortstmt.STMT_%s_LOAD_%s));\n"
+	    "\t\tstmt.raw(true);\n"
+	    "\n"
+	    "\t\tconst cols: any = stmt.get([obj.obj.%s]);\n"
+	    "\n"
+	    "\t\tif (typeof cols === 'undefined')\n"
+	    "\t\t\treturn false;\n"
+	    "\t\tobj.obj.%s = <%s%s>cols[0];\n",
+	    p->name, fd->name, p->name, p->name, fd->name,
+	    p->rowid->name, fd->name, ftypes[fd->type],
+	    (fd->flags & FIELD_NULL) ? "|null" : "") < 0)
+		return 0;
+	if ((p->flags & STRCT_HAS_PROJ) && fprintf(f,
+	    "\t\tobj.obj._filled |= BigInt(ortns.%sFilled.%s);\n",
+	    p->name, fd->name) < 0)
+		return 0;
+	return fputs("\t\treturn true;\n"
+	    "\t}\n", f) != EOF;
+}
+
+/*
+ * Generate db_xxx_blob_size_yyy method for lazy blob field "fd",
+ * reading the column length by row identifier.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_blob(FILE *f, const struct field *fd)
+{
+	const struct strct	*p = fd->parent;
+
+	assert(p->rowid != NULL);
+
+	if (!gen_commentv(f, 1, COMMENT_JS,
+	    "Get the size in bytes of the lazy "
+	    "{@link ortns.%sData.%s} column without reading it.\n"
+	    "@param id Row identifier.\n"
+	    "@return Size, null if the column is null, or undefined "
+	    "if the row was not found.\n"
+	    "@throws Throws on database error.",
+	    p->name, fd->name))
+		return 0;
+	return fprintf(f,
+	    "\tdb_%s_blob_size_%s(id: bigint): bigint|null|undefined\n"
+	    "\t{\n"
+	    "\t\tconst stmt: Database.Statement =\n"
+	    "\t\t\tthis.#o.db.prepare(ortstmt.stmtBuilder\n"
+	    "\t\t\t(ortstmt.ortstmt.STMT_%s_BLOB_SIZE_%s));\n"
+	    "\t\tstmt.raw(true);\n"
+	    "\n"
+	    "\t\tconst cols: any = stmt.get([id]);\n"
+	    "\n"
+	    "\t\tif (typeof cols === 'undefined')\n"
+	    "\t\t\treturn undefined;\n"
+	    "\t\tif (cols[0] === null)\n"
+	    "\t\t\treturn null;\n"
+	    "\t\treturn BigInt(cols[0]);\n"
+	    "\t}\n",
+	    p->name, fd->name, p->name, fd->name) > 0;
+}
+
 /*
  * Generate the database functions for a structure.  Return FALSE on
  * failure, TRUE on success.
@@ -1281,6 +1760,7 @@ gen_api(FILE *f, const struct config *cfg, const struct strct *p)
 {
 	const struct search	*s;
 	const struct update	*u;
+	const struct field	*fd;
 	size_t			 pos;
 
 	if (!gen_fill(f, p))
@@ -1288,27 +1768,65 @@ gen_api(FILE *f, const struct config *cfg, const struct strct *p)
 	if (!gen_reffind(f, p))
 		return 0;
 
-	if (p->ins != NULL && !gen_insert(f, p))
+	if (p->ins != NULL && !gen_insert(f, p, 0, 0))
 		return 0;
+	if (p->ins != NULL && (p->ins->flags & INSERT_RETURNING) &&
+	    !gen_insert(f, p, 0, 1))
+		return 0;
+	if (p->ups != NULL && !gen_insert(f, p, 1, 0))
+		return 0;
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (!(fd->flags & FIELD_LAZY))
+			continue;
+		if (fputc('\n', f) == EOF || !gen_load(f, fd))
+			return 0;
+		if (fd->type == FTYPE_BLOB &&
+		    (fputc('\n', f) == EOF || !gen_blob(f, fd)))
+			return 0;
+	}
 
 	pos = 0;
-	TAILQ_FOREACH(s, &p->sq, entries)
-		if (!gen_query(f, cfg, s, pos++))
+	TAILQ_FOREACH(s, &p->sq, entries) {
+		if (!gen_query(f, cfg, s, pos, 0))
+			return 0;
+		if ((s->flags & SEARCH_HAS_UNTIL) &&
+		    !gen_query(f, cfg, s, pos, 1))
 			return 0;
+		if ((s->flags & SEARCH_HAS_MANY) &&
+		    !gen_query_many(f, s, pos))
+			return 0;
+		pos++;
+	}
 
 	pos = 0;
 	TAILQ_FOREACH(u, &p->dq, entries)
-		if (!gen_update(f, cfg, u, pos++))
+		if (!gen_update(f, cfg, u, pos++, 0))
 			return 0;
 
 	pos = 0;
-	TAILQ_FOREACH(u, &p->uq, entries)
-		if (!gen_update(f, cfg, u, pos++))
+	TAILQ_FOREACH(u, &p->uq, entries) {
+		if (!gen_update(f, cfg, u, pos, 0))
+			return 0;
+		if ((u->flags & UPDATE_RETURNING) &&
+		    !gen_update(f, cfg, u, pos, 1))
 			return 0;
+		pos++;
+	}
 
 	return 1;
 }
 
+/*
+ * Adapt gen_api() to gen_each_strct(), "arg" being the configuration.
+ */
+static int
+gen_api_strct(FILE *f, const struct strct *p, void *arg)
+{
+
+	return gen_api(f, arg, p);
+}
+
 /*
  * Generate an bitfield pseudo-enumeration.
  * Return zero on failure, non-zero on success.
@@ -1388,6 +1906,8 @@ gen_strct(FILE *f, const struct strct *p, size_t pos)
 	const struct field	*fd;
 	const struct rref	*r;
 	const char		*tab;
+	int			 first;
+	size_t			 col;
 
 	if (pos > 0 && fputc('\n', f) == EOF)
 		return 0;
@@ -1424,9 +1944,48 @@ gen_strct(FILE *f, const struct strct *p, size_t pos)
 			return 0;
 	}
 
+	if (p->flags & STRCT_HAS_PROJ) {
+		if (!gen_commentv(f, 2, COMMENT_JS,
+		    "Columns filled from the database as "
+		    "{@link ortns.%sFilled} bits.\n"
+		    "Queries with a select clause set only the "
+		    "columns they read.", p->name))
+			return 0;
+		if (fputs("\t\t_filled: bigint;\n", f) == EOF)
+			return 0;
+	}
+
 	if (fputs("\t}\n\n", f) == EOF)
 		return 0;
 
+	if (p->flags & STRCT_HAS_PROJ) {
+		if (!gen_commentv(f, 1, COMMENT_JS,
+		    "Bits of {@link ortns.%sData._filled}, one per "
+		    "column.", p->name))
+			return 0;
+		if (fprintf(f, "\texport enum %sFilled\n\t{\n",
+		    p->name) < 0)
+			return 0;
+		first = 1;
+		TAILQ_FOREACH(fd, &p->fq, entries) {
+			if (fd->type == FTYPE_STRUCT)
+				continue;
+			col = gen_filled_col(fd);
+			if (fprintf(f, "%s\t\t%s = '0x%x",
+			    first ? "" : ",\n", fd->name,
+			    1u << (col % 4)) < 0)
+				return 0;
+			for (col /= 4; col > 0; col--)
+				if (fputc('0', f) == EOF)
+					return 0;
+			if (fputc('\'', f) == EOF)
+				return 0;
+			first = 0;
+		}
+		if (fputs("\n\t}\n\n", f) == EOF)
+			return 0;
+	}
+
 	if (fprintf(f, "\tfunction db_export_%s"
 	    "(role: string, obj: %sData): any\n"
 	    "\t{\n"
@@ -1938,6 +2497,7 @@ gen_ortdb(const struct ort_lang_nodejs *args, FILE *f)
  * This macro accepts a single parameter that's given to all of the
  * members so that a later SELECT can use INNER JOIN xxx AS yyy and have
  * multiple joins on the same table.
+ * Lazy columns are replaced by constants in the same position.
  * Return zero on failure, non-zero on success.
  */
 static int
@@ -1963,7 +2523,11 @@ gen_alias_builder(FILE *f, const struct strct *p)
 		if (!first &&
 		    fputs("\t\t       ", f) == EOF)
 			return 0;
-		if (fprintf(f, "v + \'.%s\'", fd->name) < 0)
+		if ((fd->flags & FIELD_LAZY) && fprintf(f, "\'%s\'",
+		    gen_sql_placeholder(fd, LANG_JS)) < 0)
+			return 0;
+		if (!(fd->flags & FIELD_LAZY) &&
+		    fprintf(f, "v + \'.%s\'", fd->name) < 0)
 			return 0;
 		if (fd != last) {
 			if (fputs(" + \',\' +\n", f) == EOF)
@@ -2211,9 +2775,8 @@ gen_ortctx(const struct ort_lang_nodejs *args,
 
 	if (!gen_ortctx_dbrole(f, cfg))
 		return 0;
-	TAILQ_FOREACH(p, &cfg->sq, entries)
-		if (!gen_api(f, cfg, p))
-			return 0;
+	if (!gen_each_strct(f, cfg, args->jobs, gen_api_strct, (void *)cfg))
+		return 0;
 	return fputs("}\n", f) != EOF;
 }
 
@@ -39,6 +39,11 @@ static	const char *const stypes[STYPE__MAX] = {
 	"get", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static	const char *const ftypes[FTYPE__MAX] = {
@@ -380,6 +385,7 @@ gen_data_strct(const struct strct *s, FILE *f)
 {
 	const struct field	*fd;
 	char			*cp = NULL, *name = NULL;
+	const char		*cp2;
 	int			 ret = 0, isnull, first, rc;
 
 	if ((name = strdup_title(s->name)) == NULL)
@@ -427,14 +433,44 @@ gen_data_strct(const struct strct *s, FILE *f)
 			goto out;
 	}
 
+	/* Columns filled, as FILLED_xxx bits, if partially read. */
+
+	if ((s->flags & STRCT_HAS_PROJ) &&
+	    fprintf(f, "%12spub _filled: [u64; %zu],\n", "",
+	    gen_filled_words(s)) < 0)
+		goto out;
+
 	if (fprintf(f, "%8s}\n", "") < 0)
 		goto out;
 
+	if (fprintf(f, "%8simpl %s {\n", "", name) < 0)
+		goto out;
+
+	if (s->flags & STRCT_HAS_PROJ) {
+		TAILQ_FOREACH(fd, &s->fq, entries) {
+			if (fd->type == FTYPE_STRUCT)
+				continue;
+			if (fprintf(f, "%12spub const FILLED_", "") < 0)
+				goto out;
+			for (cp2 = fd->name; *cp2 != '\0'; cp2++)
+				if (fputc(toupper((unsigned char)*cp2),
+				    f) == EOF)
+					goto out;
+			if (fprintf(f, ": usize = %zu;\n",
+			    gen_filled_col(fd)) < 0)
+				goto out;
+		}
+		if (fprintf(f,
+		    "%12spub fn is_filled(&self, col: usize) -> bool {\n"
+		    "%16s(self._filled[col / 64] >> (col %% 64)) & 1 != 0\n"
+		    "%12s}\n", "", "", "") < 0)
+			goto out;
+	}
+
 	if (fprintf(f,
-	    "%8simpl %s {\n"
 	    "%12spub(super) fn to_json(&self%s) -> String {\n"
 	    "%16slet mut ret = String::new();\n",
-	    "", name, "", TAILQ_EMPTY(&s->cfg->arq) ? 
+	    "", TAILQ_EMPTY(&s->cfg->arq) ? 
 	    "" : ", role: super::Ortrole", "") < 0)
 		goto out;
 
@@ -674,7 +710,12 @@ gen_aliases(const struct config *cfg, FILE *f)
 		TAILQ_FOREACH(fd, &s->fq, entries) {
 			if (fd->type == FTYPE_STRUCT)
 				continue;
-			if (fprintf(f,
+			if ((fd->flags & FIELD_LAZY) && fprintf(f,
+			    "%12ss += \"%s%s\";\n", "",
+			    gen_sql_placeholder(fd, LANG_RUST),
+			    last != fd ? ", " : "") < 0)
+				return 0;
+			if (!(fd->flags & FIELD_LAZY) && fprintf(f,
 			    "%12ss += &format!(\"{}.%s%s\", v);\n",
 			    "", fd->name, last != fd ? ", " : "") < 0)
 				return 0;
@@ -696,11 +737,51 @@ gen_aliases(const struct config *cfg, FILE *f)
 }
 
 /*
- * Generate db_xxx_delete or db_xxx_update method.
+ * Close the parameters of a statement returning a row of "p", which is
+ * filled into an optional object.  Constraint violations and empty
+ * results map to None.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_returning(const struct strct *p, FILE *f)
+{
+
+	if (fprintf(f,
+	    "%12s], |row| {\n"
+	    "%16slet mut i = 0;\n"
+	    "%16sself.db_%s_fill(row, &mut i)\n"
+	    "%12s}) {\n"
+	    "%16sOk(obj) => Ok(Some(objs::%c%s {\n"
+	    "%20sdata: obj,\n",
+	    "", "", "", p->name, "", "", 
+	    toupper((unsigned char)p->name[0]), &p->name[1], "") < 0)
+		return 0;
+	if (!TAILQ_EMPTY(&p->cfg->arq) &&
+	    fprintf(f, "%20srole: self.role,\n", "") < 0)
+		return 0;
+	return fprintf(f,
+	    "%16s})),\n"
+	    "%16sErr(e) => match e {\n"
+	    "%20srusqlite::Error::QueryReturnedNoRows => Ok(None),\n"
+	    "%20srusqlite::Error::SqliteFailure(err, ref _desc) => "
+	     "match err.code {\n"
+	    "%24slibsqlite3_sys::ErrorCode::ConstraintViolation => "
+	     "Ok(None),\n"
+	    "%24s_ => Err(e),\n"
+	    "%20s},\n"
+	    "%20s_ => Err(e),\n"
+	    "%16s},\n"
+	    "%12s}\n%8s}\n",
+	    "", "", "", "", "", "", "", "", "", "", "") >= 0;
+}
+
+/*
+ * Generate db_xxx_delete or db_xxx_update method or, if "ret" is
+ * non-zero, the update method returning the modified row.
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_update(const struct update *up, size_t num, FILE *f)
+gen_update(const struct update *up, size_t num, int ret, FILE *f)
 {
 	const struct uref	*ref;
 	size_t		 	 pos = 1, hash;
@@ -749,6 +830,8 @@ gen_update(const struct update *up, size_t num, FILE *f)
 			return 0;
 	}
 
+	if (ret && fputs("_returning", f) == EOF)
+		return 0;
 	if (fputs("(&self, ", f) == EOF)
 		return 0;
 
@@ -766,14 +849,22 @@ gen_update(const struct update *up, size_t num, FILE *f)
 		pos++;
 	}
 
-	if (fprintf(f, ") -> Result<%s> {\n",
+	if (ret) {
+		if (fprintf(f, ") -> Result<Option<objs::%c%s>> {\n",
+		    toupper((unsigned char)up->parent->name[0]),
+		    &up->parent->name[1]) < 0)
+			return 0;
+	} else if (fprintf(f, ") -> Result<%s> {\n",
 	    up->type == UP_MODIFY ? "bool" : "()") < 0)
 		return 0;
 	if (!gen_rolemap(f, up->rolemap))
 		return 0;
 	if (fprintf(f, "%12slet sql = stmt::stmt_fmt(stmt::", "") < 0)
 		return 0;
-	if (up->type == UP_MODIFY &&
+	if (ret && gen_enum_update_returning
+	    (f, 1, up->parent, num, LANG_RUST) < 0)
+		return 0;
+	if (!ret && up->type == UP_MODIFY &&
 	    gen_enum_update(f, 1, up->parent, num, LANG_RUST) < 0)
 		return 0;
 	if (up->type == UP_DELETE &&
@@ -810,7 +901,8 @@ gen_update(const struct update *up, size_t num, FILE *f)
 
 	if (fprintf(f,
 	    "%12slet mut stmt = self.conn.prepare(&sql)?;\n"
-	    "%12smatch stmt.execute(params![\n", "", "") < 0)
+	    "%12smatch stmt.%s(params![\n", "", "",
+	    ret ? "query_row" : "execute") < 0)
 		return 0;
 
 	pos = hash = 1;
@@ -836,6 +928,8 @@ gen_update(const struct update *up, size_t num, FILE *f)
 		pos++;
 	}
 
+	if (ret)
+		return gen_returning(up->parent, f);
 	if (up->type == UP_DELETE)
 		return fprintf(f,
 		    "%12s]) {\n"
@@ -887,6 +981,38 @@ gen_checkpass(FILE *f, size_t pos, const char *name,
 	return 1;
 }
 
+/*
+ * Print the columns of "p" filled by search "s", or by the default
+ * schema if NULL, as an array of "_filled" words.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_filled_array(FILE *f, const struct strct *p, const struct search *s)
+{
+	size_t	 i;
+
+	for (i = 0; i < gen_filled_words(p); i++)
+		if (fprintf(f, "%s0x%" PRIx64, i == 0 ? "[" : ", ",
+		    gen_filled(p, s, i)) < 0)
+			return 0;
+	return fputc(']', f) != EOF;
+}
+
+/*
+ * If search "s" reads only some columns, mark them in "obj" after it
+ * has been filled.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_query_filled(FILE *f, const struct search *s)
+{
+
+	return !gen_search_projected(s) ||
+	    (fprintf(f, "%16sobj._filled = ", "") >= 0 &&
+	     gen_filled_array(f, s->parent, s) &&
+	     fputs(";\n", f) != EOF);
+}
+
 static int
 gen_query_checkpass(FILE *f, const struct search *s, int ret)
 {
@@ -986,6 +1112,80 @@ gen_reffind(const struct strct *s, FILE *f)
 	return fprintf(f, "%12sOk(())\n%8s}\n", "", "") >= 0;
 }
 
+/*
+ * Generate db_xxxx_load_yyyy method for lazy field "fd".
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_load(const struct field *fd, FILE *f)
+{
+	const struct strct	*s = fd->parent;
+
+	assert(s->rowid != NULL);
+
+	if (fprintf(f,
+	    "%8spub fn db_%s_load_%s(&self, obj: &mut objs::%c%s) -> "
+	     "Result<bool> {\n"
+	    "%12slet sql = stmt::stmt_fmt(stmt::",
+	    "", s->name, fd->name, toupper((unsigned char)s->name[0]),
+	    s->name + 1, "") < 0)
+		return 0;
+	if (gen_enum_load(f, 1, fd, LANG_RUST) < 0)
+		return 0;
+	if (fprintf(f, ");\n"
+	    "%12slet mut stmt = self.conn.prepare(&sql)?;\n"
+	    "%12slet mut rows = stmt.query(params![\n"
+	    "%16sobj.data.%s,\n"
+	    "%12s])?;\n"
+	    "%12sif let Some(row) = rows.next()? {\n"
+	    "%16sobj.data.%s = row.get(0)?;\n",
+	    "", "", "", s->rowid->name, "", "", "", fd->name) < 0)
+		return 0;
+	if ((s->flags & STRCT_HAS_PROJ) && fprintf(f,
+	    "%16sobj.data._filled[%zu] |= 0x%" PRIx64 ";\n", "",
+	    gen_filled_col(fd) / 64,
+	    (uint64_t)1 << (gen_filled_col(fd) % 64)) < 0)
+		return 0;
+	return fprintf(f,
+	    "%16sreturn Ok(true);\n"
+	    "%12s}\n"
+	    "%12sOk(false)\n"
+	    "%8s}\n", "", "", "", "") >= 0;
+}
+
+/*
+ * Generate db_xxxx_blob_size_yyyy method for lazy blob field "fd",
+ * reading the column length by row identifier.
+ * The outer option is empty if the row was not found, the inner if
+ * the column is null.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_blob(const struct field *fd, FILE *f)
+{
+	const struct strct	*s = fd->parent;
+
+	assert(s->rowid != NULL);
+
+	if (fprintf(f,
+	    "%8spub fn db_%s_blob_size_%s(&self, id: i64) -> "
+	     "Result<Option<Option<i64>>> {\n"
+	    "%12slet sql = stmt::stmt_fmt(stmt::",
+	    "", s->name, fd->name, "") < 0)
+		return 0;
+	if (gen_enum_blob(f, 1, fd, LANG_RUST) < 0)
+		return 0;
+	return fprintf(f, ");\n"
+	    "%12slet mut stmt = self.conn.prepare(&sql)?;\n"
+	    "%12slet mut rows = stmt.query(params![id])?;\n"
+	    "%12sif let Some(row) = rows.next()? {\n"
+	    "%16sreturn Ok(Some(row.get(0)?));\n"
+	    "%12s}\n"
+	    "%12sOk(None)\n"
+	    "%8s}\n",
+	    "", "", "", "", "", "", "") >= 0;
+}
+
 static int
 gen_fill(const struct strct *s, FILE *f)
 {
@@ -1073,21 +1273,29 @@ gen_fill(const struct strct *s, FILE *f)
 		}
 	}
 
+	if ((s->flags & STRCT_HAS_PROJ) &&
+	    (fprintf(f, "%16s_filled: ", "") < 0 ||
+	     !gen_filled_array(f, s, NULL) ||
+	     fputs(",\n", f) == EOF))
+		return 0;
+
 	return fprintf(f, "%12s})\n%8s}\n", "", "") >= 0;
 }
 
 /*
- * Generate db_xxxx_insert method.
+ * Generate db_xxxx_insert method or, if "ups" is non-zero, the
+ * db_xxxx_upsert method, which returns the row identifier from the
+ * statement itself.
  * Return zero on failure, non-zero on success.
  */
 static int
-gen_insert(const struct strct *s, FILE *f)
+gen_insert(const struct strct *s, FILE *f, int ups, int ret)
 {
 	const struct field	*fd;
 	size_t	 	 	 pos, hash;
 
-	if (fprintf(f, "%8spub fn db_%s_insert"
-	    "(&self, ", "", s->name) < 0)
+	if (fprintf(f, "%8spub fn db_%s_%s(&self, ", "", s->name, 
+	    ups ? "upsert" : ret ? "insert_returning" : "insert") < 0)
 		return 0;
 
 	pos = 1;
@@ -1100,15 +1308,22 @@ gen_insert(const struct strct *s, FILE *f)
 		pos++;
 	}
 
-	if (fputs(") -> Result<i64> {\n", f) == EOF)
+	if (ret) {
+		if (fprintf(f, ") -> Result<Option<objs::%c%s>> {\n",
+		    toupper((unsigned char)s->name[0]), 
+		    &s->name[1]) < 0)
+			return 0;
+	} else if (fputs(") -> Result<i64> {\n", f) == EOF)
 		return 0;
-	if (!gen_rolemap(f, s->ins->rolemap))
+	if (!gen_rolemap(f, ups ? s->ups->rolemap : s->ins->rolemap))
 		return 0;
 
 	if (fprintf(f,
 	    "%12slet sql = stmt::stmt_fmt(stmt::", "") < 0)
 		return 0;
-	if (gen_enum_insert(f, 1, s, LANG_RUST) < 0)
+	if ((ups ? gen_enum_upsert(f, 1, s, LANG_RUST) :
+	    ret ? gen_enum_insert_returning(f, 1, s, LANG_RUST) :
+	    gen_enum_insert(f, 1, s, LANG_RUST)) < 0)
 		return 0;
 	if (fputs(");\n", f) == EOF)
 		return 0;
@@ -1145,7 +1360,8 @@ gen_insert(const struct strct *s, FILE *f)
 
 	if (fprintf(f,
 	    "%12slet mut stmt = self.conn.prepare(&sql)?;\n"
-	    "%12smatch stmt.insert(params![\n", "", "") < 0)
+	    "%12smatch stmt.%s(params![\n", "", "", 
+	    ups || ret ? "query_row" : "insert") < 0)
 		return 0;
 
 	pos = hash = 1;
@@ -1189,8 +1405,10 @@ gen_insert(const struct strct *s, FILE *f)
 		pos++;
 	}
 
+	if (ret)
+		return gen_returning(s, f);
 	if (fprintf(f,
-	    "%12s]) {\n"
+	    "%12s]%s) {\n"
 	    "%16sOk(i) => Ok(i),\n"
 	    "%16sErr(e) => match e {\n"
 	    "%20srusqlite::Error::SqliteFailure(err, ref _desc) => "
@@ -1202,31 +1420,50 @@ gen_insert(const struct strct *s, FILE *f)
 	    "%20s_ => Err(e),\n"
 	    "%16s},\n"
 	    "%12s}\n%8s}\n",
-	    "", "", "", "", "", "", "", "", "", "", "") < 0)
+	    "", ups ? ", |row| row.get(0)" : "",
+	    "", "", "", "", "", "", "", "", "", "") < 0)
 		return 0;
 	return 1;
 }
 
+/*
+ * Generate a query method.
+ * If "until" is non-zero, generates the early-terminating variant of
+ * an iterate method.
+ * Return FALSE on failure, TRUE on success.
+ */
 static int
-gen_query(const struct search *s, size_t num, FILE *f)
+gen_query(const struct search *s, size_t num, int until, FILE *f)
 {
 	const struct sent	*sent;
 	const struct strct	*rs;
+	const char		*aggrt = NULL, *mut;
 	char			*ret;
 	size_t			 pos, hash;
 
 	/*
 	 * The "real struct" we'll return is either ourselves or the one
 	 * we reference with a distinct clause.
+	 * It's modified after being filled for null references and
+	 * partial reads.
 	 */
 
 	rs = s->dst != NULL ? s->dst->strct : s->parent;
+	mut = (rs->flags & STRCT_HAS_NULLREFS) ||
+		gen_search_projected(s) ? "mut " : "";
+
+	/* Aggregates are real-valued if averaged or over reals. */
+
+	if (STYPE_ISAGGR(s->type))
+		aggrt = s->type == STYPE_AVG ||
+			TAILQ_FIRST(&s->projq)->field->type ==
+			FTYPE_REAL ? "f64" : "i64";
 	if ((ret = strdup(rs->name)) == NULL)
 		return 0;
 	ret[0] = toupper((unsigned char)ret[0]);
 
-	if (fprintf(f, "%8spub fn db_%s_%s",
-	    "", s->parent->name, stypes[s->type]) < 0)
+	if (fprintf(f, "%8spub fn db_%s_%s%s", "", s->parent->name,
+	    stypes[s->type], until ? "_until" : "") < 0)
 		return 0;
 
 	if (s->name == NULL && !TAILQ_EMPTY(&s->sntq)) {
@@ -1244,7 +1481,8 @@ gen_query(const struct search *s, size_t num, FILE *f)
 		return 0;
 
 	if (s->type == STYPE_ITERATE &&
-	    fprintf(f, ", cb: fn(res: objs::%s)", ret) < 0)
+	    fprintf(f, ", cb: fn(res: objs::%s)%s", 
+	    ret, until ? " -> bool" : "") < 0)
 		return 0;
 
 	pos = 1;
@@ -1269,10 +1507,38 @@ gen_query(const struct search *s, size_t num, FILE *f)
 			return 0;
 		break;
 	case STYPE_ITERATE:
-		if (fputs("Result<()>", f) == EOF)
+		if (fputs(until ? "Result<usize>" : "Result<()>", 
+		    f) == EOF)
+			return 0;
+		break;
+	case STYPE_EXISTS:
+		if (fputs("Result<bool>", f) == EOF)
+			return 0;
+		break;
+	case STYPE_SUM:
+	case STYPE_AVG:
+	case STYPE_MIN:
+	case STYPE_MAX:
+		if (fprintf(f, "Result<Option<%s>>", aggrt) < 0)
 			return 0;
 		break;
 	default:
+		if (SEARCH_ISHISTO(s)) {
+			if (fputs("Result<Vec<(", f) == EOF)
+				return 0;
+			if (s->group->field->type == FTYPE_ENUM) {
+				if (fprintf(f, "data::%c%s",
+				    toupper((unsigned char)
+				     s->group->field->enm->name[0]),
+				    s->group->field->enm->name + 1) < 0)
+					return 0;
+			} else if (fputs(ftypes
+			    [s->group->field->type], f) == EOF)
+				return 0;
+			if (fputs(", i64)>>", f) == EOF)
+				return 0;
+			break;
+		}
 		if (fputs("Result<i64>", f) == EOF)
 			return 0;
 		break;
@@ -1325,9 +1591,9 @@ gen_query(const struct search *s, size_t num, FILE *f)
 		    "%12sif let Some(row) = rows.next()? {\n"
 		    "%16slet mut i = 0;\n"
 		    "%16slet %sobj = self.db_%s_fill(&row, &mut i)?;\n",
-		    "", "", "",
-		    (rs->flags & STRCT_HAS_NULLREFS) ? "mut " : "",
-		    rs->name) < 0)
+		    "", "", "", mut, rs->name) < 0)
+			return 0;
+		if (!gen_query_filled(f, s))
 			return 0;
 		if (rs->flags & STRCT_HAS_NULLREFS)
 		       if (fprintf(f,
@@ -1349,13 +1615,16 @@ gen_query(const struct search *s, size_t num, FILE *f)
 			return 0;
 		break;
 	case STYPE_ITERATE:
+		if (until && fprintf(f, 
+		    "%12slet mut n: usize = 0;\n", "") < 0)
+			return 0;
 		if (fprintf(f,
 		    "%12swhile let Some(row) = rows.next()? {\n"
 		    "%16slet mut i = 0;\n"
 		    "%16slet %sobj = self.db_%s_fill(&row, &mut i)?;\n",
-		    "", "", "",
-		    (rs->flags & STRCT_HAS_NULLREFS) ? "mut " : "",
-		    rs->name) < 0)
+		    "", "", "", mut, rs->name) < 0)
+			return 0;
+		if (!gen_query_filled(f, s))
 			return 0;
 		if (rs->flags & STRCT_HAS_NULLREFS)
 		       if (fprintf(f,
@@ -1363,13 +1632,26 @@ gen_query(const struct search *s, size_t num, FILE *f)
 			   "", rs->name) < 0)
 			       return 0;
 		gen_query_checkpass(f, s, 0);
+		if (until && fprintf(f, "%16sn += 1;\n", "") < 0)
+			return 0;
 		if (fprintf(f,
-		    "%16scb(objs::%s {\n"
-		    "%20sdata: obj,\n", "", ret, "") < 0)
+		    "%16s%scb(objs::%s {\n"
+		    "%20sdata: obj,\n", "", 
+		    until ? "if " : "", ret, "") < 0)
 			return 0;
 		if (!TAILQ_EMPTY(&s->parent->cfg->arq) &&
 		    fprintf(f, "%20srole: self.role,\n", "") < 0)
 			return 0;
+		if (until) {
+			if (fprintf(f,
+			    "%16s}) {\n"
+			    "%20sbreak;\n"
+			    "%16s}\n"
+			    "%12s}\n"
+			    "%12sOk(n)\n", "", "", "", "", "") < 0)
+				return 0;
+			break;
+		}
 		if (fprintf(f,
 		    "%16s});\n"
 		    "%12s}\n"
@@ -1382,9 +1664,9 @@ gen_query(const struct search *s, size_t num, FILE *f)
 		    "%12swhile let Some(row) = rows.next()? {\n"
 		    "%16slet mut i = 0;\n"
 		    "%16slet %sobj = self.db_%s_fill(&row, &mut i)?;\n",
-		    "", "", "", "",
-		    (rs->flags & STRCT_HAS_NULLREFS) ? "mut " : "",
-		    rs->name) < 0)
+		    "", "", "", "", mut, rs->name) < 0)
+			return 0;
+		if (!gen_query_filled(f, s))
 			return 0;
 		if (rs->flags & STRCT_HAS_NULLREFS)
 		       if (fprintf(f,
@@ -1405,7 +1687,57 @@ gen_query(const struct search *s, size_t num, FILE *f)
 		    "%12sOk(vec)\n", "", "", "") < 0)
 			return 0;
 		break;
+	case STYPE_EXISTS:
+		if (fprintf(f,
+		    "%12sif let Some(row) = rows.next()? {\n"
+		    "%16slet val: i64 = row.get(0)?;\n"
+		    "%16sreturn Ok(val != 0);\n"
+		    "%12s}\n"
+		    "%12sErr(rusqlite::Error::QueryReturnedNoRows)\n",
+		    "", "", "", "", "") < 0)
+			return 0;
+		break;
+	case STYPE_SUM:
+	case STYPE_AVG:
+	case STYPE_MIN:
+	case STYPE_MAX:
+		if (fprintf(f,
+		    "%12sif let Some(row) = rows.next()? {\n"
+		    "%16slet val: Option<%s> = row.get(0)?;\n"
+		    "%16sreturn Ok(val);\n"
+		    "%12s}\n"
+		    "%12sErr(rusqlite::Error::QueryReturnedNoRows)\n",
+		    "", "", aggrt, "", "", "") < 0)
+			return 0;
+		break;
 	default:
+		if (SEARCH_ISHISTO(s)) {
+			if (fprintf(f,
+			    "%12slet mut vec = Vec::new();\n"
+			    "%12swhile let Some(row) = rows.next()? {\n"
+			    "%16slet val: %s = row.get(0)?;\n"
+			    "%16slet count: i64 = row.get(1)?;\n",
+			    "", "", "", 
+			    s->group->field->type == FTYPE_ENUM ?
+			    "i64" : ftypes[s->group->field->type],
+			    "") < 0)
+				return 0;
+			if (s->group->field->type == FTYPE_ENUM) {
+				if (fprintf(f,
+				    "%16svec.push((FromPrimitive::"
+				     "from_i64(val).ok_or(rusqlite::"
+				     "Error::IntegralValueOutOfRange"
+				     "(0, val))?, count));\n", "") < 0)
+					return 0;
+			} else if (fprintf(f, 
+			    "%16svec.push((val, count));\n", "") < 0)
+				return 0;
+			if (fprintf(f,
+			    "%12s}\n"
+			    "%12sOk(vec)\n", "", "") < 0)
+				return 0;
+			break;
+		}
 		if (fprintf(f,
 		    "%12sif let Some(row) = rows.next()? {\n"
 		    "%16slet count: i64 = row.get(0)?;\n"
@@ -1421,6 +1753,127 @@ gen_query(const struct search *s, size_t num, FILE *f)
 	return fprintf(f, "%8s}\n", "") >= 0;
 }
 
+/*
+ * Generate db_xxx_get_many method for a search with SEARCH_HAS_MANY,
+ * binding keys in chunks of GEN_MANY_CHUNK (short chunks repeating
+ * their last key) and filling each row once per matching key.
+ * Return FALSE on failure, TRUE on success.
+ */
+static int
+gen_query_many(const struct search *s, size_t num, FILE *f)
+{
+	const struct sent	*sent;
+	const struct field	*fd;
+	const struct strct	*p = s->parent;
+	char			*key;
+	int			 enm, rc;
+
+	sent = TAILQ_FIRST(&s->sntq);
+	fd = sent->field;
+	enm = fd->type == FTYPE_ENUM;
+
+	if (fprintf(f, "%8spub fn db_%s_get_many", "", p->name) < 0)
+		return 0;
+	if (s->name == NULL) {
+		if (fprintf(f, "_by_%s_%s", 
+		    sent->uname, optypes[sent->op]) < 0)
+			return 0;
+	} else if (fprintf(f, "_%s", s->name) < 0)
+		return 0;
+
+	if (fputs("(&self, v1: &[", f) == EOF)
+		return 0;
+	if (enm) {
+		if (fprintf(f, "data::%c%s",
+		    toupper((unsigned char)fd->enm->name[0]),
+		    fd->enm->name + 1) < 0)
+			return 0;
+	} else {
+		if (strcmp(ftypes[fd->type], "i64") && 
+		    fputc('&', f) == EOF)
+			return 0;
+		if (fputs(ftypes[fd->type], f) == EOF)
+			return 0;
+	}
+	if (fprintf(f, "]) -> Result<Vec<Option<objs::%c%s>>> {\n",
+	    toupper((unsigned char)p->name[0]), p->name + 1) < 0)
+		return 0;
+
+	if (!gen_rolemap(f, s->rolemap))
+		return 0;
+	if (fprintf(f, "%12slet sql = stmt::stmt_fmt(stmt::", "") < 0)
+		return 0;
+	if (gen_enum_query_many(f, 1, p, num, LANG_RUST) < 0)
+		return 0;
+	if (fprintf(f, ");\n"
+	    "%12slet mut stmt = self.conn.prepare(&sql)?;\n"
+	    "%12slet mut vec = Vec::with_capacity(v1.len());\n"
+	    "%12svec.resize_with(v1.len(), || None);\n"
+	    "%12sfor (n, keys) in v1.chunks(%d).enumerate() {\n"
+	    "%16slet last = keys.len() - 1;\n", 
+	    "", "", "", "", GEN_MANY_CHUNK, "") < 0)
+		return 0;
+	if (enm && fprintf(f, 
+	    "%16slet ints: Vec<i64> = keys.iter()\n"
+	    "%20s.map(|k| ToPrimitive::to_i64(k).unwrap())"
+	     ".collect();\n", "", "") < 0)
+		return 0;
+
+	/*
+	 * Match the filled row's key to the requested keys.
+	 * The first match takes the filled row, and duplicates are
+	 * filled again from the same row.
+	 */
+
+	if ((key = strdup_ident(fd->name)) == NULL)
+		return 0;
+	rc = fprintf(f,
+	    "%16slet parms: Vec<&dyn rusqlite::ToSql> = (0..%d)\n"
+	    "%20s.map(|j| &%s[j.min(last)] as &dyn rusqlite::ToSql)\n"
+	    "%20s.collect();\n"
+	    "%16slet mut rows = stmt.query(&parms[..])?;\n"
+	    "%16swhile let Some(row) = rows.next()? {\n"
+	    "%20slet mut i = 0;\n"
+	    "%20slet first = self.db_%s_fill(&row, &mut i)?;\n"
+	    "%20slet js: Vec<usize> = (0..keys.len())\n"
+	    "%24s.filter(|&j| first.%s == %skeys[j]).collect();\n"
+	    "%20slet mut first = Some(first);\n"
+	    "%20sfor j in js {\n"
+	    "%24slet %sobj = match first.take() {\n"
+	    "%28sSome(obj) => obj,\n"
+	    "%28sNone => {\n"
+	    "%32slet mut i = 0;\n"
+	    "%32sself.db_%s_fill(&row, &mut i)?\n"
+	    "%28s}\n"
+	    "%24s};\n",
+	    "", GEN_MANY_CHUNK, "", enm ? "ints" : "keys", "", "", "",
+	    "", "", p->name, "", "", key,
+	    strcmp(ftypes[fd->type], "i64") && !enm ? "*" : "",
+	    "", "", "", (p->flags & STRCT_HAS_NULLREFS) ? "mut " : "",
+	    "", "", "", "", p->name, "", "");
+	free(key);
+	if (rc < 0)
+		return 0;
+	if ((p->flags & STRCT_HAS_NULLREFS) && fprintf(f,
+	    "%24sself.db_%s_reffind(&mut obj)?;\n", "", p->name) < 0)
+		return 0;
+	if (fprintf(f,
+	    "%24svec[n * %d + j] = Some(objs::%c%s {\n"
+	    "%28sdata: obj,\n", "", GEN_MANY_CHUNK,
+	    toupper((unsigned char)p->name[0]), p->name + 1, "") < 0)
+		return 0;
+	if (!TAILQ_EMPTY(&p->cfg->arq) &&
+	    fprintf(f, "%28srole: self.role,\n", "") < 0)
+		return 0;
+	return fprintf(f,
+		"%24s});\n"
+		"%20s}\n"
+		"%16s}\n"
+		"%12s}\n"
+		"%12sOk(vec)\n"
+		"%8s}\n", "", "", "", "", "", "") >= 0;
+}
+
 /*
  * Generate all of the possible transitions from the given role into all
  * possible roles, then all of the transitions from the roles "beneath"
@@ -1507,41 +1960,77 @@ gen_ortctx_dbrole(const struct config *cfg, FILE *f)
 	     "%8s}\n", "", "", "", "") >= 0;
 }
 
+/*
+ * Generate the database functions for a structure.
+ * Return zero on failure, non-zero on success.
+ */
 static int
-gen_ortctx(const struct config *cfg, FILE *f)
+gen_ortctx_strct(FILE *f, const struct strct *s, void *arg)
 {
-	const struct strct	*s;
 	const struct search	*sr;
 	const struct update	*u;
+	const struct field	*fd;
 	size_t			 pos;
 
-	if (!gen_ortctx_dbrole(cfg, f))
+	if (!gen_fill(s, f))
 		return 0;
-
-	TAILQ_FOREACH(s, &cfg->sq, entries) {
-		if (!gen_fill(s, f))
+	if (!gen_reffind(s, f))
+		return 0;
+	if (s->ins != NULL && !gen_insert(s, f, 0, 0))
+		return 0;
+	if (s->ins != NULL &&
+	    (s->ins->flags & INSERT_RETURNING) &&
+	    !gen_insert(s, f, 0, 1))
+		return 0;
+	if (s->ups != NULL && !gen_insert(s, f, 1, 0))
+		return 0;
+	TAILQ_FOREACH(fd, &s->fq, entries) {
+		if (!(fd->flags & FIELD_LAZY))
+			continue;
+		if (!gen_load(fd, f))
 			return 0;
-		if (!gen_reffind(s, f))
+		if (fd->type == FTYPE_BLOB && !gen_blob(fd, f))
 			return 0;
-		if (s->ins != NULL && !gen_insert(s, f))
+	}
+	pos = 0;
+	TAILQ_FOREACH(sr, &s->sq, entries) {
+		if (!gen_query(sr, pos, 0, f))
 			return 0;
-		pos = 0;
-		TAILQ_FOREACH(sr, &s->sq, entries)
-			if (!gen_query(sr, pos++, f))
-				return 0;
-		pos = 0;
-		TAILQ_FOREACH(u, &s->dq, entries)
-			if (!gen_update(u, pos++, f))
-				return 0;
-		pos = 0;
-		TAILQ_FOREACH(u, &s->uq, entries)
-			if (!gen_update(u, pos++, f))
-				return 0;
+		if ((sr->flags & SEARCH_HAS_UNTIL) &&
+		    !gen_query(sr, pos, 1, f))
+			return 0;
+		if ((sr->flags & SEARCH_HAS_MANY) &&
+		    !gen_query_many(sr, pos, f))
+			return 0;
+		pos++;
+	}
+	pos = 0;
+	TAILQ_FOREACH(u, &s->dq, entries)
+		if (!gen_update(u, pos++, 0, f))
+			return 0;
+	pos = 0;
+	TAILQ_FOREACH(u, &s->uq, entries) {
+		if (!gen_update(u, pos, 0, f))
+			return 0;
+		if ((u->flags & UPDATE_RETURNING) &&
+		    !gen_update(u, pos, 1, f))
+			return 0;
+		pos++;
 	}
 
 	return 1;
 }
 
+static int
+gen_ortctx(const struct ort_lang_rust *args,
+	const struct config *cfg, FILE *f)
+{
+
+	if (!gen_ortctx_dbrole(cfg, f))
+		return 0;
+	return gen_each_strct(f, cfg, args->jobs, gen_ortctx_strct, NULL);
+}
+
 int
 ort_lang_rust(const struct ort_lang_rust *args,
 	const struct config *cfg, FILE *f)
@@ -1605,7 +2094,7 @@ ort_lang_rust(const struct ort_lang_rust *args,
 
 	if (fprintf(f, "\n%4simpl Ortctx {\n", "") < 0)
 		return 0;
-	if (!gen_ortctx(cfg, f))
+	if (!gen_ortctx(args, cfg, f))
 		return 0;
 
 	if (fprintf(f,
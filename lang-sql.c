@@ -55,6 +55,77 @@ static	const char *const ftypes[FTYPE__MAX] = {
 	"INTEGER", /* FTYPE_BITFIELD */
 };
 
+static	const char *const stypes[STYPE__MAX] = {
+	"count", /* STYPE_COUNT */
+	"get", /* STYPE_SEARCH */
+	"list", /* STYPE_LIST */
+	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
+};
+
+static	const char *const optypes[OPTYPE__MAX] = {
+	"eq", /* OPTYPE_EQUAL */
+	"ge", /* OPTYPE_GE */
+	"gt", /* OPTYPE_GT */
+	"le", /* OPTYPE_LE */
+	"lt", /* OPTYPE_LT */
+	"neq", /* OPTYPE_NEQUAL */
+	"like", /* OPTYPE_LIKE */
+	"and", /* OPTYPE_AND */
+	"or", /* OPTYPE_OR */
+	"streq", /* OPTYPE_STREQ */
+	"strneq", /* OPTYPE_STRNEQ */
+	/* Unary types... */
+	"isnull", /* OPTYPE_ISNULL */
+	"notnull", /* OPTYPE_NOTNULL */
+};
+
+/*
+ * Kinds of index considered by the advisor: those already in the
+ * schema and those it suggests.
+ */
+enum	adviset {
+	ADVISE_ROWID, /* primary key */
+	ADVISE_UNIQUE_FIELD, /* unique field */
+	ADVISE_UNIQUE, /* unique statement */
+	ADVISE_INDEX, /* index statement */
+	ADVISE_NEW /* suggested */
+};
+
+/*
+ * An index on the columns "cols", in order.
+ */
+struct	advice {
+	enum adviset		  type;
+	const struct strct	 *parent;
+	const struct field	 *field; /* rowid or unique field */
+	const struct unique	 *unique; /* unique statement */
+	const struct index	 *index; /* index statement */
+	const struct field	**cols;
+	size_t			  colsz;
+	TAILQ_ENTRY(advice)	  entries;
+};
+
+TAILQ_HEAD(adviceq, advice);
+
+/*
+ * The ideal index of a query on its own table: the "eqsz" columns
+ * constrained by equality (in any order), then the "tail", being a
+ * column constrained by a range or the ordering columns.
+ * If "adv" is not NULL, it's the index used by the query.
+ */
+struct	want {
+	const struct search	 *sr;
+	const struct field	**cols;
+	size_t			  eqsz;
+	size_t			  colsz;
+	const struct advice	 *adv;
+};
+
 /* Forward declarations to get __attribute__ bits. */
 
 static void gen_warnx(struct msgq *mq, 
@@ -143,6 +214,69 @@ gen_unique(FILE *f, const struct unique *u)
 	return fputs(");\n", f) != EOF;
 }
 
+/*
+ * Generate the name of an index, which is derived from its columns
+ * and "where" constraints.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_index_name(FILE *f, const struct index *ip)
+{
+	const struct iref	*ir;
+
+	if (fprintf(f, "index_%s__", ip->parent->name) < 0)
+		return 0;
+	TAILQ_FOREACH(ir, &ip->nq, entries) {
+		if (fputs(ir->field->name, f) == EOF)
+			return 0;
+		if (TAILQ_NEXT(ir, entries) != NULL &&
+		    fputc('_', f) == EOF)
+			return 0;
+	}
+	if (!TAILQ_EMPTY(&ip->wq) && fputc('_', f) == EOF)
+		return 0;
+	TAILQ_FOREACH(ir, &ip->wq, entries)
+		if (fprintf(f, "_%s_%s", ir->field->name, 
+		    ir->op == OPTYPE_ISNULL ? 
+		    "isnull" : "notnull") < 0)
+			return 0;
+	return 1;
+}
+
+/*
+ * Generate an index statement, which is partial if it has "where"
+ * constraints.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_index(FILE *f, const struct index *ip)
+{
+	const struct iref	*ir;
+
+	if (fputs("CREATE INDEX ", f) == EOF)
+		return 0;
+	if (!gen_index_name(f, ip))
+		return 0;
+	if (fprintf(f, " ON %s(", ip->parent->name) < 0)
+		return 0;
+	TAILQ_FOREACH(ir, &ip->nq, entries) {
+		if (fputs(ir->field->name, f) == EOF)
+			return 0;
+		if (TAILQ_NEXT(ir, entries) != NULL &&
+		    fputs(", ", f) == EOF)
+			return 0;
+	}
+	if (fputc(')', f) == EOF)
+		return 0;
+	TAILQ_FOREACH(ir, &ip->wq, entries)
+		if (fprintf(f, " %s %s %s", 
+		    ir == TAILQ_FIRST(&ip->wq) ? "WHERE" : "AND",
+		    ir->field->name, ir->op == OPTYPE_ISNULL ? 
+		    "ISNULL" : "NOTNULL") < 0)
+			return 0;
+	return fputs(";\n", f) != EOF;
+}
+
 /*
  * Generate the "FOREIGN KEY" statements on this table.
  * Return zero on failure, non-zero on success.
@@ -205,14 +339,15 @@ gen_field(FILE *f, const struct field *fd, int *first, int comments)
 }
 
 /*
- * Generate a table and all of its components: fields, foreign keys, and
- * unique statements.
+ * Generate a table and all of its components: fields, foreign keys,
+ * unique statements, and indexes.
  */
 static int
 gen_struct(FILE *f, const struct strct *p, int comments)
 {
 	const struct field 	*fd;
 	const struct unique 	*n;
+	const struct index 	*ip;
 	int	 		 first = 1;
 
 	if (comments &&
@@ -241,6 +376,11 @@ gen_struct(FILE *f, const struct strct *p, int comments)
 		if (!gen_unique(f, n))
 			return 0;
 	}
+	TAILQ_FOREACH(ip, &p->iq, entries) {
+		first = 0;
+		if (!gen_index(f, ip))
+			return 0;
+	}
 
 	if (!first && fputs("\n", f) == EOF)
 		return 0;
@@ -263,6 +403,498 @@ ort_lang_sql(const struct ort_lang_sql *args,
 	return 1;
 }
 
+/*
+ * Append "fd" to the columns of "w" unless already there.
+ */
+static void
+want_add(struct want *w, const struct field *fd)
+{
+	size_t	 i;
+
+	for (i = 0; i < w->colsz; i++)
+		if (w->cols[i] == fd)
+			return;
+	w->cols[w->colsz++] = fd;
+}
+
+/*
+ * Fill in the ideal index of the query "sr" on its own table.
+ * Constraints and orderings on joined structures don't contribute, as
+ * joins are always on the (indexed) rowid or unique target.
+ * Return zero on failure (memory), non-zero on success.
+ */
+static int
+want_init(struct want *w, const struct search *sr)
+{
+	const struct sent	*sent;
+	const struct ord	*ord;
+	const struct field	*range = NULL;
+	size_t			 sz = 2;
+	int			 dir = -1;
+
+	TAILQ_FOREACH(sent, &sr->sntq, entries)
+		sz++;
+	TAILQ_FOREACH(ord, &sr->ordq, entries)
+		sz++;
+
+	w->sr = sr;
+	if ((w->cols = calloc(sz, sizeof(struct field *))) == NULL)
+		return 0;
+
+	TAILQ_FOREACH(sent, &sr->sntq, entries) {
+		if (sent->chainsz != 1)
+			continue;
+		switch (sent->op) {
+		case OPTYPE_EQUAL:
+		case OPTYPE_STREQ:
+			if (sent->field->type == FTYPE_PASSWORD &&
+			    sent->op != OPTYPE_STREQ)
+				break;
+			want_add(w, sent->field);
+			break;
+		case OPTYPE_GE:
+		case OPTYPE_GT:
+		case OPTYPE_LE:
+		case OPTYPE_LT:
+			if (range == NULL)
+				range = sent->field;
+			break;
+		default:
+			break;
+		}
+	}
+
+	w->eqsz = w->colsz;
+
+	if (range != NULL) {
+		want_add(w, range);
+		return 1;
+	}
+
+	/*
+	 * Orderings are served by an index if they're all on our own
+	 * columns and in the same direction.
+	 */
+
+	TAILQ_FOREACH(ord, &sr->ordq, entries) {
+		if (ord->chainsz != 1 || 
+		    (dir != -1 && (int)ord->op != dir))
+			break;
+		dir = ord->op;
+	}
+	if (ord == NULL && !TAILQ_EMPTY(&sr->ordq)) {
+		TAILQ_FOREACH(ord, &sr->ordq, entries)
+			want_add(w, ord->field);
+		return 1;
+	}
+
+	/* Grouped counts and extrema read in column order. */
+
+	if (SEARCH_ISHISTO(sr) && sr->group->chainsz == 1)
+		want_add(w, sr->group->field);
+	else if ((sr->type == STYPE_MIN || sr->type == STYPE_MAX) &&
+	    TAILQ_FIRST(&sr->projq)->field->parent == sr->parent)
+		want_add(w, TAILQ_FIRST(&sr->projq)->field);
+
+	return 1;
+}
+
+/*
+ * Whether "fd" is one of the equality columns of "w".
+ */
+static int
+want_has_eq(const struct want *w, const struct field *fd)
+{
+	size_t	 i;
+
+	for (i = 0; i < w->eqsz; i++)
+		if (w->cols[i] == fd)
+			return 1;
+	return 0;
+}
+
+/*
+ * Whether the rowid or a unique constraint "adv" reduces the query to
+ * at most one row, making the ordering irrelevant.
+ */
+static int
+advice_unique(const struct advice *adv, const struct want *w)
+{
+	size_t	 i;
+
+	if (adv->type == ADVISE_INDEX || adv->type == ADVISE_NEW)
+		return 0;
+	for (i = 0; i < adv->colsz; i++)
+		if (!want_has_eq(w, adv->cols[i]))
+			return 0;
+	return 1;
+}
+
+/*
+ * Whether the index "adv" serves the ideal index of "w": it starts
+ * with the equality columns in any order followed by the tail.
+ * Partial indexes also need all of their constraints in the query.
+ */
+static int
+advice_serves(const struct advice *adv, const struct want *w)
+{
+	const struct iref	*ir;
+	const struct sent	*sent;
+	size_t			 i;
+
+	if (adv->colsz < w->colsz)
+		return 0;
+	for (i = 0; i < w->eqsz; i++)
+		if (!want_has_eq(w, adv->cols[i]))
+			return 0;
+	for ( ; i < w->colsz; i++)
+		if (adv->cols[i] != w->cols[i])
+			return 0;
+
+	if (adv->type != ADVISE_INDEX)
+		return 1;
+
+	TAILQ_FOREACH(ir, &adv->index->wq, entries) {
+		TAILQ_FOREACH(sent, &w->sr->sntq, entries)
+			if (sent->chainsz == 1 && 
+			    sent->field == ir->field &&
+			    sent->op == ir->op)
+				break;
+		if (sent == NULL)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Allocate an index of type "type" and append it to "q".
+ * Return NULL on failure (memory).
+ */
+static struct advice *
+advice_alloc(struct adviceq *q, const struct strct *p, 
+	enum adviset type, size_t colsz)
+{
+	struct advice	*adv;
+
+	if ((adv = calloc(1, sizeof(struct advice))) == NULL)
+		return NULL;
+	TAILQ_INSERT_TAIL(q, adv, entries);
+	adv->type = type;
+	adv->parent = p;
+	if ((adv->cols = calloc(colsz, sizeof(struct field *))) == NULL)
+		return NULL;
+	return adv;
+}
+
+/*
+ * Collect the existing indexes of "p" into "q".
+ * Return zero on failure (memory), non-zero on success.
+ */
+static int
+advice_existing(struct adviceq *q, const struct strct *p)
+{
+	const struct field	*fd;
+	const struct unique	*u;
+	const struct index	*ip;
+	const struct nref	*nf;
+	const struct iref	*ir;
+	struct advice		*adv;
+	size_t			 sz;
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (!(fd->flags & (FIELD_ROWID | FIELD_UNIQUE)))
+			continue;
+		adv = advice_alloc(q, p, (fd->flags & FIELD_ROWID) ?
+			ADVISE_ROWID : ADVISE_UNIQUE_FIELD, 1);
+		if (adv == NULL)
+			return 0;
+		adv->field = fd;
+		adv->cols[adv->colsz++] = fd;
+	}
+
+	TAILQ_FOREACH(u, &p->nq, entries) {
+		sz = 0;
+		TAILQ_FOREACH(nf, &u->nq, entries)
+			sz++;
+		if ((adv = advice_alloc(q, p, ADVISE_UNIQUE, sz)) == NULL)
+			return 0;
+		adv->unique = u;
+		TAILQ_FOREACH(nf, &u->nq, entries)
+			adv->cols[adv->colsz++] = nf->field;
+	}
+
+	TAILQ_FOREACH(ip, &p->iq, entries) {
+		sz = 0;
+		TAILQ_FOREACH(ir, &ip->nq, entries)
+			sz++;
+		if ((adv = advice_alloc(q, p, ADVISE_INDEX, sz)) == NULL)
+			return 0;
+		adv->index = ip;
+		TAILQ_FOREACH(ir, &ip->nq, entries)
+			adv->cols[adv->colsz++] = ir->field;
+	}
+
+	return 1;
+}
+
+/*
+ * Suggest an index for "w", which isn't served by any index in "q".
+ * The equality columns are ordered by how many unserved queries of
+ * "wants" also constrain them, so that shorter queries may share the
+ * same index; then by name.
+ * Return zero on failure (memory), non-zero on success.
+ */
+static int
+advice_new(struct adviceq *q, struct want *w, 
+	const struct want *wants, size_t wantsz)
+{
+	struct advice		*adv;
+	const struct field	*fd;
+	size_t			*freq, i, j, k;
+
+	if ((freq = calloc(w->eqsz, sizeof(size_t))) == NULL)
+		return 0;
+	for (i = 0; i < w->eqsz; i++)
+		for (j = 0; j < wantsz; j++)
+			if (wants[j].adv == NULL &&
+			    want_has_eq(&wants[j], w->cols[i]))
+				freq[i]++;
+
+	/* Insertion sort: these are short. */
+
+	for (i = 1; i < w->eqsz; i++) 
+		for (j = i; j > 0; j--) {
+			if (freq[j - 1] > freq[j] ||
+			    (freq[j - 1] == freq[j] && 
+			     strcmp(w->cols[j - 1]->name,
+			      w->cols[j]->name) <= 0))
+				break;
+			fd = w->cols[j];
+			w->cols[j] = w->cols[j - 1];
+			w->cols[j - 1] = fd;
+			k = freq[j];
+			freq[j] = freq[j - 1];
+			freq[j - 1] = k;
+		}
+
+	free(freq);
+
+	adv = advice_alloc(q, w->sr->parent, ADVISE_NEW, w->colsz);
+	if (adv == NULL)
+		return 0;
+	for (i = 0; i < w->colsz; i++)
+		adv->cols[adv->colsz++] = w->cols[i];
+	w->adv = adv;
+	return 1;
+}
+
+/*
+ * Print the name of the index "adv".
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_advice_name(FILE *f, const struct advice *adv)
+{
+	size_t	 i;
+
+	switch (adv->type) {
+	case ADVISE_ROWID:
+		return fputs("the primary key", f) != EOF;
+	case ADVISE_UNIQUE_FIELD:
+		return fprintf(f, "unique_%s__%s", 
+			adv->parent->name, adv->field->name) >= 0;
+	case ADVISE_INDEX:
+		return gen_index_name(f, adv->index);
+	default:
+		break;
+	}
+
+	if (fprintf(f, "%s_%s__", adv->type == ADVISE_UNIQUE ? 
+	    "unique" : "index", adv->parent->name) < 0)
+		return 0;
+	for (i = 0; i < adv->colsz; i++)
+		if (fprintf(f, "%s%s", i > 0 ? "_" : "", 
+		    adv->cols[i]->name) < 0)
+			return 0;
+	return 1;
+}
+
+/*
+ * Print the query as its generated function name and position.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_advice_query(FILE *f, const struct search *sr)
+{
+	const struct sent	*sent;
+
+	if (fprintf(f, "db_%s_%s", sr->parent->name, 
+	    stypes[sr->type]) < 0)
+		return 0;
+	if (sr->name != NULL) {
+		if (fprintf(f, "_%s", sr->name) < 0)
+			return 0;
+	} else if (!TAILQ_EMPTY(&sr->sntq)) {
+		if (fputs("_by", f) == EOF)
+			return 0;
+		TAILQ_FOREACH(sent, &sr->sntq, entries)
+			if (fprintf(f, "_%s_%s", sent->uname,
+			    optypes[sent->op]) < 0)
+				return 0;
+	}
+	return fprintf(f, " (%s:%zu:%zu)", sr->pos.fname, 
+		sr->pos.line, sr->pos.column) >= 0;
+}
+
+/*
+ * Print the suggested indexes of "p", each preceded by the queries it
+ * serves, then which queries use existing indexes and which can't use
+ * any index at all.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_advice_strct(FILE *f, const struct strct *p)
+{
+	const struct search	*sr;
+	struct want		*wants = NULL, **order = NULL, *tmp;
+	struct advice		*adv;
+	struct adviceq		 q = TAILQ_HEAD_INITIALIZER(q);
+	size_t			 i, j, wantsz = 0;
+	int			 rc = 0;
+
+	TAILQ_FOREACH(sr, &p->sq, entries)
+		wantsz++;
+	if (wantsz == 0)
+		return 1;
+
+	if ((wants = calloc(wantsz, sizeof(struct want))) == NULL ||
+	    (order = calloc(wantsz, sizeof(struct want *))) == NULL)
+		goto out;
+	i = 0;
+	TAILQ_FOREACH(sr, &p->sq, entries) {
+		order[i] = &wants[i];
+		if (!want_init(&wants[i++], sr))
+			goto out;
+	}
+
+	/* Try existing indexes, unique constraints first. */
+
+	if (!advice_existing(&q, p))
+		goto out;
+
+	for (i = 0; i < wantsz; i++) {
+		if (wants[i].colsz == 0)
+			continue;
+		TAILQ_FOREACH(adv, &q, entries)
+			if (advice_unique(adv, &wants[i]))
+				break;
+		if (adv == NULL)
+			TAILQ_FOREACH(adv, &q, entries)
+				if (advice_serves(adv, &wants[i]))
+					break;
+		wants[i].adv = adv;
+	}
+
+	/*
+	 * Suggest indexes starting with the widest queries, which
+	 * narrower ones may then share.  The sort is stable, so ties
+	 * are taken in declaration order.
+	 */
+
+	for (i = 1; i < wantsz; i++)
+		for (j = i; j > 0 && 
+		     order[j - 1]->colsz < order[j]->colsz; j--) {
+			tmp = order[j];
+			order[j] = order[j - 1];
+			order[j - 1] = tmp;
+		}
+
+	for (i = 0; i < wantsz; i++) {
+		if (order[i]->colsz == 0 || order[i]->adv != NULL)
+			continue;
+		TAILQ_FOREACH(adv, &q, entries)
+			if (adv->type == ADVISE_NEW &&
+			    advice_serves(adv, order[i]))
+				break;
+		if (adv != NULL)
+			order[i]->adv = adv;
+		else if (!advice_new(&q, order[i], wants, wantsz))
+			goto out;
+	}
+
+	TAILQ_FOREACH(adv, &q, entries) {
+		if (adv->type != ADVISE_NEW)
+			continue;
+		for (i = 0; i < wantsz; i++) {
+			if (wants[i].adv != adv)
+				continue;
+			if (fputs("-- Serves ", f) == EOF ||
+			    !gen_advice_query(f, wants[i].sr) ||
+			    fputs(".\n", f) == EOF)
+				goto out;
+		}
+		if (fputs("CREATE INDEX ", f) == EOF ||
+		    !gen_advice_name(f, adv) ||
+		    fprintf(f, " ON %s(", p->name) < 0)
+			goto out;
+		for (i = 0; i < adv->colsz; i++)
+			if (fprintf(f, "%s%s", i > 0 ? ", " : "",
+			    adv->cols[i]->name) < 0)
+				goto out;
+		if (fputs(");\n", f) == EOF)
+			goto out;
+	}
+
+	for (i = 0; i < wantsz; i++) {
+		if (wants[i].adv == NULL || 
+		    wants[i].adv->type == ADVISE_NEW)
+			continue;
+		if (fputs("-- ", f) == EOF ||
+		    !gen_advice_query(f, wants[i].sr) ||
+		    fputs(" uses ", f) == EOF ||
+		    !gen_advice_name(f, wants[i].adv) ||
+		    fputs(".\n", f) == EOF)
+			goto out;
+	}
+
+	for (i = 0; i < wantsz; i++) {
+		if (wants[i].colsz > 0)
+			continue;
+		if (fputs("-- ", f) == EOF ||
+		    !gen_advice_query(f, wants[i].sr) ||
+		    fputs(" cannot use an index "
+		    "(full table scan).\n", f) == EOF)
+			goto out;
+	}
+
+	rc = fputc('\n', f) != EOF;
+out:
+	while ((adv = TAILQ_FIRST(&q)) != NULL) {
+		TAILQ_REMOVE(&q, adv, entries);
+		free(adv->cols);
+		free(adv);
+	}
+	if (wants != NULL)
+		for (i = 0; i < wantsz; i++)
+			free(wants[i].cols);
+	free(wants);
+	free(order);
+	return rc;
+}
+
+int
+ort_lang_sql_advise(const struct ort_lang_sql *args,
+	const struct config *cfg, FILE *f)
+{
+	const struct strct *p;
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (!gen_advice_strct(f, p))
+			return 0;
+
+	return 1;
+}
+
 /*
  * This is the ALTER TABLE version of the field generators in
  * gen_struct().
@@ -522,6 +1154,17 @@ gen_diff_unique_del(FILE *f, const struct unique *u)
 	return fputs(";\n", f) != EOF;
 }
 
+static int
+gen_diff_index_del(FILE *f, const struct index *ip)
+{
+
+	if (fputs("DROP INDEX ", f) == EOF)
+		return 0;
+	if (!gen_index_name(f, ip))
+		return 0;
+	return fputs(";\n", f) != EOF;
+}
+
 /*
  * Generate an SQL diff.
  * This returns zero on failure, non-zero on success.
@@ -555,7 +1198,7 @@ ort_lang_diff_sql(const struct ort_lang_sql *args,
 	/*
 	 * Make sure we do all additions now, as we might end up
 	 * referencing these later.  Start with structures (which fields
-	 * will reference), then unique statements.
+	 * will reference), then unique statements and indexes.
 	 */
 
 	TAILQ_FOREACH(d, q, entries)
@@ -588,6 +1231,14 @@ ort_lang_diff_sql(const struct ort_lang_sql *args,
 				goto out;
 		}
 
+	TAILQ_FOREACH(d, q, entries)
+		if (d->type == DIFF_ADD_INDEX) {
+			if (!gen_prologue(f, &prol))
+				goto out;
+			if (!gen_index(f, d->index))
+				goto out;
+		}
+
 	/* Any modifications... */
 
 	TAILQ_FOREACH(d, q, entries)
@@ -613,8 +1264,8 @@ ort_lang_diff_sql(const struct ort_lang_sql *args,
 		}
 
 	/* 
-	 * For deletions, start with fields and uniques, then make our
-	 * way up to structures.
+	 * For deletions, start with fields, uniques, and indexes, then
+	 * make our way up to structures.
 	 */
 
 	TAILQ_FOREACH(d, q, entries)
@@ -631,6 +1282,11 @@ ort_lang_diff_sql(const struct ort_lang_sql *args,
 			    !gen_diff_unique_del(f, d->unique))
 				goto out;
 			break;
+		case DIFF_DEL_INDEX:
+			if (!gen_prologue(f, &prol) ||
+			    !gen_diff_index_del(f, d->index))
+				goto out;
+			break;
 		default:
 			break;
 		}
@@ -23,6 +23,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -69,6 +70,19 @@ gen_enum_insert(FILE *f, int defn, const struct strct *s,
 		fprintf(f, "STMT_%s_INSERT", s->name);
 }
 
+int
+gen_enum_upsert(FILE *f, int defn, const struct strct *s,
+	enum langt lang)
+{
+
+	return lang == LANG_RUST ?
+		fprintf(f, "%s%c%sUpsert",
+			defn ? "Ortstmt::" : "",
+			toupper((unsigned char)s->name[0]),
+			&s->name[1]) :
+		fprintf(f, "STMT_%s_UPSERT", s->name);
+}
+
 int
 gen_enum_update(FILE *f, int defn, const struct strct *s, 
 	size_t pos, enum langt lang)
@@ -82,6 +96,32 @@ gen_enum_update(FILE *f, int defn, const struct strct *s,
 		fprintf(f, "STMT_%s_UPDATE_%zu", s->name, pos);
 }
 
+int
+gen_enum_insert_returning(FILE *f, int defn, const struct strct *s,
+	enum langt lang)
+{
+
+	return lang == LANG_RUST ?
+		fprintf(f, "%s%c%sInsertReturning",
+			defn ? "Ortstmt::" : "",
+			toupper((unsigned char)s->name[0]),
+			&s->name[1]) :
+		fprintf(f, "STMT_%s_INSERT_RETURNING", s->name);
+}
+
+int
+gen_enum_update_returning(FILE *f, int defn, const struct strct *s, 
+	size_t pos, enum langt lang)
+{
+
+	return lang == LANG_RUST ?
+		fprintf(f, "%s%c%sUpdate%zuReturning",
+			defn ? "Ortstmt::" : "",
+			toupper((unsigned char)s->name[0]),
+			&s->name[1], pos) :
+		fprintf(f, "STMT_%s_UPDATE_%zu_RETURNING", s->name, pos);
+}
+
 int
 gen_enum_delete(FILE *f, int defn, const struct strct *s,
 	size_t pos, enum langt lang)
@@ -108,6 +148,19 @@ gen_enum_query(FILE *f, int defn, const struct strct *s,
 		fprintf(f, "STMT_%s_BY_SEARCH_%zu", s->name, pos);
 }
 
+int
+gen_enum_query_many(FILE *f, int defn, const struct strct *s,
+	size_t pos, enum langt lang)
+{
+
+	return lang == LANG_RUST ?
+		fprintf(f, "%s%c%sBySearch%zuMany",
+			defn ? "Ortstmt::" : "",
+			toupper((unsigned char)s->name[0]),
+			&s->name[1], pos) :
+		fprintf(f, "STMT_%s_BY_SEARCH_%zu_MANY", s->name, pos);
+}
+
 int
 gen_enum_unique(FILE *f, int defn, const struct field *fd,
 	enum langt lang)
@@ -124,6 +177,64 @@ gen_enum_unique(FILE *f, int defn, const struct field *fd,
 			fd->parent->name, fd->name);
 }
 
+int
+gen_enum_load(FILE *f, int defn, const struct field *fd,
+	enum langt lang)
+{
+
+	return lang == LANG_RUST ?
+		fprintf(f, "%s%c%sLoad%c%s",
+			defn ? "Ortstmt::" : "",
+			toupper((unsigned char)fd->parent->name[0]),
+			&fd->parent->name[1],
+			toupper((unsigned char)fd->name[0]),
+			&fd->name[1]) :
+		fprintf(f, "STMT_%s_LOAD_%s",
+			fd->parent->name, fd->name);
+}
+
+int
+gen_enum_blob(FILE *f, int defn, const struct field *fd,
+	enum langt lang)
+{
+
+	return lang == LANG_RUST ?
+		fprintf(f, "%s%c%sBlobSize%c%s",
+			defn ? "Ortstmt::" : "",
+			toupper((unsigned char)fd->parent->name[0]),
+			&fd->parent->name[1],
+			toupper((unsigned char)fd->name[0]),
+			&fd->name[1]) :
+		fprintf(f, "STMT_%s_BLOB_SIZE_%s",
+			fd->parent->name, fd->name);
+}
+
+/*
+ * Return the SQL constant standing in for column "fd" when it's not
+ * read, which is null or the type's empty value.
+ * JavaScript string quotes are escaped because our statements are
+ * themselves single-quoted.
+ */
+const char *
+gen_sql_placeholder(const struct field *fd, enum langt lang)
+{
+
+	if (fd->flags & FIELD_NULL)
+		return "NULL";
+	switch (fd->type) {
+	case FTYPE_BLOB:
+		return lang == LANG_JS ? "X\\'\\'" : "X''";
+	case FTYPE_TEXT:
+	case FTYPE_EMAIL:
+	case FTYPE_PASSWORD:
+		return lang == LANG_JS ? "\\'\\'" : "''";
+	case FTYPE_REAL:
+		return "0.0";
+	default:
+		return "0";
+	}
+}
+
 /*
  * Generate a (possibly) multi-line comment with "tabs" number of
  * preceding tab spaces.
@@ -397,9 +508,7 @@ gen_sql_stmt_schema(FILE *f, size_t tabs, enum langt lang,
 	*col += (size_t)rc;
 
 	if (pname != NULL) {
-		TAILQ_FOREACH(a, &orig->aq, entries)
-			if (strcasecmp(a->name, pname) == 0)
-				break;
+		a = ort_alias_find(orig, pname);
 		assert(a != NULL);
 		rc = fprintf(f, "%s%s%s) ", mquote, a->alias, mquote);
 	} else
@@ -435,6 +544,173 @@ gen_sql_stmt_schema(FILE *f, size_t tabs, enum langt lang,
 	return 1;
 }
 
+/*
+ * Return whether the column "fd" is read by the query "s", which has a
+ * non-empty select clause.
+ * The rowid and foreign keys are always read: the former for the
+ * results, the latter for db_xxx_reffind().
+ */
+static int
+gen_sql_stmt_selected(const struct search *s, const struct field *fd)
+{
+	const struct proj	*proj;
+
+	if ((fd->flags & FIELD_ROWID) || fd->ref != NULL)
+		return 1;
+	TAILQ_FOREACH(proj, &s->projq, entries)
+		if (proj->field == fd)
+			return 1;
+	return 0;
+}
+
+/*
+ * Return whether "s" reads only the columns of its select clause into
+ * its structure.
+ */
+int
+gen_search_projected(const struct search *s)
+{
+
+	return !TAILQ_EMPTY(&s->projq) && !STYPE_ISAGGR(s->type);
+}
+
+/*
+ * Return the bit index of column "fd", which may not be a struct, in
+ * the mask of columns filled from the database.
+ * Bits are in schema order, not counting struct fields, and are stored
+ * in 64-bit words, lowest first.
+ */
+size_t
+gen_filled_col(const struct field *fd)
+{
+	const struct field	*ffd;
+	size_t			 col = 0;
+
+	assert(fd->type != FTYPE_STRUCT);
+	TAILQ_FOREACH(ffd, &fd->parent->fq, entries)
+		if (ffd == fd)
+			break;
+		else if (ffd->type != FTYPE_STRUCT)
+			col++;
+	return col;
+}
+
+/*
+ * Return the number of 64-bit words in the mask of filled columns of
+ * "p", which is at least one.
+ */
+size_t
+gen_filled_words(const struct strct *p)
+{
+	const struct field	*fd;
+	size_t			 cols = 0;
+
+	TAILQ_FOREACH(fd, &p->fq, entries)
+		if (fd->type != FTYPE_STRUCT)
+			cols++;
+	return cols == 0 ? 1 : (cols + 63) / 64;
+}
+
+/*
+ * Return word "word" of the mask of columns of "p" filled from the
+ * database by search "s", or by the default schema if "s" is NULL or
+ * not projected.
+ * The default leaves out lazy columns.
+ */
+uint64_t
+gen_filled(const struct strct *p, const struct search *s, size_t word)
+{
+	const struct field	*fd;
+	uint64_t		 mask = 0;
+	size_t			 col = 0;
+
+	if (s != NULL && !gen_search_projected(s))
+		s = NULL;
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (fd->type == FTYPE_STRUCT)
+			continue;
+		if (col / 64 == word && (s != NULL ?
+		    gen_sql_stmt_selected(s, fd) :
+		    !(fd->flags & FIELD_LAZY)))
+			mask |= (uint64_t)1 << (col % 64);
+		col++;
+	}
+	return mask;
+}
+
+/*
+ * Like gen_sql_stmt_schema() for the first (top-level) structure, but
+ * only printing the columns selected by "s".
+ * Unselected columns are printed as constants in the same place so that
+ * the column order (and thus the filling functions) is unchanged.
+ * Referenced structures are printed in full.
+ */
+static int
+gen_sql_stmt_projected(FILE *f, size_t tabs, enum langt lang,
+	const struct search *s, size_t *col)
+{
+	const struct strct	*p = s->parent;
+	const struct field	*fd;
+	int			 rc, first = 1;
+	char			 delim;
+	const char		*spacer;
+
+	delim = lang == LANG_JS ? '\'' : '"';
+	spacer = lang == LANG_C ? "" : "+ ";
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (fd->type == FTYPE_STRUCT)
+			continue;
+		if (!first && fputc(',', f) == EOF)
+			return 0;
+		if (!first && *col >= 72) {
+			if (fprintf(f, "%c\n", delim) < 0)
+				return 0;
+			if (!gen_ws(f, tabs + 1, lang))
+				return 0;
+			if (fprintf(f, "%s%c", spacer, delim) < 0)
+				return 0;
+			*col = 8 * (tabs + 1) + 1 + strlen(spacer);
+		} else if (!first)
+			(*col)++;
+		first = 0;
+
+		/*
+		 * Enumerations stand in with their first item so that
+		 * unselected columns are still valid values.
+		 */
+
+		if (gen_sql_stmt_selected(s, fd))
+			rc = fprintf(f, "%s.%s", p->name, fd->name);
+		else if (fd->type == FTYPE_ENUM &&
+		    !(fd->flags & FIELD_NULL))
+			rc = fprintf(f, "%" PRId64,
+				TAILQ_FIRST(&fd->enm->eq)->value);
+		else
+			rc = fprintf(f, "%s",
+				gen_sql_placeholder(fd, lang));
+		if (rc < 0)
+			return 0;
+		*col += (size_t)rc;
+	}
+
+	if (fprintf(f, "%c ", delim) < 0)
+		return 0;
+	*col += 2;
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (fd->type != FTYPE_STRUCT ||
+		    (fd->ref->source->flags & FIELD_NULL))
+			continue;
+		if (!gen_sql_stmt_schema(f, tabs, lang, p, 0,
+		    fd->ref->target->parent, fd->name, col))
+			return 0;
+	}
+
+	return 1;
+}
+
 /*
  * Print all of the inner join statements required for the references of
  * a given structure "p" using its aliases if applicable.
@@ -468,10 +744,7 @@ gen_sql_stmt_join(FILE *f, size_t tabs, enum langt lang,
 		} else if ((name = strdup(fd->name)) == NULL)
 			return 0;
 
-		TAILQ_FOREACH(a, &orig->aq, entries)
-			if (strcasecmp(a->name, name) == 0)
-				break;
-
+		a = ort_alias_find(orig, name);
 		assert(a != NULL);
 
 		if (*count == 0 && fprintf(f, " %c", delim) < 0)
@@ -499,102 +772,354 @@ gen_sql_stmt_join(FILE *f, size_t tabs, enum langt lang,
 	return 1;
 }
 
-int
-gen_sql_stmts(FILE *f, size_t tabs, 
-	const struct strct *p, enum langt lang)
+/*
+ * Emit the column and value lists of an insertion into "p" starting at
+ * column "*colp", or "DEFAULT VALUES" if there are no columns.
+ * This closes the statement's string literal.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+gen_sql_stmt_insert(FILE *f, size_t ntabs, enum langt lang,
+	const struct strct *p, size_t *colp)
 {
-	const struct search	*s;
-	const struct sent	*sent;
 	const struct field	*fd;
-	const struct update	*up;
-	const struct uref	*ur;
-	const struct ord	*ord;
-	int			 first, hastrail, needquot, rc;
-	size_t			 pos, nc, col, ntabs;
+	int			 first, rc;
+	size_t			 col = *colp;
 	char			 delim;
 	const char		*spacer;
 
 	delim = lang == LANG_JS ? '\'' : '"';
 	spacer = lang == LANG_C ? "" : "+ ";
 
-	/* 
-	 * We have a special query just for our unique fields.
-	 * These are generated in the event of null foreign key
-	 * reference lookups with the generated db_xxx_reffind()
-	 * functions.
-	 * TODO: figure out which ones we should be generating and only
-	 * do this, as otherwise we're just wasting static space.
-	 */
-
-	TAILQ_FOREACH(fd, &p->fq, entries)  {
-		if (!(fd->flags & (FIELD_ROWID|FIELD_UNIQUE)))
+	first = 1;
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (fd->type == FTYPE_STRUCT ||
+		    (fd->flags & FIELD_ROWID))
 			continue;
-
-		if (!gen_ws(f, tabs, lang))
-			return 0;
-		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
-			return 0;
-		if (gen_enum_unique(f, 1, fd, lang) < 0)
-			return 0;
-		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
-			return 0;
-		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
-			return 0;
-
-		ntabs = lang == LANG_RUST ? tabs + 1 : tabs;
-
-		if (!gen_ws(f, ntabs, lang))
-			return 0;
-		col = ntabs * 8;
-		if (lang == LANG_RUST) {
-			if (fputs("s = String::new() + ", f) == EOF)
+		if (col >= 72) {
+			if (fprintf(f, "%s%c\n", 
+			    first ? "" : ",", delim) < 0)
 				return 0;
-			col += 21;
-		}
-		if ((rc = fprintf(f, "%cSELECT ", delim)) < 0)
-			return 0;
-		col += (size_t)rc;
-		if (!gen_sql_stmt_schema(f, 
-		    ntabs, lang, p, 1, p, NULL, &col))
+			if (!gen_ws(f, ntabs + 1, lang))
+				return 0;
+			if (fprintf(f, "%s%c%s", spacer, 
+			    delim, first ? "(" : " ") < 0)
+				return 0;
+			col = (ntabs + 1) * 8;
+		} else if (fputc(first ? '(' : ',', f) == EOF)
 			return 0;
-		if (fprintf(f, "%s%c FROM %s", 
-		    spacer, delim, p->name) < 0)
+
+		if ((rc = fprintf(f, "%s", fd->name)) < 0)
 			return 0;
-		nc = 0;
-		if (!gen_sql_stmt_join
-		    (f, ntabs, lang, p, p, NULL, &nc))
+		col += 1 + (size_t)rc;
+		first = 0;
+	}
+
+	if (first == 0) {
+		if ((rc = fprintf(f, ") ")) < 0)
 			return 0;
-		if (nc > 0) {
-			if (fputc('\n', f) == EOF)
+		if ((col += (size_t)rc) >= 72) {
+			if (fprintf(f, "%c\n", delim) < 0)
 				return 0;
 			if (!gen_ws(f, ntabs + 1, lang))
 				return 0;
-			if (fprintf(f, "%s%c", spacer, delim) < 0)
-				return 0;
-		} else {
-			if (fputc(' ', f) == EOF)
+			col = (ntabs + 1) * 8;
+			if ((rc = fprintf(f, 
+			    "%s%c", spacer, delim)) < 0)
 				return 0;
+			col += (size_t)rc;
 		}
-		if (fprintf(f, "WHERE %s.%s = ?%c", 
-		    p->name, fd->name, delim) < 0)
+
+		first = 1;
+		if ((rc = fprintf(f, "VALUES ")) < 0)
 			return 0;
-		if (lang == LANG_RUST && fputs("; }", f) == EOF)
+		col += (size_t)rc;
+		TAILQ_FOREACH(fd, &p->fq, entries) {
+			if (fd->type == FTYPE_STRUCT ||
+			    (fd->flags & FIELD_ROWID))
+				continue;
+			if (col >= 72) {
+				if (fprintf(f, "%s%c\n", 
+				    first ? "" : ",", 
+				    delim) < 0)
+					return 0;
+				if (!gen_ws(f, ntabs + 1, lang))
+					return 0;
+				col = (ntabs + 1) * 8;
+				rc = fprintf(f, "%s%c%s", spacer,
+					delim, first ? "(" : " ");
+				if (rc < 0)
+					return 0;
+				col += (size_t)rc;
+			} else {
+				if (fputc(first ? 
+				    '(' : ',', f) == EOF)
+					return 0;
+			}
+
+			if (fputc('?', f) == EOF)
+				return 0;
+			col += 2;
+			first = 0;
+		}
+		if (fprintf(f, ")%c", delim) < 0)
 			return 0;
-		if (fputs(",\n", f) == EOF)
+	} else {
+		if (fprintf(f, 
+		    "DEFAULT VALUES%c", delim) < 0)
 			return 0;
 	}
 
-	/* Print custom search queries. */
+	*colp = col;
+	return 1;
+}
 
-	pos = 0;
-	TAILQ_FOREACH(s, &p->sq, entries) {
-		if (!gen_ws(f, tabs, lang))
-			return 0;
-		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
-			return 0;
-		if (gen_enum_query(f, 1, p, pos++, lang) < 0)
-			return 0;
-		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+/*
+ * Emit the update statement "up" without closing its string literal.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+gen_sql_stmt_update(FILE *f, enum langt lang, const struct update *up)
+{
+	const struct uref	*ur;
+	int			 first;
+	char			 delim;
+
+	delim = lang == LANG_JS ? '\'' : '"';
+
+	if (fprintf(f, "%cUPDATE %s SET", delim, up->parent->name) < 0)
+		return 0;
+
+	first = 1;
+	TAILQ_FOREACH(ur, &up->mrq, entries) {
+		if (fputc(first ? ' ' : ',', f) == EOF)
+			return 0;
+
+		first = 0;
+		switch (ur->mod) {
+		case MODTYPE_INC:
+			if (fprintf(f, "%s = %s + ?", 
+			    ur->field->name, 
+			    ur->field->name) < 0)
+				return 0;
+			break;
+		case MODTYPE_DEC:
+			if (fprintf(f, "%s = %s - ?", 
+			    ur->field->name, 
+			    ur->field->name) < 0)
+				return 0;
+			break;
+		case MODTYPE_CONCAT:
+			if (fprintf(f, "%s = ", 
+			    ur->field->name) < 0)
+				return 0;
+
+			/*
+			 * If we concatenate a NULL with a
+			 * non-NULL, we'll always get a NULL
+			 * value, which isn't what we want.
+			 * This will wrap possibly-null values
+			 * so that they're always strings.
+			 */
+
+			if ((ur->field->flags & FIELD_NULL)) {
+				if (fprintf(f, 
+				    "COALESCE(%s,'')",
+				    ur->field->name) < 0)
+					return 0;
+			} else {
+				if (fprintf(f, "%s", 
+				    ur->field->name) < 0)
+					return 0;
+			}
+			if (fputs(" || ?", f) == EOF)
+				return 0;
+			break;
+		default:
+			if (fprintf(f, "%s = ?", 
+			    ur->field->name) < 0)
+				return 0;
+			break;
+		}
+	}
+
+	first = 1;
+	TAILQ_FOREACH(ur, &up->crq, entries) {
+		if (fprintf(f, " %s ", 
+		    first ? "WHERE" : "AND") < 0)
+			return 0;
+		if (OPTYPE_ISUNARY(ur->op)) {
+			if (fprintf(f, "%s %s", 
+			    ur->field->name, 
+			    optypes[ur->op]) < 0)
+				return 0;
+		} else {
+			if (fprintf(f, "%s %s ?", 
+			    ur->field->name,
+			    optypes[ur->op]) < 0)
+				return 0;
+		}
+		first = 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Close a statement that has had its string literal left open by
+ * returning the columns of "p" as written by the statement.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+gen_sql_stmt_returning(FILE *f, size_t ntabs, enum langt lang,
+	const struct strct *p)
+{
+	size_t	 col = 0;
+
+	if (fputs(" RETURNING ", f) == EOF)
+		return 0;
+	return gen_sql_stmt_schema(f, ntabs, lang, p, 1, p, NULL, &col);
+}
+
+/*
+ * Print the statement selecting structures by their unique column
+ * "fd", matching "keys" values at once (with IN) if more than one.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_sql_stmt_unique(FILE *f, size_t tabs, enum langt lang,
+	const struct field *fd, size_t keys)
+{
+	const struct strct	*p = fd->parent;
+	size_t			 i, nc, col, ntabs;
+	int			 rc;
+	char			 delim;
+	const char		*spacer;
+
+	delim = lang == LANG_JS ? '\'' : '"';
+	spacer = lang == LANG_C ? "" : "+ ";
+	ntabs = lang == LANG_RUST ? tabs + 1 : tabs;
+
+	if (!gen_ws(f, ntabs, lang))
+		return 0;
+	col = ntabs * 8;
+	if (lang == LANG_RUST) {
+		if (fputs("s = String::new() + ", f) == EOF)
+			return 0;
+		col += 21;
+	}
+	if ((rc = fprintf(f, "%cSELECT ", delim)) < 0)
+		return 0;
+	col += (size_t)rc;
+	if (!gen_sql_stmt_schema(f, 
+	    ntabs, lang, p, 1, p, NULL, &col))
+		return 0;
+	if (fprintf(f, "%s%c FROM %s", 
+	    spacer, delim, p->name) < 0)
+		return 0;
+	nc = 0;
+	if (!gen_sql_stmt_join
+	    (f, ntabs, lang, p, p, NULL, &nc))
+		return 0;
+	if (nc > 0) {
+		if (fputc('\n', f) == EOF)
+			return 0;
+		if (!gen_ws(f, ntabs + 1, lang))
+			return 0;
+		if (fprintf(f, "%s%c", spacer, delim) < 0)
+			return 0;
+	} else {
+		if (fputc(' ', f) == EOF)
+			return 0;
+	}
+
+	if (keys == 1) {
+		if (fprintf(f, "WHERE %s.%s = ?%c", 
+		    p->name, fd->name, delim) < 0)
+			return 0;
+	} else {
+		if (fprintf(f, "WHERE %s.%s IN (", 
+		    p->name, fd->name) < 0)
+			return 0;
+		for (i = 0; i < keys; i++) {
+			if (i > 0 && i % 16 == 0) {
+				if (fprintf(f, "%c\n", delim) < 0)
+					return 0;
+				if (!gen_ws(f, ntabs + 1, lang))
+					return 0;
+				if (fprintf(f, "%s%c", 
+				    spacer, delim) < 0)
+					return 0;
+			}
+			if (fputs(i > 0 ? ",?" : "?", f) == EOF)
+				return 0;
+		}
+		if (fprintf(f, ")%c", delim) < 0)
+			return 0;
+	}
+
+	if (lang == LANG_RUST && fputs("; }", f) == EOF)
+		return 0;
+	return fputs(",\n", f) != EOF;
+}
+
+int
+gen_sql_stmts(FILE *f, size_t tabs, 
+	const struct strct *p, enum langt lang)
+{
+	const struct search	*s;
+	const struct sent	*sent;
+	const struct field	*fd;
+	const struct update	*up;
+	const struct uref	*ur;
+	const struct ord	*ord;
+	const struct nref	*nf;
+	int			 first, hastrail, needquot, rc;
+	size_t			 pos, nc, col, ntabs;
+	char			 delim;
+	const char		*spacer;
+
+	delim = lang == LANG_JS ? '\'' : '"';
+	spacer = lang == LANG_C ? "" : "+ ";
+
+	/* 
+	 * We have a special query just for our unique fields.
+	 * These are generated in the event of null foreign key
+	 * reference lookups with the generated db_xxx_reffind()
+	 * functions.
+	 * TODO: figure out which ones we should be generating and only
+	 * do this, as otherwise we're just wasting static space.
+	 */
+
+	TAILQ_FOREACH(fd, &p->fq, entries)  {
+		if (!(fd->flags & (FIELD_ROWID|FIELD_UNIQUE)))
+			continue;
+
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_unique(f, 1, fd, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+		if (!gen_sql_stmt_unique(f, tabs, lang, fd, 1))
+			return 0;
+	}
+
+	/* Print custom search queries. */
+
+	pos = 0;
+	TAILQ_FOREACH(s, &p->sq, entries) {
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_query(f, 1, p, pos++, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
 			return 0;
 		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
 			return 0;
@@ -619,15 +1144,40 @@ gen_sql_stmts(FILE *f, size_t tabs,
 		 * Juggle around the possibilities of...
 		 *   select count(*)
 		 *   select count(distinct --gen_sql_stmt_schema--)
+		 *   select sum(table.field)
+		 *   select alias.field, count(*) ... group by alias.field
+		 *   select exists(select 1 ... limit 1)
 		 *   select --gen_sql_stmt_schema--
 		 */
 
+		if (SEARCH_ISHISTO(s)) {
+			if ((rc = fprintf(f, "%s.%s, ",
+			    s->group->alias == NULL ?
+			    p->name : s->group->alias->alias,
+			    s->group->field->name)) < 0)
+				return 0;
+			col += (size_t)rc;
+		}
 		if (s->type == STYPE_COUNT) {
 			if ((rc = fprintf(f, "COUNT(")) < 0)
 				return 0;
 			col += (size_t)rc;
 		}
-		if (s->dst) {
+		if (s->type == STYPE_EXISTS) {
+			if ((rc = fprintf(f, "EXISTS(SELECT 1")) < 0)
+				return 0;
+			col += (size_t)rc;
+		} else if (STYPE_ISAGGR(s->type)) {
+			assert(!TAILQ_EMPTY(&s->projq));
+			if ((rc = fprintf(f, "%s(%s.%s)",
+			    s->type == STYPE_SUM ? "SUM" :
+			    s->type == STYPE_AVG ? "AVG" :
+			    s->type == STYPE_MIN ? "MIN" : "MAX",
+			    p->name,
+			    TAILQ_FIRST(&s->projq)->field->name)) < 0)
+				return 0;
+			col += (size_t)rc;
+		} else if (s->dst) {
 			if ((rc = fprintf(f, "DISTINCT ")) < 0)
 				return 0;
 			col += (size_t)rc;
@@ -637,6 +1187,12 @@ gen_sql_stmts(FILE *f, size_t tabs,
 			    NULL : s->dst->fname, &col))
 				return 0;
 			needquot = 1;
+		} else if (s->type != STYPE_COUNT &&
+		    !TAILQ_EMPTY(&s->projq)) {
+			if (!gen_sql_stmt_projected(f, ntabs, 
+			    lang, s, &col))
+				return 0;
+			needquot = 1;
 		} else if (s->type != STYPE_COUNT) {
 			if (!gen_sql_stmt_schema(f, ntabs, lang,
 			    p, 1, p, NULL, &col))
@@ -660,7 +1216,8 @@ gen_sql_stmts(FILE *f, size_t tabs,
 		 */
 
 		hastrail = 
-			(s->aggr != NULL && s->group != NULL) ||
+			(s->type == STYPE_EXISTS) ||
+			(s->group != NULL) ||
 			(!TAILQ_EMPTY(&s->sntq)) ||
 			(!TAILQ_EMPTY(&s->ordq)) ||
 			(s->type != STYPE_SEARCH && s->limit > 0) ||
@@ -736,7 +1293,7 @@ gen_sql_stmts(FILE *f, size_t tabs,
 		 * failed and aren't part of the results.
 		 */
 
-		if (s->group != NULL) {
+		if (s->group != NULL && s->aggr != NULL) {
 			if (first && fputs("WHERE", f) == EOF)
 				return 0;
 			if (fprintf(f, " _custom.%s IS NULL", 
@@ -775,6 +1332,25 @@ gen_sql_stmts(FILE *f, size_t tabs,
 			}
 		}
 
+		/* Grouped counts are also ordered by their group. */
+
+		if (SEARCH_ISHISTO(s) && fprintf(f, 
+		    "%sGROUP BY %s.%s ORDER BY %s.%s ASC",
+		    first ? "" : " ",
+		    s->group->alias == NULL ?
+		    p->name : s->group->alias->alias,
+		    s->group->field->name,
+		    s->group->alias == NULL ?
+		    p->name : s->group->alias->alias,
+		    s->group->field->name) < 0)
+			return 0;
+
+		/* Existence checks (never ordered) stop at one row. */
+
+		if (s->type == STYPE_EXISTS && fprintf(f, 
+		    "%sLIMIT 1)", first ? "" : " ") < 0)
+			return 0;
+
 		first = 1;
 		if (!TAILQ_EMPTY(&s->ordq) &&
 		    fputs(" ORDER BY ", f) == EOF)
@@ -806,6 +1382,28 @@ gen_sql_stmts(FILE *f, size_t tabs,
 			return 0;
 	}
 
+	/* Searches on a unique column run over a list of keys. */
+
+	pos = 0;
+	TAILQ_FOREACH(s, &p->sq, entries) {
+		pos++;
+		if (!(s->flags & SEARCH_HAS_MANY))
+			continue;
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_query_many(f, 1, p, pos - 1, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+		if (!gen_sql_stmt_unique(f, tabs, lang, 
+		    TAILQ_FIRST(&s->sntq)->field, GEN_MANY_CHUNK))
+			return 0;
+	}
+
 	/* Insertion of a new record. */
 
 	if (p->ins != NULL) {
@@ -835,84 +1433,152 @@ gen_sql_stmts(FILE *f, size_t tabs,
 			return 0;
 		col += (size_t)rc;
 
+		if (!gen_sql_stmt_insert(f, ntabs, lang, p, &col))
+			return 0;
+		if (lang == LANG_RUST && fputs("; }", f) == EOF)
+			return 0;
+		if (fputs(",\n", f) == EOF)
+			return 0;
+	}
+
+	/* The same insertion returning the new row. */
+
+	if (p->ins != NULL && (p->ins->flags & INSERT_RETURNING)) {
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_insert_returning(f, 1, p, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+
+		ntabs = lang == LANG_RUST ? tabs + 1 : tabs;
+
+		if (!gen_ws(f, ntabs, lang))
+			return 0;
+		col = ntabs * 8;
+		if (lang == LANG_RUST) {
+			if (fputs("s = String::new() + ", f) == EOF)
+				return 0;
+			col += 21;
+		}
+		if ((rc = fprintf(f, 
+		    "%cINSERT INTO %s ", delim, p->name)) < 0)
+			return 0;
+		col += (size_t)rc;
+		if (!gen_sql_stmt_insert(f, ntabs, lang, p, &col))
+			return 0;
+		if (fputc('\n', f) == EOF ||
+		    !gen_ws(f, ntabs + 1, lang) ||
+		    fprintf(f, "%s%c", spacer, delim) < 0)
+			return 0;
+		if (!gen_sql_stmt_returning(f, ntabs, lang, p))
+			return 0;
+		if (lang == LANG_RUST && fputs("; }", f) == EOF)
+			return 0;
+		if (fputs(",\n", f) == EOF)
+			return 0;
+	}
+
+	/* 
+	 * Insertion or update on conflict with the target's unique
+	 * constraint.
+	 * The row identifier is returned in both cases.
+	 */
+
+	if (p->ups != NULL) {
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_upsert(f, 1, p, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+
+		ntabs = lang == LANG_RUST ? tabs + 1 : tabs;
+
+		if (!gen_ws(f, ntabs, lang))
+			return 0;
+		col = ntabs * 8;
+		if (lang == LANG_RUST) {
+			if (fputs("s = String::new() + ", f) == EOF)
+				return 0;
+			col += 21;
+		}
+		if ((rc = fprintf(f, 
+		    "%cINSERT INTO %s ", delim, p->name)) < 0)
+			return 0;
+		col += (size_t)rc;
+		if (!gen_sql_stmt_insert(f, ntabs, lang, p, &col))
+			return 0;
+
+		if (fputc('\n', f) == EOF ||
+		    !gen_ws(f, ntabs + 1, lang) ||
+		    fprintf(f, "%s%c ON CONFLICT ", spacer, delim) < 0)
+			return 0;
 		first = 1;
+		TAILQ_FOREACH(nf, &p->ups->target->nq, entries) {
+			if (fprintf(f, "%c%s", 
+			    first ? '(' : ',', nf->field->name) < 0)
+				return 0;
+			first = 0;
+		}
+		if (fprintf(f, ") DO UPDATE SET%c\n", delim) < 0)
+			return 0;
+
+		/* 
+		 * Update all columns not in the target.  If there are
+		 * none, re-assign a target column so that the returning
+		 * clause still produces the row.
+		 */
+
+		first = 1;
+		col = 0;
 		TAILQ_FOREACH(fd, &p->fq, entries) {
 			if (fd->type == FTYPE_STRUCT ||
 			    (fd->flags & FIELD_ROWID))
 				continue;
-			if (col >= 72) {
-				if (fprintf(f, "%s%c\n", 
-				    first ? "" : ",", delim) < 0)
+			TAILQ_FOREACH(nf, &p->ups->target->nq, entries)
+				if (nf->field == fd)
+					break;
+			if (nf != NULL)
+				continue;
+			if (first || col >= 72) {
+				if (!first && 
+				    fprintf(f, ",%c\n", delim) < 0)
 					return 0;
 				if (!gen_ws(f, ntabs + 1, lang))
 					return 0;
-				if (fprintf(f, "%s%c%s", spacer, 
-				    delim, first ? "(" : " ") < 0)
+				if ((rc = fprintf(f, "%s%c", 
+				    spacer, delim)) < 0)
 					return 0;
-				col = (ntabs + 1) * 8;
-			} else if (fputc(first ? '(' : ',', f) == EOF)
+				col = (ntabs + 1) * 8 + (size_t)rc;
+			} else if (fputc(',', f) == EOF)
 				return 0;
-
-			if ((rc = fprintf(f, "%s", fd->name)) < 0)
+			if ((rc = fprintf(f, " %s = excluded.%s", 
+			    fd->name, fd->name)) < 0)
 				return 0;
 			col += 1 + (size_t)rc;
 			first = 0;
 		}
-
-		if (first == 0) {
-			if ((rc = fprintf(f, ") ")) < 0)
-				return 0;
-			if ((col += (size_t)rc) >= 72) {
-				if (fprintf(f, "%c\n", delim) < 0)
-					return 0;
-				if (!gen_ws(f, ntabs + 1, lang))
-					return 0;
-				col = (ntabs + 1) * 8;
-				if ((rc = fprintf(f, 
-				    "%s%c", spacer, delim)) < 0)
-					return 0;
-				col += (size_t)rc;
-			}
-
-			first = 1;
-			if ((rc = fprintf(f, "VALUES ")) < 0)
-				return 0;
-			col += (size_t)rc;
-			TAILQ_FOREACH(fd, &p->fq, entries) {
-				if (fd->type == FTYPE_STRUCT ||
-				    (fd->flags & FIELD_ROWID))
-					continue;
-				if (col >= 72) {
-					if (fprintf(f, "%s%c\n", 
-					    first ? "" : ",", 
-					    delim) < 0)
-						return 0;
-					if (!gen_ws(f, ntabs + 1, lang))
-						return 0;
-					col = (ntabs + 1) * 8;
-					rc = fprintf(f, "%s%c%s", spacer,
-						delim, first ? "(" : " ");
-					if (rc < 0)
-						return 0;
-					col += (size_t)rc;
-				} else {
-					if (fputc(first ? 
-					    '(' : ',', f) == EOF)
-						return 0;
-				}
-
-				if (fputc('?', f) == EOF)
-					return 0;
-				col += 2;
-				first = 0;
-			}
-			if (fprintf(f, ")%c", delim) < 0)
-				return 0;
-		} else {
-			if (fprintf(f, 
-			    "DEFAULT VALUES%c", delim) < 0)
+		if (first) {
+			nf = TAILQ_FIRST(&p->ups->target->nq);
+			if (!gen_ws(f, ntabs + 1, lang) ||
+			    fprintf(f, "%s%c %s = excluded.%s", spacer,
+			    delim, nf->field->name, nf->field->name) < 0)
 				return 0;
 		}
+		if (fprintf(f, "%c\n", delim) < 0 ||
+		    !gen_ws(f, ntabs + 1, lang) ||
+		    fprintf(f, "%s%c RETURNING rowid%c", 
+		    spacer, delim, delim) < 0)
+			return 0;
 		if (lang == LANG_RUST && fputs("; }", f) == EOF)
 			return 0;
 		if (fputs(",\n", f) == EOF)
@@ -947,81 +1613,38 @@ gen_sql_stmts(FILE *f, size_t tabs,
 				return 0;
 			col += 21;
 		}
-		if (fprintf(f, "%cUPDATE %s SET", delim, p->name) < 0)
+		if (!gen_sql_stmt_update(f, lang, up))
+			return 0;
+		if (fputc(delim, f) == EOF)
+			return 0;
+		if (lang == LANG_RUST && fputs("; }", f) == EOF)
+			return 0;
+		if (fputs(",\n", f) == EOF)
 			return 0;
 
-		first = 1;
-		TAILQ_FOREACH(ur, &up->mrq, entries) {
-			if (fputc(first ? ' ' : ',', f) == EOF)
-				return 0;
-
-			first = 0;
-			switch (ur->mod) {
-			case MODTYPE_INC:
-				if (fprintf(f, "%s = %s + ?", 
-				    ur->field->name, 
-				    ur->field->name) < 0)
-					return 0;
-				break;
-			case MODTYPE_DEC:
-				if (fprintf(f, "%s = %s - ?", 
-				    ur->field->name, 
-				    ur->field->name) < 0)
-					return 0;
-				break;
-			case MODTYPE_CONCAT:
-				if (fprintf(f, "%s = ", 
-				    ur->field->name) < 0)
-					return 0;
-
-				/*
-				 * If we concatenate a NULL with a
-				 * non-NULL, we'll always get a NULL
-				 * value, which isn't what we want.
-				 * This will wrap possibly-null values
-				 * so that they're always strings.
-				 */
-
-				if ((ur->field->flags & FIELD_NULL)) {
-					if (fprintf(f, 
-					    "COALESCE(%s,'')",
-					    ur->field->name) < 0)
-						return 0;
-				} else {
-					if (fprintf(f, "%s", 
-					    ur->field->name) < 0)
-						return 0;
-				}
-				if (fputs(" || ?", f) == EOF)
-					return 0;
-				break;
-			default:
-				if (fprintf(f, "%s = ?", 
-				    ur->field->name) < 0)
-					return 0;
-				break;
-			}
-		}
+		/* The same update returning the row. */
 
-		first = 1;
-		TAILQ_FOREACH(ur, &up->crq, entries) {
-			if (fprintf(f, " %s ", 
-			    first ? "WHERE" : "AND") < 0)
-				return 0;
-			if (OPTYPE_ISUNARY(ur->op)) {
-				if (fprintf(f, "%s %s", 
-				    ur->field->name, 
-				    optypes[ur->op]) < 0)
-					return 0;
-			} else {
-				if (fprintf(f, "%s %s ?", 
-				    ur->field->name,
-				    optypes[ur->op]) < 0)
-					return 0;
-			}
-			first = 0;
-		}
-		if (fputc(delim, f) == EOF)
+		if (!(up->flags & UPDATE_RETURNING))
+			continue;
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_update_returning
+		    (f, 1, p, pos - 1, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+		if (!gen_ws(f, ntabs, lang))
+			return 0;
+		if (lang == LANG_RUST &&
+		    fputs("s = String::new() + ", f) == EOF)
+			return 0;
+		if (!gen_sql_stmt_update(f, lang, up))
+			return 0;
+		if (!gen_sql_stmt_returning(f, ntabs, lang, p))
 			return 0;
 		if (lang == LANG_RUST && fputs("; }", f) == EOF)
 			return 0;
@@ -1083,12 +1706,84 @@ gen_sql_stmts(FILE *f, size_t tabs,
 			return 0;
 	}
 
+	/* On-demand loading of lazy columns by row identifier. */
+
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (!(fd->flags & FIELD_LAZY))
+			continue;
+		assert(p->rowid != NULL);
+
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_load(f, 1, fd, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+
+		ntabs = lang == LANG_RUST ? tabs + 1 : tabs;
+
+		if (!gen_ws(f, ntabs, lang))
+			return 0;
+		if (lang == LANG_RUST &&
+		    fputs("s = String::new() + ", f) == EOF)
+			return 0;
+		if (fprintf(f, "%cSELECT %s FROM %s WHERE %s = ?%c",
+		    delim, fd->name, p->name, p->rowid->name,
+		    delim) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs("; }", f) == EOF)
+			return 0;
+		if (fputs(",\n", f) == EOF)
+			return 0;
+		if (fd->type != FTYPE_BLOB)
+			continue;
+
+		/*
+		 * Lazy blobs may also be sized: length() of a blob
+		 * column is answered from the record header without
+		 * reading the content.
+		 */
+
+		if (!gen_ws(f, tabs, lang))
+			return 0;
+		if (lang != LANG_RUST && fputs("/* ", f) == EOF)
+			return 0;
+		if (gen_enum_blob(f, 1, fd, lang) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs(" => {\n", f) == EOF)
+			return 0;
+		if (lang != LANG_RUST && fputs(" */\n", f) == EOF)
+			return 0;
+		if (!gen_ws(f, ntabs, lang))
+			return 0;
+		if (lang == LANG_RUST &&
+		    fputs("s = String::new() + ", f) == EOF)
+			return 0;
+		if (fprintf(f, "%cSELECT length(%s) FROM %s "
+		    "WHERE %s = ?%c", delim, fd->name, p->name,
+		    p->rowid->name, delim) < 0)
+			return 0;
+		if (lang == LANG_RUST && fputs("; }", f) == EOF)
+			return 0;
+		if (fputs(",\n", f) == EOF)
+			return 0;
+	}
+
 	return 1;
 }
 
-int
-gen_sql_enums(FILE *f, size_t tabs,
-	const struct strct *p, enum langt lang)
+/*
+ * Print the statement enumerations of "p", one per line, each wrapped
+ * in the string "q".
+ * Return zero on failure, non-zero on success.
+ */
+static int
+gen_sql_enums_quoted(FILE *f, size_t tabs,
+	const struct strct *p, enum langt lang, const char *q)
 {
 	const struct search	*s;
 	const struct update	*u;
@@ -1098,37 +1793,237 @@ gen_sql_enums(FILE *f, size_t tabs,
 	TAILQ_FOREACH(fd, &p->fq, entries)
 		if (fd->flags & (FIELD_UNIQUE|FIELD_ROWID))
 			if (!gen_ws(f, tabs, lang) ||
+			    fputs(q, f) == EOF ||
 			    gen_enum_unique(f, 0, fd, lang) < 0 ||
-			    fputs(",\n", f) == EOF)
+			    fprintf(f, "%s,\n", q) < 0)
 				return 0;
 
 	pos = 0;
 	TAILQ_FOREACH(s, &p->sq, entries)
 		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
 		    gen_enum_query(f, 0, p, pos++, lang) < 0 ||
-		    fputs(",\n", f) == EOF)
+		    fprintf(f, "%s,\n", q) < 0)
 			return 0;
 
+	pos = 0;
+	TAILQ_FOREACH(s, &p->sq, entries) {
+		pos++;
+		if ((s->flags & SEARCH_HAS_MANY) &&
+		    (!gen_ws(f, tabs, lang) ||
+		     fputs(q, f) == EOF ||
+		     gen_enum_query_many(f, 0, p, pos - 1, lang) < 0 ||
+		     fprintf(f, "%s,\n", q) < 0))
+			return 0;
+	}
+
 	if (p->ins != NULL)
 		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
 		    gen_enum_insert(f, 0, p, lang) < 0 ||
-		    fputs(",\n", f) == EOF)
+		    fprintf(f, "%s,\n", q) < 0)
+			return 0;
+
+	if (p->ins != NULL && (p->ins->flags & INSERT_RETURNING))
+		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
+		    gen_enum_insert_returning(f, 0, p, lang) < 0 ||
+		    fprintf(f, "%s,\n", q) < 0)
+			return 0;
+
+	if (p->ups != NULL)
+		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
+		    gen_enum_upsert(f, 0, p, lang) < 0 ||
+		    fprintf(f, "%s,\n", q) < 0)
 			return 0;
 
 	pos = 0;
-	TAILQ_FOREACH(u, &p->uq, entries)
+	TAILQ_FOREACH(u, &p->uq, entries) {
 		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
 		    gen_enum_update(f, 0, p, pos++, lang) < 0 ||
-		    fputs(",\n", f) == EOF)
+		    fprintf(f, "%s,\n", q) < 0)
+			return 0;
+		if ((u->flags & UPDATE_RETURNING) &&
+		    (!gen_ws(f, tabs, lang) ||
+		     fputs(q, f) == EOF ||
+		     gen_enum_update_returning
+		     (f, 0, p, pos - 1, lang) < 0 ||
+		     fprintf(f, "%s,\n", q) < 0))
 			return 0;
+	}
 
 	pos = 0;
 	TAILQ_FOREACH(u, &p->dq, entries)
 		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
 		    gen_enum_delete(f, 0, p, pos++, lang) < 0 ||
-		    fputs(",\n", f) == EOF)
+		    fprintf(f, "%s,\n", q) < 0)
 			return 0;
 
+	TAILQ_FOREACH(fd, &p->fq, entries) {
+		if (!(fd->flags & FIELD_LAZY))
+			continue;
+		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
+		    gen_enum_load(f, 0, fd, lang) < 0 ||
+		    fprintf(f, "%s,\n", q) < 0)
+			return 0;
+		if (fd->type != FTYPE_BLOB)
+			continue;
+		if (!gen_ws(f, tabs, lang) ||
+		    fputs(q, f) == EOF ||
+		    gen_enum_blob(f, 0, fd, lang) < 0 ||
+		    fprintf(f, "%s,\n", q) < 0)
+			return 0;
+	}
+
 	return 1;
 }
 
+int
+gen_sql_enums(FILE *f, size_t tabs,
+	const struct strct *p, enum langt lang)
+{
+
+	return gen_sql_enums_quoted(f, tabs, p, lang, "");
+}
+
+int
+gen_sql_enum_names(FILE *f, size_t tabs, const struct strct *p)
+{
+
+	return gen_sql_enums_quoted(f, tabs, p, LANG_C, "\"");
+}
+
+
+/*
+ * One structure's output as rendered by gen_each_strct().
+ */
+struct	strctjob {
+	const struct strct	*p;
+	char			*buf; /* output or NULL */
+	size_t			 bufsz; /* length of output */
+	int			 rc; /* generator result */
+};
+
+/*
+ * Jobs shared between gen_each_strct() workers.
+ * Each worker takes the next unclaimed job until none remain.
+ */
+struct	strctpool {
+	pthread_mutex_t	 	 mtx; /* protects "next" */
+	struct strctjob		*jobs;
+	size_t			 jobsz;
+	size_t			 next; /* next unclaimed job */
+	gen_strctf		 fp;
+	void			*arg;
+};
+
+static void *
+gen_each_strct_worker(void *arg)
+{
+	struct strctpool	*pool = arg;
+	struct strctjob		*job;
+	FILE			*f;
+	size_t			 i;
+
+	for (;;) {
+		if (pthread_mutex_lock(&pool->mtx) != 0)
+			return NULL;
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->mtx);
+		if (i >= pool->jobsz)
+			break;
+		job = &pool->jobs[i];
+		f = open_memstream(&job->buf, &job->bufsz);
+		if (f == NULL)
+			continue;
+		job->rc = pool->fp(f, job->p, pool->arg);
+		if (fclose(f) == EOF)
+			job->rc = 0;
+	}
+
+	return NULL;
+}
+
+/*
+ * Run "fp" for each structure in "cfg" in order, writing into "f".
+ * If "jobs" is greater than one, structures are rendered into their
+ * own memory buffers by up to that many threads (including the
+ * caller's), then written out in the original order, so the output
+ * is the same as when run serially.
+ * Return zero on failure, non-zero on success.
+ */
+int
+gen_each_strct(FILE *f, const struct config *cfg, size_t jobs,
+	gen_strctf fp, void *arg)
+{
+	const struct strct	*p;
+	struct strctpool	 pool;
+	pthread_t		*thrs = NULL;
+	size_t			 i, thrsz = 0;
+	int			 rc = 0;
+
+	memset(&pool, 0, sizeof(struct strctpool));
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		pool.jobsz++;
+
+	if (jobs <= 1 || pool.jobsz <= 1) {
+		TAILQ_FOREACH(p, &cfg->sq, entries)
+			if (!fp(f, p, arg))
+				return 0;
+		return 1;
+	}
+
+	if (jobs > pool.jobsz)
+		jobs = pool.jobsz;
+
+	pool.fp = fp;
+	pool.arg = arg;
+	pool.jobs = calloc(pool.jobsz, sizeof(struct strctjob));
+	if (pool.jobs == NULL)
+		return 0;
+	i = 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		pool.jobs[i++].p = p;
+
+	if (pthread_mutex_init(&pool.mtx, NULL) != 0) {
+		free(pool.jobs);
+		return 0;
+	}
+
+	/* 
+	 * Failing to start a thread isn't an error: the caller's
+	 * thread always works, so we just run with fewer.
+	 */
+
+	if ((thrs = calloc(jobs - 1, sizeof(pthread_t))) != NULL)
+		for ( ; thrsz < jobs - 1; thrsz++)
+			if (pthread_create(&thrs[thrsz], NULL,
+			    gen_each_strct_worker, &pool) != 0)
+				break;
+
+	gen_each_strct_worker(&pool);
+
+	for (i = 0; i < thrsz; i++)
+		pthread_join(thrs[i], NULL);
+
+	/* All jobs have finished: concatenate in order. */
+
+	for (i = 0; i < pool.jobsz; i++)
+		if (!pool.jobs[i].rc ||
+		    fwrite(pool.jobs[i].buf, 1, pool.jobs[i].bufsz,
+		     f) != pool.jobs[i].bufsz)
+			break;
+
+	rc = i == pool.jobsz;
+
+	for (i = 0; i < pool.jobsz; i++)
+		free(pool.jobs[i].buf);
+	free(pool.jobs);
+	free(thrs);
+	pthread_mutex_destroy(&pool.mtx);
+	return rc;
+}
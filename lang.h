@@ -35,15 +35,42 @@ enum	langt {
 	LANG_RUST
 };
 
+/*
+ * Number of keys bound by each statement of a multi-row lookup
+ * (SEARCH_HAS_MANY).
+ * Short chunks are padded by repeating the last key.
+ */
+#define	GEN_MANY_CHUNK	64
+
+/*
+ * Per-structure generator run by gen_each_strct().
+ * Must not touch any state shared between structures.
+ */
+typedef	int (*gen_strctf)(FILE *, const struct strct *, void *);
+
 int	 gen_comment(FILE *, size_t, enum cmtt, const char *);
 int	 gen_commentv(FILE *, size_t, enum cmtt, const char *, ...)
 		__attribute__((format(printf, 4, 5)));
 int	 gen_sql_stmts(FILE *, size_t, const struct strct *, enum langt);
 int	 gen_sql_enums(FILE *, size_t, const struct strct *, enum langt);
+int	 gen_sql_enum_names(FILE *, size_t, const struct strct *);
+const char *gen_sql_placeholder(const struct field *, enum langt);
+int	 gen_search_projected(const struct search *);
+uint64_t gen_filled(const struct strct *, const struct search *, size_t);
+size_t	 gen_filled_col(const struct field *);
+size_t	 gen_filled_words(const struct strct *);
 int	 gen_enum_delete(FILE *, int, const struct strct *, size_t, enum langt);
 int	 gen_enum_insert(FILE *, int, const struct strct *, enum langt);
+int	 gen_enum_upsert(FILE *, int, const struct strct *, enum langt);
+int	 gen_enum_load(FILE *, int, const struct field *, enum langt);
+int	 gen_enum_blob(FILE *, int, const struct field *, enum langt);
 int	 gen_enum_update(FILE *, int, const struct strct *, size_t, enum langt);
+int	 gen_enum_update_returning(FILE *, int, const struct strct *, size_t, enum langt);
+int	 gen_enum_insert_returning(FILE *, int, const struct strct *, enum langt);
 int	 gen_enum_query(FILE *, int, const struct strct *, size_t, enum langt);
+int	 gen_enum_query_many(FILE *, int, const struct strct *, size_t, enum langt);
 int	 gen_enum_unique(FILE *, int, const struct field *, enum langt);
+int	 gen_each_strct(FILE *, const struct config *, size_t,
+		gen_strctf, void *);
 
 #endif /* !ORT_LANG_H */
@@ -133,10 +133,44 @@ check_aggrtype(struct config *cfg, const struct search *srch)
 {
 	size_t	errs = 0;
 
-	if (srch->group != NULL) {
-		if (srch->aggr == NULL) {
-			gen_errx(cfg, &srch->group->pos,
-				"group without a constraint");
+	if (srch->group != NULL && srch->aggr == NULL &&
+	    srch->type != STYPE_COUNT) {
+		gen_errx(cfg, &srch->group->pos,
+			"group without a constraint");
+		errs++;
+	}
+
+	/*
+	 * Grouped counts return the grouped column's value, so limit
+	 * these to scalar types that don't need to be freed, and order
+	 * on the grouped column.
+	 */
+
+	if (SEARCH_ISHISTO(srch)) {
+		switch (srch->group->field->type) {
+		case FTYPE_BIT:
+		case FTYPE_BITFIELD:
+		case FTYPE_DATE:
+		case FTYPE_ENUM:
+		case FTYPE_EPOCH:
+		case FTYPE_INT:
+		case FTYPE_REAL:
+			break;
+		default:
+			gen_errx(cfg, &srch->group->pos, "grouped "
+				"count on a non-numeric, "
+				"non-enumeration field");
+			errs++;
+			break;
+		}
+		if (srch->dst != NULL) {
+			gen_errx(cfg, &srch->group->pos, "grouped "
+				"count may not use distinct");
+			errs++;
+		}
+		if (!TAILQ_EMPTY(&srch->ordq)) {
+			gen_errx(cfg, &srch->group->pos, "grouped "
+				"count may not be ordered");
 			errs++;
 		}
 	}
@@ -168,25 +202,95 @@ static int
 check_searchtype(struct config *cfg, const struct search *srch)
 {
 	const struct sent	*sent;
+	const struct proj	*proj;
 	size_t			 errs = 0;
 
 	/*
 	 * XXX: we use SQL's "count" function for this, so we can't
 	 * currently use any of the password equality checks.
+	 * The same goes for "exists" and the aggregate functions.
 	 */
 
-	if (srch->type == STYPE_COUNT)
+	if (srch->type == STYPE_COUNT || srch->type == STYPE_EXISTS ||
+	    STYPE_ISAGGR(srch->type))
 		TAILQ_FOREACH(sent, &srch->sntq, entries)
 			if (!OPTYPE_ISUNARY(sent->op) &&
 			    sent->op != OPTYPE_STREQ &&
 			    sent->op != OPTYPE_STRNEQ &&
 			    sent->field->type == FTYPE_PASSWORD) {
 				gen_errx(cfg, &sent->pos, "passwords "
-					"for count only accept unary "
-					"and string operators");
+					"for %s only accept unary "
+					"and string operators",
+					srch->type == STYPE_COUNT ?
+					"count" : 
+					srch->type == STYPE_EXISTS ?
+					"exists" : "aggregates");
 				errs++;
 			}
+
+	/*
+	 * Aggregates reduce exactly one numeric column of the
+	 * structure itself, named with "select", to a scalar.
+	 * Row-picking and distinct subsets make no sense here.
+	 */
+
+	if (STYPE_ISAGGR(srch->type)) {
+		proj = TAILQ_FIRST(&srch->projq);
+		if (proj == NULL) {
+			gen_errx(cfg, &srch->pos, "aggregate "
+				"queries must select one field");
+			errs++;
+		} else if (TAILQ_NEXT(proj, entries) != NULL) {
+			gen_errx(cfg, &TAILQ_NEXT(proj, entries)->pos,
+				"aggregate queries must select "
+				"only one field");
+			errs++;
+		} else if (proj->field->type != FTYPE_INT &&
+		    proj->field->type != FTYPE_REAL) {
+			gen_errx(cfg, &proj->pos, "aggregate "
+				"queries must select an integer "
+				"or real field");
+			errs++;
+		}
+		if (srch->dst != NULL) {
+			gen_errx(cfg, &srch->dst->pos, "aggregate "
+				"queries may not use distinct");
+			errs++;
+		}
+		if (srch->aggr != NULL || srch->group != NULL) {
+			gen_errx(cfg, &srch->pos, "aggregate "
+				"queries may not use minrow, "
+				"maxrow, or grouprow");
+			errs++;
+		}
+	}
 	
+	/*
+	 * Existence checks stop at the first matching row, so there's
+	 * nothing to order, limit, or pick amongst.
+	 */
+
+	if (srch->type == STYPE_EXISTS) {
+		if (srch->dst != NULL) {
+			gen_errx(cfg, &srch->dst->pos, "exists "
+				"queries may not use distinct");
+			errs++;
+		}
+		if (srch->aggr != NULL || srch->group != NULL) {
+			gen_errx(cfg, &srch->pos, "exists "
+				"queries may not use minrow, "
+				"maxrow, or grouprow");
+			errs++;
+		}
+		if (!TAILQ_EMPTY(&srch->ordq) ||
+		    srch->limit > 0 || srch->offset > 0) {
+			gen_errx(cfg, &srch->pos, "exists "
+				"queries may not be ordered, "
+				"limited, or offset");
+			errs++;
+		}
+	}
+
 	/*
 	 * Start by checking that singleton returns don't occur on
 	 * multiple searches and vice versa.
@@ -198,6 +302,7 @@ check_searchtype(struct config *cfg, const struct search *srch)
 			"single-result search without parameters "
 			"and without a limit of one");
 	if (srch->type != STYPE_SEARCH &&
+	    srch->type != STYPE_EXISTS &&
 	    (srch->flags & SEARCH_IS_UNIQUE))
 		gen_warnx(cfg, &srch->pos,
 			"multiple-result search on a unique field");
@@ -274,6 +379,48 @@ check_searchtype(struct config *cfg, const struct search *srch)
 			errs++;
 		}
 
+	/*
+	 * Selected columns only apply to the returned structure, so
+	 * don't allow them for counts and distinct results.
+	 * Passwords checked after the query need their hash column.
+	 * Aggregates have their own rules, above.
+	 */
+
+	if (!STYPE_ISAGGR(srch->type) &&
+	    (proj = TAILQ_FIRST(&srch->projq)) != NULL) {
+		if (srch->type == STYPE_COUNT ||
+		    srch->type == STYPE_EXISTS) {
+			gen_errx(cfg, &proj->pos,
+				"select not allowed on %s queries",
+				srch->type == STYPE_COUNT ?
+				"count" : "exists");
+			errs++;
+		}
+		if (srch->dst != NULL) {
+			gen_errx(cfg, &proj->pos,
+				"select not allowed when searching "
+				"on distinct subsets");
+			errs++;
+		}
+		TAILQ_FOREACH(sent, &srch->sntq, entries) {
+			if (OPTYPE_ISUNARY(sent->op) ||
+			    sent->op == OPTYPE_STREQ ||
+			    sent->op == OPTYPE_STRNEQ ||
+			    sent->field->type != FTYPE_PASSWORD ||
+			    sent->field->parent != srch->parent)
+				continue;
+			TAILQ_FOREACH(proj, &srch->projq, entries)
+				if (proj->field == sent->field)
+					break;
+			if (proj != NULL)
+				continue;
+			gen_errx(cfg, &sent->pos,
+				"password queries must select "
+				"the password field");
+			errs++;
+		}
+	}
+
 	return errs == 0;
 }
 
@@ -340,6 +487,27 @@ check_reffind(struct config *cfg, const struct strct *p)
 	return 0;
 }
 
+/*
+ * Lazy fields are loaded on demand by the row identifier, so their
+ * structure must have one.
+ * Return zero on failure, non-zero on success.
+ */
+static int
+check_lazy(struct config *cfg, const struct strct *p)
+{
+	const struct field	*f;
+	size_t			 errs = 0;
+
+	TAILQ_FOREACH(f, &p->fq, entries)
+		if ((f->flags & FIELD_LAZY) && p->rowid == NULL) {
+			gen_errx(cfg, &f->pos, "lazy field "
+				"requires structure rowid");
+			errs++;
+		}
+
+	return errs == 0;
+}
+
 static int
 nref_cmp(const void *a, const void *b)
 {
@@ -430,6 +598,185 @@ check_unique_unique(struct config *cfg, struct strct *s)
 	return errs == 0;
 }
 
+static int
+iref_cmp(const void *a, const void *b)
+{
+	const struct iref	*ia = *(const struct iref *const *)a,
+	     			*ib = *(const struct iref *const *)b;
+
+	return strcasecmp(ia->field->name, ib->field->name);
+}
+
+/*
+ * See whether two queues of index references are the same in order,
+ * by field and operator.
+ * Return zero if dissimilar, non-zero if similar.
+ */
+static int
+check_index_irefq(const struct irefq *a, const struct irefq *b)
+{
+	const struct iref	*ar, *br;
+
+	ar = TAILQ_FIRST(a);
+	br = TAILQ_FIRST(b);
+	while (ar != NULL && br != NULL &&
+	       ar->field == br->field && ar->op == br->op) {
+		ar = TAILQ_NEXT(ar, entries);
+		br = TAILQ_NEXT(br, entries);
+	}
+	return ar == NULL && br == NULL;
+}
+
+/*
+ * Make sure that no two index statements have the same columns (in the
+ * same order) and the same "where" constraints.
+ * Also normalise the order of "wq" entries to be lexicographic, as the
+ * constraints are order-independent.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+check_index_index(struct config *cfg, struct strct *s)
+{
+	struct index		 *ip;
+	struct iref		 *ir;
+	const struct index	 *iip;
+	struct iref		**ar;
+	size_t			  sz, i;
+
+	TAILQ_FOREACH(ip, &s->iq, entries) {
+		sz = 0;
+		TAILQ_FOREACH(ir, &ip->wq, entries)
+			sz++;
+		if (sz < 2)
+			continue;
+		if ((ar = calloc(sz, sizeof(struct iref *))) == NULL) {
+			gen_err(cfg, NULL);
+			return 0;
+		}
+		i = 0;
+		while ((ir = TAILQ_FIRST(&ip->wq)) != NULL) {
+			ar[i++] = ir;
+			TAILQ_REMOVE(&ip->wq, ir, entries);
+		}
+		qsort(ar, sz, sizeof(struct iref *), iref_cmp);
+		for (i = 0; i < sz; i++)
+			TAILQ_INSERT_TAIL(&ip->wq, ar[i], entries);
+		free(ar);
+	}
+
+	TAILQ_FOREACH(ip, &s->iq, entries)
+		for (iip = TAILQ_NEXT(ip, entries); iip != NULL; 
+		     iip = TAILQ_NEXT(iip, entries)) {
+			if (!check_index_irefq(&ip->nq, &iip->nq) ||
+			    !check_index_irefq(&ip->wq, &iip->wq))
+				continue;
+			gen_errx(cfg, &iip->pos, "duplicate "
+				"index statements: %s:%zu:%zu",
+				ip->pos.fname, ip->pos.line,
+				ip->pos.column);
+			return 0;
+		}
+
+	return 1;
+}
+
+/*
+ * The conflict target of an upsert must match a unique constraint:
+ * either a single unique field, or the same fields as one of the
+ * structure's unique statements.
+ * The rowid is not allowed: it's never inserted, so never conflicts.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+check_upsert(struct config *cfg, const struct strct *s)
+{
+	const struct unique	*u;
+	const struct nref	*nf, *unf;
+	size_t			 sz = 0, usz;
+
+	if (s->ups == NULL)
+		return 1;
+
+	TAILQ_FOREACH(nf, &s->ups->target->nq, entries)
+		sz++;
+
+	nf = TAILQ_FIRST(&s->ups->target->nq);
+	if (sz == 1 && (nf->field->flags & FIELD_UNIQUE))
+		return 1;
+
+	TAILQ_FOREACH(u, &s->nq, entries) {
+		usz = 0;
+		TAILQ_FOREACH(unf, &u->nq, entries)
+			usz++;
+		if (usz != sz)
+			continue;
+		TAILQ_FOREACH(nf, &s->ups->target->nq, entries) {
+			TAILQ_FOREACH(unf, &u->nq, entries)
+				if (nf->field == unf->field)
+					break;
+			if (unf == NULL)
+				break;
+		}
+		if (nf == NULL)
+			return 1;
+	}
+
+	gen_errx(cfg, &s->ups->pos, "upsert fields "
+		"do not match a unique constraint");
+	return 0;
+}
+
+/*
+ * Operations returning the written row fill the structure from the
+ * statement's own columns, so there may be no references to join.
+ * Updates must also write at most one row, so they need an equality
+ * constraint on a unique or rowid field.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+check_returning(struct config *cfg, const struct strct *s)
+{
+	const struct field	*fd;
+	const struct update	*up;
+	const struct uref	*ur;
+	size_t			 errs = 0;
+	int			 refs = 0;
+
+	TAILQ_FOREACH(fd, &s->fq, entries)
+		if (fd->type == FTYPE_STRUCT)
+			refs = 1;
+
+	if (s->ins != NULL && (s->ins->flags & INSERT_RETURNING) && 
+	    refs) {
+		gen_errx(cfg, &s->ins->pos, "returning "
+			"requires structure without references");
+		errs++;
+	}
+
+	TAILQ_FOREACH(up, &s->uq, entries) {
+		if (!(up->flags & UPDATE_RETURNING))
+			continue;
+		if (refs) {
+			gen_errx(cfg, &up->pos, "returning "
+				"requires structure without references");
+			errs++;
+		}
+		TAILQ_FOREACH(ur, &up->crq, entries)
+			if ((ur->op == OPTYPE_EQUAL ||
+			     ur->op == OPTYPE_STREQ) &&
+			    (ur->field->flags & 
+			     (FIELD_ROWID | FIELD_UNIQUE)))
+				break;
+		if (ur == NULL) {
+			gen_errx(cfg, &up->pos, "returning "
+				"requires unique field constraint");
+			errs++;
+		}
+	}
+
+	return errs == 0;
+}
+
 /*
  * Make sure that the rolemap contains unique roles.
  * Returns zero on failure (duplicate roles), non-zero otherwise.
@@ -476,6 +823,9 @@ check_roleops(struct config *cfg, const struct strct *p)
 	if (p->ins != NULL && p->ins->rolemap == NULL)
 		gen_warnx(cfg, &p->ins->pos,
 			"role not assigned to insert function");
+	if (p->ups != NULL && p->ups->rolemap == NULL)
+		gen_warnx(cfg, &p->ups->pos,
+			"role not assigned to upsert function");
 }
 
 /*
@@ -495,6 +845,11 @@ ort_parse_close(struct config *cfg)
 	struct search	 *srch;
 	size_t		  colour = 1, sz = 0, i = 0;
 
+	/* Snapshots are already linked. */
+
+	if (cfg->priv->loaded)
+		return 1;
+
 	if (TAILQ_EMPTY(&cfg->sq)) {
 		gen_errx(cfg, NULL, "no structures in configuration");
 		return 0;
@@ -519,6 +874,34 @@ ort_parse_close(struct config *cfg)
 	if (i > 0)
 		return 0;
 
+	/* Check for index statement duplicates. */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		i += !check_index_index(cfg, p);
+	if (i > 0)
+		return 0;
+
+	/* Check that upserts conflict on a unique constraint. */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		i += !check_upsert(cfg, p);
+	if (i > 0)
+		return 0;
+
+	/* Check that written rows may be returned. */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		i += !check_returning(cfg, p);
+	if (i > 0)
+		return 0;
+
+	/* Check that lazy fields may be loaded. */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		i += !check_lazy(cfg, p);
+	if (i > 0)
+		return 0;
+
 	/* Check that each rolemap has no duplicate roles. */
 
 	TAILQ_FOREACH(p, &cfg->sq, entries)
@@ -23,6 +23,12 @@ void 	gen_errx(struct config *, const struct pos *, const char *, ...)
 void	gen_warnx(struct config *, const struct pos *, const char *, ...)
 		__attribute__((format(printf, 3, 4)));
 
+void	*sym_find(const struct config *, unsigned int,
+		const void *, const char *);
+int	 sym_add(struct config *, unsigned int,
+		const void *, const char *, void *);
+int	 sym_build(struct config *);
+
 int	linker_resolve(struct config *);
 int	linker_aliases(struct config *);
 
@@ -31,77 +31,109 @@
 #include "linker.h"
 
 /*
- * Map all "parent.child" chains of foreign references from a given
- * structure (recursively) into alias names.
- * Also checks that the given "orig" does not have infinite recursion.
- * This is used when creating SQL queries because we might join on the
- * same structure more than once, so it requires "AS" statements.
- * The "AS" name is the alias name.
- * FIXME: limited to 26*26*26 entries.
- * Return zero on fatal error, non-zero on success.
+ * Check whether any structure can reach itself by following its
+ * references, nullable or not.
+ * This colours structures grey while being descended and black when
+ * done; reaching a grey structure means a cycle.
+ * Returns the first structure found on a cycle or NULL if none.
  */
-static int
-linker_aliases_create(struct config *cfg, struct strct *orig, 
-	struct strct *p, size_t *offs, const struct alias *prior)
+static struct strct *
+linker_aliases_cycle(struct strct *p)
 {
 	struct field	*f;
-	struct alias	*a;
-	int		 c;
+	struct strct	*t, *rc;
 
+	p->colour = 1;
 	TAILQ_FOREACH(f, &p->fq, entries) {
 		if (f->type != FTYPE_STRUCT)
 			continue;
 		assert(f->ref != NULL);
+		t = f->ref->target->parent;
+		if (t->colour == 1)
+			return t;
+		if (t->colour == 0 && (rc = linker_aliases_cycle(t)) != NULL)
+			return rc;
+	}
+	p->colour = 2;
+	return NULL;
+}
 
-		if (f->ref->target->parent == orig) {
-			gen_errx(cfg, &orig->pos,
-				"contains recursive references");
-			return 0;
-		}
-		
-		if ((a = calloc(1, sizeof(struct alias))) == NULL) {
-			gen_err(cfg, &f->pos);
-			return 0;
-		}
-		TAILQ_INSERT_TAIL(&orig->aq, a, entries);
-
-		if (prior != NULL) {
-			c = asprintf(&a->name, "%s.%s",
-				prior->name, f->name);
-			if (c == -1) {
-				gen_err(cfg, &f->pos);
-				return 0;
-			}
-		} else if ((a->name = strdup(f->name)) == NULL) {
-			gen_err(cfg, &f->pos);
-			return 0;
-		}
+/*
+ * Create the alias for "parent.child" chain "name" of "orig", where
+ * "offs" is the running count of aliases.
+ * Alias names are "_a" through "_z", then "_ba" and so on without
+ * limit, as the count in base 26.
+ * Returns the alias or NULL on fatal error.
+ */
+static struct alias *
+linker_aliases_add(struct config *cfg, struct strct *orig,
+	const struct field *f, const struct alias *prior, size_t *offs)
+{
+	struct alias	*a;
+	char		 buf[sizeof(size_t) * 8 + 2];
+	size_t		 i = sizeof(buf) - 1, n = *offs;
+	int		 c;
 
-		if (*offs >= 26 * 26 * 26) {
-			gen_errx(cfg, &f->pos, "too many aliases");
-			return 0;
-		}
-		
-		if (*offs >= 26 * 26)
-			c = asprintf(&a->alias, "_%c%c%c", 
-				(char)(*offs / 26 / 26) + 97,
-				(char)(*offs / 26) + 97,
-				(char)(*offs % 26) + 97);
-		else if (*offs >= 26)
-			c = asprintf(&a->alias, "_%c%c", 
-				(char)(*offs / 26) + 97,
-				(char)(*offs % 26) + 97);
-		else
-			c = asprintf(&a->alias, 
-				"_%c", (char)*offs + 97);
+	if ((a = calloc(1, sizeof(struct alias))) == NULL) {
+		gen_err(cfg, &f->pos);
+		return NULL;
+	}
+	TAILQ_INSERT_TAIL(&orig->aq, a, entries);
 
+	if (prior != NULL) {
+		c = asprintf(&a->name, "%s.%s", prior->name, f->name);
 		if (c == -1) {
 			gen_err(cfg, &f->pos);
-			return 0;
+			return NULL;
 		}
+	} else if ((a->name = strdup(f->name)) == NULL) {
+		gen_err(cfg, &f->pos);
+		return NULL;
+	}
 
-		(*offs)++;
+	buf[i] = '\0';
+	do {
+		buf[--i] = (char)(n % 26) + 'a';
+		n /= 26;
+	} while (n > 0);
+	buf[--i] = '_';
 
+	if ((a->alias = strdup(&buf[i])) == NULL) {
+		gen_err(cfg, &f->pos);
+		return NULL;
+	}
+	(*offs)++;
+
+	if (!sym_add(cfg, SYM_ALIAS, orig, a->name, a))
+		return NULL;
+	return a;
+}
+
+/*
+ * Map the "parent.child" chains of foreign references from a given
+ * structure (recursively) into alias names.
+ * This is used when creating SQL queries because we might join on the
+ * same structure more than once, so it requires "AS" statements.
+ * The "AS" name is the alias name.
+ * Only non-null references are followed: these are the only ones ever
+ * joined, and searches, orders, groups, aggregates, and distincts may
+ * only be over non-null references.
+ * Return zero on fatal error, non-zero on success.
+ */
+static int
+linker_aliases_create(struct config *cfg, struct strct *orig, 
+	struct strct *p, size_t *offs, const struct alias *prior)
+{
+	struct field	*f;
+	struct alias	*a;
+
+	TAILQ_FOREACH(f, &p->fq, entries) {
+		if (f->type != FTYPE_STRUCT ||
+		    (f->ref->source->flags & FIELD_NULL))
+			continue;
+		if ((a = linker_aliases_add
+		    (cfg, orig, f, prior, offs)) == NULL)
+			return 0;
 		if (!linker_aliases_create
 		    (cfg, orig, f->ref->target->parent, offs, a))
 			return 0;
@@ -110,6 +142,26 @@ linker_aliases_create(struct config *cfg, struct strct *orig,
 	return 1;
 }
 
+/*
+ * Look up the alias of "parent.child" chain "name" of "p".
+ * Use the symbol table if it's been built, else (e.g., for a
+ * configuration whose aliases were filled in by hand) scan.
+ * Returns the alias or NULL if not found.
+ */
+const struct alias *
+ort_alias_find(const struct strct *p, const char *name)
+{
+	const struct alias	*a;
+
+	if (p->cfg->priv->st.symmax > 0)
+		return sym_find(p->cfg, SYM_ALIAS, p, name);
+
+	TAILQ_FOREACH(a, &p->aq, entries)
+		if (strcasecmp(a->name, name) == 0)
+			return a;
+	return NULL;
+}
+
 /*
  * Let linker_aliases_resolve() find unique entries that use the "unique"
  * clause for multiple fields instead of a "unique" or "rowid" on the
@@ -144,6 +196,43 @@ check_search_unique(struct config *cfg, const struct search *srch)
 	return 0;
 }
 
+/*
+ * See whether "srch" may be looked up by a list of keys: it must be on
+ * the equality of a single non-null rowid or unique scalar column of
+ * its own structure and return the full structure.
+ * Returns zero if not, non-zero if so.
+ */
+static int
+check_search_many(const struct search *srch)
+{
+	const struct sent	*s;
+
+	assert(srch->type == STYPE_SEARCH);
+
+	s = TAILQ_FIRST(&srch->sntq);
+	if (s == NULL || TAILQ_NEXT(s, entries) != NULL ||
+	    s->op != OPTYPE_EQUAL ||
+	    !(s->field->flags & (FIELD_ROWID|FIELD_UNIQUE)) ||
+	    (s->field->flags & FIELD_NULL) ||
+	    s->field->parent != srch->parent ||
+	    srch->dst != NULL || !TAILQ_EMPTY(&srch->projq))
+		return 0;
+
+	switch (s->field->type) {
+	case FTYPE_BIT:
+	case FTYPE_BITFIELD:
+	case FTYPE_DATE:
+	case FTYPE_EMAIL:
+	case FTYPE_ENUM:
+	case FTYPE_EPOCH:
+	case FTYPE_INT:
+	case FTYPE_TEXT:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
 /*
  * Resolve search terms.
  * To do so, descend into each set of search terms for the structure and
@@ -155,7 +244,6 @@ static int
 linker_aliases_resolve(struct config *cfg, struct search *srch)
 {
 	struct sent	*s;
-	struct alias	*a;
 	struct strct	*p = srch->parent;
 	struct ord	*o;
 
@@ -181,44 +269,47 @@ linker_aliases_resolve(struct config *cfg, struct search *srch)
 	    check_search_unique(cfg, srch))
 		srch->flags |= SEARCH_IS_UNIQUE;
 
+	/*
+	 * A search asking to be run over a list of keys at once must
+	 * be on exactly one of our own non-null rowid or unique
+	 * columns, reading the full structure.
+	 */
+
+	if ((srch->flags & SEARCH_HAS_MANY) && !check_search_many(srch)) {
+		gen_errx(cfg, &srch->pos, "many requires equality on a "
+			"single non-null rowid or unique column of the "
+			"structure, without distinct or select");
+		return 0;
+	}
+
 	/* Resolve search alias. */
 
 	TAILQ_FOREACH(s, &srch->sntq, entries)
 		if (s->name != NULL) {
-			TAILQ_FOREACH(a, &p->aq, entries)
-				if (strcasecmp(a->name, s->name) == 0)
-					break;
-			assert(a != NULL);
-			s->alias = a;
+			s->alias = sym_find(cfg, SYM_ALIAS, p, s->name);
+			assert(s->alias != NULL);
 		}
 
 	/* Resolve order alias. */
 
 	TAILQ_FOREACH(o, &srch->ordq, entries)
 		if (o->name != NULL) {
-			TAILQ_FOREACH(a, &p->aq, entries)
-				if (strcasecmp(a->name, o->name) == 0)
-					break;
-			assert(a != NULL);
-			o->alias = a;
+			o->alias = sym_find(cfg, SYM_ALIAS, p, o->name);
+			assert(o->alias != NULL);
 		}
 
 	/* Resolve aggregate and group row. */
 
 	if (srch->group != NULL && srch->group->name != NULL) {
-		TAILQ_FOREACH(a, &p->aq, entries)
-			if (strcasecmp(a->name, srch->group->name) == 0)
-				break;
-		assert(a != NULL);
-		srch->group->alias = a;
+		srch->group->alias = sym_find(cfg, 
+			SYM_ALIAS, p, srch->group->name);
+		assert(srch->group->alias != NULL);
 	}
 
 	if (srch->aggr != NULL && srch->aggr->name != NULL) {
-		TAILQ_FOREACH(a, &p->aq, entries)
-			if (strcasecmp(a->name, srch->aggr->name) == 0)
-				break;
-		assert(a != NULL);
-		srch->aggr->alias = a;
+		srch->aggr->alias = sym_find(cfg, 
+			SYM_ALIAS, p, srch->aggr->name);
+		assert(srch->aggr->alias != NULL);
 	}
 
 	return 1;
@@ -227,11 +318,28 @@ linker_aliases_resolve(struct config *cfg, struct search *srch)
 int
 linker_aliases(struct config *cfg)
 {
-	struct strct	*p;
+	struct strct	*p, *cyc = NULL;
 	size_t		 count = 0;
 	struct search	*srch;
 
-	/* Creates aliases and checks for infinite recursion. */
+	/* 
+	 * Check for infinite recursion.
+	 * This borrows the colour, which is reset for the later
+	 * ordering of structures.
+	 */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (p->colour == 0 && 
+		    (cyc = linker_aliases_cycle(p)) != NULL)
+			break;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		p->colour = 0;
+	if (cyc != NULL) {
+		gen_errx(cfg, &cyc->pos, "contains recursive references");
+		return 0;
+	}
+
+	/* Creates aliases. */
 
 	TAILQ_FOREACH(p, &cfg->sq, entries)
 		if (!linker_aliases_create(cfg, p, p, &count, NULL))
@@ -21,7 +21,9 @@
 #endif
 
 #include <assert.h>
+#include <ctype.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,6 +32,49 @@
 #include "extern.h"
 #include "linker.h"
 
+/*
+ * Look up the object of the given type named "name" within "scope" in
+ * the configuration's symbol table.
+ * Returns the object or NULL if not found.
+ */
+void *
+sym_find(const struct config *cfg, unsigned int type,
+	const void *scope, const char *name)
+{
+
+	return symtab_find(&cfg->priv->st, type, scope, name);
+}
+
+/*
+ * Add an object to the configuration's symbol table.
+ * Returns zero on allocation failure (reported), non-zero on success.
+ */
+int
+sym_add(struct config *cfg, unsigned int type,
+	const void *scope, const char *name, void *obj)
+{
+
+	if (symtab_add(&cfg->priv->st, type, scope, name, obj))
+		return 1;
+	gen_err(cfg, NULL);
+	return 0;
+}
+
+/*
+ * Index every named object of the configuration, replacing any prior
+ * index.
+ * Returns zero on allocation failure (reported), non-zero on success.
+ */
+int
+sym_build(struct config *cfg)
+{
+
+	if (symtab_build(&cfg->priv->st, cfg))
+		return 1;
+	gen_err(cfg, NULL);
+	return 0;
+}
+
 /*
  * Resolve a reference chain to a single field: a "names" consisting of
  * "foo" "bar" "bar" would have been input as "foo.bar.baz" and resolves
@@ -47,9 +92,7 @@ resolve_field_chain(struct config *cfg, const struct pos *pos,
 	struct field	*f = NULL;
 
 	for (i = 0; i < namesz; i++) {
-		TAILQ_FOREACH(f, &s->fq, entries)
-			if (strcasecmp(f->name, names[i]) == 0)
-				break;
+		f = sym_find(cfg, SYM_FIELD, s, names[i]);
 		if (f == NULL) {
 			gen_errx(cfg, pos, "field "
 				"not found: %s", names[i]);
@@ -246,6 +289,8 @@ resolve_struct_distinct(struct config *cfg, struct struct_distinct *r)
 		r->result->strct->flags |= STRCT_HAS_QUEUE;
 	else if (r->result->parent->type == STYPE_ITERATE)
 		r->result->strct->flags |= STRCT_HAS_ITERATOR;
+	if (r->result->parent->flags & SEARCH_HAS_UNTIL)
+		r->result->strct->flags |= STRCT_HAS_UNTIL;
 
 	return 1;
 }
@@ -257,14 +302,10 @@ resolve_struct_distinct(struct config *cfg, struct struct_distinct *r)
 static int
 resolve_up_const(struct config *cfg, struct struct_up_const *r)
 {
-	struct field	*f;
 	size_t		 errs = 0;
 
-	TAILQ_FOREACH(f, &r->result->parent->parent->fq, entries)
-		if (strcasecmp(f->name, r->name) == 0) {
-			r->result->field = f;
-			break;
-		}
+	r->result->field = sym_find(cfg, 
+		SYM_FIELD, r->result->parent->parent, r->name);
 
 	if (r->result->field == NULL) {
 		gen_errx(cfg, &r->result->pos, 
@@ -329,14 +370,10 @@ resolve_up_const(struct config *cfg, struct struct_up_const *r)
 static int
 resolve_up_mod(struct config *cfg, struct struct_up_mod *r)
 {
-	struct field	*f;
 	size_t		 errs = 0;
 
-	TAILQ_FOREACH(f, &r->result->parent->parent->fq, entries)
-		if (strcasecmp(f->name, r->name) == 0) {
-			r->result->field = f;
-			break;
-		}
+	r->result->field = sym_find(cfg, 
+		SYM_FIELD, r->result->parent->parent, r->name);
 
 	if (r->result->field == NULL) {
 		gen_errx(cfg, &r->result->pos, 
@@ -397,11 +434,8 @@ resolve_struct_unique(struct config *cfg, struct struct_unique *r)
 	struct field	*f;
 	struct nref	*nf;
 
-	TAILQ_FOREACH(f, &r->result->parent->parent->fq, entries) {
-		if (strcasecmp(f->name, r->name) != 0)
-			continue;
-		if (f->type != FTYPE_STRUCT)
-			break;
+	f = sym_find(cfg, SYM_FIELD, r->result->parent->parent, r->name);
+	if (f != NULL && f->type == FTYPE_STRUCT) {
 		gen_errx(cfg, &r->result->pos, "unique field "
 			"may not be a struct: %s", f->name);
 		return 0;
@@ -426,6 +460,91 @@ resolve_struct_unique(struct config *cfg, struct struct_unique *r)
 	return 1;
 }
 
+/*
+ * Look up an index column or "where" constraint field (e.g., "index
+ * ->bar<-") within the index's structure.
+ */
+static int
+resolve_struct_index(struct config *cfg, struct struct_index *r)
+{
+	struct field		*f;
+	struct iref		*ir;
+	const struct irefq	*q;
+
+	f = sym_find(cfg, SYM_FIELD, r->result->parent->parent, r->name);
+	if (f != NULL && f->type == FTYPE_STRUCT) {
+		gen_errx(cfg, &r->result->pos, "index field "
+			"may not be a struct: %s", f->name);
+		return 0;
+	}
+
+	if (f == NULL) {
+		gen_errx(cfg, &r->result->pos, "unknown field");
+		return 0;
+	}
+
+	/* Disallow duplicates within columns or constraints. */
+
+	q = OPTYPE_ISUNARY(r->result->op) ?
+		&r->result->parent->wq : &r->result->parent->nq;
+	TAILQ_FOREACH(ir, q, entries)
+		if (f == ir->field) {
+			gen_errx(cfg, &r->result->pos, 
+				"duplicate field: %s", f->name);
+			return 0;
+		}
+
+	if (OPTYPE_ISUNARY(r->result->op) &&
+	    !(f->flags & FIELD_NULL))
+		gen_warnx(cfg, &r->result->pos, 
+			"notnull or isnull operator "
+			"on field that's never null");
+
+	r->result->field = f;
+	return 1;
+}
+
+/*
+ * Look up a column selected by a query (e.g., "select ->bar<-") within
+ * the query's structure.
+ */
+static int
+resolve_struct_proj(struct config *cfg, struct struct_proj *r)
+{
+	struct field	*f;
+	struct proj	*proj;
+
+	f = sym_find(cfg, SYM_FIELD, r->result->parent->parent, r->name);
+	if (f != NULL && f->type == FTYPE_STRUCT) {
+		gen_errx(cfg, &r->result->pos, "selected field "
+			"may not be a struct: %s", f->name);
+		return 0;
+	}
+
+	if (f == NULL) {
+		gen_errx(cfg, &r->result->pos, 
+			"field not found: %s", r->name);
+		return 0;
+	}
+
+	/* Disallow duplicates. */
+
+	TAILQ_FOREACH(proj, &r->result->parent->projq, entries)
+		if (f == proj->field) {
+			gen_errx(cfg, &r->result->pos, 
+				"duplicate field: %s", f->name);
+			return 0;
+		}
+
+	/* Generators track the columns filled by selecting queries. */
+
+	if (!STYPE_ISAGGR(r->result->parent->type))
+		r->result->parent->parent->flags |= STRCT_HAS_PROJ;
+
+	r->result->field = f;
+	return 1;
+}
+
 /*
  * Look up the enum type by its name.
  */
@@ -434,13 +553,10 @@ resolve_field_enum(struct config *cfg, struct field_enum *r)
 {
 	struct enm	*e;
 
-	/* Straightforward scan. */
-
-	TAILQ_FOREACH(e, &cfg->eq, entries)
-		if (strcasecmp(e->name, r->name) == 0) {
-			r->result->enm = e;
-			return 1;
-		}
+	if ((e = sym_find(cfg, SYM_ENM, NULL, r->name)) != NULL) {
+		r->result->enm = e;
+		return 1;
+	}
 
 	gen_errx(cfg, &r->result->parent->pos, "unknown enum type");
 	return 0;
@@ -451,11 +567,8 @@ resolve_struct_role(struct config *cfg, struct struct_role *r)
 {
 	struct role	*rr;
 
-	TAILQ_FOREACH(rr, &cfg->arq, allentries) 
-		if (strcasecmp(rr->name, r->name) == 0) {
-			r->result->role = rr;
-			break;
-		}
+	if ((rr = sym_find(cfg, SYM_ROLE, NULL, r->name)) != NULL)
+		r->result->role = rr;
 
 	if (r->result->role == NULL)
 		gen_errx(cfg, &r->result->pos, "unknown role");
@@ -481,28 +594,32 @@ resolve_struct_rolemap_insert(struct config *cfg, struct struct_rolemap *r)
 	return 1;
 }
 
+static int
+resolve_struct_rolemap_upsert(struct config *cfg, struct struct_rolemap *r)
+{
+
+	if (r->result->parent->ups == NULL) 
+		return 0;
+	assert(r->result->parent->ups->rolemap == NULL);
+	r->result->parent->ups->rolemap = r->result;
+	return 1;
+}
+
 static int
 resolve_struct_rolemap_update(struct config *cfg, struct struct_rolemap *r)
 {
-	struct updateq	*q = NULL;
 	struct update	*u;
 
-	if (r->type == ROLEMAP_DELETE)
-		q = &r->result->parent->dq;
-	else if (r->type == ROLEMAP_UPDATE)
-		q = &r->result->parent->uq;
-
-	assert(q != NULL);
-	TAILQ_FOREACH(u, q, entries) 
-		if (u->name != NULL &&
-		    strcasecmp(u->name, r->name) == 0) {
-			assert(u->rolemap == NULL);
-			u->rolemap = r->result;
-			r->result->u = u;
-			return 1;
-		}
+	assert(r->type == ROLEMAP_DELETE || r->type == ROLEMAP_UPDATE);
+	u = sym_find(cfg, r->type == ROLEMAP_DELETE ? 
+		SYM_DELETE : SYM_UPDATE, r->result->parent, r->name);
+	if (u == NULL)
+		return 0;
 
-	return 0;
+	assert(u->rolemap == NULL);
+	u->rolemap = r->result;
+	r->result->u = u;
+	return 1;
 }
 
 static int
@@ -519,20 +636,27 @@ resolve_struct_rolemap_query(struct config *cfg, struct struct_rolemap *r)
 		type = STYPE_LIST;
 	else if (r->type == ROLEMAP_COUNT)
 		type = STYPE_COUNT;
+	else if (r->type == ROLEMAP_EXISTS)
+		type = STYPE_EXISTS;
+	else if (r->type == ROLEMAP_SUM)
+		type = STYPE_SUM;
+	else if (r->type == ROLEMAP_AVG)
+		type = STYPE_AVG;
+	else if (r->type == ROLEMAP_MIN)
+		type = STYPE_MIN;
+	else if (r->type == ROLEMAP_MAX)
+		type = STYPE_MAX;
 
 	assert(type != STYPE__MAX);
 
-	TAILQ_FOREACH(s, &r->result->parent->sq, entries)
-		if (type == s->type && 
-		    s->name != NULL &&
-		    strcasecmp(s->name, r->name) == 0) {
-			assert(s->rolemap == NULL);
-			s->rolemap = r->result;
-			r->result->s = s;
-			return 1;
-		}
+	s = sym_find(cfg, SYM_SEARCH + type, r->result->parent, r->name);
+	if (s == NULL)
+		return 0;
 
-	return 0;
+	assert(s->rolemap == NULL);
+	s->rolemap = r->result;
+	r->result->s = s;
+	return 1;
 }
 
 /*
@@ -600,13 +724,13 @@ resolve_struct_rolemap_noexport(struct config *cfg,
 		return 1;
 	}
 
-	TAILQ_FOREACH(f, &r->result->parent->fq, entries)
-		if (strcasecmp(f->name, r->name) == 0) {
-			if (!resolve_struct_rolemap_field(cfg, r, f))
-				return -1;
-			r->result->f = f;
-			return 1;
-		}
+	f = sym_find(cfg, SYM_FIELD, r->result->parent, r->name);
+	if (f != NULL) {
+		if (!resolve_struct_rolemap_field(cfg, r, f))
+			return -1;
+		r->result->f = f;
+		return 1;
+	}
 
 	gen_errx(cfg, &r->result->parent->pos,
 		"field not found: %s", r->name);
@@ -693,6 +817,14 @@ resolve_struct_rolemap_post(struct config *cfg, struct struct_rolemap *r)
 		    (cfg, p->ins->rolemap, p->arolemap))
 			return 0;
 	}
+
+	if (p->ups != NULL && p->ups->rolemap == NULL) {
+		p->ups->rolemap = p->arolemap;
+	} else if (p->ups != NULL) {
+		if (!resolve_struct_rolemap_post_cover
+		    (cfg, p->ups->rolemap, p->arolemap))
+			return 0;
+	}
 	
 	return 1;
 }
@@ -728,17 +860,33 @@ resolve_struct_rolemap(struct config *cfg, struct struct_rolemap *r)
 		gen_errx(cfg, &r->result->parent->pos,
 			"insert operation not specified");
 		break;
+	case ROLEMAP_UPSERT:
+		if (resolve_struct_rolemap_upsert(cfg, r))
+			return 1;
+		gen_errx(cfg, &r->result->parent->pos,
+			"upsert operation not specified");
+		break;
+	case ROLEMAP_AVG:
 	case ROLEMAP_COUNT:
+	case ROLEMAP_EXISTS:
 	case ROLEMAP_ITERATE:
 	case ROLEMAP_LIST:
+	case ROLEMAP_MAX:
+	case ROLEMAP_MIN:
 	case ROLEMAP_SEARCH:
+	case ROLEMAP_SUM:
 		if (resolve_struct_rolemap_query(cfg, r))
 			return 1;
 		gen_errx(cfg, &r->result->parent->pos,
 			"%s operation not found: %s", 
+			r->type == ROLEMAP_AVG ? "avg" : 
 			r->type == ROLEMAP_COUNT ? "count" : 
+			r->type == ROLEMAP_EXISTS ? "exists" : 
 			r->type == ROLEMAP_ITERATE ? "iterate" : 
 			r->type == ROLEMAP_LIST ? "list" : 
+			r->type == ROLEMAP_MAX ? "max" : 
+			r->type == ROLEMAP_MIN ? "min" : 
+			r->type == ROLEMAP_SUM ? "sum" : 
 			"search", r->name);
 		break;
 	case ROLEMAP_NOEXPORT:
@@ -761,13 +909,10 @@ resolve_field_bits(struct config *cfg, struct field_bits *r)
 {
 	struct bitf	*b;
 
-	/* Straightforward scan. */
-
-	TAILQ_FOREACH(b, &cfg->bq, entries)
-		if (strcasecmp(b->name, r->name) == 0) {
-			r->result->bitf = b;
-			return 1;
-		}
+	if ((b = sym_find(cfg, SYM_BITF, NULL, r->name)) != NULL) {
+		r->result->bitf = b;
+		return 1;
+	}
 
 	gen_errx(cfg, &r->result->parent->pos, "unknown bitfield type");
 	return 0;
@@ -779,11 +924,11 @@ resolve_field_def_eitem(struct config *cfg, struct field_def_eitem *r)
 	struct eitem	*ei;
 
 	assert(r->result->enm != NULL);
-	TAILQ_FOREACH(ei, &r->result->enm->eq, entries)
-		if (strcasecmp(ei->name, r->name) == 0) {
-			r->result->def.eitem = ei;
-			return 1;
-		}
+	ei = sym_find(cfg, SYM_EITEM, r->result->enm, r->name);
+	if (ei != NULL) {
+		r->result->def.eitem = ei;
+		return 1;
+	}
 
 	gen_errx(cfg, &r->result->pos, "unknown enumeration item");
 	return 0;
@@ -800,18 +945,12 @@ resolve_field_struct(struct config *cfg, struct field_struct *r)
 {
 	struct field	*f;
 	size_t		 errs = 0;
-	struct fieldq	*fq;
 
 	/* Look up the source on our structure. */
 
-	fq = &r->result->parent->parent->fq;
-
-	TAILQ_FOREACH(f, fq, entries) {
-		if (strcasecmp(f->name, r->sfield))
-			continue;
+	f = sym_find(cfg, SYM_FIELD, r->result->parent->parent, r->sfield);
+	if (f != NULL)
 		r->result->source = f;
-		break;
-	}
 
 	/* 
 	 * Assign the target of the source, which must be a reference
@@ -856,18 +995,11 @@ resolve_field_foreign(struct config *cfg, struct field_foreign *r)
 	struct field	*f;
 	size_t		 errs = 0;
 
-	/* Look up the target on all structures. */
+	/* Look up the target structure, then its field. */
 
-	TAILQ_FOREACH(p, &cfg->sq, entries) {
-		if (strcasecmp(p->name, r->tstrct))
-			continue;
-		TAILQ_FOREACH(f, &p->fq, entries) {
-			if (strcasecmp(f->name, r->tfield))
-				continue;
-			r->result->target = f;
-			break;
-		}
-	}
+	if ((p = sym_find(cfg, SYM_STRCT, NULL, r->tstrct)) != NULL &&
+	    (f = sym_find(cfg, SYM_FIELD, p, r->tfield)) != NULL)
+		r->result->target = f;
 
 	/* Are the source and target defined? */
 
@@ -911,6 +1043,11 @@ linker_resolve(struct config *cfg)
 	size_t		 fail = 0;
 	int		 rc;
 
+	/* Names are looked up in the index, not by scanning. */
+
+	if (!sym_build(cfg))
+		return 0;
+
 	TAILQ_FOREACH(r, &cfg->priv->rq, entries)
 		switch (r->type) {
 		case RESOLVE_FIELD_STRUCT:
@@ -954,10 +1091,18 @@ linker_resolve(struct config *cfg)
 		case RESOLVE_ROLEMAP:
 			/* This requires RESOLVE_ROLE. */
 			break;
+		case RESOLVE_PROJ:
+			fail += !resolve_struct_proj
+				(cfg, &r->struct_proj);
+			break;
 		case RESOLVE_UNIQUE:
 			fail += !resolve_struct_unique
 				(cfg, &r->struct_unique);
 			break;
+		case RESOLVE_INDEX:
+			fail += !resolve_struct_index
+				(cfg, &r->struct_index);
+			break;
 		case RESOLVE_UP_CONSTRAINT:
 			fail += !resolve_up_const
 				(cfg, &r->struct_up_const);
@@ -37,14 +37,21 @@ main(int argc, char *argv[])
 	struct config		 *cfg = NULL;
 	size_t			  i;
 	int			  rc = 0, c;
-	FILE			**confs = NULL;
+	FILE			**confs = NULL, *snap = NULL;
+	const char		 *snapfile = NULL;
 
 #if HAVE_PLEDGE
-	if (pledge("stdio rpath", NULL) == -1)
+	if (pledge("stdio rpath wpath cpath", NULL) == -1)
 		err(1, "pledge");
 #endif
-	while ((c = getopt(argc, argv, "i")) != -1) 
-		goto usage;
+	while ((c = getopt(argc, argv, "c:")) != -1) 
+		switch (c) {
+		case 'c':
+			snapfile = optarg;
+			break;
+		default:
+			goto usage;
+		}
 
 	argc -= optind;
 	argv += optind;
@@ -57,6 +64,9 @@ main(int argc, char *argv[])
 		if ((confs[i] = fopen(argv[i], "r")) == NULL)
 			err(1, "%s", argv[i]);
 
+	if (snapfile != NULL && (snap = fopen(snapfile, "w")) == NULL)
+		err(1, "%s", snapfile);
+
 #if HAVE_PLEDGE
 	if (pledge("stdio", NULL) == -1)
 		err(1, "pledge");
@@ -73,9 +83,14 @@ main(int argc, char *argv[])
 	if (argc == 0 && !ort_parse_file(cfg, stdin, "<stdin>"))
 		goto out;
 
-	if ((rc = ort_parse_close(cfg)))
-		if (!(rc = ort_write_file(stdout, cfg)))
+	if ((rc = ort_parse_close(cfg))) {
+		if (snap != NULL)
+			rc = ort_config_save(snap, cfg);
+		else
+			rc = ort_write_file(stdout, cfg);
+		if (!rc)
 			warn(NULL);
+	}
 out:
 	ort_write_msg_file(stderr, &cfg->mq);
 	ort_config_free(cfg);
@@ -84,8 +99,14 @@ out:
 		fclose(confs[i]);
 
 	free(confs);
+
+	if (snap != NULL && fclose(snap) == EOF && rc) {
+		warn("%s", snapfile);
+		rc = 0;
+	}
 	return rc ? 0 : 1;
 usage:
-	fprintf(stderr, "usage: %s [-i] [config...]\n", getprogname());
+	fprintf(stderr, "usage: %s [-c snapshot] [config...]\n",
+		getprogname());
 	return 1;
 }
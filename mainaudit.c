@@ -37,6 +37,11 @@ static	const char *const stypes[STYPE__MAX] = {
 	"search", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static size_t
@@ -46,6 +51,7 @@ audit_buf(const struct audit *a, char *b, size_t bsz, size_t i)
 
 	switch (a->type) {
 	case AUDIT_INSERT:
+	case AUDIT_UPSERT:
 		c = snprintf(b, bsz, "%s", a->st->name);
 		break;
 	case AUDIT_UPDATE:
@@ -88,6 +94,17 @@ audit_insert(const struct audit *a, char *b, size_t bsz)
 		a->st->ins->pos.column);
 }
 
+static void
+audit_upsert(const struct audit *a, char *b, size_t bsz)
+{
+
+	assert(a->st->ups != NULL);
+	audit_buf(a, b, bsz, 0);
+	printf("%-11s %-*s %s:%zu:%zu\n", "upsert", (int)bsz, b,
+		a->st->ups->pos.fname, a->st->ups->pos.line, 
+		a->st->ups->pos.column);
+}
+
 static void
 audit_update(const struct audit *a, char *b, size_t bsz)
 {
@@ -104,10 +121,8 @@ audit_query(const struct audit *a, char *b, size_t bsz)
 
 	audit_buf(a, b, bsz, 0);
 	printf("%-11s %-*s %s:%zu:%zu\n", 
-		a->sr->type == STYPE_COUNT ? "count" : 
-			a->sr->type == STYPE_ITERATE ? "iterate" : 
-			a->sr->type == STYPE_SEARCH ? "search" : 
-			"list", (int)bsz, b, a->sr->pos.fname, 
+		a->sr->type == STYPE_SEARCH ? "search" : 
+			stypes[a->sr->type], (int)bsz, b, a->sr->pos.fname, 
 		a->sr->pos.line, a->sr->pos.column);
 }
 
@@ -172,6 +187,9 @@ audit_write(const struct auditq *aq, int verb)
 		case AUDIT_INSERT:
 			audit_insert(a, b, msz + 1);
 			break;
+		case AUDIT_UPSERT:
+			audit_upsert(a, b, msz + 1);
+			break;
 		case AUDIT_UPDATE:
 			audit_update(a, b, msz + 1);
 			break;
@@ -157,6 +157,7 @@ main(int argc, char *argv[])
 		case DIFF_SAME_SEARCH:
 		case DIFF_SAME_STRCT:
 		case DIFF_SAME_UPDATE:
+		case DIFF_SAME_UPSERT:
 			continue;
 		default:
 			rc = 1;
@@ -41,6 +41,7 @@ main(int argc, char *argv[])
 	int			  c, rc = 0;
 	FILE			**confs = NULL;
 	size_t			  i;
+	const char		 *er;
 
 	memset(&args, 0, sizeof(struct ort_lang_nodejs));
 	args.flags = ORT_LANG_NODEJS_DB | ORT_LANG_NODEJS_CORE;
@@ -50,7 +51,7 @@ main(int argc, char *argv[])
 		err(1, "pledge");
 #endif
 
-	while ((c = getopt(argc, argv, "eN:v")) != -1)
+	while ((c = getopt(argc, argv, "eN:P:v")) != -1)
 		switch (c) {
 		case 'e':
 			args.flags |= ORT_LANG_NODEJS_NOMODULE;
@@ -61,6 +62,11 @@ main(int argc, char *argv[])
 			if (strchr(optarg, 'd') != NULL)
 				args.flags &= ~ORT_LANG_NODEJS_DB;
 			break;
+		case 'P':
+			args.jobs = strtonum(optarg, 1, 256, &er);
+			if (er != NULL)
+				errx(1, "-P: %s: %s", optarg, er);
+			break;
 		case 'v':
 			args.flags |= ORT_LANG_NODEJS_VALID;
 			break;
@@ -107,7 +113,7 @@ out:
 	free(confs);
 	return !rc;
 usage:
-	fprintf(stderr, "usage: %s [-ev] [-N[b|d] [config...]\n", 
+	fprintf(stderr, "usage: %s [-ev] [-N[b|d] [-P jobs] [config...]\n", 
 		getprogname());
 	return 1;
 }
@@ -137,7 +137,7 @@ namespace ortJson {
 		source: fieldPtrObj;
 	}
 
-	export type fieldObjFlags = 'rowid'|'null'|'unique'|'noexport';
+	export type fieldObjFlags = 'rowid'|'null'|'unique'|'noexport'|'lazy';
 	export type fieldObjActions =  'none'|'restrict'|'nullify'|'cascade'|'default';
 
 	/**
@@ -182,6 +182,20 @@ namespace ortJson {
 	export interface insertObj {
 		pos: posObj;
 		rolemap: string[];
+		/**
+		 * Can contain "returning" to represent INSERT_RETURNING.
+		 */
+		flags: string[];
+	}
+
+	/**
+	 * Same as "struct upsert" in ort(3), with the conflict
+	 * target's field names in "nq".
+	 */
+	export interface upsertObj {
+		pos: posObj;
+		rolemap: string[];
+		nq: string[];
 	}
 
 	export type sentObjOp = 'eq'|'ge'|'gt'|'le'|'lt'|'neq'|'like'|'and'|
@@ -269,10 +283,16 @@ namespace ortJson {
 		 * which SQL provides its filters.
 		 */
 		ordq: orderObj[];
+		/**
+		 * Names of selected columns in the current structure.
+		 * If empty, all columns are selected.
+		 */
+		projq: string[];
 		aggr: aggrObj|null;
 		group: groupObj|null;
 		dst: dstnctObj|null;
-		type: 'search'|'iterate'|'list'|'count';
+		type: 'search'|'iterate'|'list'|'count'|'exists'|
+			'sum'|'avg'|'min'|'max';
 	}
 
 	export interface searchSet {
@@ -310,7 +330,8 @@ namespace ortJson {
 		type: 'update'|'delete';
 		rolemap: string[];
 		/**
-		 * Can contain "all" to represent UPDATE_ALL.
+		 * Can contain "all" to represent UPDATE_ALL and
+		 * "returning" for UPDATE_RETURNING.
 		 */
 		flags: string[];
 		mrq: urefObj[];
@@ -340,8 +361,19 @@ namespace ortJson {
 		nq: string[];
 	}
 
-	export type rolemapObjType = 'all'|'count'|'delete'|'insert'|
-		'iterate'|'list'|'search'|'update'|'noexport';
+	/**
+	 * Same as "strct index" in ort(3), with the column names in
+	 * "nq" and the partial index constraints in "wq".
+	 */
+	export interface indexObj {
+		pos: posObj;
+		nq: string[];
+		wq: { field: string; op: 'isnull'|'notnull' }[];
+	}
+
+	export type rolemapObjType = 'all'|'avg'|'count'|'delete'|
+		'exists'|'insert'|'iterate'|'list'|'max'|'min'|'search'|
+		'sum'|'update'|'upsert'|'noexport';
 
 	/**
 	 * Similar to "struct rolemap" in ort(3).
@@ -349,9 +381,9 @@ namespace ortJson {
 	export interface rolemapObj {
 		type: rolemapObjType;
 		/**
-		 * If not null (it's only null if type is "all" or
-		 * "insert", or "noexport" for all fields), is the named
-		 * field/search/update.
+		 * If not null (it's only null if type is "all",
+		 * "insert", "upsert", or "noexport" for all fields), is
+		 * the named field/search/update.
 		 */
 		name: string|null;
 		/**
@@ -369,6 +401,7 @@ namespace ortJson {
 		doc: string|null;
 		fq: fieldSet;
 		insert: insertObj|null;
+		upsert: upsertObj|null;
 		/**
 		 * Unlike "strct" in ort(3), which has all searches
 		 * under a common "sq", we split between named and
@@ -378,6 +411,7 @@ namespace ortJson {
 		uq: updateClassObj;
 		dq: updateClassObj;
 		nq: uniqueObj[];
+		iq: indexObj[];
 		/**
 		 * This is informational: all of the operations have
 		 * their roles therein.  
@@ -659,7 +693,8 @@ namespace ortJson {
 		private updateObjToString(up: updateObj): string
 		{
 			let str: string = ' ' + up.type;
-			if (up.type === 'update' && up.flags.length === 0) {
+			if (up.type === 'update' && 
+			    up.flags.indexOf('all') < 0) {
 				for (let i: number = 0; i < up.mrq.length; i++) {
 					if (i > 0)
 						str += ',';
@@ -680,6 +715,8 @@ namespace ortJson {
 			str += this.commentToString(up.doc);
 			if (up.name !== null)
 				str += ' name ' + up.name;
+			if (up.flags.indexOf('returning') >= 0)
+				str += ' returning';
 			return str + ';';
 		}
 
@@ -726,6 +763,8 @@ namespace ortJson {
 						' ' + search.ordq[i].op;
 				}
 			}
+			if (search.projq.length > 0)
+				str += ' select ' + search.projq.join(', ');
 			return str + ';';
 		}
 
@@ -771,7 +810,13 @@ namespace ortJson {
 		       		str += this.updateObjToString(strct.dq.anon[i]);	
 			str += this.updateSetToString(strct.dq.named);
 			if (strct.insert !== null)
-				str += ' insert;';
+				str += ' insert' + 
+					(strct.insert.flags.indexOf
+					 ('returning') >= 0 ?
+					 ' returning' : '') + ';';
+			if (strct.upsert !== null)
+				str += ' upsert ' + 
+					strct.upsert.nq.join(',') + ';';
 			str += this.commentToString(strct.doc);
 			if (strct.doc !== null) 
 				str += ';';
@@ -785,6 +830,15 @@ namespace ortJson {
 				}
 				str += ';';
 			}
+			for (let i: number = 0; i < strct.iq.length; i++) {
+				str += ' index ' + strct.iq[i].nq.join(',');
+				for (let j: number = 0; 
+				     j < strct.iq[i].wq.length; j++)
+					str += (j > 0 ? ',' : ' where ') +
+						strct.iq[i].wq[j].field + ' ' +
+						strct.iq[i].wq[j].op;
+				str += ';';
+			}
 			for (let i: number = 0; i < strct.rq.length; i++)
 				str += this.rolemapObjToString(strct.rq[i]);
 			return str + ' };';
@@ -2463,7 +2517,7 @@ namespace ortJson {
 			cb?: ortJson.ortJsonConfigCallbacks, arg?: any): void
 		{
 			const flags: fieldObjFlags[] = [
-				'rowid', 'null', 'unique', 'noexport'
+				'rowid', 'null', 'unique', 'noexport', 'lazy'
 			];
 			this.fillComment(e, 'field', field.doc);
 			this.replcl(e, 'config-field-name', field.name);
@@ -30,13 +30,20 @@ struct	ort_lang_c {
 	unsigned int		 flags;
 	unsigned int		 includes;
 	const char		*ext_jsmn;
+	size_t			 jobs;
 };
 
 int	ort_lang_c_header(const struct ort_lang_c *,
 		const struct config *, FILE *);
 int	ort_lang_c_source(const struct ort_lang_c *, 
 		const struct config *, FILE *f);
+int	ort_lang_c_source_common(const struct ort_lang_c *,
+		const struct config *, FILE *);
+int	ort_lang_c_source_strct(const struct ort_lang_c *,
+		const struct config *, const struct strct *, FILE *);
 int	ort_lang_c_manpage(const struct ort_lang_c *,
 		const struct config *, FILE *);
+int	ort_lang_c_explain(const struct ort_lang_c *,
+		const struct config *, FILE *);
 
 #endif /* !ORT_LANG_C_H */
@@ -24,6 +24,7 @@
 
 struct ort_lang_nodejs {
 	unsigned int	 flags;
+	size_t		 jobs;
 };
 
 int	 ort_lang_nodejs(const struct ort_lang_nodejs *,
@@ -19,6 +19,7 @@
 
 struct ort_lang_rust {
 	unsigned int	 flags;
+	size_t		 jobs;
 };
 
 int	 ort_lang_rust(const struct ort_lang_rust *,
@@ -23,6 +23,8 @@ struct ort_lang_sql {
 
 int	ort_lang_sql(const struct ort_lang_sql *, 
 		const struct config *, FILE *f);
+int	ort_lang_sql_advise(const struct ort_lang_sql *, 
+		const struct config *, FILE *f);
 int	ort_lang_diff_sql(const struct ort_lang_sql *,
 		const struct diffq *, int, FILE *f, struct msgq *);
 
@@ -0,0 +1 @@
+#define SHAREDIR "/usr/local/share/openradtool"
@@ -0,0 +1,8 @@
+#ifndef ORT_VERSION_H
+#define ORT_VERSION_H
+#define ORT_VERSION "0.14.1"
+#define ORT_MAJOR 0
+#define ORT_MINOR 14
+#define ORT_BUILD 1
+#define ORT_VSTAMP 11502
+#endif
@@ -26,10 +26,13 @@ TAILQ_HEAD(eitemq, eitem);
 TAILQ_HEAD(enmq, enm);
 TAILQ_HEAD(fieldq, field);
 TAILQ_HEAD(fvalidq, fvalid);
+TAILQ_HEAD(indexq, index);
+TAILQ_HEAD(irefq, iref);
 TAILQ_HEAD(labelq, label);
 TAILQ_HEAD(msgq, msg);
 TAILQ_HEAD(nrefq, nref);
 TAILQ_HEAD(ordq, ord);
+TAILQ_HEAD(projq, proj);
 TAILQ_HEAD(rolemapq, rolemap);
 TAILQ_HEAD(roleq, role);
 TAILQ_HEAD(rrefq, rref);
@@ -175,6 +178,7 @@ struct	field {
 #define FIELD_NULL	   0x04u
 #define	FIELD_NOEXPORT	   0x08u
 #define FIELD_HASDEF	   0x10u
+#define	FIELD_LAZY	   0x20u
 	TAILQ_ENTRY(field) entries;
 };
 
@@ -235,13 +239,19 @@ enum	modtype {
  */
 enum	rolemapt {
 	ROLEMAP_ALL = 0, /* all */
+	ROLEMAP_AVG, /* avg */
 	ROLEMAP_COUNT, /* count */
 	ROLEMAP_DELETE, /* delete */
+	ROLEMAP_EXISTS, /* exists */
 	ROLEMAP_INSERT, /* insert */
 	ROLEMAP_ITERATE, /* iterate */
 	ROLEMAP_LIST, /* list */
+	ROLEMAP_MAX, /* max */
+	ROLEMAP_MIN, /* min */
 	ROLEMAP_SEARCH, /* search */
+	ROLEMAP_SUM, /* sum */
 	ROLEMAP_UPDATE, /* update */
+	ROLEMAP_UPSERT, /* upsert */
 	ROLEMAP_NOEXPORT, /* noexport */
 	ROLEMAP__MAX
 };
@@ -330,9 +340,42 @@ enum	stype {
 	STYPE_SEARCH,
 	STYPE_LIST,
 	STYPE_ITERATE,
+	STYPE_EXISTS,
+	STYPE_SUM,
+	STYPE_AVG,
+	STYPE_MIN,
+	STYPE_MAX,
 	STYPE__MAX
 };
 
+/*
+ * Queries reducing a single selected field to a scalar.
+ */
+#define	STYPE_ISAGGR(_x) ((_x) >= STYPE_SUM)
+
+/*
+ * A count with a "grouprow" but no "minrow" or "maxrow" returns the
+ * count per distinct value of the grouped column.
+ */
+#define	SEARCH_ISHISTO(_s) \
+	((_s)->type == STYPE_COUNT && \
+	 (_s)->group != NULL && (_s)->aggr == NULL)
+
+/*
+ * A column explicitly selected by a query.
+ * If a query has any of these, only the named columns (and the rowid
+ * and foreign keys, which are always selected) are read from the
+ * database; the remainder are returned zeroed and the structure is
+ * marked with STRCT_HAS_PROJ, so generators track filled columns.
+ */
+struct	proj {
+	struct field	*field;
+	char		*fname;
+	struct pos	 pos;
+	struct search	*parent;
+	TAILQ_ENTRY(proj) entries;
+};
+
 struct	dstnct {
 	struct field	**chain;
 	size_t		  chainsz;
@@ -345,6 +388,7 @@ struct	dstnct {
 struct	search {
 	struct sentq	    sntq;
 	struct ordq	    ordq;
+	struct projq	    projq;
 	struct aggr	   *aggr;
 	struct group	   *group;
 	struct pos	    pos;
@@ -358,6 +402,8 @@ struct	search {
 	struct rolemap	   *rolemap;
 	unsigned int	    flags; 
 #define	SEARCH_IS_UNIQUE    0x01u
+#define	SEARCH_HAS_MANY	    0x02u /* also lookup by key list */
+#define	SEARCH_HAS_UNTIL    0x04u /* also early-terminating iterate */
 	TAILQ_ENTRY(search) entries;
 };
 
@@ -384,6 +430,31 @@ struct	unique {
 	TAILQ_ENTRY(unique) entries;
 };
 
+/*
+ * A column of an index or, in a partial index's "where" clause, a
+ * field with its unary constraint.
+ */
+struct	iref {
+	struct field	 *field;
+	enum optype	  op; /* unary if in "where" */
+	struct pos	  pos;
+	struct index	 *parent;
+	TAILQ_ENTRY(iref) entries;
+};
+
+/*
+ * A secondary (non-unique) index on the columns in "nq", in order.
+ * If "wq" is not empty, this is a partial index on rows matching all
+ * of its constraints.
+ */
+struct	index {
+	struct irefq	    nq;
+	struct irefq	    wq;
+	struct strct	   *parent;
+	struct pos	    pos;
+	TAILQ_ENTRY(index) entries;
+};
+
 enum	upt {
 	UP_MODIFY = 0,
 	UP_DELETE,
@@ -401,6 +472,7 @@ struct	update {
 	struct rolemap	   *rolemap;
 	unsigned int	    flags;
 #define	UPDATE_ALL	    0x01u
+#define	UPDATE_RETURNING    0x02u /* also returning the row */
 	TAILQ_ENTRY(update) entries;
 };
 
@@ -408,6 +480,21 @@ struct	insert {
 	struct rolemap	*rolemap;
 	struct strct	*parent;
 	struct pos	 pos;
+	unsigned int	 flags;
+#define	INSERT_RETURNING 0x01u /* also returning the row */
+};
+
+/*
+ * An insertion that updates the existing row on conflict of a unique
+ * constraint: either a unique (or rowid) field or a "struct unique"
+ * with the same columns.
+ * The conflict target isn't on the structure's unique queue.
+ */
+struct	upsert {
+	struct unique	*target;
+	struct rolemap	*rolemap;
+	struct strct	*parent;
+	struct pos	 pos;
 };
 
 struct	strct {
@@ -423,14 +510,18 @@ struct	strct {
 	struct updateq	   uq;
 	struct updateq	   dq;
 	struct uniqueq	   nq;
+	struct indexq	   iq;
 	struct rolemapq	   rq;
 	struct insert	  *ins;
+	struct upsert	  *ups;
 	struct rolemap	  *arolemap; /* during linkage (XXX: remove) */
 	unsigned int	   flags;
 #define	STRCT_HAS_QUEUE	   0x01u
 #define	STRCT_HAS_ITERATOR 0x02u
 #define	STRCT_HAS_BLOB	   0x04u
+#define	STRCT_HAS_PROJ	   0x08u
 #define STRCT_HAS_NULLREFS 0x10u
+#define	STRCT_HAS_UNTIL	   0x20u
 	struct config	  *cfg;
 	TAILQ_ENTRY(strct) entries;
 };
@@ -483,6 +574,7 @@ enum	difftype {
 	DIFF_ADD_EITEM,
 	DIFF_ADD_ENM,
 	DIFF_ADD_FIELD,
+	DIFF_ADD_INDEX,
 	DIFF_ADD_INSERT,
 	DIFF_ADD_ROLE,
 	DIFF_ADD_ROLES,
@@ -490,11 +582,13 @@ enum	difftype {
 	DIFF_ADD_STRCT,
 	DIFF_ADD_UNIQUE,
 	DIFF_ADD_UPDATE,
+	DIFF_ADD_UPSERT,
 	DIFF_DEL_BITF,
 	DIFF_DEL_BITIDX,
 	DIFF_DEL_EITEM,
 	DIFF_DEL_ENM,
 	DIFF_DEL_FIELD,
+	DIFF_DEL_INDEX,
 	DIFF_DEL_INSERT,
 	DIFF_DEL_ROLE,
 	DIFF_DEL_ROLES,
@@ -502,6 +596,7 @@ enum	difftype {
 	DIFF_DEL_STRCT,
 	DIFF_DEL_UNIQUE,
 	DIFF_DEL_UPDATE,
+	DIFF_DEL_UPSERT,
 	DIFF_MOD_BITF,
 	DIFF_MOD_BITF_COMMENT,
 	DIFF_MOD_BITF_LABELS,
@@ -528,6 +623,7 @@ enum	difftype {
 	DIFF_MOD_FIELD_TYPE,
 	DIFF_MOD_FIELD_VALIDS,
 	DIFF_MOD_INSERT,
+	DIFF_MOD_INSERT_FLAGS,
 	DIFF_MOD_INSERT_PARAMS,
 	DIFF_MOD_INSERT_ROLEMAP,
 	DIFF_MOD_ROLE,
@@ -545,6 +641,7 @@ enum	difftype {
 	DIFF_MOD_SEARCH_ORDER,
 	DIFF_MOD_SEARCH_PARAMS,
 	DIFF_MOD_SEARCH_ROLEMAP,
+	DIFF_MOD_SEARCH_SELECT,
 	DIFF_MOD_STRCT,
 	DIFF_MOD_STRCT_COMMENT,
 	DIFF_MOD_UPDATE,
@@ -552,6 +649,9 @@ enum	difftype {
 	DIFF_MOD_UPDATE_FLAGS,
 	DIFF_MOD_UPDATE_PARAMS,
 	DIFF_MOD_UPDATE_ROLEMAP,
+	DIFF_MOD_UPSERT,
+	DIFF_MOD_UPSERT_ROLEMAP,
+	DIFF_MOD_UPSERT_TARGET,
 	DIFF_SAME_BITF,
 	DIFF_SAME_BITIDX,
 	DIFF_SAME_EITEM,
@@ -563,6 +663,7 @@ enum	difftype {
 	DIFF_SAME_SEARCH,
 	DIFF_SAME_STRCT,
 	DIFF_SAME_UPDATE,
+	DIFF_SAME_UPSERT,
 	DIFF__MAX
 };
 
@@ -631,6 +732,7 @@ struct	diff {
 		const struct strct	*strct;
 		struct diff_strct	 strct_pair; 
 		const struct unique	*unique;
+		const struct index	*index;
 		struct diff_update	 update_pair;
 		const struct update	*update;
 	};
@@ -639,6 +741,7 @@ struct	diff {
 
 enum	auditt {
 	AUDIT_INSERT,
+	AUDIT_UPSERT,
 	AUDIT_UPDATE,
 	AUDIT_QUERY,
 	AUDIT_REACHABLE,
@@ -679,7 +782,12 @@ __BEGIN_DECLS
 
 struct config	*ort_config_alloc(void);
 void		 ort_config_free(struct config *);
+int		 ort_config_load(struct config *, const char *, size_t,
+			const char *);
+int		 ort_config_save(FILE *, const struct config *);
 int		 ort_parse_close(struct config *);
+int		 ort_parse_buffer(struct config *, const char *, size_t,
+			const char *);
 int		 ort_parse_file(struct config *, FILE *, const char *);
 int		 ort_write_file(FILE *, const struct config *);
 int		 ort_write_msg_file(FILE *f, const struct msgq *);
@@ -693,6 +801,7 @@ void	 	 ort_msg(struct msgq *, enum msgtype, int,
 			const struct pos *, const char *, ...);
 void		 ort_msgq_free(struct msgq *);
 struct auditq	*ort_audit(const struct role *, const struct config *);
+const struct alias *ort_alias_find(const struct strct *, const char *);
 void		 ort_auditq_free(struct auditq *);
 
 __END_DECLS
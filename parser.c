@@ -19,6 +19,8 @@
 #if HAVE_SYS_QUEUE
 # include <sys/queue.h>
 #endif
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <assert.h>
 #include <ctype.h>
@@ -259,6 +261,31 @@ parse_errx(struct parse *p, const char *fmt, ...)
 	return p->lasttype;
 }
 
+/*
+ * Make sure the retaining buffer can hold "sz" more bytes, doubling its
+ * size as required.
+ * Returns zero on memory failure, non-zero otherwise.
+ */
+static int
+buf_reserve(struct parse *p, size_t sz)
+{
+	void	*pp;
+	size_t	 max;
+
+	if (p->bufsz + sz < p->bufmax)
+		return 1;
+	for (max = p->bufmax ? p->bufmax : 1024;
+	     p->bufsz + sz >= max; max *= 2)
+		continue;
+	if ((pp = realloc(p->buf, max)) == NULL) {
+		parse_err(p);
+		return 0;
+	}
+	p->buf = pp;
+	p->bufmax = max;
+	return 1;
+}
+
 /*
  * Push a single character into the retaining buffer.
  * XXX: creates a binary buffer.
@@ -267,22 +294,28 @@ parse_errx(struct parse *p, const char *fmt, ...)
 static int
 buf_push(struct parse *p, int c)
 {
-	void		*pp;
-	const size_t	 inc = 1024;
 
-	if (p->bufsz + 1 >= p->bufmax) {
-		pp = realloc(p->buf, p->bufmax + inc);
-		if (pp == NULL) {
-			parse_err(p);
-			return 0;
-		}
-		p->buf = pp;
-		p->bufmax += inc;
-	}
+	if (!buf_reserve(p, 1))
+		return 0;
 	p->buf[p->bufsz++] = (char)c;
 	return 1;
 }
 
+/*
+ * Append the "sz" bytes at "s" into the retaining buffer.
+ * Returns zero on memory failure, non-zero otherwise.
+ */
+static int
+buf_append(struct parse *p, const char *s, size_t sz)
+{
+
+	if (!buf_reserve(p, sz))
+		return 0;
+	memcpy(p->buf + p->bufsz, s, sz);
+	p->bufsz += sz;
+	return 1;
+}
+
 /*
  * Check to see whether "s" is a reserved identifier or not.
  * Returns zero if this is a reserved identifier, non-zero if it's ok
@@ -339,56 +372,19 @@ parse_check_dupetoplevel(struct parse *p, const char *name)
 	return(1);
 }
 
-static int
-parse_check_eof(struct parse *p)
-{
-
-	return feof(p->f);
-}
-
-static int
-parse_check_error(struct parse *p)
-{
-
-	return ferror(p->f);
-}
-
-static int
-parse_check_error_eof(struct parse *p)
-{
-
-	return feof(p->f) || ferror(p->f);
-}
-
-static void
-parse_ungetc(struct parse *p, int c)
-{
-
-	/* FIXME: puts us at last line, not column */
-
-	if ('\n' == c)
-		p->line--;
-	else if (p->column > 0)
-		p->column--;
-
-	ungetc(c, p->f);
-}
-
 /*
- * Get the next character and advance us within the file.
- * If we've already reached an error condition, this just keeps us
- * there.
+ * Get the next character and advance us within the input.
+ * At the end of input, this just keeps us there.
  */
 static int
 parse_nextchar(struct parse *p)
 {
 	int	 c;
 
-	c = fgetc(p->f);
-
-	if (parse_check_error_eof(p))
+	if (p->inpos == p->insz)
 		return EOF;
 
+	c = (unsigned char)p->in[p->inpos++];
 	p->column++;
 
 	if ('\n' == c) {
@@ -400,23 +396,38 @@ parse_nextchar(struct parse *p)
 }
 
 /*
- * Trigger a "hard" error condition at stream error or EOF.
+ * Advance past the characters following the one just read while they
+ * satisfy "fp", which must not match a newline.
+ * Returns the length of the run, including the character just read.
+ */
+static size_t
+parse_span(struct parse *p, int (*fp)(int))
+{
+	size_t	 start = p->inpos - 1;
+
+	while (p->inpos < p->insz &&
+	       fp((unsigned char)p->in[p->inpos]))
+		p->inpos++;
+
+	p->column += p->inpos - start - 1;
+	return p->inpos - start;
+}
+
+/*
+ * Trigger a "hard" end of input condition.
  * This sets the lasttype appropriately.
  */
 static enum tok
 parse_read_err(struct parse *p)
 {
 
-	if (parse_check_error(p))
-		parse_err(p);
-	else 
-		p->lasttype = TOK_EOF;
-
+	p->lasttype = TOK_EOF;
 	return p->lasttype;
 }
 
 /*
- * Parse the next token from "f".
+ * Parse the next token from the input.
+ * Identifiers and numbers are copied from the input as a whole.
  * If we've already encountered an error or an EOF condition, this
  * doesn't do anything.
  * Otherwise, lasttype will be set to the last token type.
@@ -425,7 +436,8 @@ enum tok
 parse_next(struct parse *p)
 {
 	int		 c, last, hasdot, minus = 0;
-	const char	*ep = NULL;
+	size_t		 start;
+	const char	*ep = NULL, *nl;
 	char		*epp = NULL;
 
 again:
@@ -441,15 +453,19 @@ again:
 		c = parse_nextchar(p);
 	} while (isspace(c));
 
-	if (parse_check_error_eof(p))
+	if (EOF == c)
 		return(parse_read_err(p));
 
 	if ('#' == c) {
-		do {
-			c = parse_nextchar(p);
-		} while (EOF != c && '\n' != c);
-		if ('\n' != c)
+		nl = memchr(p->in + p->inpos, '\n', p->insz - p->inpos);
+		if (NULL == nl) {
+			p->column += p->insz - p->inpos;
+			p->inpos = p->insz;
 			return(parse_read_err(p));
+		}
+		p->inpos = nl - p->in + 1;
+		p->line++;
+		p->column = 0;
 		goto again;
 	}
 
@@ -460,7 +476,7 @@ again:
 
 	if ('-' == c) {
 		c = parse_nextchar(p);
-		if (parse_check_error_eof(p))
+		if (EOF == c)
 			return(parse_read_err(p));
 		if ( ! isdigit(c))
 			return(parse_errx(p, "expected digit"));
@@ -509,9 +525,6 @@ again:
 			last = c;
 		} 
 
-		if (parse_check_error(p))
-			return(parse_read_err(p));
-
 		if ( ! buf_push(p, '\0'))
 			return TOK_ERR;
 		p->last.string = p->buf;
@@ -521,32 +534,27 @@ again:
 		p->bufsz = 0;
 		if (minus && ! buf_push(p, '-'))
 			return TOK_ERR;
-		if ( ! buf_push(p, c))
-			return TOK_ERR;
 
-		do {
-			c = parse_nextchar(p);
-			/*
-			 * Check for a decimal number: if we encounter a
-			 * full-stop within the number, we convert to a
-			 * decimal value.
-			 * But only for the first decimal point.
-			 */
+		/*
+		 * Check for a decimal number: if we encounter a
+		 * full-stop within the number, we convert to a decimal
+		 * value.
+		 * But only for the first decimal point.
+		 */
+
+		for (start = p->inpos - 1; p->inpos < p->insz; p->inpos++) {
+			c = (unsigned char)p->in[p->inpos];
 			if ('.' == c) {
 				if (hasdot)
 					break;
 				hasdot = 1;
-			}
-			if (isdigit(c) || '.' == c)
-				if ( ! buf_push(p, c))
-					return TOK_ERR;
-		} while (isdigit(c) || '.' == c);
-
-		if (parse_check_error(p))
-			return(parse_read_err(p));
-		else if ( ! parse_check_eof(p))
-			parse_ungetc(p, c);
+			} else if ( ! isdigit(c))
+				break;
+		}
+		p->column += p->inpos - start - 1;
 
+		if ( ! buf_append(p, p->in + start, p->inpos - start))
+			return TOK_ERR;
 		if ( ! buf_push(p, '\0'))
 			return TOK_ERR;
 		if (hasdot) {
@@ -565,19 +573,9 @@ again:
 		}
 	} else if (isalpha(c)) {
 		p->bufsz = 0;
-		if ( ! buf_push(p, c))
+		start = p->inpos - 1;
+		if ( ! buf_append(p, p->in + start, parse_span(p, isalnum)))
 			return TOK_ERR;
-		do {
-			c = parse_nextchar(p);
-			if (isalnum(c) && ! buf_push(p, c))
-				return TOK_ERR;
-		} while (isalnum(c));
-
-		if (parse_check_error(p))
-			return(parse_read_err(p));
-		else if ( ! parse_check_eof(p))
-			parse_ungetc(p, c);
-
 		if ( ! buf_push(p, '\0'))
 			return TOK_ERR;
 		p->last.string = p->buf;
@@ -753,21 +751,20 @@ parse_root(struct parse *p)
 }
 
 /*
- * Parse file "f", augmenting the configuration already in "cfg".
- * Returns zero on failure, non-zero on success.
+ * Add "fname" to the configuration's file names, which outlive the
+ * parse as the names in each struct pos.
+ * Returns the copy or NULL on memory failure.
  */
-int
-ort_parse_file(struct config *cfg, FILE *f, const char *fname)
+static const char *
+parse_fname(struct config *cfg, const char *fname)
 {
-	struct parse	 p;
-	int		 rc = 0;
-	void		*pp;
+	void	*pp;
 
 	pp = reallocarray(cfg->fnames, 
 		cfg->fnamesz + 1, sizeof(char *));
 	if (pp == NULL) {
 		ort_msg(&cfg->mq, MSGTYPE_FATAL, ENOMEM, NULL, NULL);
-		return 0;
+		return NULL;
 	}
 
 	cfg->fnames = pp;
@@ -775,16 +772,126 @@ ort_parse_file(struct config *cfg, FILE *f, const char *fname)
 	cfg->fnames[cfg->fnamesz - 1] = strdup(fname);
 	if (cfg->fnames[cfg->fnamesz - 1] == NULL) {
 		ort_msg(&cfg->mq, MSGTYPE_FATAL, ENOMEM, NULL, NULL);
+		return NULL;
+	}
+
+	return cfg->fnames[cfg->fnamesz - 1];
+}
+
+/*
+ * Parse the "sz" bytes of "buf" as the file "fname", adding it to the
+ * configuration's file names, or load it if it's a snapshot.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+parse_input(struct config *cfg, const char *fname,
+	const char *buf, size_t sz)
+{
+	struct parse	 p;
+	struct pos	 pos;
+	int		 rc;
+
+	if (sz > 0 && buf[0] == '\177')
+		return ort_config_load(cfg, buf, sz, fname);
+
+	if (cfg->priv->loaded) {
+		memset(&pos, 0, sizeof(struct pos));
+		pos.fname = fname;
+		ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos, "snapshot "
+			"may not be combined with other configurations");
 		return 0;
 	}
 
+	if ((fname = parse_fname(cfg, fname)) == NULL)
+		return 0;
+
 	memset(&p, 0, sizeof(struct parse));
 	p.column = 0;
 	p.line = 1;
-	p.fname = cfg->fnames[cfg->fnamesz - 1];
-	p.f = f;
+	p.fname = fname;
 	p.cfg = cfg;
+	p.in = buf;
+	p.insz = sz;
 	rc = parse_root(&p);
 	free(p.buf);
 	return rc;
 }
+
+/*
+ * Parse the "sz" bytes of "buf" as if they were file "fname",
+ * augmenting the configuration already in "cfg".
+ * The buffer need not be NUL-terminated.
+ * It may also be a snapshot written by ort_config_save().
+ * Returns zero on failure, non-zero on success.
+ */
+int
+ort_parse_buffer(struct config *cfg, const char *buf, size_t sz,
+	const char *fname)
+{
+
+	return parse_input(cfg, fname, buf, sz);
+}
+
+/*
+ * Parse file "f", augmenting the configuration already in "cfg".
+ * Regular files are mapped into memory from their current position,
+ * which is left at the end of file; otherwise, the stream is read into
+ * memory.
+ * Either way, the input is then parsed as a buffer.
+ * Returns zero on failure, non-zero on success.
+ */
+int
+ort_parse_file(struct config *cfg, FILE *f, const char *fname)
+{
+	struct stat	 st;
+	struct pos	 pos;
+	off_t		 off;
+	void		*map, *pp;
+	char		*buf = NULL;
+	size_t		 sz = 0, max = 0, rsz;
+	int		 rc, fd = fileno(f);
+
+	if (fd != -1 && fstat(fd, &st) != -1 && S_ISREG(st.st_mode) &&
+	    st.st_size > 0 && (uintmax_t)st.st_size <= SIZE_MAX &&
+	    (off = ftello(f)) != -1 && off <= st.st_size) {
+		map = mmap(NULL, (size_t)st.st_size, 
+			PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			rc = parse_input(cfg, fname, (const char *)map + 
+				off, (size_t)(st.st_size - off));
+			munmap(map, (size_t)st.st_size);
+			fseeko(f, 0, SEEK_END);
+			return rc;
+		}
+	}
+
+	for (;;) {
+		if (sz == max) {
+			max = max ? max * 2 : BUFSIZ;
+			if ((pp = realloc(buf, max)) == NULL) {
+				ort_msg(&cfg->mq, MSGTYPE_FATAL, 
+					ENOMEM, NULL, NULL);
+				free(buf);
+				return 0;
+			}
+			buf = pp;
+		}
+		rsz = fread(buf + sz, 1, max - sz, f);
+		sz += rsz;
+		if (rsz == 0)
+			break;
+	}
+
+	if (ferror(f)) {
+		pos.fname = fname;
+		pos.line = 1;
+		pos.column = 0;
+		ort_msg(&cfg->mq, MSGTYPE_FATAL, errno, &pos, NULL);
+		free(buf);
+		return 0;
+	}
+
+	rc = parse_input(cfg, fname, buf, sz);
+	free(buf);
+	return rc;
+}
@@ -63,7 +63,9 @@ struct	parse {
 	size_t		 column; /* current column (from 1) */
 	const char	*fname; /* current filename */
 	struct config	*cfg; /* current configuration */
-	FILE		*f;
+	const char	*in; /* input (not NUL-terminated) */
+	size_t		 insz; /* length of input */
+	size_t		 inpos; /* current position in input */
 };
 
 int		parse_check_badidents(struct parse *, const char *);
@@ -214,7 +214,7 @@ parse_action(struct parse *p, enum upact *act)
  *
  *   [options | "comment" string_literal]* ";"
  *
- * The options are any of "rowid", "unique", or "noexport".
+ * The options are any of "rowid", "unique", "lazy", or "noexport".
  * This will continue processing until the semicolon is reached.
  */
 static void
@@ -270,6 +270,26 @@ parse_field_info(struct parse *p, struct field *fd)
 			if (fd->type == FTYPE_PASSWORD)
 				parse_warnx(p, "noexport is redundant");
 			fd->flags |= FIELD_NOEXPORT;
+		} else if (strcasecmp(p->last.string, "lazy") == 0) {
+			/*
+			 * Only for large values (blobs and text) that
+			 * are not used as unique or foreign keys.
+			 * The structure rowid is checked when linking.
+			 */
+
+			if (fd->type != FTYPE_BLOB &&
+			    fd->type != FTYPE_TEXT) {
+				parse_errx(p, "lazy on non-blob or "
+					"non-text type");
+				break;
+			} else if (fd->flags & FIELD_UNIQUE) {
+				parse_errx(p, "lazy on unique field");
+				break;
+			} else if (fd->ref != NULL) {
+				parse_errx(p, "lazy on reference");
+				break;
+			}
+			fd->flags |= FIELD_LAZY;
 		} else if (strcasecmp(p->last.string, "limit") == 0) {
 			parse_validate(p, fd);
 		} else if (strcasecmp(p->last.string, "unique") == 0) {
@@ -284,6 +304,9 @@ parse_field_info(struct parse *p, struct field *fd)
 			} else if (fd->flags & FIELD_ROWID) {
 				parse_warnx(p, "unique is redunant");
 				continue;
+			} else if (fd->flags & FIELD_LAZY) {
+				parse_errx(p, "lazy on unique field");
+				break;
 			}
 
 			fd->flags |= FIELD_UNIQUE;
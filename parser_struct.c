@@ -51,13 +51,19 @@ static	const char *const optypes[OPTYPE__MAX] = {
 
 static	const char *const rolemapts[ROLEMAP__MAX] = {
 	"all", /* ROLEMAP_ALL */
+	"avg", /* ROLEMAP_AVG */
 	"count", /* ROLEMAP_COUNT */
 	"delete", /* ROLEMAP_DELETE */
+	"exists", /* ROLEMAP_EXISTS */
 	"insert", /* ROLEMAP_INSERT */
 	"iterate", /* ROLEMAP_ITERATE */
 	"list", /* ROLEMAP_LIST */
+	"max", /* ROLEMAP_MAX */
+	"min", /* ROLEMAP_MIN */
 	"search", /* ROLEMAP_SEARCH */
+	"sum", /* ROLEMAP_SUM */
 	"update", /* ROLEMAP_UPDATE */
+	"upsert", /* ROLEMAP_UPSERT */
 	"noexport", /* ROLEMAP_NOEXPORT */
 };
 
@@ -108,6 +114,7 @@ strct_alloc(struct parse *p, const char *name)
 	TAILQ_INIT(&s->aq);
 	TAILQ_INIT(&s->uq);
 	TAILQ_INIT(&s->nq);
+	TAILQ_INIT(&s->iq);
 	TAILQ_INIT(&s->dq);
 	TAILQ_INIT(&s->rq);
 	return s;
@@ -505,6 +512,62 @@ parse_config_group_terms(struct parse *p, struct search *srch)
 		parse_err(p);
 }
 
+/*
+ * Like parse_config_search_terms() but for selected columns.
+ * These are only within the current structure.
+ * On return, the last token is the one after the last column.
+ *
+ *  field ["," field]*
+ */
+static void
+parse_config_select_terms(struct parse *p, struct search *srch)
+{
+	struct proj	*proj;
+	struct resolve	*r;
+
+	if (!TAILQ_EMPTY(&srch->projq)) {
+		parse_errx(p, "duplicate select clause");
+		return;
+	}
+
+	while (!PARSE_STOP(p)) {
+		if (p->lasttype != TOK_IDENT) {
+			parse_errx(p, "expected select identifier");
+			return;
+		}
+		if ((proj = calloc(1, sizeof(struct proj))) == NULL) {
+			parse_err(p);
+			return;
+		}
+		TAILQ_INSERT_TAIL(&srch->projq, proj, entries);
+		proj->parent = srch;
+		parse_point(p, &proj->pos);
+		if (!ref_append(&proj->fname, p->last.string, '.')) {
+			parse_err(p);
+			return;
+		}
+
+		/* Initialise the resolver. */
+
+		if ((r = calloc(1, sizeof(struct resolve))) == NULL) {
+			parse_err(p);
+			return;
+		}
+		TAILQ_INSERT_TAIL(&p->cfg->priv->rq, r, entries);
+		r->type = RESOLVE_PROJ;
+		r->struct_proj.result = proj;
+		r->struct_proj.name = strdup(p->last.string);
+		if (r->struct_proj.name == NULL) {
+			parse_err(p);
+			return;
+		}
+
+		if (parse_next(p) != TOK_COMMA)
+			break;
+		parse_next(p);
+	}
+}
+
 /*
  * Like parse_config_search_terms() but for order terms.
  *
@@ -747,7 +810,10 @@ parse_config_limit_params(struct parse *p, struct search *s)
  *     "distinct" distinct_struct |
  *     "minrow"|"maxrow" aggr_fields ]* |
  *     "grouprow" group_fields |
- *     "order" order_fields ]* ";"
+ *     "many" |
+ *     "order" order_fields |
+ *     "select" select_fields |
+ *     "until" ]* ";"
  */
 static void
 parse_config_search_params(struct parse *p, struct search *s)
@@ -809,9 +875,26 @@ parse_config_search_params(struct parse *p, struct search *s)
 		} else if (strcasecmp("grouprow", p->last.string) == 0) {
 			parse_next(p);
 			parse_config_group_terms(p, s);
+		} else if (strcasecmp("select", p->last.string) == 0) {
+			parse_next(p);
+			parse_config_select_terms(p, s);
 		} else if (strcasecmp("distinct", p->last.string) == 0) {
 			parse_next(p);
 			parse_config_distinct_term(p, s);
+		} else if (strcasecmp("many", p->last.string) == 0) {
+			if (s->type != STYPE_SEARCH)
+				parse_errx(p, "many only for search");
+			else if (s->flags & SEARCH_HAS_MANY)
+				parse_warnx(p, "redeclaring many");
+			s->flags |= SEARCH_HAS_MANY;
+			parse_next(p);
+		} else if (strcasecmp("until", p->last.string) == 0) {
+			if (s->type != STYPE_ITERATE)
+				parse_errx(p, "until only for iterate");
+			else if (s->flags & SEARCH_HAS_UNTIL)
+				parse_warnx(p, "redeclaring until");
+			s->flags |= SEARCH_HAS_UNTIL;
+			parse_next(p);
 		} else {
 			parse_errx(p, "unknown search parameter");
 			break;
@@ -820,7 +903,8 @@ parse_config_search_params(struct parse *p, struct search *s)
 			break;
 	}
 
-	if (s->group != NULL && s->aggr == NULL)
+	if (s->group != NULL && s->aggr == NULL && 
+	    s->type != STYPE_COUNT)
 		parse_errx(p, "group without a constraint");
 	if (s->aggr != NULL && s->group == NULL)
 		parse_errx(p, "constraint without a group");
@@ -897,13 +981,106 @@ parse_struct_unique(struct parse *p, struct strct *s)
 			"required for unique constraint");
 }
 
+/*
+ * Parse an index clause.
+ * This has the following syntax:
+ *
+ *  "index" field ["," field]* ["where" field op ["," field op]*]? ";"
+ *
+ * The fields are within the current structure.
+ * The "where" operators are unary, making this a partial index.
+ */
+static void
+parse_struct_index(struct parse *p, struct strct *s)
+{
+	struct iref	 *ir;
+	struct index	 *ip;
+	struct resolve	 *r;
+	struct irefq	 *q;
+
+	if ((ip = calloc(1, sizeof(struct index))) == NULL) {
+		parse_err(p);
+		return;
+	}
+
+	ip->parent = s;
+	parse_point(p, &ip->pos);
+	TAILQ_INIT(&ip->nq);
+	TAILQ_INIT(&ip->wq);
+	TAILQ_INSERT_TAIL(&s->iq, ip, entries);
+	q = &ip->nq;
+
+	while (!PARSE_STOP(p)) {
+		if (parse_next(p) != TOK_IDENT) {
+			parse_errx(p, "expected index field");
+			return;
+		}
+
+		/* Append to resolver. */
+
+		if ((ir = calloc(1, sizeof(struct iref))) == NULL) {
+			parse_err(p);
+			return;
+		}
+		TAILQ_INSERT_TAIL(q, ir, entries);
+		parse_point(p, &ir->pos);
+		ir->parent = ip;
+
+		if ((r = calloc(1, sizeof(struct resolve))) == NULL) {
+			parse_err(p);
+			return;
+		}
+		r->type = RESOLVE_INDEX;
+		TAILQ_INSERT_TAIL(&p->cfg->priv->rq, r, entries);
+		r->struct_index.result = ir;
+		r->struct_index.name = strdup(p->last.string);
+		if (r->struct_index.name == NULL) {
+			parse_err(p);
+			return;
+		}
+
+		/* Constraints have a mandatory unary operator. */
+
+		if (q == &ip->wq) {
+			if (parse_next(p) != TOK_IDENT) {
+				parse_errx(p, "expected operator");
+				return;
+			}
+			for (ir->op = OPTYPE_ISNULL; 
+			     ir->op != OPTYPE__MAX; ir->op++)
+				if (strcasecmp(p->last.string, 
+				    optypes[ir->op]) == 0)
+					break;
+			if (ir->op == OPTYPE__MAX) {
+				parse_errx(p, "expected unary operator");
+				return;
+			}
+		}
+
+		/* Next statement or start of constraints. */
+
+		if (parse_next(p) == TOK_SEMICOLON)
+			break;
+		if (p->lasttype == TOK_IDENT && q == &ip->nq &&
+		    strcasecmp(p->last.string, "where") == 0) {
+			q = &ip->wq;
+			continue;
+		}
+		if (p->lasttype != TOK_COMMA) {
+			parse_errx(p, "expected semicolon or comma");
+			return;
+		}
+	}
+}
+
 /*
  * Parse an update clause.
  * This has the following syntax:
  *
  *  "update" [ ufield [,ufield]* ]?
  *     [ ":" sfield [,sfield]*
- *       [ ":" [ "name" name | "comment" quot | "action" action ]* ]? 
+ *       [ ":" [ "name" name | "comment" quot | "action" action |
+ *               "returning" ]* ]? 
  *     ]? ";"
  *
  * The fields ("ufield" for update field and "sfield" for select field)
@@ -1057,7 +1234,7 @@ crq:
 
 	/*
 	 * Lastly, process update terms.
-	 * This now consists of "name" and "comment".
+	 * This now consists of "name", "comment", and "returning".
 	 */
 terms:
 	parse_next(p);
@@ -1086,6 +1263,13 @@ terms:
 		} else if (0 == strcasecmp(p->last.string, "comment")) {
 			if ( ! parse_comment(p, &up->doc))
 				return;
+		} else if (0 == strcasecmp(p->last.string, "returning")) {
+			if (up->type != UP_MODIFY) {
+				parse_errx(p, "returning "
+					"only for updates");
+				return;
+			}
+			up->flags |= UPDATE_RETURNING;
 		} else
 			parse_errx(p, "unknown term: %s", p->last.string);
 
@@ -1096,7 +1280,9 @@ terms:
 /*
  * Parse a search clause as follows:
  *
- *  ["search"|"list"|"iterate"|"count"] [ search_terms ]* 
+ *  ["search"|"list"|"iterate"|"count"|"exists"|
+ *   "sum"|"avg"|"min"|"max"]
+ *  [ search_terms ]* 
  *  [":" search_params ]? ";"
  *
  * The optional terms (searchable field) parts are parsed in
@@ -1118,6 +1304,7 @@ parse_struct_search(struct parse *p, struct strct *s, enum stype stype)
 	parse_point(p, &srch->pos);
 	TAILQ_INIT(&srch->sntq);
 	TAILQ_INIT(&srch->ordq);
+	TAILQ_INIT(&srch->projq);
 	TAILQ_INSERT_TAIL(&s->sq, srch, entries);
 
 	/*
@@ -1163,6 +1350,8 @@ parse_struct_search(struct parse *p, struct strct *s, enum stype stype)
 			s->flags |= STRCT_HAS_QUEUE;
 		else if (stype == STYPE_ITERATE)
 			s->flags |= STRCT_HAS_ITERATOR;
+		if (srch->flags & SEARCH_HAS_UNTIL)
+			s->flags |= STRCT_HAS_UNTIL;
 	}
 }
 
@@ -1328,6 +1517,7 @@ parse_struct_roles(struct parse *p, struct strct *s)
 		parse_next(p);
 		if (p->lasttype == TOK_IDENT) {
 			if (type == ROLEMAP_INSERT || 
+			    type == ROLEMAP_UPSERT ||
 			    type == ROLEMAP_ALL) {
 				parse_errx(p, "unexpected "
 					"role constraint name");
@@ -1337,6 +1527,7 @@ parse_struct_roles(struct parse *p, struct strct *s)
 			parse_next(p);
 		} else if (p->lasttype == TOK_SEMICOLON) {
 			if (type != ROLEMAP_INSERT &&
+			    type != ROLEMAP_UPSERT &&
 			    type != ROLEMAP_NOEXPORT &&
 			    type != ROLEMAP_ALL) {
 				parse_errx(p, "expected "
@@ -1389,6 +1580,9 @@ parse_struct_comment(struct parse *p, struct strct *s)
 /*
  * Parse the insert statement of a struct until and including the
  * trailing semicolon.
+ * This has the following syntax:
+ *
+ *  "insert" [ "returning" ]? ";"
  */
 static void
 parse_struct_insert(struct parse *p, struct strct *s)
@@ -1404,10 +1598,84 @@ parse_struct_insert(struct parse *p, struct strct *s)
 	}
 	s->ins->parent = s;
 	parse_point(p, &s->ins->pos);
-	if (parse_next(p) != TOK_SEMICOLON)
+	if (parse_next(p) == TOK_IDENT &&
+	    strcasecmp(p->last.string, "returning") == 0) {
+		s->ins->flags |= INSERT_RETURNING;
+		parse_next(p);
+	}
+	if (p->lasttype != TOK_SEMICOLON)
 		parse_errx(p, "expected semicolon");
 }
 
+/*
+ * Parse the upsert statement of a struct until and including the
+ * trailing semicolon.
+ * This has the following syntax:
+ *
+ *  "upsert" field ["," field]* ";"
+ *
+ * The fields, within the current structure, are the conflict target and
+ * must match a unique constraint.
+ */
+static void
+parse_struct_upsert(struct parse *p, struct strct *s)
+{
+	struct nref	*nf;
+	struct unique	*up;
+	struct resolve	*r;
+
+	if (s->ups != NULL) {
+		parse_errx(p, "upsert already defined");
+		return;
+	}
+	if ((s->ups = calloc(1, sizeof(struct upsert))) == NULL ||
+	    (up = calloc(1, sizeof(struct unique))) == NULL) {
+		parse_err(p);
+		return;
+	}
+	s->ups->parent = s;
+	s->ups->target = up;
+	parse_point(p, &s->ups->pos);
+
+	up->parent = s;
+	up->pos = s->ups->pos;
+	TAILQ_INIT(&up->nq);
+
+	while (!PARSE_STOP(p)) {
+		if (parse_next(p) != TOK_IDENT) {
+			parse_errx(p, "expected upsert field");
+			return;
+		}
+		if ((nf = calloc(1, sizeof(struct nref))) == NULL) {
+			parse_err(p);
+			return;
+		}
+		TAILQ_INSERT_TAIL(&up->nq, nf, entries);
+		parse_point(p, &nf->pos);
+		nf->parent = up;
+
+		if ((r = calloc(1, sizeof(struct resolve))) == NULL) {
+			parse_err(p);
+			return;
+		}
+		r->type = RESOLVE_UNIQUE;
+		TAILQ_INSERT_TAIL(&p->cfg->priv->rq, r, entries);
+		r->struct_unique.result = nf;
+		r->struct_unique.name = strdup(p->last.string);
+		if (r->struct_unique.name == NULL) {
+			parse_err(p);
+			return;
+		}
+
+		if (parse_next(p) == TOK_SEMICOLON)
+			break;
+		if (p->lasttype != TOK_COMMA) {
+			parse_errx(p, "expected semicolon or comma");
+			return;
+		}
+	}
+}
+
 /*
  * Parse a full struct until and including the semicolon following.
  */
@@ -1435,14 +1703,28 @@ parse_struct_data(struct parse *p, struct strct *s)
 			parse_struct_search(p, s, STYPE_LIST);
 		else if (strcasecmp(p->last.string, "iterate") == 0)
 			parse_struct_search(p, s, STYPE_ITERATE);
+		else if (strcasecmp(p->last.string, "exists") == 0)
+			parse_struct_search(p, s, STYPE_EXISTS);
+		else if (strcasecmp(p->last.string, "sum") == 0)
+			parse_struct_search(p, s, STYPE_SUM);
+		else if (strcasecmp(p->last.string, "avg") == 0)
+			parse_struct_search(p, s, STYPE_AVG);
+		else if (strcasecmp(p->last.string, "min") == 0)
+			parse_struct_search(p, s, STYPE_MIN);
+		else if (strcasecmp(p->last.string, "max") == 0)
+			parse_struct_search(p, s, STYPE_MAX);
 		else if (strcasecmp(p->last.string, "update") == 0)
 			parse_struct_update(p, s, UP_MODIFY);
 		else if (strcasecmp(p->last.string, "delete") == 0)
 			parse_struct_update(p, s, UP_DELETE);
 		else if (strcasecmp(p->last.string, "insert") == 0)
 			parse_struct_insert(p, s);
+		else if (strcasecmp(p->last.string, "upsert") == 0)
+			parse_struct_upsert(p, s);
 		else if (strcasecmp(p->last.string, "unique") == 0)
 			parse_struct_unique(p, s);
+		else if (strcasecmp(p->last.string, "index") == 0)
+			parse_struct_index(p, s);
 		else if (strcasecmp(p->last.string, "roles") == 0)
 			parse_struct_roles(p, s);
 		else if (strcasecmp(p->last.string, "field") == 0)
@@ -0,0 +1,93 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "aggregate.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	int64_t		 ival, qty;
+	double		 rval, price;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	/* No rows: no result. */
+
+	if (db_item_sum_qty(ort, &ival, 1) ||
+	    db_item_avg_price(ort, &rval, 1) ||
+	    db_item_min_minqty(ort, &ival) ||
+	    db_item_max_maxprice(ort, &rval))
+		return 1;
+
+	/* Only null values: no result. */
+
+	if (db_item_insert(ort, 1, NULL, NULL) < 0)
+		return 1;
+	if (db_item_sum_qty(ort, &ival, 1) ||
+	    db_item_avg_price(ort, &rval, 1) ||
+	    db_item_min_minqty(ort, &ival) ||
+	    db_item_max_maxprice(ort, &rval))
+		return 1;
+
+	/* Null values are skipped. */
+
+	qty = 3;
+	price = 1.0;
+	if (db_item_insert(ort, 1, &qty, &price) < 0)
+		return 1;
+	qty = 5;
+	price = 2.0;
+	if (db_item_insert(ort, 1, &qty, &price) < 0)
+		return 1;
+	qty = -2;
+	price = 10.0;
+	if (db_item_insert(ort, 2, &qty, &price) < 0)
+		return 1;
+
+	if (!db_item_sum_qty(ort, &ival, 1) || ival != 8)
+		return 1;
+	if (!db_item_sum_qty(ort, &ival, 2) || ival != -2)
+		return 1;
+	if (db_item_sum_qty(ort, &ival, 3))
+		return 1;
+	if (!db_item_avg_price(ort, &rval, 1) || rval != 1.5)
+		return 1;
+	if (!db_item_min_minqty(ort, &ival) || ival != -2)
+		return 1;
+	if (!db_item_max_maxprice(ort, &rval) || rval != 10.0)
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
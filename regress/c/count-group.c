@@ -0,0 +1,84 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "count-group.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort			*ort;
+	struct item_count_percat	*c;
+	struct item_count_percatbyname	*cn;
+	size_t				 sz;
+	const char			*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	/* No rows: no result. */
+
+	if (db_item_count_percat(ort, &sz) != NULL || sz != 0)
+		return 1;
+
+	/* Inserted out of order to check the ordering. */
+
+	if (db_item_insert(ort, 5, "a") < 0 ||
+	    db_item_insert(ort, 1, "a") < 0 ||
+	    db_item_insert(ort, 3, "b") < 0 ||
+	    db_item_insert(ort, 1, "b") < 0 ||
+	    db_item_insert(ort, 5, "a") < 0 ||
+	    db_item_insert(ort, 5, "b") < 0)
+		return 1;
+
+	if ((c = db_item_count_percat(ort, &sz)) == NULL || sz != 3)
+		return 1;
+	if (c[0].value != 1 || c[0].count != 2 ||
+	    c[1].value != 3 || c[1].count != 1 ||
+	    c[2].value != 5 || c[2].count != 3)
+		return 1;
+	free(c);
+
+	/* Grouping applies after the search constraint. */
+
+	if ((cn = db_item_count_percatbyname(ort, &sz, "a")) == NULL ||
+	    sz != 2)
+		return 1;
+	if (cn[0].value != 1 || cn[0].count != 1 ||
+	    cn[1].value != 5 || cn[1].count != 2)
+		return 1;
+	free(cn);
+
+	if (db_item_count_percatbyname(ort, &sz, "c") != NULL || sz != 0)
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "exists.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	if (db_item_exists_any(ort) ||
+	    db_item_exists_hascat(ort, 1) ||
+	    db_item_exists_hascatname(ort, 1, "a"))
+		return 1;
+
+	/* Multiple matches are still just one answer. */
+
+	if (db_item_insert(ort, 1, "a") < 0 ||
+	    db_item_insert(ort, 1, "b") < 0 ||
+	    db_item_insert(ort, 2, "a") < 0)
+		return 1;
+
+	if (!db_item_exists_any(ort))
+		return 1;
+	if (!db_item_exists_hascat(ort, 1) ||
+	    !db_item_exists_hascat(ort, 2) ||
+	    db_item_exists_hascat(ort, 3))
+		return 1;
+	if (!db_item_exists_hascatname(ort, 1, "a") ||
+	    !db_item_exists_hascatname(ort, 1, "b") ||
+	    db_item_exists_hascatname(ort, 2, "b"))
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
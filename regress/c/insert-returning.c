@@ -0,0 +1,83 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "insert-returning.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct user	*u1, *u2;
+	int64_t		 id;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	/* Make sure the returned identifier isn't just the first. */
+
+	if ((id = db_user_insert(ort, "x@y.com", "other", 0)) < 0)
+		return 1;
+
+	/* The returned row carries the new identifier and values. */
+
+	if ((u1 = db_user_insert_returning(ort, "a@b.com", "alpha", 3)) == NULL)
+		return 1;
+	if (u1->id == id || strcmp(u1->email, "a@b.com") ||
+	    strcmp(u1->name, "alpha") || u1->logins != 3)
+		return 1;
+
+	/* A constraint violation returns NULL. */
+
+	if (db_user_insert_returning(ort, "a@b.com", "beta", 4) != NULL)
+		return 1;
+
+	/* The updated row is returned with its new value. */
+
+	u2 = db_user_update_name_set_by_email_eq_returning
+		(ort, "gamma", "a@b.com");
+	if (u2 == NULL)
+		return 1;
+	if (u2->id != u1->id || strcmp(u2->name, "gamma") ||
+	    u2->logins != 3)
+		return 1;
+	db_user_free(u1);
+	db_user_free(u2);
+
+	/* No matching row returns NULL. */
+
+	if (db_user_update_name_set_by_email_eq_returning
+	    (ort, "delta", "c@d.com") != NULL)
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "iterate-until.ort.h"
+
+struct	seen {
+	int64_t	 stop; /* qty to stop at or -1 */
+	int64_t	 next; /* next expected qty */
+	size_t	 calls;
+};
+
+static int
+cb(const struct item *p, void *arg)
+{
+	struct seen	*s = arg;
+
+	if (p->qty != s->next++)
+		abort();
+	s->calls++;
+	return p->qty == s->stop;
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct seen	 s;
+	int64_t		 i;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	for (i = 0; i < 5; i++)
+		if (db_item_insert(ort, 1, 10 + i) < 0)
+			return 1;
+	if (db_item_insert(ort, 2, 20) < 0)
+		return 1;
+
+	/* Stop early: the stopping result is counted. */
+
+	memset(&s, 0, sizeof(struct seen));
+	s.stop = 12;
+	s.next = 10;
+	if (db_item_iterate_until_bycat(ort, cb, &s, 1) != 3 ||
+	    s.calls != 3)
+		return 1;
+
+	/* The database is usable after stopping. */
+
+	if (db_item_insert(ort, 1, 15) < 0)
+		return 1;
+
+	/* Never stopping runs through all results. */
+
+	memset(&s, 0, sizeof(struct seen));
+	s.stop = -1;
+	s.next = 10;
+	if (db_item_iterate_until_bycat(ort, cb, &s, 1) != 6 ||
+	    s.calls != 6)
+		return 1;
+
+	memset(&s, 0, sizeof(struct seen));
+	s.stop = -1;
+	if (db_item_iterate_until_bycat(ort, cb, &s, 3) != 0 ||
+	    s.calls != 0)
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
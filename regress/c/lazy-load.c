@@ -0,0 +1,133 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+#include <sys/queue.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "lazy-load.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct doc	*d;
+	struct doc_q	*q;
+	struct doc	 missing;
+	const void	*photo = "\x01\x00\x02";
+	int64_t		 id1, id2;
+	size_t		 sz;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	if ((id1 = db_doc_insert(ort, "one", "hello", 3, &photo)) < 0)
+		return 1;
+	if ((id2 = db_doc_insert(ort, "two", "world", 0, NULL)) < 0)
+		return 1;
+
+	/* Lazy columns are not read with the row. */
+
+	if ((d = db_doc_get_byid(ort, id1)) == NULL)
+		return 1;
+	if (strcmp(d->title, "one") ||
+	    !DB_ISFILLED(d, DB_FILLED_doc_title))
+		return 1;
+	if (d->body == NULL || d->body[0] != '\0' ||
+	    DB_ISFILLED(d, DB_FILLED_doc_body))
+		return 1;
+	if (d->has_photo || d->photo != NULL ||
+	    DB_ISFILLED(d, DB_FILLED_doc_photo))
+		return 1;
+
+	/* Each arrives only after its load. */
+
+	if (!db_doc_load_body(ort, d))
+		return 1;
+	if (strcmp(d->body, "hello") ||
+	    !DB_ISFILLED(d, DB_FILLED_doc_body))
+		return 1;
+	if (d->has_photo || DB_ISFILLED(d, DB_FILLED_doc_photo))
+		return 1;
+	if (!db_doc_load_photo(ort, d))
+		return 1;
+	if (!d->has_photo || d->photo_sz != 3 ||
+	    memcmp(d->photo, photo, 3) ||
+	    !DB_ISFILLED(d, DB_FILLED_doc_photo))
+		return 1;
+	db_doc_free(d);
+
+	/* A null lazy column is still marked as loaded. */
+
+	if ((d = db_doc_get_byid(ort, id2)) == NULL)
+		return 1;
+	if (!db_doc_load_photo(ort, d))
+		return 1;
+	if (d->has_photo || !DB_ISFILLED(d, DB_FILLED_doc_photo))
+		return 1;
+	db_doc_free(d);
+
+	/* Lists and projections leave them for loading, too. */
+
+	if ((q = db_doc_list_all(ort)) == NULL ||
+	    (d = TAILQ_FIRST(q)) == NULL)
+		return 1;
+	if (d->body[0] != '\0' || DB_ISFILLED(d, DB_FILLED_doc_body))
+		return 1;
+	if (!db_doc_load_body(ort, d) || strcmp(d->body, "hello"))
+		return 1;
+	db_doc_freeq(q);
+
+	if ((d = db_doc_get_titlebyid(ort, id2)) == NULL)
+		return 1;
+	if (!db_doc_load_body(ort, d) || strcmp(d->body, "world") ||
+	    !DB_ISFILLED(d, DB_FILLED_doc_body))
+		return 1;
+	db_doc_free(d);
+
+	/* Loading a row that doesn't exist fails. */
+
+	memset(&missing, 0, sizeof(struct doc));
+	missing.id = id2 + 1;
+	if (db_doc_load_body(ort, &missing) ||
+	    db_doc_load_photo(ort, &missing))
+		return 1;
+
+	/* Sizes are read without the blob. */
+
+	if (db_doc_blob_size_photo(ort, id1, &sz) <= 0 || sz != 3)
+		return 1;
+	if (db_doc_blob_size_photo(ort, id2, &sz) != 0)
+		return 1;
+	if (db_doc_blob_size_photo(ort, id2 + 1, &sz) >= 0)
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
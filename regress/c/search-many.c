@@ -0,0 +1,108 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "search-many.ort.h"
+
+#define	KEYS 131
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct item	**res;
+	char		 bufs[KEYS][16];
+	const char	*keys[KEYS];
+	size_t		 i;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	for (i = 0; i < 100; i++) {
+		snprintf(bufs[0], sizeof(bufs[0]), "k%zu", i);
+		if (db_item_insert(ort, bufs[0], i) < 0)
+			return 1;
+	}
+
+	/*
+	 * More than two batches of keys, the last being padded, with
+	 * missing keys (k100 and above) and duplicates both across
+	 * and within batches.
+	 */
+
+	for (i = 0; i < 128; i++)
+		snprintf(bufs[i], sizeof(bufs[i]), "k%zu", (i * 7) % 120);
+	snprintf(bufs[128], sizeof(bufs[128]), "k5");
+	snprintf(bufs[129], sizeof(bufs[129]), "k5");
+	snprintf(bufs[130], sizeof(bufs[130]), "k999");
+	for (i = 0; i < KEYS; i++)
+		keys[i] = bufs[i];
+
+	if ((res = db_item_get_many_bysku(ort, keys, KEYS)) == NULL)
+		return 1;
+
+	for (i = 0; i < KEYS; i++) {
+		if (strtol(keys[i] + 1, NULL, 10) >= 100) {
+			if (res[i] != NULL)
+				return 1;
+			continue;
+		}
+		if (res[i] == NULL || strcmp(res[i]->sku, keys[i]) ||
+		    res[i]->qty != strtol(keys[i] + 1, NULL, 10))
+			return 1;
+	}
+
+	/* Duplicate keys have their own copies. */
+
+	if (res[128] == res[129])
+		return 1;
+
+	for (i = 0; i < KEYS; i++)
+		db_item_free(res[i]);
+	free(res);
+
+	/* A single key is padded out to the full batch. */
+
+	keys[0] = "k42";
+	if ((res = db_item_get_many_bysku(ort, keys, 1)) == NULL)
+		return 1;
+	if (res[0] == NULL || res[0]->qty != 42)
+		return 1;
+	db_item_free(res[0]);
+	free(res);
+
+	if (db_item_get_many_bysku(ort, keys, 0) != NULL)
+		return 1;
+
+	db_close(ort);
+	return 0;
+}
@@ -0,0 +1,110 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+#include <sys/queue.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "select-filled.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct user	*u;
+	struct user_q	*q;
+	int64_t		 age = 42, id1, id2;
+	const char	*bio = "bio";
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	if ((id1 = db_user_insert(ort, "a@b.com", "alpha", &age, &bio)) < 0)
+		return 1;
+	if ((id2 = db_user_insert(ort, "c@d.com", "beta", NULL, NULL)) < 0)
+		return 1;
+
+	/* A full row has all columns filled. */
+
+	if ((u = db_user_get_byemail(ort, "a@b.com")) == NULL)
+		return 1;
+	if (!DB_ISFILLED(u, DB_FILLED_user_id) ||
+	    !DB_ISFILLED(u, DB_FILLED_user_email) ||
+	    !DB_ISFILLED(u, DB_FILLED_user_name) ||
+	    !DB_ISFILLED(u, DB_FILLED_user_age) ||
+	    !DB_ISFILLED(u, DB_FILLED_user_bio))
+		return 1;
+	if (strcmp(u->email, "a@b.com") || !u->has_age ||
+	    u->age != 42 || !u->has_bio || strcmp(u->bio, "bio"))
+		return 1;
+	db_user_free(u);
+
+	/* Only the selected columns (and the rowid) are filled. */
+
+	if ((u = db_user_get_namebyemail(ort, "a@b.com")) == NULL)
+		return 1;
+	if (!DB_ISFILLED(u, DB_FILLED_user_id) ||
+	    DB_ISFILLED(u, DB_FILLED_user_email) ||
+	    !DB_ISFILLED(u, DB_FILLED_user_name) ||
+	    DB_ISFILLED(u, DB_FILLED_user_age) ||
+	    DB_ISFILLED(u, DB_FILLED_user_bio))
+		return 1;
+	if (u->id != id1 || strcmp(u->name, "alpha"))
+		return 1;
+	if (u->email == NULL || u->email[0] != '\0' ||
+	    u->has_age || u->age != 0 || u->has_bio || u->bio != NULL)
+		return 1;
+	db_user_free(u);
+
+	/* Likewise for lists, where a selected column may be null. */
+
+	if ((q = db_user_list_names(ort)) == NULL)
+		return 1;
+	if ((u = TAILQ_FIRST(q)) == NULL)
+		return 1;
+	if (!DB_ISFILLED(u, DB_FILLED_user_age) ||
+	    DB_ISFILLED(u, DB_FILLED_user_bio))
+		return 1;
+	if (u->id != id1 || strcmp(u->name, "alpha") ||
+	    !u->has_age || u->age != 42 || u->has_bio || u->bio != NULL)
+		return 1;
+	if ((u = TAILQ_NEXT(u, _entries)) == NULL)
+		return 1;
+	if (!DB_ISFILLED(u, DB_FILLED_user_age) ||
+	    DB_ISFILLED(u, DB_FILLED_user_email))
+		return 1;
+	if (u->id != id2 || strcmp(u->name, "beta") || u->has_age)
+		return 1;
+	if (TAILQ_NEXT(u, _entries) != NULL)
+		return 1;
+	db_user_freeq(q);
+
+	db_close(ort);
+	return 0;
+}
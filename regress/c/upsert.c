@@ -0,0 +1,83 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kcgi.h>
+#include <kcgijson.h>
+
+#include "upsert.ort.h"
+
+int
+main(int argc, char *argv[])
+{
+	struct ort	*ort;
+	struct user	*u;
+	int64_t		 id1, id2, id3;
+	const char	*fname;
+
+	assert(argc == 2);
+	fname = argv[1];
+
+	if ((ort = db_open(fname)) == NULL)
+		return 1;
+
+	/* A new key inserts a row. */
+
+	if ((id1 = db_user_upsert(ort, "a@b.com", "alpha", 1)) < 0)
+		return 1;
+
+	/* A conflicting key updates and returns the existing row. */
+
+	if ((id2 = db_user_upsert(ort, "a@b.com", "beta", 2)) < 0)
+		return 1;
+	if (id1 != id2)
+		return 1;
+
+	if ((u = db_user_get_byemail(ort, "a@b.com")) == NULL)
+		return 1;
+	if (u->id != id1 || strcmp(u->name, "beta") || u->logins != 2)
+		return 1;
+	db_user_free(u);
+
+	/* Another key gets its own row. */
+
+	if ((id3 = db_user_upsert(ort, "c@d.com", "gamma", 3)) < 0)
+		return 1;
+	if (id3 == id1)
+		return 1;
+
+	/* Updating the first row again still returns its identifier. */
+
+	if ((id2 = db_user_upsert(ort, "a@b.com", "delta", 4)) != id1)
+		return 1;
+
+	if ((u = db_user_get_byemail(ort, "c@d.com")) == NULL)
+		return 1;
+	if (u->id != id3 || strcmp(u->name, "gamma") || u->logins != 3)
+		return 1;
+	db_user_free(u);
+
+	db_close(ort);
+	return 0;
+}
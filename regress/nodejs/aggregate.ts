@@ -0,0 +1,34 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+if (ctx.db_item_sum_qty(BigInt(1)) !== null ||
+    ctx.db_item_avg_price(BigInt(1)) !== null ||
+    ctx.db_item_min_minqty() !== null ||
+    ctx.db_item_max_maxprice() !== null)
+	return false;
+
+if (ctx.db_item_insert(BigInt(1), null, null) < 0)
+	return false;
+if (ctx.db_item_sum_qty(BigInt(1)) !== null ||
+    ctx.db_item_avg_price(BigInt(1)) !== null ||
+    ctx.db_item_min_minqty() !== null ||
+    ctx.db_item_max_maxprice() !== null)
+	return false;
+
+if (ctx.db_item_insert(BigInt(1), BigInt(3), 1.0) < 0 ||
+    ctx.db_item_insert(BigInt(1), BigInt(5), 2.0) < 0 ||
+    ctx.db_item_insert(BigInt(2), BigInt(-2), 10.0) < 0)
+	return false;
+
+if (ctx.db_item_sum_qty(BigInt(1)) !== BigInt(8) ||
+    ctx.db_item_sum_qty(BigInt(2)) !== BigInt(-2) ||
+    ctx.db_item_sum_qty(BigInt(3)) !== null)
+	return false;
+if (ctx.db_item_avg_price(BigInt(1)) !== 1.5)
+	return false;
+if (ctx.db_item_min_minqty() !== BigInt(-2))
+	return false;
+if (ctx.db_item_max_maxprice() !== 10.0)
+	return false;
+
+return true;
@@ -0,0 +1,32 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+if (ctx.db_item_count_percat().length !== 0)
+	return false;
+
+if (ctx.db_item_insert(BigInt(5), 'a') < 0 ||
+    ctx.db_item_insert(BigInt(1), 'a') < 0 ||
+    ctx.db_item_insert(BigInt(3), 'b') < 0 ||
+    ctx.db_item_insert(BigInt(1), 'b') < 0 ||
+    ctx.db_item_insert(BigInt(5), 'a') < 0 ||
+    ctx.db_item_insert(BigInt(5), 'b') < 0)
+	return false;
+
+const c: { value: bigint, count: bigint }[] = ctx.db_item_count_percat();
+if (c.length !== 3 ||
+    c[0].value !== BigInt(1) || c[0].count !== BigInt(2) ||
+    c[1].value !== BigInt(3) || c[1].count !== BigInt(1) ||
+    c[2].value !== BigInt(5) || c[2].count !== BigInt(3))
+	return false;
+
+const cn: { value: bigint, count: bigint }[] =
+	ctx.db_item_count_percatbyname('a');
+if (cn.length !== 2 ||
+    cn[0].value !== BigInt(1) || cn[0].count !== BigInt(1) ||
+    cn[1].value !== BigInt(5) || cn[1].count !== BigInt(2))
+	return false;
+
+if (ctx.db_item_count_percatbyname('c').length !== 0)
+	return false;
+
+return true;
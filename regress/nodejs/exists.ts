@@ -0,0 +1,25 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+if (ctx.db_item_exists_any() ||
+    ctx.db_item_exists_hascat(BigInt(1)) ||
+    ctx.db_item_exists_hascatname(BigInt(1), 'a'))
+	return false;
+
+if (ctx.db_item_insert(BigInt(1), 'a') < 0 ||
+    ctx.db_item_insert(BigInt(1), 'b') < 0 ||
+    ctx.db_item_insert(BigInt(2), 'a') < 0)
+	return false;
+
+if (ctx.db_item_exists_any() !== true)
+	return false;
+if (ctx.db_item_exists_hascat(BigInt(1)) !== true ||
+    ctx.db_item_exists_hascat(BigInt(2)) !== true ||
+    ctx.db_item_exists_hascat(BigInt(3)) !== false)
+	return false;
+if (ctx.db_item_exists_hascatname(BigInt(1), 'a') !== true ||
+    ctx.db_item_exists_hascatname(BigInt(1), 'b') !== true ||
+    ctx.db_item_exists_hascatname(BigInt(2), 'b') !== false)
+	return false;
+
+return true;
@@ -0,0 +1,27 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+const id: bigint = ctx.db_user_insert('x@y.com', 'other', BigInt(0));
+if (id < 0)
+	return false;
+
+const u1: ortns.user|null =
+	ctx.db_user_insert_returning('a@b.com', 'alpha', BigInt(3));
+if (u1 === null || u1.obj.id === id || u1.obj.email !== 'a@b.com' ||
+    u1.obj.name !== 'alpha' || u1.obj.logins !== BigInt(3))
+	return false;
+
+if (ctx.db_user_insert_returning('a@b.com', 'beta', BigInt(4)) !== null)
+	return false;
+
+const u2: ortns.user|null =
+	ctx.db_user_update_name_set_by_email_eq_returning('gamma', 'a@b.com');
+if (u2 === null || u2.obj.id !== u1.obj.id ||
+    u2.obj.name !== 'gamma' || u2.obj.logins !== BigInt(3))
+	return false;
+
+if (ctx.db_user_update_name_set_by_email_eq_returning
+    ('delta', 'c@d.com') !== null)
+	return false;
+
+return true;
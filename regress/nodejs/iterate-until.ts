@@ -0,0 +1,47 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+for (let i: number = 0; i < 5; i++)
+	if (ctx.db_item_insert(BigInt(1), BigInt(10 + i)) < 0)
+		return false;
+if (ctx.db_item_insert(BigInt(2), BigInt(20)) < 0)
+	return false;
+
+/* Stop early: the stopping result is counted. */
+
+let seen: bigint[] = [];
+if (ctx.db_item_iterate_until_bycat(BigInt(1),
+    (res: ortns.item): boolean => {
+	seen.push(res.obj.qty);
+	return res.obj.qty === BigInt(12);
+    }) !== 3)
+	return false;
+if (seen.join(',') !== '10,11,12')
+	return false;
+
+/* The database is usable after stopping. */
+
+if (ctx.db_item_insert(BigInt(1), BigInt(15)) < 0)
+	return false;
+
+/* Never stopping runs through all results. */
+
+seen = [];
+if (ctx.db_item_iterate_until_bycat(BigInt(1),
+    (res: ortns.item): boolean => {
+	seen.push(res.obj.qty);
+	return false;
+    }) !== 6)
+	return false;
+if (seen.join(',') !== '10,11,12,13,14,15')
+	return false;
+
+seen = [];
+if (ctx.db_item_iterate_until_bycat(BigInt(3),
+    (res: ortns.item): boolean => {
+	seen.push(res.obj.qty);
+	return false;
+    }) !== 0 || seen.length !== 0)
+	return false;
+
+return true;
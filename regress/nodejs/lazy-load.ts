@@ -0,0 +1,69 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+const photo: Buffer = Buffer.from([1, 0, 2]);
+
+const id1: bigint = ctx.db_doc_insert('one', 'hello', photo);
+const id2: bigint = ctx.db_doc_insert('two', 'world', null);
+if (id1 < 0 || id2 < 0)
+	return false;
+
+const isfilled = (obj: ortns.docData, col: ortns.docFilled): boolean =>
+	(obj._filled & BigInt(col)) !== BigInt(0);
+
+/* Lazy columns are not read with the row. */
+
+const d1: ortns.doc|null = ctx.db_doc_get_byid(id1);
+if (d1 === null || d1.obj.title !== 'one' ||
+    !isfilled(d1.obj, ortns.docFilled.title))
+	return false;
+if (d1.obj.body !== '' || isfilled(d1.obj, ortns.docFilled.body) ||
+    d1.obj.photo !== null || isfilled(d1.obj, ortns.docFilled.photo))
+	return false;
+
+/* Each arrives only after its load. */
+
+if (!ctx.db_doc_load_body(d1) || d1.obj.body !== 'hello' ||
+    !isfilled(d1.obj, ortns.docFilled.body))
+	return false;
+if (d1.obj.photo !== null || isfilled(d1.obj, ortns.docFilled.photo))
+	return false;
+if (!ctx.db_doc_load_photo(d1) || d1.obj.photo === null ||
+    !photo.equals(d1.obj.photo) ||
+    !isfilled(d1.obj, ortns.docFilled.photo))
+	return false;
+
+/* A null lazy column is still marked as loaded. */
+
+const d2: ortns.doc|null = ctx.db_doc_get_byid(id2);
+if (d2 === null || !ctx.db_doc_load_photo(d2) ||
+    d2.obj.photo !== null || !isfilled(d2.obj, ortns.docFilled.photo))
+	return false;
+
+/* Lists and projections leave them for loading, too. */
+
+const q: ortns.doc[] = ctx.db_doc_list_all();
+if (q.length !== 2 || q[0].obj.body !== '' ||
+    isfilled(q[0].obj, ortns.docFilled.body))
+	return false;
+if (!ctx.db_doc_load_body(q[0]) || q[0].obj.body !== 'hello')
+	return false;
+
+const d3: ortns.doc|null = ctx.db_doc_get_titlebyid(id2);
+if (d3 === null || !ctx.db_doc_load_body(d3) ||
+    d3.obj.body !== 'world' || !isfilled(d3.obj, ortns.docFilled.body))
+	return false;
+
+/* Loading a row that doesn't exist fails. */
+
+d3.obj.id = id2 + BigInt(1);
+if (ctx.db_doc_load_body(d3) || ctx.db_doc_load_photo(d3))
+	return false;
+
+/* Sizes are read without the blob. */
+
+if (ctx.db_doc_blob_size_photo(id1) !== BigInt(3) ||
+    ctx.db_doc_blob_size_photo(id2) !== null ||
+    ctx.db_doc_blob_size_photo(id2 + BigInt(1)) !== undefined)
+	return false;
+
+return true;
@@ -0,0 +1,49 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+for (let i: number = 0; i < 100; i++)
+	if (ctx.db_item_insert('k' + i.toString(), BigInt(i)) < 0)
+		return false;
+
+/*
+ * More than two batches of keys, the last being padded, with missing
+ * keys (k100 and above) and duplicates both across and within batches.
+ */
+
+const keys: string[] = [];
+for (let i: number = 0; i < 128; i++)
+	keys.push('k' + ((i * 7) % 120).toString());
+keys.push('k5', 'k5', 'k999');
+
+const res: (ortns.item|null)[] = ctx.db_item_get_many_bysku(keys);
+if (res.length !== keys.length)
+	return false;
+
+for (let i: number = 0; i < keys.length; i++) {
+	const num: number = parseInt(keys[i].substring(1));
+	const obj: ortns.item|null = res[i];
+	if (num >= 100) {
+		if (obj !== null)
+			return false;
+		continue;
+	}
+	if (obj === null || obj.obj.sku !== keys[i] ||
+	    obj.obj.qty !== BigInt(num))
+		return false;
+}
+
+/* Duplicate keys have their own copies. */
+
+if (res[128] === res[129])
+	return false;
+
+/* A single key is padded out to the full batch. */
+
+const one: (ortns.item|null)[] = ctx.db_item_get_many_bysku(['k42']);
+if (one.length !== 1 || one[0] === null || one[0].obj.qty !== BigInt(42))
+	return false;
+
+if (ctx.db_item_get_many_bysku([]).length !== 0)
+	return false;
+
+return true;
@@ -0,0 +1,56 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+const id1: bigint = ctx.db_user_insert('a@b.com', 'alpha', BigInt(42), 'bio');
+const id2: bigint = ctx.db_user_insert('c@d.com', 'beta', null, null);
+if (id1 < 0 || id2 < 0)
+	return false;
+
+const isfilled = (obj: ortns.userData, col: ortns.userFilled): boolean =>
+	(obj._filled & BigInt(col)) !== BigInt(0);
+
+/* A full row has all columns filled. */
+
+const u1: ortns.user|null = ctx.db_user_get_byemail('a@b.com');
+if (u1 === null ||
+    !isfilled(u1.obj, ortns.userFilled.id) ||
+    !isfilled(u1.obj, ortns.userFilled.email) ||
+    !isfilled(u1.obj, ortns.userFilled.name) ||
+    !isfilled(u1.obj, ortns.userFilled.age) ||
+    !isfilled(u1.obj, ortns.userFilled.bio))
+	return false;
+if (u1.obj.email !== 'a@b.com' || u1.obj.age !== BigInt(42) ||
+    u1.obj.bio !== 'bio')
+	return false;
+
+/* Only the selected columns (and the rowid) are filled. */
+
+const u2: ortns.user|null = ctx.db_user_get_namebyemail('a@b.com');
+if (u2 === null ||
+    !isfilled(u2.obj, ortns.userFilled.id) ||
+    isfilled(u2.obj, ortns.userFilled.email) ||
+    !isfilled(u2.obj, ortns.userFilled.name) ||
+    isfilled(u2.obj, ortns.userFilled.age) ||
+    isfilled(u2.obj, ortns.userFilled.bio))
+	return false;
+if (u2.obj.id !== id1 || u2.obj.name !== 'alpha' ||
+    u2.obj.email !== '' || u2.obj.age !== null || u2.obj.bio !== null)
+	return false;
+
+/* Likewise for lists, where a selected column may be null. */
+
+const q: ortns.user[] = ctx.db_user_list_names();
+if (q.length !== 2)
+	return false;
+if (!isfilled(q[0].obj, ortns.userFilled.age) ||
+    isfilled(q[0].obj, ortns.userFilled.bio) ||
+    q[0].obj.id !== id1 || q[0].obj.name !== 'alpha' ||
+    q[0].obj.age !== BigInt(42) || q[0].obj.bio !== null)
+	return false;
+if (!isfilled(q[1].obj, ortns.userFilled.age) ||
+    isfilled(q[1].obj, ortns.userFilled.email) ||
+    q[1].obj.id !== id2 || q[1].obj.name !== 'beta' ||
+    q[1].obj.age !== null)
+	return false;
+
+return true;
@@ -0,0 +1,28 @@
+const db: ortdb = ort(dbfile);
+const ctx: ortctx = db.connect();
+
+const id1: bigint = ctx.db_user_upsert('a@b.com', 'alpha', BigInt(1));
+if (id1 < 0)
+	return false;
+
+const id2: bigint = ctx.db_user_upsert('a@b.com', 'beta', BigInt(2));
+if (id2 !== id1)
+	return false;
+
+const u1: ortns.user|null = ctx.db_user_get_byemail('a@b.com');
+if (u1 === null || u1.obj.id !== id1 ||
+    u1.obj.name !== 'beta' || u1.obj.logins !== BigInt(2))
+	return false;
+
+const id3: bigint = ctx.db_user_upsert('c@d.com', 'gamma', BigInt(3));
+if (id3 < 0 || id3 === id1)
+	return false;
+
+if (ctx.db_user_upsert('a@b.com', 'delta', BigInt(4)) !== id1)
+	return false;
+
+const u2: ortns.user|null = ctx.db_user_get_byemail('c@d.com');
+if (u2 === null || u2.obj.id !== id3 || u2.obj.name !== 'gamma')
+	return false;
+
+return true;
@@ -0,0 +1,31 @@
+use orb::ort;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+
+    assert_eq!(ctx.db_item_sum_qty(1).unwrap(), None);
+    assert_eq!(ctx.db_item_avg_price(1).unwrap(), None);
+    assert_eq!(ctx.db_item_min_minqty().unwrap(), None);
+    assert_eq!(ctx.db_item_max_maxprice().unwrap(), None);
+
+    assert_ne!(ctx.db_item_insert(1, None, None).unwrap(), -1);
+    assert_eq!(ctx.db_item_sum_qty(1).unwrap(), None);
+    assert_eq!(ctx.db_item_avg_price(1).unwrap(), None);
+    assert_eq!(ctx.db_item_min_minqty().unwrap(), None);
+    assert_eq!(ctx.db_item_max_maxprice().unwrap(), None);
+
+    assert_ne!(ctx.db_item_insert(1, Some(3), Some(1.0)).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(1, Some(5), Some(2.0)).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(2, Some(-2), Some(10.0)).unwrap(), -1);
+
+    assert_eq!(ctx.db_item_sum_qty(1).unwrap(), Some(8));
+    assert_eq!(ctx.db_item_sum_qty(2).unwrap(), Some(-2));
+    assert_eq!(ctx.db_item_sum_qty(3).unwrap(), None);
+    assert_eq!(ctx.db_item_avg_price(1).unwrap(), Some(1.5));
+    assert_eq!(ctx.db_item_min_minqty().unwrap(), Some(-2));
+    assert_eq!(ctx.db_item_max_maxprice().unwrap(), Some(10.0));
+}
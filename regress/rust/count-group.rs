@@ -0,0 +1,27 @@
+use orb::ort;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let a = "a".to_string();
+    let b = "b".to_string();
+
+    assert!(ctx.db_item_count_percat().unwrap().is_empty());
+
+    assert_ne!(ctx.db_item_insert(5, &a).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(1, &a).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(3, &b).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(1, &b).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(5, &a).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(5, &b).unwrap(), -1);
+
+    assert_eq!(ctx.db_item_count_percat().unwrap(),
+               vec![(1, 2), (3, 1), (5, 3)]);
+    assert_eq!(ctx.db_item_count_percatbyname(&a).unwrap(),
+               vec![(1, 1), (5, 2)]);
+    assert!(ctx.db_item_count_percatbyname
+            (&"c".to_string()).unwrap().is_empty());
+}
@@ -0,0 +1,27 @@
+use orb::ort;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let a = "a".to_string();
+    let b = "b".to_string();
+
+    assert!(!ctx.db_item_exists_any().unwrap());
+    assert!(!ctx.db_item_exists_hascat(1).unwrap());
+    assert!(!ctx.db_item_exists_hascatname(1, &a).unwrap());
+
+    assert_ne!(ctx.db_item_insert(1, &a).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(1, &b).unwrap(), -1);
+    assert_ne!(ctx.db_item_insert(2, &a).unwrap(), -1);
+
+    assert!(ctx.db_item_exists_any().unwrap());
+    assert!(ctx.db_item_exists_hascat(1).unwrap());
+    assert!(ctx.db_item_exists_hascat(2).unwrap());
+    assert!(!ctx.db_item_exists_hascat(3).unwrap());
+    assert!(ctx.db_item_exists_hascatname(1, &a).unwrap());
+    assert!(ctx.db_item_exists_hascatname(1, &b).unwrap());
+    assert!(!ctx.db_item_exists_hascatname(2, &b).unwrap());
+}
@@ -0,0 +1,35 @@
+use orb::ort;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let email = "a@b.com".to_string();
+
+    let id = ctx.db_user_insert
+        (&"x@y.com".to_string(), &"other".to_string(), 0).unwrap();
+    assert_ne!(id, -1);
+
+    let u1 = ctx.db_user_insert_returning
+        (&email, &"alpha".to_string(), 3).unwrap().unwrap();
+    assert_ne!(u1.data.id, id);
+    assert_eq!(u1.data.email, "a@b.com");
+    assert_eq!(u1.data.name, "alpha");
+    assert_eq!(u1.data.logins, 3);
+
+    let dupe = ctx.db_user_insert_returning
+        (&email, &"beta".to_string(), 4).unwrap();
+    assert!(dupe.is_none());
+
+    let u2 = ctx.db_user_update_name_set_by_email_eq_returning
+        (&"gamma".to_string(), &email).unwrap().unwrap();
+    assert_eq!(u2.data.id, u1.data.id);
+    assert_eq!(u2.data.name, "gamma");
+    assert_eq!(u2.data.logins, 3);
+
+    let none = ctx.db_user_update_name_set_by_email_eq_returning
+        (&"delta".to_string(), &"c@d.com".to_string()).unwrap();
+    assert!(none.is_none());
+}
@@ -0,0 +1,50 @@
+use orb::ort;
+use std::env;
+use std::sync::atomic::{AtomicI64, Ordering};
+
+static NEXT: AtomicI64 = AtomicI64::new(0);
+
+fn check(res: &ort::objs::Item) {
+    assert_eq!(res.data.qty, NEXT.fetch_add(1, Ordering::SeqCst));
+}
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+
+    for i in 0..5 {
+        assert_ne!(ctx.db_item_insert(1, 10 + i).unwrap(), -1);
+    }
+    assert_ne!(ctx.db_item_insert(2, 20).unwrap(), -1);
+
+    // Stop early: the stopping result is counted.
+
+    NEXT.store(10, Ordering::SeqCst);
+    let n = ctx.db_item_iterate_until_bycat(|res| {
+        check(&res);
+        res.data.qty == 12
+    }, 1).unwrap();
+    assert_eq!(n, 3);
+    assert_eq!(NEXT.load(Ordering::SeqCst), 13);
+
+    // The database is usable after stopping.
+
+    assert_ne!(ctx.db_item_insert(1, 15).unwrap(), -1);
+
+    // Never stopping runs through all results.
+
+    NEXT.store(10, Ordering::SeqCst);
+    let n = ctx.db_item_iterate_until_bycat(|res| {
+        check(&res);
+        false
+    }, 1).unwrap();
+    assert_eq!(n, 6);
+    assert_eq!(NEXT.load(Ordering::SeqCst), 16);
+
+    let n = ctx.db_item_iterate_until_bycat(|_| {
+        panic!("no results expected");
+    }, 3).unwrap();
+    assert_eq!(n, 0);
+}
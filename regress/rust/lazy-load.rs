@@ -0,0 +1,72 @@
+use orb::ort;
+use orb::ort::data::Doc;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let photo: Vec<u8> = vec![1, 0, 2];
+
+    let id1 = ctx.db_doc_insert(&"one".to_string(),
+        &"hello".to_string(), Some(&photo)).unwrap();
+    assert_ne!(id1, -1);
+    let id2 = ctx.db_doc_insert(&"two".to_string(),
+        &"world".to_string(), None).unwrap();
+    assert_ne!(id2, -1);
+
+    // Lazy columns are not read with the row.
+
+    let mut d1 = ctx.db_doc_get_byid(id1).unwrap().unwrap();
+    assert_eq!(d1.data.title, "one");
+    assert!(d1.data.is_filled(Doc::FILLED_TITLE));
+    assert_eq!(d1.data.body, "");
+    assert!(!d1.data.is_filled(Doc::FILLED_BODY));
+    assert_eq!(d1.data.photo, None);
+    assert!(!d1.data.is_filled(Doc::FILLED_PHOTO));
+
+    // Each arrives only after its load.
+
+    assert!(ctx.db_doc_load_body(&mut d1).unwrap());
+    assert_eq!(d1.data.body, "hello");
+    assert!(d1.data.is_filled(Doc::FILLED_BODY));
+    assert_eq!(d1.data.photo, None);
+    assert!(!d1.data.is_filled(Doc::FILLED_PHOTO));
+    assert!(ctx.db_doc_load_photo(&mut d1).unwrap());
+    assert_eq!(d1.data.photo, Some(photo.clone()));
+    assert!(d1.data.is_filled(Doc::FILLED_PHOTO));
+
+    // A null lazy column is still marked as loaded.
+
+    let mut d2 = ctx.db_doc_get_byid(id2).unwrap().unwrap();
+    assert!(ctx.db_doc_load_photo(&mut d2).unwrap());
+    assert_eq!(d2.data.photo, None);
+    assert!(d2.data.is_filled(Doc::FILLED_PHOTO));
+
+    // Lists and projections leave them for loading, too.
+
+    let mut q = ctx.db_doc_list_all().unwrap();
+    assert_eq!(q.len(), 2);
+    assert_eq!(q[0].data.body, "");
+    assert!(!q[0].data.is_filled(Doc::FILLED_BODY));
+    assert!(ctx.db_doc_load_body(&mut q[0]).unwrap());
+    assert_eq!(q[0].data.body, "hello");
+
+    let mut d3 = ctx.db_doc_get_titlebyid(id2).unwrap().unwrap();
+    assert!(ctx.db_doc_load_body(&mut d3).unwrap());
+    assert_eq!(d3.data.body, "world");
+    assert!(d3.data.is_filled(Doc::FILLED_BODY));
+
+    // Loading a row that doesn't exist fails.
+
+    d3.data.id = id2 + 1;
+    assert!(!ctx.db_doc_load_body(&mut d3).unwrap());
+    assert!(!ctx.db_doc_load_photo(&mut d3).unwrap());
+
+    // Sizes are read without the blob.
+
+    assert_eq!(ctx.db_doc_blob_size_photo(id1).unwrap(), Some(Some(3)));
+    assert_eq!(ctx.db_doc_blob_size_photo(id2).unwrap(), Some(None));
+    assert_eq!(ctx.db_doc_blob_size_photo(id2 + 1).unwrap(), None);
+}
@@ -0,0 +1,47 @@
+use orb::ort;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+
+    for i in 0..100 {
+        assert_ne!(ctx.db_item_insert(&format!("k{}", i), i).unwrap(), -1);
+    }
+
+    // More than two batches of keys, the last being padded, with
+    // missing keys (k100 and above) and duplicates both across and
+    // within batches.
+
+    let mut keys: Vec<String> = (0..128)
+        .map(|i| format!("k{}", (i * 7) % 120)).collect();
+    keys.push("k5".to_string());
+    keys.push("k5".to_string());
+    keys.push("k999".to_string());
+    let refs: Vec<&String> = keys.iter().collect();
+
+    let res = ctx.db_item_get_many_bysku(&refs).unwrap();
+    assert_eq!(res.len(), keys.len());
+
+    for (key, obj) in keys.iter().zip(res.iter()) {
+        let num: i64 = key[1..].parse().unwrap();
+        if num >= 100 {
+            assert!(obj.is_none());
+            continue;
+        }
+        let obj = obj.as_ref().unwrap();
+        assert_eq!(&obj.data.sku, key);
+        assert_eq!(obj.data.qty, num);
+    }
+
+    // A single key is padded out to the full batch.
+
+    let key = "k42".to_string();
+    let one = ctx.db_item_get_many_bysku(&[&key]).unwrap();
+    assert_eq!(one.len(), 1);
+    assert_eq!(one[0].as_ref().unwrap().data.qty, 42);
+
+    assert!(ctx.db_item_get_many_bysku(&[]).unwrap().is_empty());
+}
@@ -0,0 +1,60 @@
+use orb::ort;
+use orb::ort::data::User;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let email = "a@b.com".to_string();
+
+    let id1 = ctx.db_user_insert(&email, &"alpha".to_string(),
+        Some(42), Some(&"bio".to_string())).unwrap();
+    assert_ne!(id1, -1);
+    let id2 = ctx.db_user_insert(&"c@d.com".to_string(),
+        &"beta".to_string(), None, None).unwrap();
+    assert_ne!(id2, -1);
+
+    // A full row has all columns filled.
+
+    let u1 = ctx.db_user_get_byemail(&email).unwrap().unwrap();
+    assert!(u1.data.is_filled(User::FILLED_ID));
+    assert!(u1.data.is_filled(User::FILLED_EMAIL));
+    assert!(u1.data.is_filled(User::FILLED_NAME));
+    assert!(u1.data.is_filled(User::FILLED_AGE));
+    assert!(u1.data.is_filled(User::FILLED_BIO));
+    assert_eq!(u1.data.email, "a@b.com");
+    assert_eq!(u1.data.age, Some(42));
+    assert_eq!(u1.data.bio, Some("bio".to_string()));
+
+    // Only the selected columns (and the rowid) are filled.
+
+    let u2 = ctx.db_user_get_namebyemail(&email).unwrap().unwrap();
+    assert!(u2.data.is_filled(User::FILLED_ID));
+    assert!(!u2.data.is_filled(User::FILLED_EMAIL));
+    assert!(u2.data.is_filled(User::FILLED_NAME));
+    assert!(!u2.data.is_filled(User::FILLED_AGE));
+    assert!(!u2.data.is_filled(User::FILLED_BIO));
+    assert_eq!(u2.data.id, id1);
+    assert_eq!(u2.data.name, "alpha");
+    assert_eq!(u2.data.email, "");
+    assert_eq!(u2.data.age, None);
+    assert_eq!(u2.data.bio, None);
+
+    // Likewise for lists, where a selected column may be null.
+
+    let q = ctx.db_user_list_names().unwrap();
+    assert_eq!(q.len(), 2);
+    assert!(q[0].data.is_filled(User::FILLED_AGE));
+    assert!(!q[0].data.is_filled(User::FILLED_BIO));
+    assert_eq!(q[0].data.id, id1);
+    assert_eq!(q[0].data.name, "alpha");
+    assert_eq!(q[0].data.age, Some(42));
+    assert_eq!(q[0].data.bio, None);
+    assert!(q[1].data.is_filled(User::FILLED_AGE));
+    assert!(!q[1].data.is_filled(User::FILLED_EMAIL));
+    assert_eq!(q[1].data.id, id2);
+    assert_eq!(q[1].data.name, "beta");
+    assert_eq!(q[1].data.age, None);
+}
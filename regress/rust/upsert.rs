@@ -0,0 +1,32 @@
+use orb::ort;
+use std::env;
+
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    assert_eq!(args.len(), 2);
+    let db = ort::Ortdb::new(&args[1]);
+    let ctx = db.connect().unwrap();
+    let email1 = "a@b.com".to_string();
+    let email2 = "c@d.com".to_string();
+
+    let id1 = ctx.db_user_upsert(&email1, &"alpha".to_string(), 1).unwrap();
+    assert_ne!(id1, -1);
+    let id2 = ctx.db_user_upsert(&email1, &"beta".to_string(), 2).unwrap();
+    assert_eq!(id2, id1);
+
+    let u1 = ctx.db_user_get_byemail(&email1).unwrap().unwrap();
+    assert_eq!(u1.data.id, id1);
+    assert_eq!(u1.data.name, "beta");
+    assert_eq!(u1.data.logins, 2);
+
+    let id3 = ctx.db_user_upsert(&email2, &"gamma".to_string(), 3).unwrap();
+    assert_ne!(id3, -1);
+    assert_ne!(id3, id1);
+
+    let id4 = ctx.db_user_upsert(&email1, &"delta".to_string(), 4).unwrap();
+    assert_eq!(id4, id1);
+
+    let u2 = ctx.db_user_get_byemail(&email2).unwrap().unwrap();
+    assert_eq!(u2.data.id, id3);
+    assert_eq!(u2.data.name, "gamma");
+}
@@ -41,6 +41,7 @@ main(int argc, char *argv[])
 	int			  c, rc = 0;
 	FILE			**confs = NULL;
 	size_t			  i;
+	const char		 *er;
 
 	memset(&args, 0, sizeof(struct ort_lang_rust));
 
@@ -49,8 +50,16 @@ main(int argc, char *argv[])
 		err(1, "pledge");
 #endif
 
-	while ((c = getopt(argc, argv, "")) != -1)
-		goto usage;
+	while ((c = getopt(argc, argv, "P:")) != -1)
+		switch (c) {
+		case 'P':
+			args.jobs = strtonum(optarg, 1, 256, &er);
+			if (er != NULL)
+				errx(1, "-P: %s: %s", optarg, er);
+			break;
+		default:
+			goto usage;
+		}
 
 	argc -= optind;
 	argv += optind;
@@ -91,7 +100,7 @@ out:
 	free(confs);
 	return !rc;
 usage:
-	fprintf(stderr, "usage: %s [config...]\n", 
+	fprintf(stderr, "usage: %s [-P jobs] [config...]\n", 
 		getprogname());
 	return 1;
 }
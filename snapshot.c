@@ -0,0 +1,2144 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "config.h"
+
+#if HAVE_SYS_QUEUE
+# include <sys/queue.h>
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ort.h"
+#include "ort-version.h"
+#include "extern.h"
+
+/*
+ * A snapshot is a linked configuration serialised depth-first in the
+ * order of its queues.
+ * It begins with SNAP_MAGIC, the format revision, and the version
+ * stamp of the writer, all of which must match when loading.
+ * Integers are little-endian base-128 (signed ones zig-zag encoded),
+ * reals are their IEEE 754 bits as an integer, and strings are their
+ * length plus one (zero for NULL) followed by the bytes.
+ * Objects that may be pointed to from elsewhere in the configuration
+ * are numbered by type in the order they're written, and the snapshot
+ * is prefixed by the count of each: pointers are these numbers plus
+ * one (zero for NULL).
+ * All other objects are owned by their parent and written in place.
+ */
+#define	SNAP_MAGIC	"\177ORT"
+#define	SNAP_MAGICSZ	4
+#define	SNAP_REVISION	1
+
+/*
+ * Objects that may be referenced by pointer.
+ */
+enum	snapt {
+	SNAP_ALIAS,
+	SNAP_BITF,
+	SNAP_EITEM,
+	SNAP_ENM,
+	SNAP_FIELD,
+	SNAP_ROLE,
+	SNAP_ROLEMAP,
+	SNAP_SEARCH,
+	SNAP_STRCT,
+	SNAP_UPDATE,
+	SNAP__MAX
+};
+
+static	const size_t snapsz[SNAP__MAX] = {
+	sizeof(struct alias), /* SNAP_ALIAS */
+	sizeof(struct bitf), /* SNAP_BITF */
+	sizeof(struct eitem), /* SNAP_EITEM */
+	sizeof(struct enm), /* SNAP_ENM */
+	sizeof(struct field), /* SNAP_FIELD */
+	sizeof(struct role), /* SNAP_ROLE */
+	sizeof(struct rolemap), /* SNAP_ROLEMAP */
+	sizeof(struct search), /* SNAP_SEARCH */
+	sizeof(struct strct), /* SNAP_STRCT */
+	sizeof(struct update), /* SNAP_UPDATE */
+};
+
+/*
+ * Number of a referenced object while writing.
+ */
+struct	snapidx {
+	const void	*obj; /* object or NULL if empty slot */
+	size_t		 idx; /* number within its type */
+};
+
+struct	save {
+	FILE			*f;
+	const struct config	*cfg;
+	struct snapidx		*idx; /* open-addressed by object */
+	size_t			 idxsz; /* occupied slots */
+	size_t			 idxmax; /* slots (power of two) */
+	size_t			 count[SNAP__MAX]; /* objects by type */
+	int			 rc; /* zero on failure */
+};
+
+struct	load {
+	struct config		*cfg;
+	const unsigned char	*buf;
+	size_t			 sz;
+	size_t			 pos; /* current offset in buf */
+	size_t			 fbase; /* first of our cfg->fnames */
+	size_t			 fsz; /* number of our cfg->fnames */
+	void			**objs[SNAP__MAX]; /* pre-allocated */
+	size_t			 count[SNAP__MAX]; /* objs sizes */
+	size_t			 next[SNAP__MAX]; /* next unused objs */
+	int			 er; /* errno on failure */
+	int			 bad; /* malformed on failure */
+};
+
+static size_t
+snap_hash(const void *obj)
+{
+
+	return (size_t)(((uintptr_t)obj >> 3) * 2654435761u);
+}
+
+/*
+ * Number object "obj" as the next of its type.
+ * Returns zero on allocation failure, non-zero on success.
+ */
+static int
+save_number(struct save *s, enum snapt type, const void *obj)
+{
+	struct snapidx	*old;
+	size_t		 i, j, oldmax;
+
+	if ((s->idxsz + 1) * 2 > s->idxmax) {
+		old = s->idx;
+		oldmax = s->idxmax;
+		s->idxmax = oldmax == 0 ? 256 : oldmax * 2;
+		s->idx = calloc(s->idxmax, sizeof(struct snapidx));
+		if (s->idx == NULL) {
+			s->idx = old;
+			s->idxmax = oldmax;
+			return 0;
+		}
+		for (i = 0; i < oldmax; i++) {
+			if (old[i].obj == NULL)
+				continue;
+			j = snap_hash(old[i].obj) & (s->idxmax - 1);
+			while (s->idx[j].obj != NULL)
+				j = (j + 1) & (s->idxmax - 1);
+			s->idx[j] = old[i];
+		}
+		free(old);
+	}
+
+	i = snap_hash(obj) & (s->idxmax - 1);
+	while (s->idx[i].obj != NULL)
+		i = (i + 1) & (s->idxmax - 1);
+	s->idx[i].obj = obj;
+	s->idx[i].idx = s->count[type]++;
+	s->idxsz++;
+	return 1;
+}
+
+/*
+ * Number all objects that may be referenced by pointer, in the order
+ * in which they're written by save_config().
+ * Returns zero on allocation failure, non-zero on success.
+ */
+static int
+save_numbers(struct save *s)
+{
+	const struct enm	*e;
+	const struct eitem	*ei;
+	const struct bitf	*b;
+	const struct role	*r;
+	const struct strct	*p;
+	const struct field	*f;
+	const struct search	*sr;
+	const struct alias	*a;
+	const struct update	*u;
+	const struct rolemap	*rm;
+
+	TAILQ_FOREACH(e, &s->cfg->eq, entries) {
+		if (!save_number(s, SNAP_ENM, e))
+			return 0;
+		TAILQ_FOREACH(ei, &e->eq, entries)
+			if (!save_number(s, SNAP_EITEM, ei))
+				return 0;
+	}
+	TAILQ_FOREACH(b, &s->cfg->bq, entries)
+		if (!save_number(s, SNAP_BITF, b))
+			return 0;
+	TAILQ_FOREACH(r, &s->cfg->arq, allentries)
+		if (!save_number(s, SNAP_ROLE, r))
+			return 0;
+	TAILQ_FOREACH(p, &s->cfg->sq, entries) {
+		if (!save_number(s, SNAP_STRCT, p))
+			return 0;
+		TAILQ_FOREACH(f, &p->fq, entries)
+			if (!save_number(s, SNAP_FIELD, f))
+				return 0;
+		TAILQ_FOREACH(sr, &p->sq, entries)
+			if (!save_number(s, SNAP_SEARCH, sr))
+				return 0;
+		TAILQ_FOREACH(a, &p->aq, entries)
+			if (!save_number(s, SNAP_ALIAS, a))
+				return 0;
+		TAILQ_FOREACH(u, &p->uq, entries)
+			if (!save_number(s, SNAP_UPDATE, u))
+				return 0;
+		TAILQ_FOREACH(u, &p->dq, entries)
+			if (!save_number(s, SNAP_UPDATE, u))
+				return 0;
+		TAILQ_FOREACH(rm, &p->rq, entries)
+			if (!save_number(s, SNAP_ROLEMAP, rm))
+				return 0;
+	}
+	return 1;
+}
+
+static void
+save_uint(struct save *s, uint64_t v)
+{
+	unsigned char	 buf[10];
+	size_t		 sz = 0;
+
+	do {
+		buf[sz] = v & 0x7f;
+		if ((v >>= 7) > 0)
+			buf[sz] |= 0x80;
+		sz++;
+	} while (v > 0);
+
+	if (fwrite(buf, 1, sz, s->f) != sz)
+		s->rc = 0;
+}
+
+static void
+save_int(struct save *s, int64_t v)
+{
+
+	save_uint(s, ((uint64_t)v << 1) ^ (v < 0 ? UINT64_MAX : 0));
+}
+
+static void
+save_real(struct save *s, double v)
+{
+	uint64_t	 bits;
+
+	assert(sizeof(double) == sizeof(uint64_t));
+	memcpy(&bits, &v, sizeof(uint64_t));
+	save_uint(s, bits);
+}
+
+static void
+save_str(struct save *s, const char *v)
+{
+	size_t	 sz;
+
+	if (v == NULL) {
+		save_uint(s, 0);
+		return;
+	}
+	sz = strlen(v);
+	save_uint(s, (uint64_t)sz + 1);
+	if (fwrite(v, 1, sz, s->f) != sz)
+		s->rc = 0;
+}
+
+/*
+ * Write the number (plus one) of a referenced object or zero if NULL.
+ */
+static void
+save_ref(struct save *s, const void *obj)
+{
+	size_t	 i;
+
+	if (obj == NULL) {
+		save_uint(s, 0);
+		return;
+	}
+	assert(s->idxmax > 0);
+	i = snap_hash(obj) & (s->idxmax - 1);
+	while (s->idx[i].obj != obj) {
+		assert(s->idx[i].obj != NULL);
+		i = (i + 1) & (s->idxmax - 1);
+	}
+	save_uint(s, (uint64_t)s->idx[i].idx + 1);
+}
+
+static void
+save_pos(struct save *s, const struct pos *pos)
+{
+	size_t	 i;
+
+	for (i = 0; i < s->cfg->fnamesz; i++)
+		if (pos->fname == s->cfg->fnames[i])
+			break;
+	save_uint(s, i < s->cfg->fnamesz ? i + 1 : 0);
+	save_uint(s, pos->line);
+	save_uint(s, pos->column);
+}
+
+static void
+save_labels(struct save *s, const struct labelq *q)
+{
+	const struct label	*l;
+	size_t			 sz = 0;
+
+	TAILQ_FOREACH(l, q, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(l, q, entries) {
+		save_str(s, l->label);
+		save_uint(s, l->lang);
+		save_pos(s, &l->pos);
+	}
+}
+
+static void
+save_chain(struct save *s, struct field *const *chain, size_t sz)
+{
+	size_t	 i;
+
+	save_uint(s, sz);
+	for (i = 0; i < sz; i++)
+		save_ref(s, chain[i]);
+}
+
+static void
+save_field(struct save *s, const struct field *f)
+{
+	const struct fvalid	*fv;
+	size_t			 sz = 0;
+
+	save_str(s, f->name);
+	save_str(s, f->doc);
+	save_pos(s, &f->pos);
+	save_uint(s, f->type);
+	save_uint(s, f->actdel);
+	save_uint(s, f->actup);
+	save_uint(s, f->flags);
+	save_ref(s, f->enm);
+	save_ref(s, f->bitf);
+	save_ref(s, f->rolemap);
+
+	save_uint(s, f->ref != NULL);
+	if (f->ref != NULL) {
+		save_ref(s, f->ref->target);
+		save_ref(s, f->ref->source);
+		save_ref(s, f->ref->parent);
+	}
+
+	switch (f->type) {
+	case FTYPE_REAL:
+		save_real(s, f->def.decimal);
+		break;
+	case FTYPE_TEXT:
+	case FTYPE_EMAIL:
+		save_str(s, f->def.string);
+		break;
+	case FTYPE_ENUM:
+		save_ref(s, f->def.eitem);
+		break;
+	default:
+		save_int(s, f->def.integer);
+		break;
+	}
+
+	TAILQ_FOREACH(fv, &f->fvq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(fv, &f->fvq, entries) {
+		save_uint(s, fv->type);
+		switch (f->type) {
+		case FTYPE_REAL:
+			save_real(s, fv->d.value.decimal);
+			break;
+		case FTYPE_BLOB:
+		case FTYPE_EMAIL:
+		case FTYPE_TEXT:
+		case FTYPE_PASSWORD:
+			save_uint(s, fv->d.value.len);
+			break;
+		default:
+			save_int(s, fv->d.value.integer);
+			break;
+		}
+	}
+}
+
+static void
+save_search(struct save *s, const struct search *sr)
+{
+	const struct sent	*sent;
+	const struct ord	*ord;
+	const struct proj	*proj;
+	size_t			 sz;
+
+	save_str(s, sr->name);
+	save_str(s, sr->doc);
+	save_pos(s, &sr->pos);
+	save_uint(s, sr->type);
+	save_int(s, sr->limit);
+	save_int(s, sr->offset);
+	save_uint(s, sr->flags);
+	save_ref(s, sr->rolemap);
+
+	sz = 0;
+	TAILQ_FOREACH(sent, &sr->sntq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(sent, &sr->sntq, entries) {
+		save_chain(s, sent->chain, sent->chainsz);
+		save_pos(s, &sent->pos);
+		save_ref(s, sent->field);
+		save_uint(s, sent->op);
+		save_str(s, sent->name);
+		save_str(s, sent->fname);
+		save_str(s, sent->uname);
+		save_ref(s, sent->alias);
+	}
+
+	sz = 0;
+	TAILQ_FOREACH(ord, &sr->ordq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(ord, &sr->ordq, entries) {
+		save_chain(s, ord->chain, ord->chainsz);
+		save_pos(s, &ord->pos);
+		save_ref(s, ord->field);
+		save_uint(s, ord->op);
+		save_str(s, ord->name);
+		save_str(s, ord->fname);
+		save_ref(s, ord->alias);
+	}
+
+	sz = 0;
+	TAILQ_FOREACH(proj, &sr->projq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(proj, &sr->projq, entries) {
+		save_pos(s, &proj->pos);
+		save_ref(s, proj->field);
+		save_str(s, proj->fname);
+	}
+
+	save_uint(s, sr->aggr != NULL);
+	if (sr->aggr != NULL) {
+		save_chain(s, sr->aggr->chain, sr->aggr->chainsz);
+		save_pos(s, &sr->aggr->pos);
+		save_ref(s, sr->aggr->field);
+		save_uint(s, sr->aggr->op);
+		save_str(s, sr->aggr->name);
+		save_str(s, sr->aggr->fname);
+		save_ref(s, sr->aggr->alias);
+	}
+
+	save_uint(s, sr->group != NULL);
+	if (sr->group != NULL) {
+		save_chain(s, sr->group->chain, sr->group->chainsz);
+		save_pos(s, &sr->group->pos);
+		save_ref(s, sr->group->field);
+		save_str(s, sr->group->name);
+		save_str(s, sr->group->fname);
+		save_ref(s, sr->group->alias);
+	}
+
+	save_uint(s, sr->dst != NULL);
+	if (sr->dst != NULL) {
+		save_chain(s, sr->dst->chain, sr->dst->chainsz);
+		save_pos(s, &sr->dst->pos);
+		save_ref(s, sr->dst->strct);
+		save_str(s, sr->dst->fname);
+	}
+}
+
+static void
+save_urefq(struct save *s, const struct urefq *q)
+{
+	const struct uref	*ur;
+	size_t			 sz = 0;
+
+	TAILQ_FOREACH(ur, q, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(ur, q, entries) {
+		save_pos(s, &ur->pos);
+		save_ref(s, ur->field);
+		save_uint(s, ur->op);
+		save_uint(s, ur->mod);
+	}
+}
+
+static void
+save_updateq(struct save *s, const struct updateq *q)
+{
+	const struct update	*u;
+	size_t			 sz = 0;
+
+	TAILQ_FOREACH(u, q, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(u, q, entries) {
+		save_str(s, u->name);
+		save_str(s, u->doc);
+		save_pos(s, &u->pos);
+		save_uint(s, u->type);
+		save_uint(s, u->flags);
+		save_ref(s, u->rolemap);
+		save_urefq(s, &u->mrq);
+		save_urefq(s, &u->crq);
+	}
+}
+
+static void
+save_unique(struct save *s, const struct unique *n)
+{
+	const struct nref	*nr;
+	size_t			 sz = 0;
+
+	save_pos(s, &n->pos);
+	TAILQ_FOREACH(nr, &n->nq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(nr, &n->nq, entries) {
+		save_pos(s, &nr->pos);
+		save_ref(s, nr->field);
+	}
+}
+
+static void
+save_irefq(struct save *s, const struct irefq *q)
+{
+	const struct iref	*ir;
+	size_t			 sz = 0;
+
+	TAILQ_FOREACH(ir, q, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(ir, q, entries) {
+		save_pos(s, &ir->pos);
+		save_ref(s, ir->field);
+		save_uint(s, ir->op);
+	}
+}
+
+static void
+save_rolemap(struct save *s, const struct rolemap *rm)
+{
+	const struct rref	*rr;
+	size_t			 sz = 0;
+
+	save_uint(s, rm->type);
+	switch (rm->type) {
+	case ROLEMAP_NOEXPORT:
+		save_ref(s, rm->f);
+		break;
+	case ROLEMAP_DELETE:
+	case ROLEMAP_UPDATE:
+		save_ref(s, rm->u);
+		break;
+	case ROLEMAP_ALL:
+	case ROLEMAP_INSERT:
+	case ROLEMAP_UPSERT:
+		break;
+	default:
+		save_ref(s, rm->s);
+		break;
+	}
+
+	TAILQ_FOREACH(rr, &rm->rq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(rr, &rm->rq, entries) {
+		save_pos(s, &rr->pos);
+		save_ref(s, rr->role);
+	}
+}
+
+static void
+save_strct(struct save *s, const struct strct *p)
+{
+	const struct field	*f;
+	const struct search	*sr;
+	const struct alias	*a;
+	const struct unique	*n;
+	const struct index	*ix;
+	const struct rolemap	*rm;
+	size_t			 sz;
+
+	save_str(s, p->name);
+	save_str(s, p->doc);
+	save_pos(s, &p->pos);
+	save_uint(s, p->height);
+	save_uint(s, p->colour);
+	save_uint(s, p->flags);
+
+	sz = 0;
+	TAILQ_FOREACH(f, &p->fq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(f, &p->fq, entries)
+		save_field(s, f);
+
+	sz = 0;
+	TAILQ_FOREACH(sr, &p->sq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(sr, &p->sq, entries)
+		save_search(s, sr);
+
+	sz = 0;
+	TAILQ_FOREACH(a, &p->aq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(a, &p->aq, entries) {
+		save_str(s, a->name);
+		save_str(s, a->alias);
+	}
+
+	save_updateq(s, &p->uq);
+	save_updateq(s, &p->dq);
+
+	sz = 0;
+	TAILQ_FOREACH(n, &p->nq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(n, &p->nq, entries)
+		save_unique(s, n);
+
+	sz = 0;
+	TAILQ_FOREACH(ix, &p->iq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(ix, &p->iq, entries) {
+		save_pos(s, &ix->pos);
+		save_irefq(s, &ix->nq);
+		save_irefq(s, &ix->wq);
+	}
+
+	sz = 0;
+	TAILQ_FOREACH(rm, &p->rq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(rm, &p->rq, entries)
+		save_rolemap(s, rm);
+
+	save_uint(s, p->ins != NULL);
+	if (p->ins != NULL) {
+		save_pos(s, &p->ins->pos);
+		save_ref(s, p->ins->rolemap);
+		save_uint(s, p->ins->flags);
+	}
+
+	save_uint(s, p->ups != NULL);
+	if (p->ups != NULL) {
+		save_pos(s, &p->ups->pos);
+		save_ref(s, p->ups->rolemap);
+		save_unique(s, p->ups->target);
+	}
+
+	save_ref(s, p->rowid);
+	save_ref(s, p->arolemap);
+}
+
+static void
+save_config(struct save *s)
+{
+	const struct config	*cfg = s->cfg;
+	const struct enm	*e;
+	const struct eitem	*ei;
+	const struct bitf	*b;
+	const struct bitidx	*bi;
+	const struct role	*r;
+	const struct strct	*p;
+	size_t			 i, sz;
+
+	if (fwrite(SNAP_MAGIC, 1, SNAP_MAGICSZ, s->f) != SNAP_MAGICSZ)
+		s->rc = 0;
+	save_uint(s, SNAP_REVISION);
+	save_uint(s, ORT_VSTAMP);
+
+	for (i = 0; i < SNAP__MAX; i++)
+		save_uint(s, s->count[i]);
+
+	save_uint(s, cfg->flags);
+	save_uint(s, cfg->langsz);
+	for (i = 0; i < cfg->langsz; i++)
+		save_str(s, cfg->langs[i]);
+	save_uint(s, cfg->fnamesz);
+	for (i = 0; i < cfg->fnamesz; i++)
+		save_str(s, cfg->fnames[i]);
+
+	sz = 0;
+	TAILQ_FOREACH(e, &cfg->eq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(e, &cfg->eq, entries) {
+		save_str(s, e->name);
+		save_str(s, e->doc);
+		save_pos(s, &e->pos);
+		save_labels(s, &e->labels_null);
+		sz = 0;
+		TAILQ_FOREACH(ei, &e->eq, entries)
+			sz++;
+		save_uint(s, sz);
+		TAILQ_FOREACH(ei, &e->eq, entries) {
+			save_str(s, ei->name);
+			save_str(s, ei->doc);
+			save_pos(s, &ei->pos);
+			save_int(s, ei->value);
+			save_uint(s, ei->flags);
+			save_labels(s, &ei->labels);
+		}
+	}
+
+	sz = 0;
+	TAILQ_FOREACH(b, &cfg->bq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(b, &cfg->bq, entries) {
+		save_str(s, b->name);
+		save_str(s, b->doc);
+		save_pos(s, &b->pos);
+		save_labels(s, &b->labels_unset);
+		save_labels(s, &b->labels_null);
+		sz = 0;
+		TAILQ_FOREACH(bi, &b->bq, entries)
+			sz++;
+		save_uint(s, sz);
+		TAILQ_FOREACH(bi, &b->bq, entries) {
+			save_str(s, bi->name);
+			save_str(s, bi->doc);
+			save_pos(s, &bi->pos);
+			save_int(s, bi->value);
+			save_labels(s, &bi->labels);
+		}
+	}
+
+	sz = 0;
+	TAILQ_FOREACH(r, &cfg->arq, allentries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(r, &cfg->arq, allentries) {
+		save_str(s, r->name);
+		save_str(s, r->doc);
+		save_pos(s, &r->pos);
+		save_ref(s, r->parent);
+	}
+
+	sz = 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		sz++;
+	save_uint(s, sz);
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		save_strct(s, p);
+}
+
+/*
+ * Write a snapshot of the linked configuration "cfg" to "f".
+ * The snapshot may be read back by ort_config_load() (or any of the
+ * parse functions) in lieu of parsing and linking the configuration.
+ * Returns zero on failure (allocation or writing), non-zero on success.
+ */
+int
+ort_config_save(FILE *f, const struct config *cfg)
+{
+	struct save	 s;
+
+	memset(&s, 0, sizeof(struct save));
+	s.f = f;
+	s.cfg = cfg;
+	s.rc = 1;
+
+	if (!save_numbers(&s)) {
+		free(s.idx);
+		return 0;
+	}
+	save_config(&s);
+	free(s.idx);
+	return s.rc;
+}
+
+static uint64_t
+load_uint(struct load *l)
+{
+	uint64_t	 v = 0;
+	unsigned int	 shift = 0;
+	unsigned char	 c;
+
+	do {
+		if (l->bad || l->er || l->pos == l->sz || shift > 63) {
+			l->bad = 1;
+			return 0;
+		}
+		c = l->buf[l->pos++];
+		v |= (uint64_t)(c & 0x7f) << shift;
+		shift += 7;
+	} while (c & 0x80);
+
+	return v;
+}
+
+static int64_t
+load_int(struct load *l)
+{
+	uint64_t	 v;
+
+	v = load_uint(l);
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static double
+load_real(struct load *l)
+{
+	uint64_t	 bits;
+	double		 v;
+
+	bits = load_uint(l);
+	memcpy(&v, &bits, sizeof(double));
+	return v;
+}
+
+/*
+ * Read a size that's bounded by "max", exclusive.
+ */
+static size_t
+load_size(struct load *l, uint64_t max)
+{
+	uint64_t	 v;
+
+	if ((v = load_uint(l)) >= max) {
+		l->bad = 1;
+		return 0;
+	}
+	return (size_t)v;
+}
+
+/*
+ * Read flags, which may only be those in "mask".
+ */
+static unsigned int
+load_flags(struct load *l, unsigned int mask)
+{
+	uint64_t	 v;
+
+	if ((v = load_uint(l)) & ~(uint64_t)mask) {
+		l->bad = 1;
+		return 0;
+	}
+	return (unsigned int)v;
+}
+
+/*
+ * Read the number of entries in a queue.
+ * Each entry takes at least one byte, so this is bounded by what's
+ * left of the snapshot.
+ */
+static size_t
+load_count(struct load *l)
+{
+
+	return load_size(l, (uint64_t)(l->sz - l->pos) + 1);
+}
+
+/*
+ * Read a NUL-terminated copy of a possibly-NULL string.
+ * The caller must check for failure.
+ */
+static char *
+load_str(struct load *l)
+{
+	size_t	 sz;
+	char	*v;
+
+	if ((sz = load_size(l, (uint64_t)(l->sz - l->pos) + 2)) == 0)
+		return NULL;
+	if ((v = malloc(sz)) == NULL) {
+		l->er = errno;
+		return NULL;
+	}
+	memcpy(v, &l->buf[l->pos], sz - 1);
+	v[sz - 1] = '\0';
+	l->pos += sz - 1;
+	return v;
+}
+
+static void
+load_pos(struct load *l, struct pos *pos)
+{
+	size_t	 i;
+
+	i = load_size(l, (uint64_t)l->fsz + 1);
+	pos->fname = i == 0 ? NULL : l->cfg->fnames[l->fbase + i - 1];
+	pos->line = load_size(l, SIZE_MAX);
+	pos->column = load_size(l, SIZE_MAX);
+}
+
+/*
+ * Look up a referenced object, which need not have been read yet.
+ * The caller must check for failure.
+ */
+static void *
+load_ref(struct load *l, enum snapt type)
+{
+	size_t	 i;
+
+	i = load_size(l, (uint64_t)l->count[type] + 1);
+	return i == 0 ? NULL : l->objs[type][i - 1];
+}
+
+/*
+ * Like load_ref(), but the reference may not be NULL.
+ */
+static void *
+load_ref_nonnull(struct load *l, enum snapt type)
+{
+	void	*p;
+
+	if ((p = load_ref(l, type)) == NULL)
+		l->bad = 1;
+	return p;
+}
+
+/*
+ * Take the next pre-allocated object of the given type, which is read
+ * in place.
+ * Returns NULL if there are none left.
+ */
+static void *
+load_next(struct load *l, enum snapt type)
+{
+
+	if (l->next[type] == l->count[type]) {
+		l->bad = 1;
+		return NULL;
+	}
+	return l->objs[type][l->next[type]++];
+}
+
+/*
+ * Allocate an object owned by its parent.
+ * Returns NULL on failure.
+ */
+static void *
+load_alloc(struct load *l, size_t sz)
+{
+	void	*p;
+
+	if ((p = calloc(1, sz)) == NULL)
+		l->er = errno;
+	return p;
+}
+
+#define	LOAD_OK(_l)	(!(_l)->bad && !(_l)->er)
+
+static int
+load_labels(struct load *l, struct labelq *q)
+{
+	struct label	*lab;
+	size_t		 i, sz;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((lab = load_alloc(l, sizeof(struct label))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(q, lab, entries);
+		lab->label = load_str(l);
+		lab->lang = load_size(l, l->cfg->langsz);
+		load_pos(l, &lab->pos);
+	}
+	return LOAD_OK(l);
+}
+
+static struct field **
+load_chain(struct load *l, size_t *chainsz)
+{
+	struct field	**chain;
+	size_t		  i;
+
+	if ((*chainsz = load_count(l)) == 0 || !LOAD_OK(l))
+		return NULL;
+	chain = calloc(*chainsz, sizeof(struct field *));
+	if (chain == NULL) {
+		l->er = errno;
+		*chainsz = 0;
+		return NULL;
+	}
+	for (i = 0; i < *chainsz; i++)
+		chain[i] = load_ref_nonnull(l, SNAP_FIELD);
+	return chain;
+}
+
+static int
+load_field(struct load *l, struct strct *p)
+{
+	struct field	*f;
+	struct fvalid	*fv;
+	size_t		 i, sz;
+
+	if ((f = load_next(l, SNAP_FIELD)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&p->fq, f, entries);
+	TAILQ_INIT(&f->fvq);
+	f->parent = p;
+
+	f->name = load_str(l);
+	f->doc = load_str(l);
+	load_pos(l, &f->pos);
+	f->type = load_size(l, FTYPE__MAX);
+	f->actdel = load_size(l, UPACT__MAX);
+	f->actup = load_size(l, UPACT__MAX);
+	f->flags = load_flags(l, FIELD_ROWID | FIELD_UNIQUE |
+	    FIELD_NULL | FIELD_NOEXPORT | FIELD_HASDEF | FIELD_LAZY);
+	f->enm = load_ref(l, SNAP_ENM);
+	f->bitf = load_ref(l, SNAP_BITF);
+	f->rolemap = load_ref(l, SNAP_ROLEMAP);
+
+	if (load_size(l, 2)) {
+		if ((f->ref = load_alloc(l, sizeof(struct ref))) == NULL)
+			return 0;
+		f->ref->target = load_ref_nonnull(l, SNAP_FIELD);
+		f->ref->source = load_ref_nonnull(l, SNAP_FIELD);
+		f->ref->parent = load_ref_nonnull(l, SNAP_FIELD);
+	}
+
+	switch (f->type) {
+	case FTYPE_REAL:
+		f->def.decimal = load_real(l);
+		break;
+	case FTYPE_TEXT:
+	case FTYPE_EMAIL:
+		f->def.string = load_str(l);
+		break;
+	case FTYPE_ENUM:
+		f->def.eitem = load_ref(l, SNAP_EITEM);
+		break;
+	default:
+		f->def.integer = load_int(l);
+		break;
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((fv = load_alloc(l, sizeof(struct fvalid))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&f->fvq, fv, entries);
+		fv->type = load_size(l, VALIDATE__MAX);
+		switch (f->type) {
+		case FTYPE_REAL:
+			fv->d.value.decimal = load_real(l);
+			break;
+		case FTYPE_BLOB:
+		case FTYPE_EMAIL:
+		case FTYPE_TEXT:
+		case FTYPE_PASSWORD:
+			fv->d.value.len = load_size(l, SIZE_MAX);
+			break;
+		default:
+			fv->d.value.integer = load_int(l);
+			break;
+		}
+	}
+
+	return LOAD_OK(l);
+}
+
+static int
+load_search(struct load *l, struct strct *p)
+{
+	struct search	*sr;
+	struct sent	*sent;
+	struct ord	*ord;
+	struct proj	*proj;
+	size_t		 i, sz;
+
+	if ((sr = load_next(l, SNAP_SEARCH)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&p->sq, sr, entries);
+	TAILQ_INIT(&sr->sntq);
+	TAILQ_INIT(&sr->ordq);
+	TAILQ_INIT(&sr->projq);
+	sr->parent = p;
+
+	sr->name = load_str(l);
+	sr->doc = load_str(l);
+	load_pos(l, &sr->pos);
+	sr->type = load_size(l, STYPE__MAX);
+	sr->limit = load_int(l);
+	sr->offset = load_int(l);
+	sr->flags = load_flags(l, SEARCH_IS_UNIQUE | SEARCH_HAS_MANY |
+	    SEARCH_HAS_UNTIL);
+	sr->rolemap = load_ref(l, SNAP_ROLEMAP);
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((sent = load_alloc(l, sizeof(struct sent))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&sr->sntq, sent, entries);
+		sent->parent = sr;
+		sent->chain = load_chain(l, &sent->chainsz);
+		load_pos(l, &sent->pos);
+		sent->field = load_ref_nonnull(l, SNAP_FIELD);
+		sent->op = load_size(l, OPTYPE__MAX);
+		sent->name = load_str(l);
+		sent->fname = load_str(l);
+		sent->uname = load_str(l);
+		sent->alias = load_ref(l, SNAP_ALIAS);
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((ord = load_alloc(l, sizeof(struct ord))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&sr->ordq, ord, entries);
+		ord->parent = sr;
+		ord->chain = load_chain(l, &ord->chainsz);
+		load_pos(l, &ord->pos);
+		ord->field = load_ref_nonnull(l, SNAP_FIELD);
+		ord->op = load_size(l, ORDTYPE_DESC + 1);
+		ord->name = load_str(l);
+		ord->fname = load_str(l);
+		ord->alias = load_ref(l, SNAP_ALIAS);
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((proj = load_alloc(l, sizeof(struct proj))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&sr->projq, proj, entries);
+		proj->parent = sr;
+		load_pos(l, &proj->pos);
+		proj->field = load_ref_nonnull(l, SNAP_FIELD);
+		proj->fname = load_str(l);
+	}
+
+	if (load_size(l, 2) && LOAD_OK(l)) {
+		sr->aggr = load_alloc(l, sizeof(struct aggr));
+		if (sr->aggr == NULL)
+			return 0;
+		sr->aggr->parent = sr;
+		sr->aggr->chain = load_chain(l, &sr->aggr->chainsz);
+		load_pos(l, &sr->aggr->pos);
+		sr->aggr->field = load_ref_nonnull(l, SNAP_FIELD);
+		sr->aggr->op = load_size(l, AGGR_MINROW + 1);
+		sr->aggr->name = load_str(l);
+		sr->aggr->fname = load_str(l);
+		sr->aggr->alias = load_ref(l, SNAP_ALIAS);
+	}
+
+	if (load_size(l, 2) && LOAD_OK(l)) {
+		sr->group = load_alloc(l, sizeof(struct group));
+		if (sr->group == NULL)
+			return 0;
+		sr->group->parent = sr;
+		sr->group->chain = load_chain(l, &sr->group->chainsz);
+		load_pos(l, &sr->group->pos);
+		sr->group->field = load_ref_nonnull(l, SNAP_FIELD);
+		sr->group->name = load_str(l);
+		sr->group->fname = load_str(l);
+		sr->group->alias = load_ref(l, SNAP_ALIAS);
+	}
+
+	if (load_size(l, 2) && LOAD_OK(l)) {
+		sr->dst = load_alloc(l, sizeof(struct dstnct));
+		if (sr->dst == NULL)
+			return 0;
+		sr->dst->parent = sr;
+		sr->dst->chain = load_chain(l, &sr->dst->chainsz);
+		load_pos(l, &sr->dst->pos);
+		sr->dst->strct = load_ref_nonnull(l, SNAP_STRCT);
+		sr->dst->fname = load_str(l);
+	}
+
+	return LOAD_OK(l);
+}
+
+static int
+load_urefq(struct load *l, struct update *u, struct urefq *q)
+{
+	struct uref	*ur;
+	size_t		 i, sz;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((ur = load_alloc(l, sizeof(struct uref))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(q, ur, entries);
+		ur->parent = u;
+		load_pos(l, &ur->pos);
+		ur->field = load_ref_nonnull(l, SNAP_FIELD);
+		ur->op = load_size(l, OPTYPE__MAX);
+		ur->mod = load_size(l, MODTYPE__MAX);
+	}
+	return LOAD_OK(l);
+}
+
+static int
+load_updateq(struct load *l, struct strct *p, struct updateq *q)
+{
+	struct update	*u;
+	size_t		 i, sz;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((u = load_next(l, SNAP_UPDATE)) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(q, u, entries);
+		TAILQ_INIT(&u->mrq);
+		TAILQ_INIT(&u->crq);
+		u->parent = p;
+		u->name = load_str(l);
+		u->doc = load_str(l);
+		load_pos(l, &u->pos);
+		u->type = load_size(l, UP__MAX);
+		u->flags = load_flags(l, UPDATE_ALL | UPDATE_RETURNING);
+		u->rolemap = load_ref(l, SNAP_ROLEMAP);
+		if (!load_urefq(l, u, &u->mrq) ||
+		    !load_urefq(l, u, &u->crq))
+			return 0;
+	}
+	return LOAD_OK(l);
+}
+
+/*
+ * Read the unique constraint "n", which has already been allocated
+ * and put in its queue, if any.
+ */
+static int
+load_unique(struct load *l, struct strct *p, struct unique *n)
+{
+	struct nref	*nr;
+	size_t		 i, sz;
+
+	TAILQ_INIT(&n->nq);
+	n->parent = p;
+	load_pos(l, &n->pos);
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((nr = load_alloc(l, sizeof(struct nref))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&n->nq, nr, entries);
+		nr->parent = n;
+		load_pos(l, &nr->pos);
+		nr->field = load_ref_nonnull(l, SNAP_FIELD);
+	}
+	return LOAD_OK(l);
+}
+
+static int
+load_irefq(struct load *l, struct index *ix, struct irefq *q)
+{
+	struct iref	*ir;
+	size_t		 i, sz;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((ir = load_alloc(l, sizeof(struct iref))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(q, ir, entries);
+		ir->parent = ix;
+		load_pos(l, &ir->pos);
+		ir->field = load_ref_nonnull(l, SNAP_FIELD);
+		ir->op = load_size(l, OPTYPE__MAX);
+	}
+	return LOAD_OK(l);
+}
+
+static int
+load_rolemap(struct load *l, struct strct *p)
+{
+	struct rolemap	*rm;
+	struct rref	*rr;
+	size_t		 i, sz;
+
+	if ((rm = load_next(l, SNAP_ROLEMAP)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&p->rq, rm, entries);
+	TAILQ_INIT(&rm->rq);
+	rm->parent = p;
+
+	rm->type = load_size(l, ROLEMAP__MAX);
+	switch (rm->type) {
+	case ROLEMAP_NOEXPORT:
+		rm->f = load_ref(l, SNAP_FIELD);
+		break;
+	case ROLEMAP_DELETE:
+	case ROLEMAP_UPDATE:
+		rm->u = load_ref(l, SNAP_UPDATE);
+		break;
+	case ROLEMAP_ALL:
+	case ROLEMAP_INSERT:
+	case ROLEMAP_UPSERT:
+		break;
+	default:
+		rm->s = load_ref(l, SNAP_SEARCH);
+		break;
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((rr = load_alloc(l, sizeof(struct rref))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&rm->rq, rr, entries);
+		rr->parent = rm;
+		load_pos(l, &rr->pos);
+		rr->role = load_ref_nonnull(l, SNAP_ROLE);
+	}
+	return LOAD_OK(l);
+}
+
+static int
+load_strct(struct load *l)
+{
+	struct strct	*p;
+	struct alias	*a;
+	struct unique	*n;
+	struct index	*ix;
+	size_t		 i, sz;
+
+	if ((p = load_next(l, SNAP_STRCT)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&l->cfg->sq, p, entries);
+	TAILQ_INIT(&p->fq);
+	TAILQ_INIT(&p->sq);
+	TAILQ_INIT(&p->aq);
+	TAILQ_INIT(&p->uq);
+	TAILQ_INIT(&p->dq);
+	TAILQ_INIT(&p->nq);
+	TAILQ_INIT(&p->iq);
+	TAILQ_INIT(&p->rq);
+	p->cfg = l->cfg;
+
+	p->name = load_str(l);
+	p->doc = load_str(l);
+	load_pos(l, &p->pos);
+	p->height = load_size(l, SIZE_MAX);
+	p->colour = load_size(l, SIZE_MAX);
+	p->flags = load_flags(l, STRCT_HAS_QUEUE |
+	    STRCT_HAS_ITERATOR | STRCT_HAS_BLOB | STRCT_HAS_PROJ |
+	    STRCT_HAS_NULLREFS | STRCT_HAS_UNTIL);
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_field(l, p))
+			return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_search(l, p))
+			return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((a = load_next(l, SNAP_ALIAS)) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&p->aq, a, entries);
+		a->name = load_str(l);
+		a->alias = load_str(l);
+	}
+
+	if (!load_updateq(l, p, &p->uq) ||
+	    !load_updateq(l, p, &p->dq))
+		return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((n = load_alloc(l, sizeof(struct unique))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&p->nq, n, entries);
+		if (!load_unique(l, p, n))
+			return 0;
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((ix = load_alloc(l, sizeof(struct index))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&p->iq, ix, entries);
+		TAILQ_INIT(&ix->nq);
+		TAILQ_INIT(&ix->wq);
+		ix->parent = p;
+		load_pos(l, &ix->pos);
+		if (!load_irefq(l, ix, &ix->nq) ||
+		    !load_irefq(l, ix, &ix->wq))
+			return 0;
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_rolemap(l, p))
+			return 0;
+
+	if (load_size(l, 2) && LOAD_OK(l)) {
+		if ((p->ins = load_alloc(l, sizeof(struct insert))) == NULL)
+			return 0;
+		p->ins->parent = p;
+		load_pos(l, &p->ins->pos);
+		p->ins->rolemap = load_ref(l, SNAP_ROLEMAP);
+		p->ins->flags = load_flags(l, INSERT_RETURNING);
+	}
+
+	if (load_size(l, 2) && LOAD_OK(l)) {
+		if ((p->ups = load_alloc(l, sizeof(struct upsert))) == NULL)
+			return 0;
+		p->ups->parent = p;
+		load_pos(l, &p->ups->pos);
+		p->ups->rolemap = load_ref(l, SNAP_ROLEMAP);
+		p->ups->target = load_alloc(l, sizeof(struct unique));
+		if (p->ups->target == NULL ||
+		    !load_unique(l, p, p->ups->target))
+			return 0;
+	}
+
+	p->rowid = load_ref(l, SNAP_FIELD);
+	p->arolemap = load_ref(l, SNAP_ROLEMAP);
+	return LOAD_OK(l);
+}
+
+static int
+load_enm(struct load *l)
+{
+	struct enm	*e;
+	struct eitem	*ei;
+	size_t		 i, sz;
+
+	if ((e = load_next(l, SNAP_ENM)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&l->cfg->eq, e, entries);
+	TAILQ_INIT(&e->labels_null);
+	TAILQ_INIT(&e->eq);
+
+	e->name = load_str(l);
+	e->doc = load_str(l);
+	load_pos(l, &e->pos);
+	if (!load_labels(l, &e->labels_null))
+		return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((ei = load_next(l, SNAP_EITEM)) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&e->eq, ei, entries);
+		TAILQ_INIT(&ei->labels);
+		ei->parent = e;
+		ei->name = load_str(l);
+		ei->doc = load_str(l);
+		load_pos(l, &ei->pos);
+		ei->value = load_int(l);
+		ei->flags = load_flags(l, EITEM_AUTO);
+		if (!load_labels(l, &ei->labels))
+			return 0;
+	}
+	return LOAD_OK(l);
+}
+
+static int
+load_bitf(struct load *l)
+{
+	struct bitf	*b;
+	struct bitidx	*bi;
+	size_t		 i, sz;
+
+	if ((b = load_next(l, SNAP_BITF)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&l->cfg->bq, b, entries);
+	TAILQ_INIT(&b->labels_unset);
+	TAILQ_INIT(&b->labels_null);
+	TAILQ_INIT(&b->bq);
+
+	b->name = load_str(l);
+	b->doc = load_str(l);
+	load_pos(l, &b->pos);
+	if (!load_labels(l, &b->labels_unset) ||
+	    !load_labels(l, &b->labels_null))
+		return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++) {
+		if ((bi = load_alloc(l, sizeof(struct bitidx))) == NULL)
+			return 0;
+		TAILQ_INSERT_TAIL(&b->bq, bi, entries);
+		TAILQ_INIT(&bi->labels);
+		bi->parent = b;
+		bi->name = load_str(l);
+		bi->doc = load_str(l);
+		load_pos(l, &bi->pos);
+		bi->value = load_int(l);
+		if (!load_labels(l, &bi->labels))
+			return 0;
+	}
+	return LOAD_OK(l);
+}
+
+static int
+load_role(struct load *l)
+{
+	struct role	*r;
+	size_t		 i;
+
+	if ((r = load_next(l, SNAP_ROLE)) == NULL)
+		return 0;
+	TAILQ_INSERT_TAIL(&l->cfg->arq, r, allentries);
+	TAILQ_INIT(&r->subrq);
+
+	r->name = load_str(l);
+	r->doc = load_str(l);
+	load_pos(l, &r->pos);
+
+	/*
+	 * Roles are written in order of creation, which is also the
+	 * order of each parent's children, so parents are always read
+	 * before their children.
+	 */
+
+	i = load_size(l, l->next[SNAP_ROLE]);
+	if (!LOAD_OK(l))
+		return 0;
+	if (i > 0) {
+		r->parent = l->objs[SNAP_ROLE][i - 1];
+		TAILQ_INSERT_TAIL(&r->parent->subrq, r, entries);
+	} else
+		TAILQ_INSERT_TAIL(&l->cfg->rq, r, entries);
+	return 1;
+}
+
+/*
+ * Read the configuration proper into the empty "l->cfg", after the
+ * header and object counts, pre-allocating every referenced object.
+ * Returns zero on failure, non-zero on success.
+ */
+static int
+load_config(struct load *l)
+{
+	struct config	*cfg = l->cfg;
+	void		*pp;
+	char		*cp;
+	size_t		 i, j, sz;
+
+	for (i = 0; i < SNAP__MAX; i++) {
+		l->count[i] = load_count(l);
+		if (!LOAD_OK(l))
+			return 0;
+		if (l->count[i] == 0)
+			continue;
+		l->objs[i] = calloc(l->count[i], sizeof(void *));
+		if (l->objs[i] == NULL) {
+			l->er = errno;
+			return 0;
+		}
+		for (j = 0; j < l->count[i]; j++)
+			if ((l->objs[i][j] =
+			    load_alloc(l, snapsz[i])) == NULL)
+				return 0;
+	}
+
+	cfg->flags = load_flags(l, CONFIG_HAS_PASS);
+
+	/* Replace the default language. */
+
+	if ((sz = load_count(l)) == 0 || !LOAD_OK(l)) {
+		l->bad = 1;
+		return 0;
+	}
+	for (i = 0; i < cfg->langsz; i++)
+		free(cfg->langs[i]);
+	free(cfg->langs);
+	cfg->langsz = 0;
+	if ((cfg->langs = calloc(sz, sizeof(char *))) == NULL) {
+		l->er = errno;
+		return 0;
+	}
+	for (i = 0; i < sz; i++, cfg->langsz++)
+		if ((cfg->langs[i] = load_str(l)) == NULL) {
+			l->bad = 1;
+			return 0;
+		}
+
+	/* Positions use the original file names. */
+
+	l->fsz = load_count(l);
+	if (!LOAD_OK(l))
+		return 0;
+	l->fbase = cfg->fnamesz;
+	if (l->fsz > 0) {
+		pp = reallocarray(cfg->fnames,
+			cfg->fnamesz + l->fsz, sizeof(char *));
+		if (pp == NULL) {
+			l->er = errno;
+			return 0;
+		}
+		cfg->fnames = pp;
+	}
+	for (i = 0; i < l->fsz; i++, cfg->fnamesz++) {
+		if ((cp = load_str(l)) == NULL) {
+			l->bad = 1;
+			return 0;
+		}
+		cfg->fnames[cfg->fnamesz] = cp;
+	}
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_enm(l))
+			return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_bitf(l))
+			return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_role(l))
+			return 0;
+
+	sz = load_count(l);
+	for (i = 0; i < sz && LOAD_OK(l); i++)
+		if (!load_strct(l))
+			return 0;
+
+	if (!LOAD_OK(l))
+		return 0;
+
+	/* Every object must have been read and nothing else. */
+
+	for (i = 0; i < SNAP__MAX; i++)
+		if (l->next[i] != l->count[i])
+			l->bad = 1;
+	if (l->pos != l->sz)
+		l->bad = 1;
+	return LOAD_OK(l);
+}
+
+/*
+ * The loader only guarantees that every object was read once, into
+ * the queue of its parent, and that references are to objects of the
+ * right type.
+ * The following check that references also link up the way the linker
+ * would have left them, as the generators rely on this without further
+ * checks.
+ * Each returns zero if the graph is inconsistent, non-zero if not.
+ */
+
+/*
+ * A reference chain from "p" must step through non-terminal structure
+ * fields to its terminal "field".
+ */
+static int
+check_chain(const struct strct *p, struct field *const *chain,
+	size_t chainsz, const struct field *field)
+{
+	size_t	 i;
+
+	if (chainsz == 0 || chain[chainsz - 1] != field)
+		return 0;
+	for (i = 0; i < chainsz; i++) {
+		if (chain[i]->parent != p)
+			return 0;
+		if (i == chainsz - 1)
+			break;
+		if (chain[i]->type != FTYPE_STRUCT)
+			return 0;
+		p = chain[i]->ref->target->parent;
+	}
+	return 1;
+}
+
+static int
+check_rolemap(const struct strct *p, const struct rolemap *rm)
+{
+
+	return rm == NULL || rm->parent == p;
+}
+
+static int
+check_field(const struct field *f)
+{
+	const struct ref	*r = f->ref;
+
+	if (((f->flags & FIELD_LAZY) && (f->parent->rowid == NULL ||
+	     (f->type != FTYPE_BLOB && f->type != FTYPE_TEXT))) ||
+	    (f->type == FTYPE_ENUM) != (f->enm != NULL) ||
+	    (f->type == FTYPE_BITFIELD) != (f->bitf != NULL) ||
+	    (f->type == FTYPE_STRUCT && r == NULL) ||
+	    !check_rolemap(f->parent, f->rolemap))
+		return 0;
+
+	/* 
+	 * A foreign key is its own source; a structure's source is a
+	 * foreign key of the same structure, whose target it shares.
+	 */
+
+	if (r != NULL) {
+		if (r->parent != f || r->source->parent != f->parent)
+			return 0;
+		if (f->type == FTYPE_STRUCT) {
+			if (r->source->type == FTYPE_STRUCT ||
+			    r->source->ref == NULL ||
+			    r->source->ref->target != r->target)
+				return 0;
+		} else if (r->source != f)
+			return 0;
+	}
+
+	if (f->flags & FIELD_HASDEF) {
+		if (f->type == FTYPE_ENUM && (f->def.eitem == NULL ||
+		    f->def.eitem->parent != f->enm))
+			return 0;
+		if ((f->type == FTYPE_TEXT || f->type == FTYPE_EMAIL) &&
+		    f->def.string == NULL)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * An alias, if given, must be one of the aliases of "p".
+ */
+static int
+check_alias(const struct strct *p, const struct alias *a)
+{
+
+	return a == NULL || ort_alias_find(p, a->name) == a;
+}
+
+/*
+ * The aliases of a structure are created in order by following each
+ * chain of non-null references from it, as in linker_aliases_create(),
+ * so step through them in "a" while doing the same from "p".
+ * The name of each is that of the prior one in the chain, "prior",
+ * and the field's.
+ */
+static int
+check_aliases(const struct strct *p, const struct alias **a,
+	const struct alias *prior)
+{
+	const struct field	*f;
+	const struct alias	*cur;
+	size_t			 sz;
+
+	TAILQ_FOREACH(f, &p->fq, entries) {
+		if (f->type != FTYPE_STRUCT ||
+		    (f->ref->source->flags & FIELD_NULL))
+			continue;
+		if ((cur = *a) == NULL)
+			return 0;
+		if (prior == NULL) {
+			if (strcasecmp(cur->name, f->name))
+				return 0;
+		} else {
+			sz = strlen(prior->name);
+			if (strncasecmp(cur->name, prior->name, sz) ||
+			    cur->name[sz] != '.' ||
+			    strcasecmp(&cur->name[sz + 1], f->name))
+				return 0;
+		}
+		*a = TAILQ_NEXT(cur, entries);
+		if (!check_aliases(f->ref->target->parent, a, cur))
+			return 0;
+	}
+	return 1;
+}
+
+static int
+check_search(const struct strct *p, const struct search *s)
+{
+	const struct sent	*sent;
+	const struct ord	*ord;
+	const struct proj	*proj;
+	const struct dstnct	*d = s->dst;
+
+	if (!check_rolemap(p, s->rolemap))
+		return 0;
+	if ((s->flags & SEARCH_HAS_UNTIL) && s->type != STYPE_ITERATE)
+		return 0;
+
+	/* See check_search_many() in the linker. */
+
+	if (s->flags & SEARCH_HAS_MANY) {
+		sent = TAILQ_FIRST(&s->sntq);
+		if (s->type != STYPE_SEARCH || sent == NULL ||
+		    TAILQ_NEXT(sent, entries) != NULL ||
+		    sent->op != OPTYPE_EQUAL ||
+		    !(sent->field->flags & (FIELD_ROWID|FIELD_UNIQUE)) ||
+		    (sent->field->flags & FIELD_NULL) ||
+		    sent->field->parent != p ||
+		    sent->field->type == FTYPE_BLOB ||
+		    sent->field->type == FTYPE_PASSWORD ||
+		    sent->field->type == FTYPE_REAL ||
+		    sent->field->type == FTYPE_STRUCT ||
+		    d != NULL || !TAILQ_EMPTY(&s->projq))
+			return 0;
+	}
+
+	TAILQ_FOREACH(sent, &s->sntq, entries)
+		if (sent->fname == NULL || sent->uname == NULL ||
+		    !check_alias(p, sent->alias) ||
+		    !check_chain(p, sent->chain, 
+		     sent->chainsz, sent->field))
+			return 0;
+	TAILQ_FOREACH(ord, &s->ordq, entries)
+		if (ord->fname == NULL || !check_alias(p, ord->alias) ||
+		    !check_chain(p, ord->chain, 
+		     ord->chainsz, ord->field))
+			return 0;
+	TAILQ_FOREACH(proj, &s->projq, entries)
+		if (proj->fname == NULL || proj->field->parent != p)
+			return 0;
+	if (s->aggr != NULL && (s->aggr->fname == NULL ||
+	    !check_alias(p, s->aggr->alias) ||
+	    !check_chain(p, s->aggr->chain, 
+	     s->aggr->chainsz, s->aggr->field)))
+		return 0;
+	if (s->group != NULL && (s->group->fname == NULL ||
+	    !check_alias(p, s->group->alias) ||
+	    !check_chain(p, s->group->chain, 
+	     s->group->chainsz, s->group->field)))
+		return 0;
+
+	/* A distinct chain ends at a structure, or is for all of "p". */
+
+	if (d != NULL) {
+		if (d->fname == NULL)
+			return 0;
+		if (d->chainsz == 0)
+			return d->strct == p;
+		if (!check_chain(p, d->chain, 
+		    d->chainsz, d->chain[d->chainsz - 1]) ||
+		    d->chain[d->chainsz - 1]->type != FTYPE_STRUCT ||
+		    d->chain[d->chainsz - 1]->ref->target->parent != 
+		    d->strct)
+			return 0;
+	}
+
+	return 1;
+}
+
+static int
+check_updateq(const struct strct *p, const struct updateq *q)
+{
+	const struct update	*u;
+	const struct uref	*ur;
+
+	TAILQ_FOREACH(u, q, entries) {
+		if (!check_rolemap(p, u->rolemap))
+			return 0;
+		TAILQ_FOREACH(ur, &u->mrq, entries)
+			if (ur->field->parent != p)
+				return 0;
+		TAILQ_FOREACH(ur, &u->crq, entries)
+			if (ur->field->parent != p)
+				return 0;
+	}
+	return 1;
+}
+
+static int
+check_unique(const struct strct *p, const struct unique *n)
+{
+	const struct nref	*nr;
+
+	TAILQ_FOREACH(nr, &n->nq, entries)
+		if (nr->field->parent != p)
+			return 0;
+	return 1;
+}
+
+static int
+check_strct(const struct strct *p)
+{
+	const struct search	*s;
+	const struct alias	*a;
+	const struct unique	*n;
+	const struct index	*ix;
+	const struct iref	*ir;
+	const struct rolemap	*rm;
+
+	if ((p->rowid != NULL && p->rowid->parent != p) ||
+	    !check_rolemap(p, p->arolemap))
+		return 0;
+
+	TAILQ_FOREACH(s, &p->sq, entries)
+		if (!check_search(p, s))
+			return 0;
+	a = TAILQ_FIRST(&p->aq);
+	if (!check_aliases(p, &a, NULL) || a != NULL)
+		return 0;
+	if (!check_updateq(p, &p->uq) || !check_updateq(p, &p->dq))
+		return 0;
+	TAILQ_FOREACH(n, &p->nq, entries)
+		if (!check_unique(p, n))
+			return 0;
+	TAILQ_FOREACH(ix, &p->iq, entries) {
+		TAILQ_FOREACH(ir, &ix->nq, entries)
+			if (ir->field->parent != p)
+				return 0;
+		TAILQ_FOREACH(ir, &ix->wq, entries)
+			if (ir->field->parent != p)
+				return 0;
+	}
+
+	TAILQ_FOREACH(rm, &p->rq, entries)
+		switch (rm->type) {
+		case ROLEMAP_NOEXPORT:
+			if (rm->f != NULL && rm->f->parent != p)
+				return 0;
+			break;
+		case ROLEMAP_DELETE:
+		case ROLEMAP_UPDATE:
+			if (rm->u != NULL && rm->u->parent != p)
+				return 0;
+			break;
+		case ROLEMAP_ALL:
+		case ROLEMAP_INSERT:
+		case ROLEMAP_UPSERT:
+			break;
+		default:
+			if (rm->s != NULL && rm->s->parent != p)
+				return 0;
+			break;
+		}
+
+	if (p->ins != NULL && !check_rolemap(p, p->ins->rolemap))
+		return 0;
+	if (p->ups != NULL && (!check_rolemap(p, p->ups->rolemap) ||
+	    !check_unique(p, p->ups->target)))
+		return 0;
+	return 1;
+}
+
+/*
+ * Structures may not reach themselves through structure fields, as
+ * generators follow these recursively.
+ * Like linker_aliases_cycle(), this colours structures grey while being
+ * descended and black when done, so the caller must save and restore
+ * the loaded colours.
+ */
+static int
+check_acyclic(struct strct *p)
+{
+	const struct field	*f;
+	struct strct		*t;
+
+	p->colour = 1;
+	TAILQ_FOREACH(f, &p->fq, entries) {
+		if (f->type != FTYPE_STRUCT)
+			continue;
+		t = f->ref->target->parent;
+		if (t->colour == 1)
+			return 0;
+		if (t->colour == 0 && !check_acyclic(t))
+			return 0;
+	}
+	p->colour = 2;
+	return 1;
+}
+
+/*
+ * Objects looked up by name must have one.
+ * This must be checked before the symbol table is built.
+ */
+static int
+check_names(const struct config *cfg)
+{
+	const struct enm	*e;
+	const struct eitem	*ei;
+	const struct bitf	*b;
+	const struct bitidx	*bi;
+	const struct role	*r;
+	const struct strct	*p;
+	const struct field	*f;
+	const struct alias	*a;
+
+	TAILQ_FOREACH(e, &cfg->eq, entries) {
+		if (e->name == NULL)
+			return 0;
+		TAILQ_FOREACH(ei, &e->eq, entries)
+			if (ei->name == NULL)
+				return 0;
+	}
+	TAILQ_FOREACH(b, &cfg->bq, entries) {
+		if (b->name == NULL)
+			return 0;
+		TAILQ_FOREACH(bi, &b->bq, entries)
+			if (bi->name == NULL)
+				return 0;
+	}
+	TAILQ_FOREACH(r, &cfg->arq, allentries)
+		if (r->name == NULL)
+			return 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries) {
+		if (p->name == NULL)
+			return 0;
+		TAILQ_FOREACH(f, &p->fq, entries)
+			if (f->name == NULL)
+				return 0;
+		TAILQ_FOREACH(a, &p->aq, entries)
+			if (a->name == NULL || a->alias == NULL)
+				return 0;
+	}
+	return 1;
+}
+
+static int
+check_config(struct load *l)
+{
+	const struct config	*cfg = l->cfg;
+	const struct role	*r;
+	const struct field	*f;
+	struct strct		*p;
+	size_t			*colour, i;
+	int			 rc = 1;
+
+	/* Generators expect the virtual roles if there are any. */
+
+	if (!TAILQ_EMPTY(&cfg->arq)) {
+		TAILQ_FOREACH(r, &cfg->rq, entries)
+			if (strcmp(r->name, "all") == 0)
+				break;
+		if (r == NULL)
+			return 0;
+	}
+
+	/* 
+	 * Fields first, as everything else follows their references,
+	 * then make sure that doing so terminates.
+	 */
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		TAILQ_FOREACH(f, &p->fq, entries)
+			if (!check_field(f))
+				return 0;
+
+	if (l->count[SNAP_STRCT] == 0)
+		return 1;
+	colour = calloc(l->count[SNAP_STRCT], sizeof(size_t));
+	if (colour == NULL) {
+		l->er = errno;
+		return 0;
+	}
+	i = 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries) {
+		colour[i++] = p->colour;
+		p->colour = 0;
+	}
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (p->colour == 0 && !check_acyclic(p)) {
+			rc = 0;
+			break;
+		}
+	i = 0;
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		p->colour = colour[i++];
+	free(colour);
+	if (!rc)
+		return 0;
+
+	TAILQ_FOREACH(p, &cfg->sq, entries)
+		if (!check_strct(p))
+			return 0;
+	return 1;
+}
+
+/*
+ * Load the snapshot written by ort_config_save() in the "sz" bytes of
+ * "buf", named "fname", into "cfg", which must not contain anything
+ * else.
+ * The configuration is already linked, so ort_parse_close() does
+ * nothing further, and no more may be parsed into it.
+ * On failure, "cfg" should be freed.
+ * Returns zero on failure, non-zero on success.
+ */
+int
+ort_config_load(struct config *cfg, const char *buf, size_t sz,
+	const char *fname)
+{
+	struct load	 l;
+	struct pos	 pos;
+	size_t		 i, j;
+	int		 rc = 0;
+
+	memset(&pos, 0, sizeof(struct pos));
+	pos.fname = fname;
+
+	if (cfg->priv->loaded || !TAILQ_EMPTY(&cfg->sq) ||
+	    !TAILQ_EMPTY(&cfg->eq) || !TAILQ_EMPTY(&cfg->bq) ||
+	    !TAILQ_EMPTY(&cfg->arq)) {
+		ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos, "snapshot "
+			"may not be combined with other configurations");
+		return 0;
+	}
+
+	memset(&l, 0, sizeof(struct load));
+	l.cfg = cfg;
+	l.buf = (const unsigned char *)buf;
+	l.sz = sz;
+
+	if (sz < SNAP_MAGICSZ ||
+	    memcmp(buf, SNAP_MAGIC, SNAP_MAGICSZ) != 0) {
+		ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos,
+			"not a configuration snapshot");
+		return 0;
+	}
+	l.pos = SNAP_MAGICSZ;
+	if (load_uint(&l) != SNAP_REVISION ||
+	    load_uint(&l) != ORT_VSTAMP || !LOAD_OK(&l)) {
+		ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos, "snapshot "
+			"from a different version of openradtool");
+		return 0;
+	}
+
+	if (!load_config(&l)) {
+		if (l.er)
+			ort_msg(&cfg->mq, MSGTYPE_FATAL, l.er, &pos, NULL);
+		else
+			ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos,
+				"truncated or corrupt snapshot");
+	} else if (!check_names(cfg))
+		ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos,
+			"inconsistent snapshot");
+	else if (!symtab_build(&cfg->priv->st, cfg))
+		ort_msg(&cfg->mq, MSGTYPE_FATAL, errno, &pos, NULL);
+	else if (!(rc = check_config(&l))) {
+		if (l.er)
+			ort_msg(&cfg->mq, MSGTYPE_FATAL, l.er, &pos, NULL);
+		else
+			ort_msg(&cfg->mq, MSGTYPE_ERROR, 0, &pos,
+				"inconsistent snapshot");
+	}
+
+	/* Objects not yet read aren't in the configuration. */
+
+	for (i = 0; i < SNAP__MAX; i++) {
+		for (j = l.next[i]; j < l.count[i]; j++)
+			if (l.objs[i] != NULL)
+				free(l.objs[i][j]);
+		free(l.objs[i]);
+	}
+
+	cfg->priv->loaded = 1;
+	return rc;
+}
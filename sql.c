@@ -39,7 +39,7 @@ main(int argc, char *argv[])
 {
 	FILE		**confs = NULL;
 	struct config	 *cfg = NULL;
-	int		  rc = 0;
+	int		  rc = 0, c, advise = 0;
 	size_t		  i;
 
 #if HAVE_PLEDGE
@@ -47,8 +47,14 @@ main(int argc, char *argv[])
 		err(1, "pledge");
 #endif
 
-	if (getopt(argc, argv, "") != -1)
-		goto usage;
+	while ((c = getopt(argc, argv, "I")) != -1)
+		switch (c) {
+		case 'I':
+			advise = 1;
+			break;
+		default:
+			goto usage;
+		}
 
 	argc -= optind;
 	argv += optind;
@@ -76,7 +82,9 @@ main(int argc, char *argv[])
 		goto out;
 
 	if ((rc = ort_parse_close(cfg)))
-		if (!(rc = ort_lang_sql(NULL, cfg, stdout)))
+		if (!(rc = advise ?
+		    ort_lang_sql_advise(NULL, cfg, stdout) :
+		    ort_lang_sql(NULL, cfg, stdout)))
 			warn(NULL);
 out:
 	ort_write_msg_file(stderr, &cfg->mq);
@@ -88,6 +96,6 @@ out:
 	free(confs);
 	return rc ? 0 : 1;
 usage:
-	fprintf(stderr, "usage: %s [config...]\n", getprogname());
+	fprintf(stderr, "usage: %s [-I] [config...]\n", getprogname());
 	return 1;
 }
@@ -0,0 +1,218 @@
+/*	$Id$ */
+/*
+ * Copyright (c) 2021 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "config.h"
+
+#if HAVE_SYS_QUEUE
+# include <sys/queue.h>
+#endif
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ort.h"
+#include "extern.h"
+
+/*
+ * FNV-1a hash of a symbol's type, scope, and lower-cased name.
+ */
+static size_t
+sym_hash(unsigned int type, const void *scope, const char *name)
+{
+	size_t			 h = 2166136261u;
+	const unsigned char	*cp;
+
+	h = (h ^ type) * 16777619u;
+	h = (h ^ (size_t)(uintptr_t)scope) * 16777619u;
+	for (cp = (const unsigned char *)name; *cp != '\0'; cp++)
+		h = (h ^ (size_t)tolower(*cp)) * 16777619u;
+	return h;
+}
+
+/*
+ * Look up the object of the given type named "name" within "scope".
+ * Returns the object or NULL if not found.
+ */
+void *
+symtab_find(const struct symtab *st, unsigned int type,
+	const void *scope, const char *name)
+{
+	const struct sym	*sym;
+	size_t			 h, i;
+
+	if (st->symmax == 0)
+		return NULL;
+
+	h = sym_hash(type, scope, name);
+	for (i = h & (st->symmax - 1); ; i = (i + 1) & (st->symmax - 1)) {
+		sym = &st->syms[i];
+		if (sym->name == NULL)
+			return NULL;
+		if (sym->hash == h && sym->type == type &&
+		    sym->scope == scope && 
+		    strcasecmp(sym->name, name) == 0)
+			return sym->obj;
+	}
+}
+
+/*
+ * Put "sym" into the first free slot of its chain unless an equal
+ * symbol is already there: like a scan of the queues, the first
+ * declared object of a name wins.
+ * There must be a free slot.
+ */
+static void
+sym_insert(struct symtab *st, const struct sym *sym)
+{
+	struct sym	*dst;
+	size_t		 i;
+
+	for (i = sym->hash & (st->symmax - 1); ; 
+	     i = (i + 1) & (st->symmax - 1)) {
+		dst = &st->syms[i];
+		if (dst->name == NULL)
+			break;
+		if (dst->hash == sym->hash && dst->type == sym->type &&
+		    dst->scope == sym->scope &&
+		    strcasecmp(dst->name, sym->name) == 0)
+			return;
+	}
+
+	*dst = *sym;
+	st->symsz++;
+}
+
+/*
+ * Add an object to the symbol table, growing it to keep it at most half
+ * full.
+ * Returns zero on allocation failure, non-zero on success.
+ */
+int
+symtab_add(struct symtab *st, unsigned int type,
+	const void *scope, const char *name, void *obj)
+{
+	struct sym	*old, sym;
+	size_t		 i, oldmax;
+
+	if ((st->symsz + 1) * 2 > st->symmax) {
+		old = st->syms;
+		oldmax = st->symmax;
+		st->symmax = oldmax == 0 ? 256 : oldmax * 2;
+		st->syms = calloc(st->symmax, sizeof(struct sym));
+		if (st->syms == NULL) {
+			st->syms = old;
+			st->symmax = oldmax;
+			return 0;
+		}
+		st->symsz = 0;
+		for (i = 0; i < oldmax; i++)
+			if (old[i].name != NULL)
+				sym_insert(st, &old[i]);
+		free(old);
+	}
+
+	sym.type = type;
+	sym.scope = scope;
+	sym.name = name;
+	sym.hash = sym_hash(type, scope, name);
+	sym.obj = obj;
+	sym_insert(st, &sym);
+	return 1;
+}
+
+/*
+ * Index every named object of "cfg" that's resolved by name: structures
+ * and their fields, named queries, updates, deletes, and aliases (which
+ * only exist in a linked configuration); enumerations and their items;
+ * bitfields and their items; and roles.
+ * This replaces any prior index.
+ * Returns zero on allocation failure, non-zero on success.
+ */
+int
+symtab_build(struct symtab *st, const struct config *cfg)
+{
+	struct strct	*p;
+	struct alias	*a;
+	struct field	*f;
+	struct search	*s;
+	struct update	*u;
+	struct enm	*e;
+	struct eitem	*ei;
+	struct bitf	*b;
+	struct bitidx	*bi;
+	struct role	*r;
+
+	symtab_free(st);
+
+	TAILQ_FOREACH(p, &cfg->sq, entries) {
+		if (!symtab_add(st, SYM_STRCT, NULL, p->name, p))
+			return 0;
+		TAILQ_FOREACH(f, &p->fq, entries)
+			if (!symtab_add(st, SYM_FIELD, p, f->name, f))
+				return 0;
+		TAILQ_FOREACH(s, &p->sq, entries)
+			if (s->name != NULL && !symtab_add(st,
+			    SYM_SEARCH + s->type, p, s->name, s))
+				return 0;
+		TAILQ_FOREACH(u, &p->uq, entries)
+			if (u->name != NULL && 
+			    !symtab_add(st, SYM_UPDATE, p, u->name, u))
+				return 0;
+		TAILQ_FOREACH(u, &p->dq, entries)
+			if (u->name != NULL && 
+			    !symtab_add(st, SYM_DELETE, p, u->name, u))
+				return 0;
+		TAILQ_FOREACH(a, &p->aq, entries)
+			if (!symtab_add(st, SYM_ALIAS, p, a->name, a))
+				return 0;
+	}
+
+	TAILQ_FOREACH(e, &cfg->eq, entries) {
+		if (!symtab_add(st, SYM_ENM, NULL, e->name, e))
+			return 0;
+		TAILQ_FOREACH(ei, &e->eq, entries)
+			if (!symtab_add(st, SYM_EITEM, e, ei->name, ei))
+				return 0;
+	}
+
+	TAILQ_FOREACH(b, &cfg->bq, entries) {
+		if (!symtab_add(st, SYM_BITF, NULL, b->name, b))
+			return 0;
+		TAILQ_FOREACH(bi, &b->bq, entries)
+			if (!symtab_add(st, SYM_BITIDX, b, bi->name, bi))
+				return 0;
+	}
+
+	TAILQ_FOREACH(r, &cfg->arq, allentries)
+		if (!symtab_add(st, SYM_ROLE, NULL, r->name, r))
+			return 0;
+
+	return 1;
+}
+
+/*
+ * Free the slots of "st", leaving it empty (and reusable).
+ */
+void
+symtab_free(struct symtab *st)
+{
+
+	free(st->syms);
+	memset(st, 0, sizeof(struct symtab));
+}
@@ -36,6 +36,7 @@ static	const char *difftypes[DIFF__MAX] = {
 	NULL, /* DIFF_ADD_EITEM */
 	NULL, /* DIFF_ADD_ENM */
 	NULL, /* DIFF_ADD_FIELD */
+	NULL, /* DIFF_ADD_INDEX */
 	NULL, /* DIFF_ADD_INSERT */
 	NULL, /* DIFF_ADD_ROLE */
 	NULL, /* DIFF_ADD_ROLES */
@@ -43,11 +44,13 @@ static	const char *difftypes[DIFF__MAX] = {
 	NULL, /* DIFF_ADD_STRCT */
 	NULL, /* DIFF_ADD_UNIQUE */
 	NULL, /* DIFF_ADD_UPDATE */
+	NULL, /* DIFF_ADD_UPSERT */
 	NULL, /* DIFF_DEL_BITF */
 	NULL, /* DIFF_DEL_BITIDX */
 	NULL, /* DIFF_DEL_EITEM */
 	NULL, /* DIFF_DEL_ENM */
 	NULL, /* DIFF_DEL_FIELD */
+	NULL, /* DIFF_DEL_INDEX */
 	NULL, /* DIFF_DEL_INSERT */
 	NULL, /* DIFF_DEL_ROLE */
 	NULL, /* DIFF_DEL_ROLES */
@@ -55,6 +58,7 @@ static	const char *difftypes[DIFF__MAX] = {
 	NULL, /* DIFF_DEL_STRCT */
 	NULL, /* DIFF_DEL_UNIQUE */
 	NULL, /* DIFF_DEL_UPDATE */
+	NULL, /* DIFF_DEL_UPSERT */
 	NULL, /* DIFF_MOD_BITF */
 	NULL, /* DIFF_MOD_BITF_COMMENT */
 	NULL, /* DIFF_MOD_BITF_LABELS */
@@ -81,6 +85,7 @@ static	const char *difftypes[DIFF__MAX] = {
 	"type", /* DIFF_MOD_FIELD_TYPE */
 	"valids", /* DIFF_MOD_FIELD_VALIDS */
 	NULL, /* DIFF_MOD_INSERT */
+	"flags", /* DIFF_MOD_INSERT_FLAGS */
 	"params", /* DIFF_MOD_INSERT_PARAMS */
 	"rolemap", /* DIFF_MOD_INSERT_ROLEMAP */
 	NULL, /* DIFF_MOD_ROLE */
@@ -98,6 +103,7 @@ static	const char *difftypes[DIFF__MAX] = {
 	"order", /* DIFF_MOD_SEARCH_ORDER */
 	"params", /* DIFF_MOD_SEARCH_PARAMS */
 	"rolemap", /* DIFF_MOD_SEARCH_ROLEMAP */
+	"select", /* DIFF_MOD_SEARCH_SELECT */
 	NULL, /* DIFF_MOD_STRCT */
 	NULL, /* DIFF_MOD_STRCT_COMMENT */
 	NULL, /* DIFF_MOD_UPDATE */
@@ -105,6 +111,9 @@ static	const char *difftypes[DIFF__MAX] = {
 	"flags", /* DIFF_MOD_UPDATE_FLAGS */
 	"params", /* DIFF_MOD_UPDATE_PARAMS */
 	"rolemap", /* DIFF_MOD_UPDATE_ROLEMAP */
+	NULL, /* DIFF_MOD_UPSERT */
+	"rolemap", /* DIFF_MOD_UPSERT_ROLEMAP */
+	"target", /* DIFF_MOD_UPSERT_TARGET */
 	NULL, /* DIFF_SAME_BITF */
 	NULL, /* DIFF_SAME_BITIDX */
 	NULL, /* DIFF_SAME_EITEM */
@@ -116,6 +125,7 @@ static	const char *difftypes[DIFF__MAX] = {
 	NULL, /* DIFF_SAME_SEARCH */
 	NULL, /* DIFF_SAME_STRCT */
 	NULL, /* DIFF_SAME_UPDATE */
+	NULL, /* DIFF_SAME_UPSERT */
 };
 
 static int
@@ -156,6 +166,13 @@ ort_write_unique(FILE *f, int add, const struct diff *d)
 	return ort_write_one(f, add, "unique", &d->unique->pos);
 }
 
+static int
+ort_write_index(FILE *f, int add, const struct diff *d)
+{
+
+	return ort_write_one(f, add, "index", &d->index->pos);
+}
+
 static int
 ort_write_search(FILE *f, int add, const struct diff *d)
 {
@@ -227,6 +244,31 @@ ort_write_insert_pair(FILE *f, int chnge, const struct diff *d)
 		&d->strct_pair.into->ins->pos);
 }
 
+static int
+ort_write_upsert(FILE *f, int add, const struct diff *d)
+{
+
+	return ort_write_one(f, add, "upsert", &d->strct->ups->pos);
+}
+
+static int
+ort_write_upsert_mod(FILE *f, const struct diff *d)
+{
+
+	return ort_write_mod(f, difftypes[d->type], "upsert",
+		&d->strct_pair.from->ups->pos, 
+		&d->strct_pair.into->ups->pos);
+}
+
+static int
+ort_write_upsert_pair(FILE *f, int chnge, const struct diff *d)
+{
+
+	return ort_write_pair(f, chnge, "upsert",
+		&d->strct_pair.from->ups->pos, 
+		&d->strct_pair.into->ups->pos);
+}
+
 static int
 ort_write_strct(FILE *f, int add, const struct diff *d)
 {
@@ -487,6 +529,7 @@ ort_write_diff_insert(FILE *f, const struct diffq *q, const struct diff *d)
 	TAILQ_FOREACH(dd, q, entries) {
 		rc = 1;
 		switch (dd->type) {
+		case DIFF_MOD_INSERT_FLAGS:
 		case DIFF_MOD_INSERT_PARAMS:
 		case DIFF_MOD_INSERT_ROLEMAP:
 			if (dd->strct_pair.into != 
@@ -511,6 +554,44 @@ ort_write_diff_insert(FILE *f, const struct diffq *q, const struct diff *d)
 	return 1;
 }
 
+/*
+ * Return zero on failure, non-zero on success.
+ */
+static int
+ort_write_diff_upsert(FILE *f, const struct diffq *q, const struct diff *d)
+{
+	const struct diff	*dd;
+	int			 rc;
+
+	assert(d->type == DIFF_MOD_UPSERT);
+
+	TAILQ_FOREACH(dd, q, entries) {
+		rc = 1;
+		switch (dd->type) {
+		case DIFF_MOD_UPSERT_ROLEMAP:
+		case DIFF_MOD_UPSERT_TARGET:
+			if (dd->strct_pair.into != 
+			     d->strct_pair.into &&
+			    dd->strct_pair.from != 
+			     d->strct_pair.from)
+				break;
+			assert(dd->strct_pair.into ==
+				d->strct_pair.into);
+			assert(dd->strct_pair.from ==
+				d->strct_pair.from);
+			assert(difftypes[dd->type] != NULL);
+			rc = ort_write_upsert_mod(f, dd);
+			break;
+		default:
+			break;
+		}
+		if (rc < 0)
+			return 0;
+	}
+
+	return 1;
+}
+
 /*
  * Return zero on failure, non-zero on success.
  */
@@ -532,6 +613,7 @@ ort_write_diff_search(FILE *f,
 		case DIFF_MOD_SEARCH_ORDER:
 		case DIFF_MOD_SEARCH_PARAMS:
 		case DIFF_MOD_SEARCH_ROLEMAP:
+		case DIFF_MOD_SEARCH_SELECT:
 			if (dd->search_pair.into != 
 			     d->search_pair.into &&
 			    dd->search_pair.from != 
@@ -658,10 +740,18 @@ ort_write_diff_strct(FILE *f, const struct diffq *q, const struct diff *d)
 			if (dd->unique->parent == d->strct_pair.into)
 				rc = ort_write_unique(f, 1, dd);
 			break;
+		case DIFF_ADD_INDEX:
+			if (dd->index->parent == d->strct_pair.into)
+				rc = ort_write_index(f, 1, dd);
+			break;
 		case DIFF_ADD_UPDATE:
 			if (dd->update->parent == d->strct_pair.into)
 				rc = ort_write_update(f, 1, dd);
 			break;
+		case DIFF_ADD_UPSERT:
+			if (dd->strct == d->strct_pair.into)
+				rc = ort_write_upsert(f, 1, dd);
+			break;
 		case DIFF_DEL_FIELD:
 			if (dd->field->parent == d->strct_pair.from)
 				rc = ort_write_field(f, 0, dd);
@@ -678,10 +768,18 @@ ort_write_diff_strct(FILE *f, const struct diffq *q, const struct diff *d)
 			if (dd->unique->parent == d->strct_pair.from)
 				rc = ort_write_unique(f, 0, dd);
 			break;
+		case DIFF_DEL_INDEX:
+			if (dd->index->parent == d->strct_pair.from)
+				rc = ort_write_index(f, 0, dd);
+			break;
 		case DIFF_DEL_UPDATE:
 			if (dd->update->parent == d->strct_pair.from)
 				rc = ort_write_update(f, 0, dd);
 			break;
+		case DIFF_DEL_UPSERT:
+			if (dd->strct == d->strct_pair.from)
+				rc = ort_write_upsert(f, 0, dd);
+			break;
 		case DIFF_MOD_FIELD:
 			if (dd->field_pair.into->parent != 
 			    d->strct_pair.into)
@@ -717,6 +815,13 @@ ort_write_diff_strct(FILE *f, const struct diffq *q, const struct diff *d)
 			if (!ort_write_diff_update(f, q, dd))
 				return 0;
 			break;
+		case DIFF_MOD_UPSERT:
+			if (dd->strct_pair.into != d->strct_pair.into)
+				break;
+			rc = ort_write_upsert_pair(f, 1, dd);
+			if (!ort_write_diff_upsert(f, q, dd))
+				return 0;
+			break;
 		case DIFF_SAME_FIELD:
 			if (dd->field_pair.into->parent != 
 			    d->strct_pair.into)
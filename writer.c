@@ -35,6 +35,11 @@ static	const char *const stypes[STYPE__MAX] = {
 	"search", /* STYPE_SEARCH */
 	"list", /* STYPE_LIST */
 	"iterate", /* STYPE_ITERATE */
+	"exists", /* STYPE_EXISTS */
+	"sum", /* STYPE_SUM */
+	"avg", /* STYPE_AVG */
+	"min", /* STYPE_MIN */
+	"max", /* STYPE_MAX */
 };
 
 static	const char *const upts[UP__MAX] = {
@@ -100,13 +105,19 @@ static	const char *const optypes[OPTYPE__MAX] = {
 
 static	const char *const rolemapts[ROLEMAP__MAX] = {
 	"all", /* ROLEMAP_ALL */
+	"avg", /* ROLEMAP_AVG */
 	"count", /* ROLEMAP_COUNT */
 	"delete", /* ROLEMAP_DELETE */
+	"exists", /* ROLEMAP_EXISTS */
 	"insert", /* ROLEMAP_INSERT */
 	"iterate", /* ROLEMAP_ITERATE */
 	"list", /* ROLEMAP_LIST */
+	"max", /* ROLEMAP_MAX */
+	"min", /* ROLEMAP_MIN */
 	"search", /* ROLEMAP_SEARCH */
+	"sum", /* ROLEMAP_SUM */
 	"update", /* ROLEMAP_UPDATE */
+	"upsert", /* ROLEMAP_UPSERT */
 	"noexport", /* ROLEMAP_NOEXPORT */
 };
 
@@ -242,6 +253,11 @@ parse_write_field(struct writer *w, const struct field *p)
 			return 0;
 		fl &= ~FIELD_NOEXPORT;
 	}
+	if (fl & FIELD_LAZY) {
+		if (!wputs(w, " lazy"))
+			return 0;
+		fl &= ~FIELD_LAZY;
+	}
 	if (fl & FIELD_HASDEF) {
 		switch (p->type) {
 		case FTYPE_BIT:
@@ -354,8 +370,8 @@ parse_write_modify(struct writer *w, const struct update *p)
 		}
 	}
 
-	if (TAILQ_EMPTY(&p->crq) &&
-	    p->name == NULL && p->doc == NULL)
+	if (TAILQ_EMPTY(&p->crq) && p->name == NULL &&
+	    p->doc == NULL && !(p->flags & UPDATE_RETURNING))
 		return wputs(w, ";\n");
 
 	if (p->type == UP_MODIFY && !wputc(w, ':'))
@@ -375,12 +391,16 @@ parse_write_modify(struct writer *w, const struct update *p)
 
 	/* Trailing data (optional). */
 
-	if (p->name != NULL || p->doc != NULL) {
+	if (p->name != NULL || p->doc != NULL ||
+	    (p->flags & UPDATE_RETURNING)) {
 		if (!wputc(w, ':'))
 			return 0;
 		if (p->name != NULL && 
 		    !wprint(w, " name %s", p->name))
 			return 0;
+		if ((p->flags & UPDATE_RETURNING) &&
+		    !wputs(w, " returning"))
+			return 0;
 		if (!parse_write_comment(w, p->doc, 2))
 			return 0;
 	}
@@ -389,16 +409,18 @@ parse_write_modify(struct writer *w, const struct update *p)
 }
 
 /*
- * Write a structure unique constraint.
+ * Write a structure unique constraint or the conflict target of an
+ * upsert, being "type".
  * Returns zero on failure (memory), non-zero otherwise.
  */
 static int
-parse_write_unique(struct writer *w, const struct unique *p)
+parse_write_unique(struct writer *w,
+	const char *type, const struct unique *p)
 {
 	const struct nref	*n;
 	size_t			 nf = 0;
 
-	if (!wputs(w, "\tunique"))
+	if (!wprint(w, "\t%s", type))
 		return 0;
 
 	TAILQ_FOREACH(n, &p->nq, entries)
@@ -409,6 +431,33 @@ parse_write_unique(struct writer *w, const struct unique *p)
 	return wputs(w, ";\n");
 }
 
+/*
+ * Write a structure index with its optional "where" constraints.
+ * Returns zero on failure (memory), non-zero otherwise.
+ */
+static int
+parse_write_index(struct writer *w, const struct index *p)
+{
+	const struct iref	*ir;
+	size_t			 nf = 0;
+
+	if (!wputs(w, "\tindex"))
+		return 0;
+
+	TAILQ_FOREACH(ir, &p->nq, entries)
+		if (!wprint(w, "%s %s",
+		    nf++ ? "," : "", ir->field->name))
+			return 0;
+
+	nf = 0;
+	TAILQ_FOREACH(ir, &p->wq, entries)
+		if (!wprint(w, "%s %s %s", nf++ ? "," : " where",
+		    ir->field->name, optypes[ir->op]))
+			return 0;
+
+	return wputs(w, ";\n");
+}
+
 /*
  * Write a structure query.
  * Returns zero on failure (memory), non-zero otherwise.
@@ -418,6 +467,7 @@ parse_write_query(struct writer *w, const struct search *p)
 {
 	const struct sent	*s;
 	const struct ord	*o;
+	const struct proj	*pr;
 	size_t			 nf;
 	int			 colon = 0;
 
@@ -445,6 +495,21 @@ parse_write_query(struct writer *w, const struct search *p)
 		colon = 1;
 	}
 
+	/* Selected columns. */
+
+	if (TAILQ_FIRST(&p->projq)) {
+		if (!colon && !wputc(w, ':'))
+			return 0;
+		if (!wputs(w, " select"))
+			return 0;
+		colon = 1;
+	}
+
+	nf = 0;
+	TAILQ_FOREACH(pr, &p->projq, entries)
+		if (!wprint(w, "%s %s", nf++ ? "," : "", pr->fname))
+			return 0;
+
 	/* Ordering. */
 
 	if (TAILQ_FIRST(&p->ordq)) {
@@ -480,13 +545,27 @@ parse_write_query(struct writer *w, const struct search *p)
 	if (p->group != NULL) {
 		if (!colon && !wputc(w, ':'))
 			return 0;
-		if (!wprint(w, " grouprow %s %s %s", p->group->fname,
+		if (!wprint(w, " grouprow %s", p->group->fname))
+			return 0;
+		if (p->aggr != NULL && !wprint(w, " %s %s", 
 		    p->aggr->op == AGGR_MAXROW ? "maxrow" : "minrow",
 		    p->aggr->fname))
 			return 0;
 		colon = 1;
 	}
 
+	/* Multi-key lookup and early-terminating iteration. */
+
+	if (p->flags & (SEARCH_HAS_MANY|SEARCH_HAS_UNTIL)) {
+		if (!colon && !wputc(w, ':'))
+			return 0;
+		if ((p->flags & SEARCH_HAS_MANY) && !wputs(w, " many"))
+			return 0;
+		if ((p->flags & SEARCH_HAS_UNTIL) && !wputs(w, " until"))
+			return 0;
+		colon = 1;
+	}
+
 	/* Distinct selection. */
 
 	if (p->dst != NULL) {
@@ -532,10 +611,15 @@ parse_write_rolemap(struct writer *w, const struct rolemap *p)
 	if (!wprint(w, " { %s", rolemapts[p->type]))
 		return 0;
 	switch (p->type) {
+	case ROLEMAP_AVG:
 	case ROLEMAP_COUNT:
+	case ROLEMAP_EXISTS:
 	case ROLEMAP_ITERATE:
 	case ROLEMAP_LIST:
+	case ROLEMAP_MAX:
+	case ROLEMAP_MIN:
 	case ROLEMAP_SEARCH:
+	case ROLEMAP_SUM:
 		if (p->s != NULL && !wprint(w, " %s", p->s->name))
 			return 0;
 		break;
@@ -566,6 +650,7 @@ parse_write_strct(struct writer *w, const struct strct *p)
 	const struct search	*s;
 	const struct update	*u;
 	const struct unique	*n;
+	const struct index	*ix;
 	const struct rolemap	*r;
 
 	if (!wprint(w, "struct %s {\n", p->name))
@@ -583,10 +668,18 @@ parse_write_strct(struct writer *w, const struct strct *p)
 	TAILQ_FOREACH(u, &p->dq, entries)
 		if (!parse_write_modify(w, u))
 			return 0;
-	if (p->ins != NULL && !wputs(w, "\tinsert;\n"))
+	if (p->ins != NULL && !wputs(w, 
+	    (p->ins->flags & INSERT_RETURNING) ?
+	    "\tinsert returning;\n" : "\tinsert;\n"))
+		return 0;
+	if (p->ups != NULL &&
+	    !parse_write_unique(w, "upsert", p->ups->target))
 		return 0;
 	TAILQ_FOREACH(n, &p->nq, entries)
-		if (!parse_write_unique(w, n))
+		if (!parse_write_unique(w, "unique", n))
+			return 0;
+	TAILQ_FOREACH(ix, &p->iq, entries)
+		if (!parse_write_index(w, ix))
 			return 0;
 	TAILQ_FOREACH(r, &p->rq, entries) 
 		if (!parse_write_rolemap(w, r))